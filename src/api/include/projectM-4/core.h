@@ -82,6 +82,9 @@ PROJECTM_EXPORT projectm_handle projectm_create_with_opengl_load_proc(projectm_l
  *
  * After destroying the handle, it must not be used for any other calls to the API.
  *
+ * If log messages are queued, see projectm_set_log_mode(), all pending messages are delivered to
+ * their callbacks before this function returns.
+ *
  * @param instance A handle returned by projectm_create() or projectm_create_settings().
  * @since 4.0.0
  */
@@ -125,6 +128,101 @@ PROJECTM_EXPORT void projectm_load_preset_file(projectm_handle instance, const c
 PROJECTM_EXPORT void projectm_load_preset_data(projectm_handle instance, const char* data,
                                                bool smooth_transition);
 
+/**
+ * @brief Checks if a preset file can be loaded, without switching to it.
+ *
+ * The preset is parsed, all expression code is compiled and the preset shaders are translated
+ * into GLSL. The final GLSL compilation step requires an OpenGL context and is not performed, so a
+ * preset passing this check may still fall back to a default shader when actually loaded.
+ *
+ * This function doesn't use any OpenGL functions and can safely be called from any thread, e.g.
+ * to check a whole preset collection in the background. The same URL schemas as for
+ * projectm_load_preset_file() are supported.
+ *
+ * @param instance The projectM instance handle.
+ * @param filename The preset filename or URL to check.
+ * @param error_message Optional. If not NULL and the preset can't be loaded, receives a pointer to
+ *                      the error message. Free the string with projectm_free_string() after use.
+ *                      Set to NULL if the preset is valid.
+ * @return True if the preset can be loaded, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_validate_preset_file(projectm_handle instance, const char* filename,
+                                                   char** error_message);
+
+/**
+ * @brief Precompiles preset files and writes them into a single bundle file.
+ *
+ * The bundle contains the parsed preset values, the expression code and the translated preset
+ * shaders, so loading a bundled preset skips all text processing. Presets which can't be parsed
+ * are skipped.
+ *
+ * This function doesn't use any OpenGL functions and can safely be called from any thread.
+ *
+ * @param instance The projectM instance handle.
+ * @param preset_filenames An array of preset filenames to add to the bundle.
+ * @param count The number of filenames in preset_filenames.
+ * @param bundle_filename The bundle file to write. An existing file will be overwritten.
+ * @param error_message Optional. If not NULL and the bundle can't be written, receives a pointer
+ *                      to the error message. Free the string with projectm_free_string() after use.
+ *                      Set to NULL on success.
+ * @return True if the bundle was written, false if an error occurred.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_write_preset_bundle(projectm_handle instance, const char** preset_filenames,
+                                                  size_t count, const char* bundle_filename,
+                                                  char** error_message);
+
+/**
+ * @brief Adds a bundle of precompiled presets.
+ *
+ * When projectm_load_preset_file() is called with a filename contained in the bundle, the preset
+ * is loaded from the precompiled data. The filename must match the one passed to
+ * projectm_write_preset_bundle() exactly. If the preset file was modified after the bundle was
+ * written, the preset is loaded from the source file instead. Shaders are translated again if the
+ * available textures or the target GLSL version differ from those the bundle was written with.
+ *
+ * If multiple bundles contain the same preset, the most recently added bundle is used.
+ *
+ * @param instance The projectM instance handle.
+ * @param bundle_filename The bundle file to add.
+ * @return True if the bundle was added, false if it can't be read or has an unsupported format.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_add_preset_bundle(projectm_handle instance, const char* bundle_filename);
+
+/**
+ * @brief Removes all preset bundles added with projectm_add_preset_bundle().
+ * @param instance The projectM instance handle.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_clear_preset_bundles(projectm_handle instance);
+
+/**
+ * @brief Reads the properties of a preset file without loading it.
+ *
+ * The preset is parsed and its shaders are translated into GLSL to find the referenced textures
+ * and the required blur level. The time spent in both steps is measured and returned as well.
+ * Shaders which can't be translated are still reported as present, but don't add any textures.
+ *
+ * This function doesn't use any OpenGL functions and can safely be called from any thread, e.g.
+ * to index a whole preset collection in the background. The same URL schemas as for
+ * projectm_load_preset_file() are supported.
+ *
+ * @param instance The projectM instance handle.
+ * @param filename The preset filename or URL to read.
+ * @param metadata Receives the preset properties. Free the textures member with
+ *                 projectm_free_string() after use. Left unchanged if an error occurred.
+ * @param error_message Optional. If not NULL and the preset can't be read, receives a pointer to
+ *                      the error message. Free the string with projectm_free_string() after use.
+ *                      Set to NULL on success.
+ * @return True if the metadata was read, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_get_preset_metadata(projectm_handle instance, const char* filename,
+                                                  projectm_preset_metadata* metadata,
+                                                  char** error_message);
+
 /**
  * @brief Reloads all textures.
  *
@@ -0,0 +1,123 @@
+/**
+ * @file instrumentation.h
+ * @copyright 2003-2025 projectM Team
+ * @brief Functions for querying rendering performance and other runtime statistics.
+ * @since 4.2.0
+ *
+ * projectM -- Milkdrop-esque visualisation SDK
+ * Copyright (C)2003-2025 projectM Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * See 'LICENSE.txt' included within this release
+ *
+ */
+
+#pragma once
+
+#include "projectM-4/types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Returns the number of frames rendered since the current preset was loaded.
+ *
+ * The counter is reset each time a new preset is successfully loaded, regardless of whether
+ * a hard or soft transition is performed.
+ *
+ * @param instance The projectM instance handle.
+ * @return The number of frames rendered with the most recently loaded preset.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint32_t projectm_get_preset_frame_count(projectm_handle instance);
+
+/**
+ * @brief Returns the average CPU time spent rendering a frame since the current preset was loaded.
+ *
+ * The value measures the time spent inside @a projectm_opengl_render_frame(), including the
+ * time needed to submit all OpenGL commands. While a soft transition is in progress, the cost of
+ * rendering both presets is attributed to the newly loaded one.
+ *
+ * Applications can use this value to identify presets which are too expensive to render on the
+ * current hardware. The value is reset together with the frame count.
+ *
+ * @param instance The projectM instance handle.
+ * @return The average frame render time in seconds, or 0.0 if no frame was rendered yet.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT double projectm_get_preset_average_frame_time(projectm_handle instance);
+
+/**
+ * @brief Returns the state of the shared expression memory buffer pool.
+ *
+ * Applications can poll this function to monitor how many gmegabuf buffers are kept for reuse in
+ * long-running sessions.
+ *
+ * @param instance The projectM instance handle.
+ * @param stats [out] Receives the memory statistics.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_preset_memory_stats(projectm_handle instance, projectm_preset_memory_stats* stats);
+
+/**
+ * @brief Returns the hit/miss counters and memory usage of the preset cache.
+ *
+ * The counters are accumulated over the lifetime of the instance.
+ *
+ * @param instance The projectM instance handle.
+ * @param stats [out] Receives the cache statistics.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_preset_cache_stats(projectm_handle instance, projectm_preset_cache_stats* stats);
+
+/**
+ * @brief Returns how long the phases of creating the projectM instance took.
+ *
+ * Transition shaders are compiled on first use, so their compile time isn't part of the startup.
+ *
+ * @param instance The projectM instance handle.
+ * @param stats [out] Receives the startup phase durations.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_startup_stats(projectm_handle instance, projectm_startup_stats* stats);
+
+/**
+ * @brief Returns the estimated render target memory traffic of the last rendered frame.
+ *
+ * Applications can use these values to choose a render target quality with
+ * projectm_set_render_target_quality() or to enable the fast blur on bandwidth-bound GPUs.
+ *
+ * @param instance The projectM instance handle.
+ * @param stats [out] Receives the bandwidth estimate.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_frame_bandwidth_stats(projectm_handle instance, projectm_frame_bandwidth_stats* stats);
+
+/**
+ * @brief Returns how many displayed frames also ran the preset simulation.
+ *
+ * With a fixed simulation rate set via projectm_set_simulation_rate(), the ratio approaches the
+ * simulation rate divided by the display refresh rate.
+ *
+ * @param instance The projectM instance handle.
+ * @param stats [out] Receives the frame counters.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_get_simulation_stats(projectm_handle instance, projectm_simulation_stats* stats);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
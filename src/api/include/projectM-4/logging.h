@@ -89,6 +89,48 @@ PROJECTM_EXPORT void projectm_set_log_callback(projectm_log_callback callback,
 PROJECTM_EXPORT void projectm_set_log_level(projectm_log_level log_level,
                                             bool current_thread_only);
 
+/**
+ * @brief Sets how log messages are passed to the callbacks.
+ *
+ * By default, callbacks are called synchronously on the thread which logged the message. If the
+ * application's callback can block, e.g. when writing to a socket, this also stalls rendering.
+ *
+ * In the queued and background modes, projectM copies each message into a fixed-size queue instead,
+ * without taking locks or allocating memory. Messages are then delivered either when the application
+ * calls projectm_flush_logs(), or by a background thread. Thread-specific callbacks receive the
+ * messages of their thread, but are then called on the flushing or background thread. Callbacks
+ * are never called in parallel in these modes.
+ *
+ * The queue holds 256 messages. Messages longer than 511 bytes are truncated. If the queue is full,
+ * new messages are dropped and counted, see projectm_get_dropped_log_messages().
+ *
+ * Switching back to PROJECTM_LOG_MODE_SYNCHRONOUS delivers all pending messages, as does
+ * projectm_destroy(). Applications using the background mode should switch back before unloading
+ * the library.
+ *
+ * @param mode The new log delivery mode. Default: PROJECTM_LOG_MODE_SYNCHRONOUS
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_log_mode(projectm_log_mode mode);
+
+/**
+ * @brief Passes all queued log messages to their callbacks on the calling thread.
+ *
+ * Used with PROJECTM_LOG_MODE_QUEUED, e.g. once per frame after rendering. Can also be called in
+ * the other modes, where it delivers any messages which are still pending.
+ *
+ * @return The number of delivered messages.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint32_t projectm_flush_logs();
+
+/**
+ * @brief Returns the number of log messages dropped because the queue was full.
+ * @return The number of dropped messages since the library was loaded.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint64_t projectm_get_dropped_log_messages();
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
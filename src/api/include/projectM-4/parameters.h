@@ -299,6 +299,94 @@ PROJECTM_EXPORT void projectm_set_aspect_correction(projectm_handle instance, bo
  */
 PROJECTM_EXPORT bool projectm_get_aspect_correction(projectm_handle instance);
 
+/**
+ * @brief Enables or disables the fast blur algorithm for preset shaders.
+ *
+ * Presets sampling the blur1, blur2 or blur3 textures normally use Milkdrop's blur, which renders
+ * two passes per blur level. The fast blur renders each level in a single downsampling pass with
+ * fewer texture fetches. The result looks very similar, but is not pixel-identical. Useful on
+ * low-end GPUs and at high resolutions.
+ *
+ * @param instance The projectM instance handle.
+ * @param enabled True to use the fast blur, false to use Milkdrop's blur. Default: false
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_fast_blur(projectm_handle instance, bool enabled);
+
+/**
+ * @brief Returns whether the fast blur algorithm is enabled or not.
+ * @param instance The projectM instance handle.
+ * @return True if the fast blur is used, false if Milkdrop's blur is used.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT bool projectm_get_fast_blur(projectm_handle instance);
+
+/**
+ * @brief Selects the texture formats used for the preset render targets.
+ *
+ * Presets render into two full-screen main images and a motion vector u/v map each frame. The low
+ * quality setting stores the u/v map with 8 bits per channel, halving its memory bandwidth on
+ * integrated GPUs at the cost of slightly less accurate motion vectors. The high quality setting
+ * uses 10 bits per color channel for the main images to reduce banding, with the same bandwidth
+ * as the default setting.
+ *
+ * Changing the setting recreates the render targets of the displayed presets, which briefly
+ * resets the image.
+ *
+ * @param instance The projectM instance handle.
+ * @param quality The render target quality. Default: PROJECTM_RENDER_TARGET_QUALITY_DEFAULT
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_render_target_quality(projectm_handle instance, projectm_render_target_quality quality);
+
+/**
+ * @brief Returns the texture format set used for the preset render targets.
+ * @param instance The projectM instance handle.
+ * @return The current render target quality.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT projectm_render_target_quality projectm_get_render_target_quality(projectm_handle instance);
+
+/**
+ * @brief Runs the preset simulation at a fixed rate, independent of the display refresh rate.
+ *
+ * Milkdrop presets are tuned for about 60 frames per second. On high refresh rate displays,
+ * rendering the full preset every frame multiplies the work without a visible improvement. With a
+ * fixed simulation rate, presets are only rendered once per simulation interval. Display frames
+ * in between only redraw the last preset output, the running transition and the user sprites.
+ *
+ * If the display is slower than the simulation rate, the presets are rendered in every frame.
+ * The value is also passed to presets as the "fps" variable instead of the value set with
+ * projectm_set_fps().
+ *
+ * @param instance The projectM instance handle.
+ * @param steps_per_second The number of preset simulation steps per second, or 0 to render the
+ *                         presets in every frame. Default: 0
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_simulation_rate(projectm_handle instance, uint32_t steps_per_second);
+
+/**
+ * @brief Returns the fixed preset simulation rate.
+ * @param instance The projectM instance handle.
+ * @return The number of preset simulation steps per second, or 0 if presets are rendered in every frame.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint32_t projectm_get_simulation_rate(projectm_handle instance);
+
+/**
+ * @brief Seeds the random number generator used for presets and transitions.
+ *
+ * The generator is seeded randomly when the instance is created. Setting a fixed seed makes the
+ * random shader values, random textures and transition effects reproducible, e.g. for testing or
+ * offline rendering. The seed only affects presets and transitions which are loaded afterwards.
+ *
+ * @param instance The projectM instance handle.
+ * @param seed The new seed value.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_random_seed(projectm_handle instance, uint64_t seed);
+
 /**
  * @brief Sets the "easter egg" value.
  *
@@ -394,6 +482,25 @@ PROJECTM_EXPORT void projectm_set_preset_start_clean(projectm_handle instance, b
  */
 PROJECTM_EXPORT bool projectm_get_preset_start_clean(projectm_handle instance);
 
+/**
+ * @brief Sets the limits of the cache for recently used presets.
+ *
+ * Presets which are no longer displayed are kept fully initialized, so loading the same file again
+ * only resets the preset state instead of parsing and compiling it from scratch. The least recently
+ * used presets are destroyed if any of the limits is exceeded.
+ *
+ * Cached presets keep their render target textures allocated. Memory is estimated from the
+ * viewport size at the time the preset was last displayed.
+ * If the size or modification time of a preset file changed, the cached preset is discarded and
+ * the file is loaded again.
+ *
+ * @param instance The projectM instance handle.
+ * @param max_presets Max number of cached presets. 0 disables the cache. Default: 4
+ * @param max_bytes Max estimated memory held by all cached presets. Default: 256 MiB
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_set_preset_cache_limits(projectm_handle instance, uint32_t max_presets, size_t max_bytes);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
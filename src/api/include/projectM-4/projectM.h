@@ -29,6 +29,7 @@
 #include "projectM-4/callbacks.h"
 #include "projectM-4/core.h"
 #include "projectM-4/debug.h"
+#include "projectM-4/instrumentation.h"
 #include "projectM-4/logging.h"
 #include "projectM-4/memory.h"
 #include "projectM-4/parameters.h"
@@ -63,6 +63,38 @@ PROJECTM_EXPORT void projectm_opengl_render_frame_fbo(projectm_handle instance,
  */
 PROJECTM_EXPORT void projectm_opengl_burn_texture(projectm_handle instance, uint32_t texture, int left, int top, int width, int height);
 
+/**
+ * @brief Adds a framebuffer which receives a scaled copy of every rendered frame.
+ *
+ * Use this to feed additional outputs with different resolutions, e.g. a low-resolution preview,
+ * from a single simulation step. After the frame including all user sprites has been drawn, the
+ * image is scaled into each output target with framebuffer blits. Targets much smaller than the
+ * main output are fed from a chain of half-size images, which is a lot cheaper than rendering
+ * the presets again with a second projectM instance.
+ *
+ * To render into a texture, attach it to a framebuffer object and pass the framebuffer.
+ * The framebuffer must stay valid until the target is removed or the instance is destroyed.
+ *
+ * @param instance The projectM instance handle.
+ * @param framebuffer_object_id The OpenGL FBO ID to draw the scaled image into.
+ * @param width The width of the output target in pixels.
+ * @param height The height of the output target in pixels.
+ * @return An identifier for the output target, or 0 if the size is invalid.
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT uint32_t projectm_opengl_add_output_target(projectm_handle instance, uint32_t framebuffer_object_id, int width, int height);
+
+/**
+ * @brief Stops drawing into the given output target.
+ *
+ * To change the size of an output target, remove it and add it again with the new size.
+ *
+ * @param instance The projectM instance handle.
+ * @param output_target_id The identifier returned by projectm_opengl_add_output_target().
+ * @since 4.2.0
+ */
+PROJECTM_EXPORT void projectm_opengl_remove_output_target(projectm_handle instance, uint32_t output_target_id);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -93,6 +93,128 @@ typedef enum
     PROJECTM_LOG_LEVEL_FATAL = 6   //!< Irrecoverable errors preventing projectM from working.
 } projectm_log_level;
 
+/**
+ * Log message delivery modes, used with projectm_set_log_mode().
+ * @since 4.2.0
+ */
+typedef enum
+{
+    PROJECTM_LOG_MODE_SYNCHRONOUS = 0, //!< Callbacks are called immediately on the logging thread.
+    PROJECTM_LOG_MODE_QUEUED = 1,      //!< Messages are queued until the application calls projectm_flush_logs().
+    PROJECTM_LOG_MODE_BACKGROUND = 2   //!< Messages are queued and delivered by a background thread.
+} projectm_log_mode;
+
+/**
+ * Texture format sets for the preset render targets, used with projectm_set_render_target_quality().
+ * @since 4.2.0
+ */
+typedef enum
+{
+    PROJECTM_RENDER_TARGET_QUALITY_LOW = 0,     //!< 8 bits per channel for all render targets, for bandwidth-bound GPUs.
+    PROJECTM_RENDER_TARGET_QUALITY_DEFAULT = 1, //!< 8 bits per channel main images, 16-bit float motion vector u/v map.
+    PROJECTM_RENDER_TARGET_QUALITY_HIGH = 2     //!< 10 bits per color channel main images, reducing banding in dark gradients.
+} projectm_render_target_quality;
+
+/**
+ * @brief Properties of a preset file, as returned by projectm_get_preset_metadata().
+ *
+ * The textures member is allocated by projectM and must be freed with projectm_free_string().
+ *
+ * @since 4.2.0
+ */
+typedef struct projectm_preset_metadata {
+    bool has_warp_shader;           /**< True if the preset has a warp shader which is used. */
+    bool has_composite_shader;      /**< True if the preset has a composite shader which is used. */
+    bool has_per_pixel_code;        /**< True if the preset has per-pixel expression code. */
+    uint32_t custom_wave_count;     /**< Number of enabled custom waveforms. */
+    uint32_t custom_shape_count;    /**< Number of enabled custom shapes. */
+    uint32_t max_wave_samples;      /**< Highest sample count of all enabled custom waveforms. */
+    uint32_t max_shape_instances;   /**< Highest instance count of all enabled custom shapes. */
+    uint32_t blur_level;            /**< Highest blur texture level used by the preset shaders, 0 to 3. */
+    double parse_time;              /**< Time in seconds spent reading and parsing the preset file. */
+    double shader_translation_time; /**< Time in seconds spent translating the preset shaders. */
+    char* textures;                 /**< Space-separated, lower-case names of all textures referenced by the preset shaders. NULL if none. */
+} projectm_preset_metadata;
+
+/**
+ * @brief Expression memory usage, as returned by projectm_get_preset_memory_stats().
+ *
+ * The gmegabuf buffers of unloaded presets are cleared and recycled by the next preset. The pool
+ * of recycled buffers is shared by all projectM instances in the process. The memory held by a
+ * buffer is managed by the expression evaluator and not reported.
+ *
+ * @since 4.2.0
+ */
+typedef struct projectm_preset_memory_stats {
+    uint32_t pooled_buffers; /**< Number of recycled buffers waiting to be reused. */
+} projectm_preset_memory_stats;
+
+/**
+ * @brief Preset cache usage, as returned by projectm_get_preset_cache_stats().
+ *
+ * Presets which are no longer displayed are kept in a cache. Loading the same preset file again
+ * reuses the cached instance, skipping parsing and code/shader compilation.
+ *
+ * @since 4.2.0
+ */
+typedef struct projectm_preset_cache_stats {
+    uint64_t hits;           /**< Number of preset loads served from the cache. */
+    uint64_t misses;         /**< Number of preset file loads which had to create a new preset. */
+    uint64_t evictions;      /**< Number of presets removed from the cache to stay within the limits. */
+    uint32_t cached_presets; /**< Number of presets currently in the cache. */
+    size_t cached_bytes;     /**< Estimated texture memory held by all cached presets. */
+} projectm_preset_cache_stats;
+
+/**
+ * @brief Durations of the startup phases, as returned by projectm_get_startup_stats().
+ *
+ * All times are wall-clock seconds measured during projectm_create(). CPU-only work, like
+ * generating the noise textures, decoding the built-in idle textures and parsing the idle preset,
+ * runs on worker threads in the background. Time spent waiting for their results is included in
+ * the phase which first needs them.
+ *
+ * @since 4.2.0
+ */
+typedef struct projectm_startup_stats {
+    double gl_check_time;        /**< Checking the OpenGL shader language version. */
+    double preset_factory_time;  /**< Registering the preset factories and starting to precompile the idle preset. */
+    double texture_manager_time; /**< Creating the texture samplers and starting to generate the built-in textures. */
+    double renderer_time;        /**< Creating the shader cache, transition shader manager, texture copier and sprite manager. */
+    double idle_preset_time;     /**< Loading the idle preset, including uploading the built-in textures and compiling its shaders. */
+    double total_time;           /**< The whole initialization. */
+} projectm_startup_stats;
+
+/**
+ * @brief Estimated render target traffic, as returned by projectm_get_frame_bandwidth_stats().
+ *
+ * The values are calculated from the render target sizes and formats of the last rendered frame,
+ * counting each full-screen texture read or write once. GPU caches, framebuffer compression and
+ * the geometry drawn on top of the images aren't taken into account. While a soft transition is
+ * running, both presets are counted.
+ *
+ * @since 4.2.0
+ */
+typedef struct projectm_frame_bandwidth_stats {
+    size_t bytes_read;          /**< Estimated bytes read from preset render targets in the last frame. */
+    size_t bytes_written;       /**< Estimated bytes written to preset render targets in the last frame. */
+    size_t render_target_bytes; /**< Video memory allocated for the render targets of the displayed presets. */
+} projectm_frame_bandwidth_stats;
+
+/**
+ * @brief Displayed and simulated frame counts, as returned by projectm_get_simulation_stats().
+ *
+ * Without a fixed simulation rate, both counters are equal except for frames in which no preset
+ * could be displayed.
+ *
+ * @since 4.2.0
+ */
+typedef struct projectm_simulation_stats {
+    uint64_t displayed_frames; /**< Number of frames rendered by the application since the instance was created. */
+    uint64_t simulated_frames; /**< Number of frames in which the presets were simulated and rendered. */
+    double simulation_ratio;   /**< Simulated frames divided by displayed frames, or 0.0 if no frame was displayed yet. */
+    double simulated_seconds;  /**< Sum of the time steps passed to the presets. Follows the frame times, minus at most one simulation interval. */
+} projectm_simulation_stats;
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
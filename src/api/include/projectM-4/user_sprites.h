@@ -107,6 +107,9 @@ PROJECTM_EXPORT void projectm_sprite_get_sprite_ids(projectm_handle instance, ui
  *
  * Once the limit is exceeded, the oldest sprite will be destroyed in order to display a new one.
  *
+ * Sprites sharing the same image and blend mode are drawn together, so hundreds of sprites can be
+ * displayed at once. At most 1,048,575 sprites can be active, regardless of a higher limit.
+ *
  * @param instance The projectM instance handle.
  * @param max_sprites Maximum number of sprites to be displayed at once. Defaults to 16.
  * @since 4.2.0
@@ -0,0 +1,98 @@
+#include "LogQueue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace libprojectM {
+
+LogQueue::LogQueue()
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "LogQueue capacity must be a power of two.");
+
+    for (size_t index = 0; index < Capacity; index++)
+    {
+        m_slots[index].sequence.store(index, std::memory_order_relaxed);
+    }
+}
+
+auto LogQueue::Push(Logging::UserCallback callback, const std::string& message, Logging::LogLevel severity) -> bool
+{
+    // Bounded multi-producer queue: a slot is free for position N if its sequence number equals N.
+    auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+    Slot* slot{nullptr};
+    while (true)
+    {
+        slot = &m_slots[position & (Capacity - 1)];
+        auto const sequence = slot->sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0)
+        {
+            if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            // The slot still holds an undelivered message from the previous round.
+            m_droppedMessages.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = m_enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->callback = callback;
+    slot->severity = severity;
+    slot->length = std::min(message.length(), MaxMessageLength);
+    std::memcpy(slot->message.data(), message.data(), slot->length);
+    slot->message[slot->length] = '\0';
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    return true;
+}
+
+auto LogQueue::Deliver() -> size_t
+{
+    std::lock_guard<std::mutex> lock(m_deliveryMutex);
+
+    size_t deliveredMessages{};
+    std::array<char, MaxMessageLength + 1> message{};
+
+    while (true)
+    {
+        auto& slot = m_slots[m_dequeuePosition & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+        {
+            // Either empty, or a producer is still writing the next message.
+            break;
+        }
+
+        // Copy the message and release the slot before calling back, so a slow callback doesn't block producers.
+        auto const callback = slot.callback;
+        auto const severity = slot.severity;
+        std::memcpy(message.data(), slot.message.data(), slot.length + 1);
+
+        slot.sequence.store(m_dequeuePosition + Capacity, std::memory_order_release);
+        m_dequeuePosition++;
+
+        if (callback.callbackFunction != nullptr)
+        {
+            callback.callbackFunction(message.data(), static_cast<int>(severity), callback.userData);
+        }
+        deliveredMessages++;
+    }
+
+    return deliveredMessages;
+}
+
+auto LogQueue::DroppedMessages() const -> uint64_t
+{
+    return m_droppedMessages.load(std::memory_order_relaxed);
+}
+
+} // namespace libprojectM
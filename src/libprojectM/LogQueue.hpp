@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Logging.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace libprojectM {
+
+/**
+ * @class LogQueue
+ * @brief A bounded, lock-free queue for log messages which are delivered later on another thread.
+ *
+ * Any number of threads can push messages without taking a lock or allocating memory. Each
+ * message is copied into a fixed-size slot together with the callback that was active on the
+ * logging thread, so thread-specific callbacks still receive the messages of their own thread.
+ * If all slots are in use, the message is dropped and counted instead of blocking the caller.
+ *
+ * Messages are removed in order by Deliver(), which calls the stored callbacks. Concurrent
+ * Deliver() calls are serialized, so callbacks are never called in parallel.
+ */
+class LogQueue
+{
+public:
+    static constexpr size_t Capacity{256};         //!< Number of message slots. Must be a power of two.
+    static constexpr size_t MaxMessageLength{511}; //!< Longer messages are truncated to this number of bytes.
+
+    LogQueue();
+
+    /**
+     * @brief Copies a message into the queue.
+     * @param callback The callback which should receive the message.
+     * @param message The message text.
+     * @param severity The severity of the message.
+     * @return true if the message was queued, false if the queue was full and the message was dropped.
+     */
+    auto Push(Logging::UserCallback callback, const std::string& message, Logging::LogLevel severity) -> bool;
+
+    /**
+     * @brief Passes all queued messages to their callbacks on the calling thread.
+     * @return The number of delivered messages.
+     */
+    auto Deliver() -> size_t;
+
+    /**
+     * @brief Returns the number of messages dropped because the queue was full.
+     * @return The number of dropped messages since the queue was created.
+     */
+    auto DroppedMessages() const -> uint64_t;
+
+private:
+    /**
+     * @brief A single queued message.
+     */
+    struct Slot {
+        std::atomic<size_t> sequence{};                    //!< Queue position this slot is ready for, used to hand over slots between threads.
+        Logging::UserCallback callback;                    //!< The callback which receives the message.
+        Logging::LogLevel severity{};                      //!< The message severity.
+        size_t length{};                                   //!< Number of valid bytes in message.
+        std::array<char, MaxMessageLength + 1> message{}; //!< Zero-terminated message text.
+    };
+
+    std::array<Slot, Capacity> m_slots;       //!< Message storage.
+    std::atomic<size_t> m_enqueuePosition{}; //!< Position of the next message to write.
+    size_t m_dequeuePosition{};               //!< Position of the next message to deliver. Guarded by m_deliveryMutex.
+    std::mutex m_deliveryMutex;               //!< Serializes message delivery.
+    std::atomic<uint64_t> m_droppedMessages{}; //!< Number of messages dropped due to a full queue.
+};
+
+} // namespace libprojectM
@@ -1,9 +1,69 @@
 #include "Logging.hpp"
 
+#include "LogQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace libprojectM {
 
+namespace {
+
+/**
+ * @brief Delivers queued log messages on a background thread until destroyed.
+ */
+class DeliveryThread
+{
+public:
+    explicit DeliveryThread(LogQueue& queue)
+        : m_queue(queue)
+        , m_thread(&DeliveryThread::Run, this)
+    {
+    }
+
+    ~DeliveryThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wakeUp.notify_one();
+        m_thread.join();
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop)
+        {
+            // Poll instead of waking the thread on each message, so logging threads never make a system call.
+            m_wakeUp.wait_for(lock, std::chrono::milliseconds(10));
+            lock.unlock();
+            m_queue.Deliver();
+            lock.lock();
+        }
+    }
+
+    LogQueue& m_queue;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    bool m_stop{false};
+    std::thread m_thread;
+};
+
+LogQueue logQueue;
+std::atomic<Logging::Mode> logMode{Logging::Mode::Synchronous};
+std::mutex logModeMutex;
+std::unique_ptr<DeliveryThread> deliveryThread;
+
+} // namespace
+
 Logging::UserCallback Logging::m_globalCallback = {};
 thread_local Logging::UserCallback Logging::m_threadCallback = {};
 
@@ -61,9 +121,53 @@ void Logging::Log(const std::string& message, LogLevel severity)
         return;
     }
 
+    if (logMode.load(std::memory_order_relaxed) != Mode::Synchronous)
+    {
+        logQueue.Push(callback, message, severity);
+        return;
+    }
+
     callback.callbackFunction(message.c_str(), static_cast<int>(severity), callback.userData);
 }
 
+void Logging::SetMode(Mode mode)
+{
+    std::lock_guard<std::mutex> lock(logModeMutex);
+
+    logMode.store(mode, std::memory_order_relaxed);
+
+    if (mode == Mode::Background)
+    {
+        if (!deliveryThread)
+        {
+            deliveryThread = std::make_unique<DeliveryThread>(logQueue);
+        }
+        return;
+    }
+
+    deliveryThread.reset();
+
+    if (mode == Mode::Synchronous)
+    {
+        logQueue.Deliver();
+    }
+}
+
+auto Logging::GetMode() -> Mode
+{
+    return logMode.load(std::memory_order_relaxed);
+}
+
+auto Logging::Flush() -> size_t
+{
+    return logQueue.Deliver();
+}
+
+auto Logging::DroppedMessages() -> uint64_t
+{
+    return logQueue.DroppedMessages();
+}
+
 auto Logging::GetLoggingCallback() -> UserCallback
 {
     if (m_threadCallback.callbackFunction != nullptr)
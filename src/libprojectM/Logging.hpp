@@ -31,6 +31,16 @@ public:
         Fatal        //!< An unrecoverable error occurred and the projectM instance cannot continue execution.
     };
 
+    /**
+     * How log messages are passed to the callbacks.
+     */
+    enum class Mode : uint8_t
+    {
+        Synchronous, //!< Callbacks are called immediately on the logging thread.
+        Queued,      //!< Messages are queued until Flush() is called.
+        Background   //!< Messages are queued and delivered by a background thread.
+    };
+
     /**
      * The application callback function.
      */
@@ -91,6 +101,35 @@ public:
      */
     PROJECTM_CXX_EXPORT static void Log(const std::string& message, LogLevel severity);
 
+    /**
+     * @brief Sets how log messages are passed to the callbacks.
+     *
+     * In the queued modes, messages are copied into a bounded queue together with the callback active
+     * on the logging thread, so a slow callback can't stall rendering. Messages logged while the queue
+     * is full are dropped and counted. Switching back to Mode::Synchronous delivers all pending messages.
+     *
+     * @param mode The new delivery mode.
+     */
+    PROJECTM_CXX_EXPORT static void SetMode(Mode mode);
+
+    /**
+     * @brief Returns the current delivery mode.
+     * @return The current delivery mode.
+     */
+    PROJECTM_CXX_EXPORT static auto GetMode() -> Mode;
+
+    /**
+     * @brief Passes all queued messages to their callbacks on the calling thread.
+     * @return The number of delivered messages.
+     */
+    PROJECTM_CXX_EXPORT static auto Flush() -> size_t;
+
+    /**
+     * @brief Returns the number of messages dropped because the queue was full.
+     * @return The number of dropped messages since the library was loaded.
+     */
+    PROJECTM_CXX_EXPORT static auto DroppedMessages() -> uint64_t;
+
     /**
      * The default log level used if no log level is set (LogLevel::Information)
      */
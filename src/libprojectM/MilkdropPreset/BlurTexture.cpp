@@ -71,8 +71,18 @@ void BlurTexture::Initialize(const Renderer::RenderContext& renderContext)
         renderContext.shaderCache->Insert("milkdrop_blur2", blur2Shader);
     }
 
+    auto fastShader = renderContext.shaderCache->Get("milkdrop_blur_fast");
+    if (!fastShader)
+    {
+        fastShader = std::make_shared<Renderer::Shader>();
+        fastShader->CompileProgram(staticShaders->GetBlurVertexShader(),
+                                   staticShaders->GetBlurFastFragmentShader());
+        renderContext.shaderCache->Insert("milkdrop_blur_fast", fastShader);
+    }
+
     m_blur1Shader = blur1Shader;
     m_blur2Shader = blur2Shader;
+    m_fastShader = fastShader;
 }
 
 void BlurTexture::SetRequiredBlurLevel(BlurTexture::BlurLevel level)
@@ -80,6 +90,11 @@ void BlurTexture::SetRequiredBlurLevel(BlurTexture::BlurLevel level)
     m_blurLevel = std::max(level, m_blurLevel);
 }
 
+void BlurTexture::SetMode(BlurTexture::Mode mode)
+{
+    m_mode = mode;
+}
+
 auto BlurTexture::GetDescriptorsForBlurLevel(BlurTexture::BlurLevel blurLevel) const -> std::vector<Renderer::TextureSamplerDescriptor>
 {
     std::vector<Renderer::TextureSamplerDescriptor> descriptors;
@@ -103,9 +118,33 @@ auto BlurTexture::GetDescriptorsForBlurLevel(BlurTexture::BlurLevel blurLevel) c
     return descriptors;
 }
 
-void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext)
+auto BlurTexture::TextureMemory() const -> size_t
 {
-    if (m_blurLevel == BlurLevel::None)
+    size_t bytes{0};
+    for (const auto& texture : m_blurTextures)
+    {
+        if (texture)
+        {
+            // Blur textures are always RGBA8.
+            bytes += static_cast<size_t>(texture->Width()) * static_cast<size_t>(texture->Height()) * 4;
+        }
+    }
+
+    return bytes;
+}
+
+void BlurTexture::LastUpdateBandwidth(size_t& bytesRead, size_t& bytesWritten) const
+{
+    bytesRead = m_bytesRead;
+    bytesWritten = m_bytesWritten;
+}
+
+void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext, BlurLevel blurLevel)
+{
+    m_bytesRead = 0;
+    m_bytesWritten = 0;
+
+    if (blurLevel == BlurLevel::None)
     {
         return;
     }
@@ -118,17 +157,15 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
 
     AllocateTextures(sourceTexture);
 
-    unsigned int const passes = static_cast<int>(m_blurLevel) * 2;
+    auto const levels = static_cast<unsigned int>(blurLevel);
     auto const blur1EdgeDarken = static_cast<float>(*perFrameContext.blur1_edge_darken);
 
-    const std::array<float, 8> weights = {4.0f, 3.8f, 3.5f, 2.9f, 1.9f, 1.2f, 0.7f, 0.3f}; //<- user can specify these
-
     Values blurMin;
     Values blurMax;
     GetSafeBlurMinMaxValues(perFrameContext, blurMin, blurMax);
 
-    std::array<float, 3> scale{};
-    std::array<float, 3> bias{};
+    Values scale{};
+    Values bias{};
 
     // figure out the progressive scale & bias needed, at each step,
     // to go from one [min..max] range to the next.
@@ -153,6 +190,31 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
 
     Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::One, Renderer::BlendMode::Function::Zero);
 
+    if (m_mode == Mode::Fast)
+    {
+        UpdateFast(sourceTexture, levels, scale, bias, blur1EdgeDarken);
+    }
+    else
+    {
+        UpdateClassic(sourceTexture, levels * 2, scale, bias, blur1EdgeDarken);
+    }
+
+    Renderer::Mesh::Unbind();
+    Renderer::BlendMode::Set(false, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
+
+    // Bind previous framebuffer and reset viewport size
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, origReadFramebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, origDrawFramebuffer);
+    glViewport(0, 0, sourceTexture.Width(), sourceTexture.Height());
+
+    Renderer::Shader::Unbind();
+}
+
+void BlurTexture::UpdateClassic(const Renderer::Texture& sourceTexture, unsigned int passes,
+                                const Values& scale, const Values& bias, float blur1EdgeDarken)
+{
+    const std::array<float, 8> weights = {4.0f, 3.8f, 3.5f, 2.9f, 1.9f, 1.2f, 0.7f, 0.3f}; //<- user can specify these
+
     for (unsigned int pass = 0; pass < passes; pass++)
     {
         if (m_blurTextures[pass]->TextureID() == 0)
@@ -254,24 +316,81 @@ void BlurTexture::Update(const Renderer::Texture& sourceTexture, const PerFrameC
             }
         }
 
-        // Draw fullscreen quad
-        m_blurMesh.Draw();
+        DrawPass(pass == 0 ? sourceTexture : *m_blurTextures[pass - 1], *m_blurTextures[pass]);
+    }
+}
 
-        // Save to blur texture
-        m_blurTextures[pass]->Bind(0);
-        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, m_blurTextures[pass]->Width(), m_blurTextures[pass]->Height());
-        m_blurTextures[pass]->Unbind(0);
+void BlurTexture::UpdateFast(const Renderer::Texture& sourceTexture, unsigned int levels,
+                             const Values& scale, const Values& bias, float blur1EdgeDarken)
+{
+    auto blurShader = m_fastShader.lock();
+    if (!blurShader)
+    {
+        return;
     }
 
-    Renderer::Mesh::Unbind();
-    Renderer::BlendMode::Set(false, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
+    blurShader->Bind();
+    blurShader->SetUniformInt("texture_sampler", 0);
 
-    // Bind previous framebuffer and reset viewport size
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, origReadFramebuffer);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, origDrawFramebuffer);
-    glViewport(0, 0, sourceTexture.Width(), sourceTexture.Height());
+    // Only the user-visible textures are drawn, each one directly downsampled from the previous level.
+    const Renderer::Texture* previousTexture = &sourceTexture;
+    for (unsigned int level = 0; level < levels; level++)
+    {
+        const auto& targetTexture = m_blurTextures[level * 2 + 1];
+        if (targetTexture->TextureID() == 0)
+        {
+            continue;
+        }
 
-    Renderer::Shader::Unbind();
+        glViewport(0, 0, targetTexture->Width(), targetTexture->Height());
+
+        previousTexture->Bind(0);
+        m_blurSampler->Bind(0);
+        blurShader->SetUniformInt("flipVertical", level == 0 ? 1 : 0);
+
+        auto const srcWidth = static_cast<float>(previousTexture->Width());
+        auto const srcHeight = static_cast<float>(previousTexture->Height());
+
+        //-------------------------------------
+        //float4 _c0; // source texsize (.xy), and inverse (.zw)
+        //float4 _c1; // scale, bias, edge_darken_c1, edge_darken_c2
+        //float4 _c2; // edge_darken_c3, sample spread
+        //-------------------------------------
+        blurShader->SetUniformFloat4("_c0", {srcWidth, srcHeight, 1.0f / srcWidth, 1.0f / srcHeight});
+        if (level == 0)
+        {
+            // Darken edges
+            blurShader->SetUniformFloat4("_c1", {scale[level], bias[level], (1 - blur1EdgeDarken), blur1EdgeDarken});
+        }
+        else
+        {
+            // Don't darken
+            blurShader->SetUniformFloat4("_c1", {scale[level], bias[level], 1.0f, 0.0f});
+        }
+        // Spread the samples of the smaller levels a bit more to match the width of Milkdrop's blur.
+        blurShader->SetUniformFloat4("_c2", {5.0f, level == 0 ? 1.0f : 1.25f, 0.0f, 0.0f});
+
+        DrawPass(*previousTexture, *targetTexture);
+
+        previousTexture = targetTexture.get();
+    }
+}
+
+void BlurTexture::DrawPass(const Renderer::Texture& sourceTexture, const Renderer::Texture& targetTexture)
+{
+    // Draw fullscreen quad
+    m_blurMesh.Draw();
+
+    // Save to blur texture
+    targetTexture.Bind(0);
+    glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, targetTexture.Width(), targetTexture.Height());
+    targetTexture.Unbind(0);
+
+    // The pass reads the source once and writes the framebuffer, the copy reads it back into the texture.
+    auto const sourceBytes = static_cast<size_t>(sourceTexture.Width()) * static_cast<size_t>(sourceTexture.Height()) * 4;
+    auto const targetBytes = static_cast<size_t>(targetTexture.Width()) * static_cast<size_t>(targetTexture.Height()) * 4;
+    m_bytesRead += sourceBytes + targetBytes;
+    m_bytesWritten += targetBytes * 2;
 }
 
 void BlurTexture::Bind(GLint& unit, Renderer::Shader& shader) const
@@ -334,12 +453,16 @@ void BlurTexture::AllocateTextures(const Renderer::Texture& sourceTexture)
         width > 0 &&
         height > 0 &&
         width == m_sourceTextureWidth &&
-        height == m_sourceTextureHeight)
+        height == m_sourceTextureHeight &&
+        m_mode == m_allocatedMode)
     {
-        // Size unchanged, return.
+        // Size and mode unchanged, return.
         return;
     }
 
+    // Fast mode draws the user-visible textures directly, the intermediate ones stay empty.
+    size_t const firstTexture = m_mode == Mode::Fast ? 1 : 0;
+
     for (size_t i = 0; i < m_blurTextures.size(); i++)
     {
         // main VS = 1024
@@ -357,7 +480,7 @@ void BlurTexture::AllocateTextures(const Renderer::Texture& sourceTexture)
         int width2 = ((width + 3) / 16) * 16;
         int height2 = ((height + 3) / 4) * 4;
 
-        if (i == 0)
+        if (i == firstTexture)
         {
             // Only use as much space as needed to render the blur textures.
             m_blurFramebuffer.SetSize(width2, height2);
@@ -370,11 +493,19 @@ void BlurTexture::AllocateTextures(const Renderer::Texture& sourceTexture)
         }
 
         // This will automatically replace any old texture.
-        m_blurTextures[i] = std::make_shared<Renderer::Texture>(textureName, width2, height2, false);
+        if (m_mode == Mode::Fast && i % 2 == 0)
+        {
+            m_blurTextures[i] = std::make_shared<Renderer::Texture>(textureName, 0, GL_TEXTURE_2D, 0, 0, false);
+        }
+        else
+        {
+            m_blurTextures[i] = std::make_shared<Renderer::Texture>(textureName, width2, height2, false);
+        }
     }
 
     m_sourceTextureWidth = sourceTexture.Width();
     m_sourceTextureHeight = sourceTexture.Height();
+    m_allocatedMode = m_mode;
 }
 
 } // namespace MilkdropPreset
@@ -11,6 +11,7 @@
 #include <Renderer/TextureSamplerDescriptor.hpp>
 
 #include <array>
+#include <cstddef>
 #include <memory>
 
 namespace libprojectM {
@@ -41,6 +42,15 @@ public:
         Blur3  //!< Third blur level (6 passes)
     };
 
+    /**
+     * Algorithm used to render the blur textures.
+     */
+    enum class Mode : int
+    {
+        Classic, //!< Milkdrop's separable blur, two passes per blur level.
+        Fast     //!< Single-pass box downsampling pyramid with fewer texture fetches, one pass per blur level.
+    };
+
     /**
      * Constructor.
      */
@@ -64,6 +74,16 @@ public:
      */
     void SetRequiredBlurLevel(BlurLevel level);
 
+    /**
+     * @brief Sets the algorithm used to render the blur textures.
+     *
+     * The fast mode produces visually similar, but not identical textures. Can be changed at any
+     * time, the next Update() call will use the new mode and reallocate the textures for it.
+     *
+     * @param mode The blur mode.
+     */
+    void SetMode(Mode mode);
+
     /**
      * @brief Returns a list of descriptors for the given blur level.
      * The blur textures don't need to be present and can be empty placeholders.
@@ -71,12 +91,31 @@ public:
      */
     auto GetDescriptorsForBlurLevel(BlurLevel blurLevel) const -> std::vector<Renderer::TextureSamplerDescriptor>;
 
+    /**
+     * @brief Returns the video memory allocated for the blur textures.
+     * @return The size of all allocated blur textures in bytes.
+     */
+    auto TextureMemory() const -> size_t;
+
+    /**
+     * @brief Returns the estimated texture traffic of the last Update() call.
+     * Both main image formats and all blur textures use four bytes per pixel.
+     * @param bytesRead [out] Bytes read from the source and blur textures.
+     * @param bytesWritten [out] Bytes written to the blur textures.
+     */
+    void LastUpdateBandwidth(size_t& bytesRead, size_t& bytesWritten) const;
+
     /**
      * @brief Renders the required blur passes on the given texture.
+     *
+     * Only renders the passes needed for the given level, which should be the highest level read by
+     * any shader drawn with the resulting textures. Does nothing if the level is BlurLevel::None.
+     *
      * @param sourceTexture The texture to create the blur levels from.
      * @param perFrameContext The per-frame variables.
+     * @param blurLevel The blur level to update the textures for.
      */
-    void Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext);
+    void Update(const Renderer::Texture& sourceTexture, const PerFrameContext& perFrameContext, BlurLevel blurLevel);
 
     /**
      * @brief Binds the user-readable blur textures to the texture slots starting with the given index.
@@ -101,15 +140,46 @@ private:
     static constexpr int NumBlurTextures = 6; //!< Maximum number of blur passes/textures.
 
     /**
-     * Allocates the blur textures.
+     * Allocates the blur textures sampled by the current mode.
+     * In fast mode, the intermediate textures of the classic blur are left empty.
      * @param sourceTexture The source texture.
      */
     void AllocateTextures(const Renderer::Texture& sourceTexture);
 
+    /**
+     * @brief Renders the blur textures using Milkdrop's two-pass separable blur.
+     * @param sourceTexture The texture to create the blur levels from.
+     * @param passes The number of passes to render.
+     * @param scale The color scale applied for each blur level.
+     * @param bias The color bias applied for each blur level.
+     * @param blur1EdgeDarken The edge darkening factor of the first blur level.
+     */
+    void UpdateClassic(const Renderer::Texture& sourceTexture, unsigned int passes,
+                       const Values& scale, const Values& bias, float blur1EdgeDarken);
+
+    /**
+     * @brief Renders the user-visible blur textures directly with one downsampling pass each.
+     * @param sourceTexture The texture to create the blur levels from.
+     * @param levels The number of blur levels to render.
+     * @param scale The color scale applied for each blur level.
+     * @param bias The color bias applied for each blur level.
+     * @param blur1EdgeDarken The edge darkening factor of the first blur level.
+     */
+    void UpdateFast(const Renderer::Texture& sourceTexture, unsigned int levels,
+                    const Values& scale, const Values& bias, float blur1EdgeDarken);
+
+    /**
+     * @brief Draws the blur mesh and copies the result into the given blur texture.
+     * @param sourceTexture The texture bound as the pass input, used for the bandwidth estimate.
+     * @param targetTexture The blur texture receiving the pass result.
+     */
+    void DrawPass(const Renderer::Texture& sourceTexture, const Renderer::Texture& targetTexture);
+
     Renderer::Mesh m_blurMesh; //!< The blur mesh (a simple quad).
 
     std::weak_ptr<Renderer::Shader> m_blur1Shader; //!< The shader used on the first blur pass.
     std::weak_ptr<Renderer::Shader> m_blur2Shader; //!< The shader used for subsequent blur passes after the initial pass.
+    std::weak_ptr<Renderer::Shader> m_fastShader;  //!< The single-pass downsampling shader used in fast mode.
 
     int m_sourceTextureWidth{};  //!< Width of the source texture used to create the blur textures.
     int m_sourceTextureHeight{}; //!< Height of the source texture used to create the blur textures.
@@ -118,6 +188,10 @@ private:
     std::shared_ptr<Renderer::Sampler> m_blurSampler;                               //!< The blur sampler.
     std::array<std::shared_ptr<Renderer::Texture>, NumBlurTextures> m_blurTextures; //!< The blur textures for each pass.
     BlurLevel m_blurLevel{BlurLevel::None};                                         //!< Current blur level.
+    Mode m_mode{Mode::Classic};                                                     //!< The algorithm used to render the blur textures.
+    Mode m_allocatedMode{Mode::Classic};                                            //!< The mode the blur textures were allocated for.
+    size_t m_bytesRead{};                                                           //!< Estimated bytes read by the last update.
+    size_t m_bytesWritten{};                                                        //!< Estimated bytes written by the last update.
 };
 
 } // namespace MilkdropPreset
@@ -60,6 +60,21 @@ void CustomShape::Initialize(PresetFileParser& parsedFile, int index)
 }
 
 void CustomShape::CompileCodeAndRunInitExpressions()
+{
+    RunInitExpressions();
+
+    m_perFrameContext.CompilePerFrameCode(m_presetState.customShapePerFrameCode[m_index], *this);
+}
+
+void CustomShape::ResetState()
+{
+    projectm_eval_context_reset_variables(m_perFrameContext.perFrameCodeContext);
+    projectm_eval_context_free_memory(m_perFrameContext.perFrameCodeContext);
+
+    RunInitExpressions();
+}
+
+void CustomShape::RunInitExpressions()
 {
     m_perFrameContext.LoadStateVariables(m_presetState, *this, 0);
     m_perFrameContext.EvaluateInitCode(m_presetState.customShapeInitCode[m_index], *this);
@@ -68,8 +83,6 @@ void CustomShape::CompileCodeAndRunInitExpressions()
     {
         m_tValuesAfterInitCode[t] = *m_perFrameContext.t_vars[t];
     }
-
-    m_perFrameContext.CompilePerFrameCode(m_presetState.customShapePerFrameCode[m_index], *this);
 }
 
 void CustomShape::Draw()
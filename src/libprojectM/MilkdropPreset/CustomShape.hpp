@@ -39,12 +39,23 @@ public:
      */
     void CompileCodeAndRunInitExpressions();
 
+    /**
+     * @brief Clears all expression variables and memory, then runs the init expression again.
+     * Restores the state after CompileCodeAndRunInitExpressions() without recompiling the code.
+     */
+    void ResetState();
+
     /**
      * @brief Renders the shape.
      */
     void Draw();
 
 private:
+    /**
+     * @brief Runs the init expression and stores the resulting t values.
+     */
+    void RunInitExpressions();
+
     Renderer::Mesh m_outlineMesh; //!< The shape's border/outline mesh.
     Renderer::Mesh m_fillMesh; //!< The shape's color/texture mesh.
 
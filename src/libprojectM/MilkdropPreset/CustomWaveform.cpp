@@ -51,6 +51,24 @@ void CustomWaveform::Initialize(PresetFileParser& parsedFile, int index)
 }
 
 void CustomWaveform::CompileCodeAndRunInitExpressions(const PerFrameContext& presetPerFrameContext)
+{
+    RunInitExpressions(presetPerFrameContext);
+
+    m_perFrameContext.CompilePerFrameCode(m_presetState.customWavePerFrameCode[m_index], *this);
+    m_perPointContext.CompilePerPointCode(m_presetState.customWavePerPointCode[m_index], *this);
+}
+
+void CustomWaveform::ResetState(const PerFrameContext& presetPerFrameContext)
+{
+    projectm_eval_context_reset_variables(m_perFrameContext.perFrameCodeContext);
+    projectm_eval_context_free_memory(m_perFrameContext.perFrameCodeContext);
+    projectm_eval_context_reset_variables(m_perPointContext.perPointCodeContext);
+    projectm_eval_context_free_memory(m_perPointContext.perPointCodeContext);
+
+    RunInitExpressions(presetPerFrameContext);
+}
+
+void CustomWaveform::RunInitExpressions(const PerFrameContext& presetPerFrameContext)
 {
     m_perFrameContext.LoadStateVariables(m_presetState, presetPerFrameContext, *this);
     m_perFrameContext.EvaluateInitCode(m_presetState.customWaveInitCode[m_index], *this);
@@ -59,9 +77,6 @@ void CustomWaveform::CompileCodeAndRunInitExpressions(const PerFrameContext& pre
     {
         m_tValuesAfterInitCode[t] = *m_perFrameContext.t_vars[t];
     }
-
-    m_perFrameContext.CompilePerFrameCode(m_presetState.customWavePerFrameCode[m_index], *this);
-    m_perPointContext.CompilePerPointCode(m_presetState.customWavePerPointCode[m_index], *this);
 }
 
 void CustomWaveform::Draw(const PerFrameContext& presetPerFrameContext)
@@ -38,6 +38,13 @@ public:
      */
     void CompileCodeAndRunInitExpressions(const PerFrameContext& presetPerFrameContext);
 
+    /**
+     * @brief Clears all expression variables and memory, then runs the init expression again.
+     * Restores the state after CompileCodeAndRunInitExpressions() without recompiling the code.
+     * @param presetPerFrameContext The per-frame context to retrieve the init Q vars from.
+     */
+    void ResetState(const PerFrameContext& presetPerFrameContext);
+
     /**
      * @brief Renders the waveform.
      * @param presetPerFrameContext The per-frame context to retrieve the init Q vars from.
@@ -45,6 +52,12 @@ public:
     void Draw(const PerFrameContext& presetPerFrameContext);
 
 private:
+    /**
+     * @brief Runs the init expression and stores the resulting t values.
+     * @param presetPerFrameContext The per-frame context to retrieve the init Q vars from.
+     */
+    void RunInitExpressions(const PerFrameContext& presetPerFrameContext);
+
     /**
      * @brief Initializes the per-frame context with the preset per-frame state.
      * @param presetPerFrameContext The preset per-frame context to pull q vars from.
@@ -1,4 +1,24 @@
 #include <projectm-eval.h>
 
-void projectm_eval_memory_host_lock_mutex() {}
-void projectm_eval_memory_host_unlock_mutex() {}
+#include <mutex>
+
+namespace {
+
+/**
+ * Guards the projectm-eval memory buffer allocations. Presets of different projectM instances may
+ * run their code on different threads at the same time. Compiling code doesn't need a lock, the
+ * compiler only uses state stored in the context it compiles for.
+ */
+std::mutex evalMemoryMutex;
+
+} // namespace
+
+void projectm_eval_memory_host_lock_mutex()
+{
+    evalMemoryMutex.lock();
+}
+
+void projectm_eval_memory_host_unlock_mutex()
+{
+    evalMemoryMutex.unlock();
+}
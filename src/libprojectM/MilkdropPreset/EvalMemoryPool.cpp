@@ -0,0 +1,76 @@
+#include "EvalMemoryPool.hpp"
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+auto EvalMemoryPool::Instance() -> EvalMemoryPool&
+{
+    static EvalMemoryPool instance;
+    return instance;
+}
+
+EvalMemoryPool::~EvalMemoryPool()
+{
+    Clear();
+}
+
+auto EvalMemoryPool::Acquire() -> projectm_eval_mem_buffer
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_buffers.empty())
+        {
+            // Prefer the most recently released buffer, its memory is most likely still cached.
+            auto* buffer = m_buffers.back();
+            m_buffers.pop_back();
+            return buffer;
+        }
+    }
+
+    return projectm_eval_memory_buffer_create();
+}
+
+void EvalMemoryPool::Release(projectm_eval_mem_buffer buffer)
+{
+    if (buffer == nullptr)
+    {
+        return;
+    }
+
+    // The buffer isn't shared with any other context anymore, so it can be cleared without holding the pool lock.
+    projectm_eval_memory_buffer_clear(buffer);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_buffers.size() < MaxPooledBuffers)
+        {
+            m_buffers.push_back(buffer);
+            return;
+        }
+    }
+
+    projectm_eval_memory_buffer_destroy(buffer);
+}
+
+void EvalMemoryPool::Clear()
+{
+    std::vector<projectm_eval_mem_buffer> buffers;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        buffers.swap(m_buffers);
+    }
+
+    for (auto* buffer : buffers)
+    {
+        projectm_eval_memory_buffer_destroy(buffer);
+    }
+}
+
+auto EvalMemoryPool::PooledBuffers() const -> uint32_t
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint32_t>(m_buffers.size());
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
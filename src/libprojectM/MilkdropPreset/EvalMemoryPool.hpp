@@ -0,0 +1,74 @@
+/**
+ * @file EvalMemoryPool.hpp
+ * @brief Recycles projectm-eval global memory buffers (gmegabuf) between presets.
+ */
+#pragma once
+
+#include <projectm-eval.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief A process-wide pool of projectm-eval memory buffers.
+ *
+ * Presets take their gmegabuf buffer from the pool and return it when they are unloaded. Returned
+ * buffers are cleared with projectm_eval_memory_buffer_clear() and handed to the next preset, so
+ * switching presets doesn't destroy and create a buffer every time. The pool only uses the public
+ * projectm-eval API and never accesses the contents of a buffer, so the memory layout stays private
+ * to the expression library.
+ *
+ * The pool keeps at most MaxPooledBuffers buffers. Buffers exceeding this limit are destroyed when
+ * released.
+ *
+ * All methods are thread-safe.
+ */
+class EvalMemoryPool
+{
+public:
+    static constexpr size_t MaxPooledBuffers = 4; //!< Max number of buffers kept for reuse.
+
+    /**
+     * @brief Returns the process-wide pool instance.
+     */
+    static auto Instance() -> EvalMemoryPool&;
+
+    /**
+     * @brief Returns an empty memory buffer, reusing a released one if available.
+     * @return A memory buffer with all values set to zero.
+     */
+    auto Acquire() -> projectm_eval_mem_buffer;
+
+    /**
+     * @brief Clears a buffer and returns it to the pool.
+     * The buffer must not be used by any expression context afterwards.
+     * @param buffer The buffer to release. Null pointers are ignored.
+     */
+    void Release(projectm_eval_mem_buffer buffer);
+
+    /**
+     * @brief Destroys all pooled buffers, freeing their memory.
+     */
+    void Clear();
+
+    /**
+     * @brief Returns the number of buffers currently kept for reuse.
+     */
+    auto PooledBuffers() const -> uint32_t;
+
+private:
+    EvalMemoryPool() = default;
+
+    ~EvalMemoryPool();
+
+    mutable std::mutex m_mutex;                      //!< Guards the list of pooled buffers.
+    std::vector<projectm_eval_mem_buffer> m_buffers; //!< Released buffers, ready for reuse.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -0,0 +1,1183 @@
+#include "ExpressionOptimizer.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iomanip>
+#include <locale>
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+namespace {
+
+using Node = ExpressionOptimizer::Node;
+
+/**
+ * Thrown by the parser if the code uses a construct the optimizer doesn't support.
+ */
+struct UnsupportedCode {
+};
+
+/**
+ * Properties of a function supported by the optimizer.
+ */
+struct FunctionInfo {
+    size_t arguments{0};  //!< Number of arguments.
+    bool pure{true};      //!< False if the function has side effects or accesses memory.
+    bool foldable{false};  //!< True if calls with constant arguments can be evaluated at compile time.
+};
+
+const std::map<std::string, FunctionInfo>& Functions()
+{
+    static const std::map<std::string, FunctionInfo> functions{
+        {"abs", {1, true, true}},
+        {"above", {2, true, false}},
+        {"acos", {1, true, false}},
+        {"asin", {1, true, false}},
+        {"atan", {1, true, true}},
+        {"atan2", {2, true, true}},
+        {"band", {2, true, false}},
+        {"below", {2, true, false}},
+        {"bnot", {1, true, false}},
+        {"bor", {2, true, false}},
+        {"ceil", {1, true, true}},
+        {"cos", {1, true, true}},
+        {"equal", {2, true, false}},
+        {"exec2", {2, false, false}},
+        {"exec3", {3, false, false}},
+        {"exp", {1, true, false}},
+        {"floor", {1, true, true}},
+        {"freembuf", {1, false, false}},
+        {"gmegabuf", {1, false, false}},
+        {"if", {3, true, false}},
+        {"int", {1, true, false}},
+        {"invsqrt", {1, true, false}},
+        {"log", {1, true, false}},
+        {"log10", {1, true, false}},
+        {"loop", {2, false, false}},
+        {"max", {2, true, true}},
+        {"megabuf", {1, false, false}},
+        {"memcpy", {3, false, false}},
+        {"memset", {3, false, false}},
+        {"min", {2, true, true}},
+        {"pow", {2, true, false}},
+        {"rand", {1, false, false}},
+        {"sigmoid", {2, true, false}},
+        {"sign", {1, true, false}},
+        {"sin", {1, true, true}},
+        {"sqr", {1, true, true}},
+        {"sqrt", {1, true, false}},
+        {"tan", {1, true, true}},
+        {"while", {1, false, false}}};
+
+    return functions;
+}
+
+auto Lower(const std::string& text) -> std::string
+{
+    std::string lowerText(text);
+    std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), [](unsigned char character) {
+        return static_cast<char>(std::tolower(character));
+    });
+    return lowerText;
+}
+
+auto IsIdentifierStart(char character) -> bool
+{
+    return std::isalpha(static_cast<unsigned char>(character)) || character == '_';
+}
+
+auto IsIdentifierCharacter(char character) -> bool
+{
+    return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+}
+
+auto IsGlobalRegister(const std::string& lowerName) -> bool
+{
+    return lowerName.size() == 5 && lowerName.compare(0, 3, "reg") == 0 &&
+           std::isdigit(static_cast<unsigned char>(lowerName[3])) &&
+           std::isdigit(static_cast<unsigned char>(lowerName[4]));
+}
+
+/**
+ * @brief Formats a number so it can be parsed again without loss.
+ * @return False if the number can't be written as a plain decimal number.
+ */
+auto FormatNumber(double value, std::string& text) -> bool
+{
+    if (!std::isfinite(value))
+    {
+        return false;
+    }
+
+    for (int precision = 15; precision <= 17; precision++)
+    {
+        std::ostringstream stream;
+        stream.imbue(std::locale::classic());
+        stream << std::setprecision(precision) << value;
+        text = stream.str();
+
+        std::istringstream parseStream(text);
+        parseStream.imbue(std::locale::classic());
+        double parsedValue{};
+        parseStream >> parsedValue;
+        if (parsedValue == value)
+        {
+            break;
+        }
+    }
+
+    return text.find_first_of("eE") == std::string::npos;
+}
+
+auto MakeNode(Node::Type type, std::string name = {}) -> std::unique_ptr<Node>
+{
+    auto node = std::make_unique<Node>();
+    node->type = type;
+    node->name = std::move(name);
+    return node;
+}
+
+auto MakeNumber(double value) -> std::unique_ptr<Node>
+{
+    std::string text;
+    if (!FormatNumber(value, text))
+    {
+        return {};
+    }
+
+    auto node = MakeNode(Node::Type::Number, text);
+    node->value = value;
+    return node;
+}
+
+/**
+ * A single token of expression code.
+ */
+struct Token {
+    enum class Type
+    {
+        Number,
+        Identifier,
+        Operator,
+        End
+    };
+
+    Type type{Type::End};
+    std::string text;
+    double value{};
+};
+
+auto Tokenize(const std::string& code) -> std::vector<Token>
+{
+    static const std::vector<std::string> operators{
+        "==", "!=", "<=", ">=", "&&", "||", "+=", "-=", "*=", "/=", "%=", "^=", "&=", "|=",
+        "+", "-", "*", "/", "%", "^", "&", "|", "!", "<", ">", "=", "?", ":", "(", ")", ",", ";"};
+
+    std::vector<Token> tokens;
+    size_t position{0};
+
+    while (position < code.size())
+    {
+        char character = code[position];
+
+        if (std::isspace(static_cast<unsigned char>(character)))
+        {
+            position++;
+            continue;
+        }
+
+        if (code.compare(position, 2, "//") == 0)
+        {
+            position = code.find('\n', position);
+            if (position == std::string::npos)
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (code.compare(position, 2, "/*") == 0)
+        {
+            position = code.find("*/", position + 2);
+            if (position == std::string::npos)
+            {
+                break;
+            }
+            position += 2;
+            continue;
+        }
+
+        Token token;
+
+        if (std::isdigit(static_cast<unsigned char>(character)) ||
+            (character == '.' && position + 1 < code.size() && std::isdigit(static_cast<unsigned char>(code[position + 1]))))
+        {
+            size_t start = position;
+            while (position < code.size() && std::isdigit(static_cast<unsigned char>(code[position])))
+            {
+                position++;
+            }
+            if (position < code.size() && code[position] == '.')
+            {
+                position++;
+                while (position < code.size() && std::isdigit(static_cast<unsigned char>(code[position])))
+                {
+                    position++;
+                }
+            }
+            if (position < code.size() && (IsIdentifierCharacter(code[position]) || code[position] == '.'))
+            {
+                // Exponents, suffixes or multiple decimal points.
+                throw UnsupportedCode();
+            }
+
+            token.type = Token::Type::Number;
+            token.text = code.substr(start, position - start);
+
+            std::istringstream valueStream(token.text);
+            valueStream.imbue(std::locale::classic());
+            valueStream >> token.value;
+            tokens.push_back(token);
+            continue;
+        }
+
+        if (character == '$')
+        {
+            size_t start = ++position;
+            while (position < code.size() && IsIdentifierCharacter(code[position]))
+            {
+                position++;
+            }
+
+            auto constantName = Lower(code.substr(start, position - start));
+            double value{};
+            if (constantName == "pi")
+            {
+                value = 3.14159265358979323846;
+            }
+            else if (constantName == "e")
+            {
+                value = 2.71828182845904523536;
+            }
+            else if (constantName == "phi")
+            {
+                value = 1.61803398874989484820;
+            }
+            else
+            {
+                // Hex and character constants.
+                throw UnsupportedCode();
+            }
+
+            token.type = Token::Type::Number;
+            token.value = value;
+            FormatNumber(value, token.text);
+            tokens.push_back(token);
+            continue;
+        }
+
+        if (IsIdentifierStart(character))
+        {
+            size_t start = position;
+            while (position < code.size() && IsIdentifierCharacter(code[position]))
+            {
+                position++;
+            }
+
+            token.type = Token::Type::Identifier;
+            token.text = code.substr(start, position - start);
+            tokens.push_back(token);
+            continue;
+        }
+
+        bool foundOperator{false};
+        for (const auto& op : operators)
+        {
+            if (code.compare(position, op.size(), op) == 0)
+            {
+                token.type = Token::Type::Operator;
+                token.text = op;
+                tokens.push_back(token);
+                position += op.size();
+                foundOperator = true;
+                break;
+            }
+        }
+
+        if (!foundOperator)
+        {
+            throw UnsupportedCode();
+        }
+    }
+
+    tokens.emplace_back();
+    return tokens;
+}
+
+/**
+ * Recursive descent parser for the supported language subset.
+ */
+class Parser
+{
+public:
+    explicit Parser(std::vector<Token> tokens)
+        : m_tokens(std::move(tokens))
+    {
+    }
+
+    auto ParseProgram() -> std::unique_ptr<Node>
+    {
+        auto program = ParseSequence();
+        if (Current().type != Token::Type::End)
+        {
+            throw UnsupportedCode();
+        }
+        return program;
+    }
+
+private:
+    auto Current() const -> const Token&
+    {
+        return m_tokens[m_position];
+    }
+
+    auto IsOperator(const char* op) const -> bool
+    {
+        return Current().type == Token::Type::Operator && Current().text == op;
+    }
+
+    void Expect(const char* op)
+    {
+        if (!IsOperator(op))
+        {
+            throw UnsupportedCode();
+        }
+        m_position++;
+    }
+
+    static auto IsAtomic(const Node& node) -> bool
+    {
+        return node.parenthesized ||
+               node.type == Node::Type::Number ||
+               node.type == Node::Type::Variable ||
+               node.type == Node::Type::Call;
+    }
+
+    static auto IsComparison(const std::string& op) -> bool
+    {
+        return op == "==" || op == "!=" || op == "<" || op == ">" || op == "<=" || op == ">=";
+    }
+
+    static auto BinaryPrecedence(const std::string& op) -> int
+    {
+        if (op == "||")
+        {
+            return 1;
+        }
+        if (op == "&&")
+        {
+            return 2;
+        }
+        if (op == "|")
+        {
+            return 3;
+        }
+        if (op == "&")
+        {
+            return 4;
+        }
+        if (IsComparison(op))
+        {
+            return 5;
+        }
+        if (op == "+" || op == "-")
+        {
+            return 6;
+        }
+        if (op == "*" || op == "/" || op == "%")
+        {
+            return 7;
+        }
+        return 0;
+    }
+
+    auto ParseSequence() -> std::unique_ptr<Node>
+    {
+        auto sequence = MakeNode(Node::Type::Sequence);
+
+        while (Current().type != Token::Type::End && !IsOperator(")") && !IsOperator(","))
+        {
+            if (IsOperator(";"))
+            {
+                m_position++;
+                continue;
+            }
+
+            sequence->children.push_back(ParseAssignment());
+
+            if (!IsOperator(";"))
+            {
+                break;
+            }
+        }
+
+        return sequence;
+    }
+
+    auto ParseAssignment() -> std::unique_ptr<Node>
+    {
+        auto left = ParseTernary();
+
+        if (Current().type == Token::Type::Operator && Current().text.back() == '=' &&
+            Current().text != "==" && Current().text != "!=" && Current().text != "<=" && Current().text != ">=")
+        {
+            if (left->type != Node::Type::Variable || left->parenthesized)
+            {
+                throw UnsupportedCode();
+            }
+
+            auto assignment = MakeNode(Node::Type::Assignment, Current().text);
+            m_position++;
+            assignment->children.push_back(std::move(left));
+            assignment->children.push_back(ParseAssignment());
+            return assignment;
+        }
+
+        return left;
+    }
+
+    auto ParseTernary() -> std::unique_ptr<Node>
+    {
+        auto condition = ParseBinary(1);
+
+        if (!IsOperator("?"))
+        {
+            return condition;
+        }
+
+        m_position++;
+        auto trueExpression = ParseAssignment();
+        Expect(":");
+        auto falseExpression = ParseAssignment();
+
+        // Unparenthesized assignments or nested conditionals may be grouped differently.
+        for (const auto* branch : {trueExpression.get(), falseExpression.get()})
+        {
+            if (!branch->parenthesized && (branch->type == Node::Type::Assignment || branch->type == Node::Type::Ternary))
+            {
+                throw UnsupportedCode();
+            }
+        }
+
+        auto ternary = MakeNode(Node::Type::Ternary, "?");
+        ternary->children.push_back(std::move(condition));
+        ternary->children.push_back(std::move(trueExpression));
+        ternary->children.push_back(std::move(falseExpression));
+        return ternary;
+    }
+
+    auto ParseBinary(int minPrecedence) -> std::unique_ptr<Node>
+    {
+        auto left = ParseUnary();
+
+        while (Current().type == Token::Type::Operator)
+        {
+            auto op = Current().text;
+            auto precedence = BinaryPrecedence(op);
+            if (precedence == 0 || precedence < minPrecedence)
+            {
+                break;
+            }
+
+            m_position++;
+            auto right = ParseBinary(precedence + 1);
+
+            for (const auto* operand : {left.get(), right.get()})
+            {
+                // The precedence of these operators differs between expression language implementations.
+                if ((op == "|" || op == "&" || op == "%") && !IsAtomic(*operand))
+                {
+                    throw UnsupportedCode();
+                }
+                if (op != "&&" && op != "||" && !operand->parenthesized &&
+                    operand->type == Node::Type::Unary && operand->name == "!")
+                {
+                    throw UnsupportedCode();
+                }
+                if (IsComparison(op) && !operand->parenthesized &&
+                    operand->type == Node::Type::Binary && IsComparison(operand->name))
+                {
+                    throw UnsupportedCode();
+                }
+            }
+
+            auto binary = MakeNode(Node::Type::Binary, op);
+            binary->children.push_back(std::move(left));
+            binary->children.push_back(std::move(right));
+            left = std::move(binary);
+        }
+
+        return left;
+    }
+
+    auto ParseUnary() -> std::unique_ptr<Node>
+    {
+        if (IsOperator("-") || IsOperator("+") || IsOperator("!"))
+        {
+            auto unary = MakeNode(Node::Type::Unary, Current().text);
+            m_position++;
+            auto operand = ParseUnary();
+            if (!operand->parenthesized && operand->type == Node::Type::Binary && operand->name == "^")
+            {
+                throw UnsupportedCode();
+            }
+            unary->children.push_back(std::move(operand));
+            return unary;
+        }
+
+        return ParsePower();
+    }
+
+    auto ParsePower() -> std::unique_ptr<Node>
+    {
+        auto base = ParsePrimary();
+
+        if (!IsOperator("^"))
+        {
+            return base;
+        }
+
+        m_position++;
+        auto exponent = ParsePrimary();
+        if (IsOperator("^"))
+        {
+            throw UnsupportedCode();
+        }
+
+        auto power = MakeNode(Node::Type::Binary, "^");
+        power->children.push_back(std::move(base));
+        power->children.push_back(std::move(exponent));
+        return power;
+    }
+
+    auto ParsePrimary() -> std::unique_ptr<Node>
+    {
+        const auto& token = Current();
+
+        if (token.type == Token::Type::Number)
+        {
+            auto number = MakeNode(Node::Type::Number, token.text);
+            number->value = token.value;
+            m_position++;
+            return number;
+        }
+
+        if (token.type == Token::Type::Identifier)
+        {
+            auto name = token.text;
+            m_position++;
+
+            if (!IsOperator("("))
+            {
+                return MakeNode(Node::Type::Variable, name);
+            }
+
+            auto function = Functions().find(Lower(name));
+            if (function == Functions().end())
+            {
+                throw UnsupportedCode();
+            }
+
+            m_position++;
+            auto call = MakeNode(Node::Type::Call, function->first);
+            if (!IsOperator(")"))
+            {
+                while (true)
+                {
+                    call->children.push_back(ParseParenthesizedSequence());
+                    if (!IsOperator(","))
+                    {
+                        break;
+                    }
+                    m_position++;
+                }
+            }
+            Expect(")");
+
+            if (call->children.size() != function->second.arguments)
+            {
+                throw UnsupportedCode();
+            }
+
+            return call;
+        }
+
+        if (IsOperator("("))
+        {
+            m_position++;
+            auto expression = ParseParenthesizedSequence();
+            Expect(")");
+            expression->parenthesized = true;
+            return expression;
+        }
+
+        throw UnsupportedCode();
+    }
+
+    /**
+     * Parses a statement list inside parentheses or a function argument.
+     * Single statements are returned as-is.
+     */
+    auto ParseParenthesizedSequence() -> std::unique_ptr<Node>
+    {
+        auto sequence = ParseSequence();
+        if (sequence->children.empty())
+        {
+            throw UnsupportedCode();
+        }
+        if (sequence->children.size() == 1)
+        {
+            return std::move(sequence->children.front());
+        }
+        return sequence;
+    }
+
+    std::vector<Token> m_tokens;
+    size_t m_position{0};
+};
+
+auto Print(const Node& node, bool statement = false) -> std::string
+{
+    switch (node.type)
+    {
+        case Node::Type::Number:
+            return node.name.front() == '-' ? "(" + node.name + ")" : node.name;
+
+        case Node::Type::Variable:
+            return node.name;
+
+        case Node::Type::Unary:
+            return "(" + node.name + Print(*node.children[0]) + ")";
+
+        case Node::Type::Binary:
+            return "(" + Print(*node.children[0]) + node.name + Print(*node.children[1]) + ")";
+
+        case Node::Type::Ternary:
+            return "(" + Print(*node.children[0]) + "?" + Print(*node.children[1]) + ":" + Print(*node.children[2]) + ")";
+
+        case Node::Type::Assignment: {
+            auto assignment = node.children[0]->name + node.name + Print(*node.children[1]);
+            return statement ? assignment : "(" + assignment + ")";
+        }
+
+        case Node::Type::Call: {
+            std::string call = node.name + "(";
+            for (size_t index = 0; index < node.children.size(); index++)
+            {
+                call += (index > 0 ? "," : "") + Print(*node.children[index]);
+            }
+            return call + ")";
+        }
+
+        case Node::Type::Sequence: {
+            std::string sequence;
+            for (const auto& child : node.children)
+            {
+                sequence += Print(*child, statement && child->type == Node::Type::Assignment) + (statement ? ";\n" : ";");
+            }
+            if (!statement && !sequence.empty())
+            {
+                sequence.pop_back();
+                sequence = "(" + sequence + ")";
+            }
+            return sequence;
+        }
+    }
+
+    return {};
+}
+
+auto IsPure(const Node& node) -> bool
+{
+    if (node.type == Node::Type::Assignment)
+    {
+        return false;
+    }
+
+    if (node.type == Node::Type::Call && !Functions().at(node.name).pure)
+    {
+        return false;
+    }
+
+    return std::all_of(node.children.begin(), node.children.end(), [](const std::unique_ptr<Node>& child) {
+        return IsPure(*child);
+    });
+}
+
+/**
+ * Counts variable reads and collects all assigned variables in the tree.
+ */
+void CollectVariables(const Node& node, std::map<std::string, int>& reads, std::set<std::string>& writes)
+{
+    if (node.type == Node::Type::Variable)
+    {
+        reads[Lower(node.name)]++;
+        return;
+    }
+
+    if (node.type == Node::Type::Assignment)
+    {
+        auto target = Lower(node.children[0]->name);
+        writes.insert(target);
+        if (node.name != "=")
+        {
+            reads[target]++;
+        }
+        CollectVariables(*node.children[1], reads, writes);
+        return;
+    }
+
+    for (const auto& child : node.children)
+    {
+        CollectVariables(*child, reads, writes);
+    }
+}
+
+auto ReferencesVariable(const Node& node, const std::string& lowerName) -> bool
+{
+    if (node.type == Node::Type::Variable)
+    {
+        return Lower(node.name) == lowerName;
+    }
+
+    return std::any_of(node.children.begin(), node.children.end(), [&lowerName](const std::unique_ptr<Node>& child) {
+        return ReferencesVariable(*child, lowerName);
+    });
+}
+
+auto IsPlainAssignmentTo(const Node& node, const std::string& lowerName) -> bool
+{
+    return node.type == Node::Type::Assignment && node.name == "=" && Lower(node.children[0]->name) == lowerName;
+}
+
+auto FoldNode(const Node& node) -> std::unique_ptr<Node>
+{
+    for (const auto& child : node.children)
+    {
+        if (child->type != Node::Type::Number)
+        {
+            return {};
+        }
+    }
+
+    if (node.type == Node::Type::Unary && node.name == "-")
+    {
+        return MakeNumber(-node.children[0]->value);
+    }
+
+    if (node.type == Node::Type::Binary)
+    {
+        auto left = node.children[0]->value;
+        auto right = node.children[1]->value;
+
+        if (node.name == "+")
+        {
+            return MakeNumber(left + right);
+        }
+        if (node.name == "-")
+        {
+            return MakeNumber(left - right);
+        }
+        if (node.name == "*")
+        {
+            return MakeNumber(left * right);
+        }
+        if (node.name == "/" && right != 0.0)
+        {
+            return MakeNumber(left / right);
+        }
+        return {};
+    }
+
+    if (node.type == Node::Type::Call && Functions().at(node.name).foldable)
+    {
+        auto argument = node.children[0]->value;
+        const auto& name = node.name;
+
+        if (name == "abs")
+        {
+            return MakeNumber(std::fabs(argument));
+        }
+        if (name == "atan")
+        {
+            return MakeNumber(std::atan(argument));
+        }
+        if (name == "atan2")
+        {
+            return MakeNumber(std::atan2(argument, node.children[1]->value));
+        }
+        if (name == "ceil")
+        {
+            return MakeNumber(std::ceil(argument));
+        }
+        if (name == "cos")
+        {
+            return MakeNumber(std::cos(argument));
+        }
+        if (name == "floor")
+        {
+            return MakeNumber(std::floor(argument));
+        }
+        if (name == "max")
+        {
+            return MakeNumber(std::max(argument, node.children[1]->value));
+        }
+        if (name == "min")
+        {
+            return MakeNumber(std::min(argument, node.children[1]->value));
+        }
+        if (name == "sin")
+        {
+            return MakeNumber(std::sin(argument));
+        }
+        if (name == "sqr")
+        {
+            return MakeNumber(argument * argument);
+        }
+        if (name == "tan")
+        {
+            return MakeNumber(std::tan(argument));
+        }
+    }
+
+    return {};
+}
+
+void FoldNodeConstants(std::unique_ptr<Node>& node)
+{
+    for (auto& child : node->children)
+    {
+        FoldNodeConstants(child);
+    }
+
+    if (node->type == Node::Type::Unary && node->name == "+")
+    {
+        node = std::move(node->children[0]);
+        return;
+    }
+
+    auto folded = FoldNode(*node);
+    if (folded)
+    {
+        folded->parenthesized = node->parenthesized;
+        node = std::move(folded);
+    }
+}
+
+/**
+ * Replaces assignments to variables which aren't live by the assigned value.
+ */
+template<typename IsLive>
+auto RemoveUnreadAssignments(std::unique_ptr<Node>& node, const IsLive& isLive) -> bool
+{
+    bool changed{false};
+
+    while (node->type == Node::Type::Assignment && node->name == "=" && !isLive(Lower(node->children[0]->name)))
+    {
+        node = std::move(node->children[1]);
+        changed = true;
+    }
+
+    for (auto& child : node->children)
+    {
+        if (node->type == Node::Type::Assignment && child == node->children[0])
+        {
+            continue;
+        }
+        changed |= RemoveUnreadAssignments(child, isLive);
+    }
+
+    return changed;
+}
+
+/**
+ * Removes top-level assignments which are overwritten before the variable is read again.
+ */
+auto RemoveOverwrittenAssignments(std::vector<std::unique_ptr<Node>>& statements) -> bool
+{
+    for (size_t index = 0; index < statements.size(); index++)
+    {
+        const auto& statement = *statements[index];
+        if (statement.type != Node::Type::Assignment || statement.name != "=" || !IsPure(*statement.children[1]))
+        {
+            continue;
+        }
+
+        auto target = Lower(statement.children[0]->name);
+        for (size_t next = index + 1; next < statements.size(); next++)
+        {
+            const auto& nextStatement = *statements[next];
+            if (!ReferencesVariable(nextStatement, target))
+            {
+                continue;
+            }
+
+            if (IsPlainAssignmentTo(nextStatement, target) && !ReferencesVariable(*nextStatement.children[1], target))
+            {
+                statements.erase(statements.begin() + static_cast<std::ptrdiff_t>(index));
+                return true;
+            }
+            break;
+        }
+    }
+
+    return false;
+}
+
+auto IsInvariant(const Node& node, const std::set<std::string>& variantVariables) -> bool
+{
+    if (node.type == Node::Type::Variable)
+    {
+        return variantVariables.find(Lower(node.name)) == variantVariables.end();
+    }
+
+    return std::all_of(node.children.begin(), node.children.end(), [&variantVariables](const std::unique_ptr<Node>& child) {
+        return IsInvariant(*child, variantVariables);
+    });
+}
+
+auto HasVariable(const Node& node) -> bool
+{
+    return node.type == Node::Type::Variable ||
+           std::any_of(node.children.begin(), node.children.end(), [](const std::unique_ptr<Node>& child) {
+               return HasVariable(*child);
+           });
+}
+
+/**
+ * Replaces invariant sub-expressions by prologue variables.
+ */
+void Hoist(std::unique_ptr<Node>& node, const std::set<std::string>& variantVariables, const std::string& prefix,
+           std::map<std::string, std::string>& hoistedExpressions, std::string& prologue)
+{
+    bool worthHoisting = node->type == Node::Type::Binary ||
+                         node->type == Node::Type::Ternary ||
+                         node->type == Node::Type::Call ||
+                         (node->type == Node::Type::Unary && node->children[0]->type != Node::Type::Variable &&
+                          node->children[0]->type != Node::Type::Number);
+
+    if (worthHoisting && IsPure(*node) && HasVariable(*node) && IsInvariant(*node, variantVariables))
+    {
+        auto expression = Print(*node);
+        auto hoistedExpression = hoistedExpressions.find(expression);
+        if (hoistedExpression == hoistedExpressions.end())
+        {
+            auto variableName = prefix + std::to_string(hoistedExpressions.size());
+            hoistedExpression = hoistedExpressions.emplace(expression, variableName).first;
+            prologue += variableName + "=" + expression + ";\n";
+        }
+
+        node = MakeNode(Node::Type::Variable, hoistedExpression->second);
+        return;
+    }
+
+    for (auto& child : node->children)
+    {
+        if (node->type == Node::Type::Assignment && child == node->children[0])
+        {
+            continue;
+        }
+        Hoist(child, variantVariables, prefix, hoistedExpressions, prologue);
+    }
+}
+
+} // namespace
+
+auto ExpressionOptimizer::Parse(const std::string& code) -> bool
+{
+    m_program.reset();
+
+    try
+    {
+        Parser parser(Tokenize(code));
+        m_program = parser.ParseProgram();
+        return true;
+    }
+    catch (const UnsupportedCode&)
+    {
+        return false;
+    }
+}
+
+void ExpressionOptimizer::FoldConstants()
+{
+    if (!m_program)
+    {
+        return;
+    }
+
+    for (auto& statement : m_program->children)
+    {
+        FoldNodeConstants(statement);
+    }
+}
+
+void ExpressionOptimizer::RemoveDeadStores(const std::set<std::string>& externalVariables)
+{
+    if (!m_program)
+    {
+        return;
+    }
+
+    auto& statements = m_program->children;
+
+    bool changed{true};
+    while (changed)
+    {
+        std::map<std::string, int> reads;
+        std::set<std::string> writes;
+        CollectVariables(*m_program, reads, writes);
+
+        auto isLive = [&externalVariables, &reads](const std::string& lowerName) {
+            return externalVariables.find(lowerName) != externalVariables.end() ||
+                   IsGlobalRegister(lowerName) ||
+                   reads[lowerName] > 0;
+        };
+
+        changed = false;
+        for (auto& statement : statements)
+        {
+            changed |= RemoveUnreadAssignments(statement, isLive);
+        }
+
+        // Statements without side effects don't do anything, the program result isn't used.
+        auto endOfEffectiveStatements = std::remove_if(statements.begin(), statements.end(), [](const std::unique_ptr<Node>& statement) {
+            return IsPure(*statement);
+        });
+        changed |= endOfEffectiveStatements != statements.end();
+        statements.erase(endOfEffectiveStatements, statements.end());
+
+        changed |= RemoveOverwrittenAssignments(statements);
+    }
+}
+
+auto ExpressionOptimizer::HoistInvariants(const std::set<std::string>& variantVariables) -> std::string
+{
+    if (!m_program)
+    {
+        return {};
+    }
+
+    std::map<std::string, int> reads;
+    std::set<std::string> writes;
+    CollectVariables(*m_program, reads, writes);
+
+    std::set<std::string> allVariantVariables(variantVariables);
+    allVariantVariables.insert(writes.begin(), writes.end());
+
+    // Use a variable name prefix which doesn't collide with any existing variable.
+    std::string prefix = "_ppinv";
+    auto prefixUsed = [&prefix](const std::string& name) {
+        return name.compare(0, prefix.size(), prefix) == 0;
+    };
+    while (std::any_of(writes.begin(), writes.end(), prefixUsed) ||
+           std::any_of(reads.begin(), reads.end(), [&prefixUsed](const std::pair<const std::string, int>& read) {
+               return prefixUsed(read.first);
+           }))
+    {
+        prefix.insert(0, "_");
+    }
+
+    std::map<std::string, std::string> hoistedExpressions;
+    std::string prologue;
+    for (auto& statement : m_program->children)
+    {
+        Hoist(statement, allVariantVariables, prefix, hoistedExpressions, prologue);
+    }
+
+    return prologue;
+}
+
+auto ExpressionOptimizer::Code() const -> std::string
+{
+    if (!m_program)
+    {
+        return {};
+    }
+
+    return Print(*m_program, true);
+}
+
+auto ExpressionOptimizer::Program() const -> const Node&
+{
+    static const auto emptyProgram = MakeNode(Node::Type::Sequence);
+    return m_program ? *m_program : *emptyProgram;
+}
+
+auto ExpressionOptimizer::OptimizePerFrameCode(const std::string& code, const std::set<std::string>& externalVariables) -> std::string
+{
+    ExpressionOptimizer optimizer;
+    if (!optimizer.Parse(code))
+    {
+        return code;
+    }
+
+    optimizer.FoldConstants();
+    optimizer.RemoveDeadStores(externalVariables);
+
+    return optimizer.Code();
+}
+
+auto ExpressionOptimizer::OptimizePerPixelCode(const std::string& code, const std::set<std::string>& externalVariables,
+                                               const std::set<std::string>& variantVariables, std::string& prologue) -> std::string
+{
+    prologue.clear();
+
+    ExpressionOptimizer optimizer;
+    if (!optimizer.Parse(code))
+    {
+        return code;
+    }
+
+    optimizer.FoldConstants();
+    optimizer.RemoveDeadStores(externalVariables);
+    prologue = optimizer.HoistInvariants(variantVariables);
+
+    return optimizer.Code();
+}
+
+auto ExpressionOptimizer::ReferencedIdentifiers(const std::string& code) -> std::set<std::string>
+{
+    std::set<std::string> identifiers;
+
+    size_t position{0};
+    while (position < code.size())
+    {
+        if (!IsIdentifierCharacter(code[position]))
+        {
+            position++;
+            continue;
+        }
+
+        size_t start = position;
+        while (position < code.size() && IsIdentifierCharacter(code[position]))
+        {
+            position++;
+        }
+
+        if (IsIdentifierStart(code[start]))
+        {
+            identifiers.insert(Lower(code.substr(start, position - start)));
+        }
+    }
+
+    return identifiers;
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
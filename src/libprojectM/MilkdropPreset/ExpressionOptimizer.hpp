@@ -0,0 +1,135 @@
+/**
+ * @file ExpressionOptimizer.hpp
+ * @brief Source-level optimizations for Milkdrop per-frame and per-pixel expression code.
+ */
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Parses expression code into a syntax tree, optimizes it and prints it back as code.
+ *
+ * The expression library compiles preset code as written. This class runs a few optimizations
+ * before the code is handed to the library:
+ * - Constant folding of arithmetic and pure math functions with constant arguments.
+ * - Dead store elimination, removing assignments to variables nobody reads and assignments which
+ *   are overwritten before being read.
+ * - Hoisting of per-pixel sub-expressions which only depend on per-frame values into a prologue
+ *   which is executed once per frame instead of once per mesh vertex.
+ *
+ * Only a conservative subset of the language is supported. If the code contains anything else,
+ * e.g. unknown functions, memory brackets, hex or character constants or operator combinations
+ * where the precedence in the expression library isn't certain, Parse() returns false and the
+ * original code must be used.
+ *
+ * Variable names are compared case-insensitively, as in the expression library.
+ */
+class ExpressionOptimizer
+{
+public:
+    /**
+     * @brief A node in the syntax tree.
+     */
+    struct Node {
+        enum class Type
+        {
+            Number,     //!< A numeric constant.
+            Variable,   //!< A variable reference.
+            Unary,      //!< A unary operator, name holds the operator.
+            Binary,     //!< A binary operator, name holds the operator.
+            Ternary,    //!< The ?: operator with condition, true and false expressions.
+            Assignment, //!< An assignment, name holds the operator. First child is the target variable.
+            Call,       //!< A function call, name holds the lower-case function name.
+            Sequence    //!< A list of statements separated by semicolons.
+        };
+
+        Type type{Type::Number};                     //!< The node type.
+        double value{};                              //!< The value of a number node.
+        std::string name;                            //!< Variable name, operator, function name or original number text.
+        std::vector<std::unique_ptr<Node>> children; //!< Operands, arguments or statements.
+        bool parenthesized{false};                   //!< True if the node was enclosed in parentheses in the code.
+    };
+
+    /**
+     * @brief Parses the given code.
+     * @param code The expression code.
+     * @return True if the code was parsed, false if it uses unsupported constructs.
+     */
+    auto Parse(const std::string& code) -> bool;
+
+    /**
+     * @brief Replaces operations on constant values with the result.
+     */
+    void FoldConstants();
+
+    /**
+     * @brief Removes assignments to variables which are never read.
+     * @param externalVariables Lower-case names of variables read by the host or other code after execution.
+     *                          The global reg00-reg99 variables are always considered as external.
+     */
+    void RemoveDeadStores(const std::set<std::string>& externalVariables);
+
+    /**
+     * @brief Moves sub-expressions which have the same value in every execution into a prologue.
+     *
+     * A sub-expression is invariant if it has no side effects and only reads variables which are
+     * neither assigned in the code nor in the given set of per-execution inputs. The prologue assigns
+     * the values to new variables, which are then used in the code instead.
+     *
+     * @param variantVariables Lower-case names of variables set by the host before each execution.
+     * @return The prologue code, or an empty string if nothing was hoisted.
+     */
+    auto HoistInvariants(const std::set<std::string>& variantVariables) -> std::string;
+
+    /**
+     * @brief Returns the code of the current syntax tree.
+     * @return The code, or an empty string if the code contains no statements.
+     */
+    auto Code() const -> std::string;
+
+    /**
+     * @brief Returns the root node of the syntax tree, a sequence of all statements.
+     */
+    auto Program() const -> const Node&;
+
+    /**
+     * @brief Optimizes per-frame code.
+     * @param code The per-frame code.
+     * @param externalVariables Lower-case names of variables read by the host or other code after execution.
+     * @return The optimized code, or the original code if it couldn't be parsed.
+     */
+    static auto OptimizePerFrameCode(const std::string& code, const std::set<std::string>& externalVariables) -> std::string;
+
+    /**
+     * @brief Optimizes per-pixel code and hoists per-frame invariant expressions into a prologue.
+     * @param code The per-pixel code.
+     * @param externalVariables Lower-case names of variables read by the host after execution.
+     * @param variantVariables Lower-case names of variables set by the host for each vertex.
+     * @param prologue [out] Receives the code which needs to run once per frame before the per-pixel code.
+     * @return The optimized code, or the original code if it couldn't be parsed.
+     */
+    static auto OptimizePerPixelCode(const std::string& code, const std::set<std::string>& externalVariables,
+                                     const std::set<std::string>& variantVariables, std::string& prologue) -> std::string;
+
+    /**
+     * @brief Returns all identifiers in the given code, without parsing it.
+     *
+     * Can be used on any code, including shaders, to check which variables it might read.
+     *
+     * @param code The code to scan.
+     * @return The lower-case identifiers.
+     */
+    static auto ReferencedIdentifiers(const std::string& code) -> std::set<std::string>;
+
+private:
+    std::unique_ptr<Node> m_program; //!< The parsed program.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
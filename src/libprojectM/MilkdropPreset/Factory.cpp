@@ -1,21 +1,50 @@
 #include "Factory.hpp"
 
+#include "EvalMemoryPool.hpp"
 #include "IdlePreset.hpp"
 #include "MilkdropPreset.hpp"
+#include "MilkdropPresetExceptions.hpp"
+
+#include <Logging.hpp>
+
+#include <stdexcept>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
+Factory::Factory()
+    : m_idlePreset(std::async(std::launch::async, &IdlePresets::precompile).share())
+{
+}
+
 std::unique_ptr<::libprojectM::Preset> Factory::LoadPresetFromFile(const std::string& filename)
 {
     std::string path;
     auto protocol = PresetFactory::Protocol(filename, path);
     if (protocol == "idle")
     {
-        return IdlePresets::allocate();
+        try
+        {
+            return IdlePresets::allocate(m_idlePreset.get());
+        }
+        catch (MilkdropPresetLoadException&)
+        {
+            // Fall back to parsing the preset text again, which will report the error.
+            return IdlePresets::allocate();
+        }
     }
     else if (protocol == "" || protocol == "file")
     {
+        // Later bundles take precedence.
+        for (auto bundle = m_presetBundles.rbegin(); bundle != m_presetBundles.rend(); ++bundle)
+        {
+            PrecompiledPreset precompiledPreset;
+            if ((*bundle)->Load(path, precompiledPreset))
+            {
+                return std::make_unique<MilkdropPreset>(path, precompiledPreset);
+            }
+        }
+
         return std::make_unique<MilkdropPreset>(path);
     }
     else
@@ -30,5 +59,70 @@ std::unique_ptr<Preset> Factory::LoadPresetFromStream(std::istream& data)
     return std::make_unique<MilkdropPreset>(data);
 }
 
+void Factory::ValidatePresetFile(const std::string& filename)
+{
+    std::string path;
+    auto protocol = PresetFactory::Protocol(filename, path);
+    if (protocol == "idle")
+    {
+        return;
+    }
+
+    if (protocol != "" && protocol != "file")
+    {
+        throw std::runtime_error("[MilkdropPresetFactory] Unsupported protocol \"" + protocol + "\".");
+    }
+
+    MilkdropPreset::Validate(path);
+}
+
+auto Factory::AddPresetBundle(const std::string& bundleFilename) -> bool
+{
+    auto bundle = std::make_unique<PresetBundle>();
+    if (!bundle->Open(bundleFilename))
+    {
+        return false;
+    }
+
+    m_presetBundles.push_back(std::move(bundle));
+
+    return true;
+}
+
+void Factory::ClearPresetBundles()
+{
+    m_presetBundles.clear();
+}
+
+void Factory::WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename)
+{
+    auto presetCount = PresetBundle::Write(presetFilenames, bundleFilename);
+
+    LOG_INFO("[MilkdropPresetFactory] Wrote " + std::to_string(presetCount) + " of " + std::to_string(presetFilenames.size()) +
+             " presets to bundle \"" + bundleFilename + "\".");
+}
+
+auto Factory::ReadPresetMetadata(const std::string& filename) -> PresetMetadata
+{
+    std::string path;
+    auto protocol = PresetFactory::Protocol(filename, path);
+    if (protocol == "idle")
+    {
+        return {};
+    }
+
+    if (protocol != "" && protocol != "file")
+    {
+        throw std::runtime_error("[MilkdropPresetFactory] Unsupported protocol \"" + protocol + "\".");
+    }
+
+    return MilkdropPreset::ReadMetadata(path);
+}
+
+auto Factory::PooledMemoryBuffers() const -> uint32_t
+{
+    return EvalMemoryPool::Instance().PooledBuffers();
+}
+
 } // namespace MilkdropPreset
 } // namespace libprojectM
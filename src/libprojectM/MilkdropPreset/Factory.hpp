@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include "PresetBundle.hpp"
+
 #include <PresetFactory.hpp>
 
+#include <future>
 #include <memory>
+#include <vector>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -23,15 +27,36 @@ class Factory : public PresetFactory
 {
 
 public:
+    /**
+     * @brief Constructor.
+     * Starts precompiling the idle preset on a worker thread, so it's ready when projectM displays it.
+     */
+    Factory();
+
     std::unique_ptr<Preset> LoadPresetFromFile(const std::string& filename) override;
 
     std::unique_ptr<Preset> LoadPresetFromStream(std::istream& data) override;
 
+    void ValidatePresetFile(const std::string& filename) override;
+
+    auto AddPresetBundle(const std::string& bundleFilename) -> bool override;
+
+    void ClearPresetBundles() override;
+
+    void WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename) override;
+
+    auto ReadPresetMetadata(const std::string& filename) -> PresetMetadata override;
+
+    auto PooledMemoryBuffers() const -> uint32_t override;
+
     std::string supportedExtensions() const override
     {
         return ".milk .prjm";
     }
 
+private:
+    std::vector<std::unique_ptr<PresetBundle>> m_presetBundles; //!< Added preset bundles, most recently added last.
+    std::shared_future<PrecompiledPreset> m_idlePreset;         //!< The idle preset, precompiled in the background.
 };
 
 } // namespace MilkdropPreset
@@ -41,7 +41,14 @@ void FinalComposite::LoadCompositeShader(const PresetState& presetState)
         {
             try
             {
-                m_compositeShader->LoadCode(presetState.compositeShader);
+                if (!presetState.precompiledCompositeShader.preprocessedCode.empty())
+                {
+                    m_compositeShader->LoadPrecompiledCode(presetState.compositeShader, presetState.precompiledCompositeShader);
+                }
+                else
+                {
+                    m_compositeShader->LoadCode(presetState.compositeShader);
+                }
                 LOG_DEBUG("[FinalComposite] Successfully loaded composite shader code.");
             }
             catch (Renderer::ShaderException& ex)
@@ -92,6 +99,10 @@ void FinalComposite::CompileCompositeShader(PresetState& presetState)
             m_compositeShader->LoadTexturesAndCompile(presetState);
         }
     }
+    else if (m_videoEcho)
+    {
+        m_videoEcho->CompileShader();
+    }
 }
 
 void FinalComposite::Draw(const PresetState& presetState, const PerFrameContext& perFrameContext)
@@ -110,9 +121,8 @@ void FinalComposite::Draw(const PresetState& presetState, const PerFrameContext&
     }
     else
     {
-        // Apply old-school filters
-        m_videoEcho->Draw();
-        if (m_filters)
+        // Apply old-school filters, in a single pass if the video echo shader supports it.
+        if (!m_videoEcho->Draw() && m_filters)
         {
             m_filters->Draw();
         }
@@ -126,6 +136,16 @@ auto FinalComposite::HasCompositeShader() const -> bool
     return m_compositeShader != nullptr;
 }
 
+auto FinalComposite::RequiredBlurLevel() const -> BlurTexture::BlurLevel
+{
+    if (!m_compositeShader)
+    {
+        return BlurTexture::BlurLevel::None;
+    }
+
+    return m_compositeShader->RequiredBlurLevel();
+}
+
 void FinalComposite::InitializeMesh(const PresetState& presetState)
 {
     if (m_viewportWidth == presetState.renderContext.viewportSizeX &&
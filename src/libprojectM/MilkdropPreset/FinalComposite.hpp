@@ -45,6 +45,12 @@ public:
      */
     auto HasCompositeShader() const -> bool;
 
+    /**
+     * @brief Returns the highest blur level sampled by the composite shader.
+     * @return The required blur level, or BlurLevel::None if no composite shader is used.
+     */
+    auto RequiredBlurLevel() const -> BlurTexture::BlurLevel;
+
 private:
     /**
      * Composite mesh vertex with all required attributes.
@@ -95,7 +101,7 @@ private:
 
     std::unique_ptr<MilkdropShader> m_compositeShader; //!< The composite shader. Either preset-defined or empty.
     std::unique_ptr<VideoEcho> m_videoEcho;            //!< Video echo effect. Used if no composite shader is loaded and video echo is enabled.
-    std::unique_ptr<Filters> m_filters;                //!< Color post-processing filters. Used if no composite shader is loaded.
+    std::unique_ptr<Filters> m_filters;                //!< Color post-processing filters. Used if no composite shader is loaded and the video echo can't draw them.
 };
 
 } // namespace MilkdropPreset
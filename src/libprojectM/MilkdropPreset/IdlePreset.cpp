@@ -1,6 +1,7 @@
 #include "IdlePreset.hpp"
 
 #include "MilkdropPreset.hpp"
+#include "PresetBundle.hpp"
 
 #include <sstream>
 #include <string>
@@ -199,5 +200,17 @@ IdlePresets::allocate()
     return std::unique_ptr<Preset>(new MilkdropPreset(in));
 }
 
+std::unique_ptr<::libprojectM::Preset>
+IdlePresets::allocate(const PrecompiledPreset& precompiledPreset)
+{
+    return std::unique_ptr<Preset>(new MilkdropPreset("", precompiledPreset));
+}
+
+auto IdlePresets::precompile() -> PrecompiledPreset
+{
+    std::istringstream in(presetText());
+    return PresetBundle::Precompile(in);
+}
+
 } // namespace MilkdropPreset
 } // namespace libprojectM
@@ -9,6 +9,8 @@ class Preset;
 
 namespace MilkdropPreset {
 
+struct PrecompiledPreset;
+
 /**
  * A preset that does not depend on the file system to be loaded. This allows projectM to render
  * something (ie. self indulgent project advertising) even when no valid preset directory is found.
@@ -26,6 +28,21 @@ public:
      */
     static std::unique_ptr<::libprojectM::Preset> allocate();
 
+    /**
+     * @brief Allocate a new idle preset instance from previously precompiled data.
+     * Skips parsing the preset text and translating the shaders.
+     * @param precompiledPreset The result of a previous call to precompile().
+     * @return A newly allocated auto pointer of an idle preset instance
+     */
+    static std::unique_ptr<::libprojectM::Preset> allocate(const PrecompiledPreset& precompiledPreset);
+
+    /**
+     * @brief Parses the idle preset and precompiles its code and shaders.
+     * Doesn't use any OpenGL functions, so it can be used on a worker thread.
+     * @return The precompiled idle preset.
+     */
+    static auto precompile() -> PrecompiledPreset;
+
 private:
     static std::string presetText();
 };
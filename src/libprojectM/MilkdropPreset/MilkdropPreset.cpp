@@ -21,15 +21,65 @@
 
 #include "MilkdropPreset.hpp"
 
+#include "EvalMemoryPool.hpp"
+#include "ExpressionOptimizer.hpp"
 #include "Factory.hpp"
 #include "MilkdropPresetExceptions.hpp"
+#include "MilkdropShader.hpp"
+#include "PresetBundle.hpp"
 #include "PresetFileParser.hpp"
+#include "Utils.hpp"
 
 #include <Logging.hpp>
 
+#include <projectm-eval.h>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <utility>
+#include <vector>
+
 namespace libprojectM {
 namespace MilkdropPreset {
 
+namespace {
+
+/**
+ * Texture format of a render target.
+ */
+struct RenderTargetFormat {
+    GLint internalFormat; //!< OpenGL internal format.
+    GLenum format;        //!< Texture format.
+    GLenum type;          //!< Data type.
+    size_t bytesPerPixel; //!< Size of a single pixel.
+};
+
+auto MainImageFormat(Renderer::RenderTargetQuality quality) -> RenderTargetFormat
+{
+    if (quality == Renderer::RenderTargetQuality::High)
+    {
+        return {GL_RGB10_A2, GL_RGBA, GL_UNSIGNED_INT_2_10_10_10_REV, 4};
+    }
+
+    return {GL_RGBA, GL_RGBA, GL_UNSIGNED_BYTE, 4};
+}
+
+auto MotionVectorUVMapFormat(Renderer::RenderTargetQuality quality) -> RenderTargetFormat
+{
+    if (quality == Renderer::RenderTargetQuality::Low)
+    {
+        // Clamps the coordinates to 0..1 with a precision of 1/255 of the viewport size,
+        // which is good enough for the motion vector lines.
+        return {GL_RG8, GL_RG, GL_UNSIGNED_BYTE, 2};
+    }
+
+    return {GL_RG16F, GL_RG, GL_FLOAT, 4};
+}
+
+} // namespace
+
 MilkdropPreset::MilkdropPreset(const std::string& absoluteFilePath)
     : m_absoluteFilePath(absoluteFilePath)
     , m_perFrameContext(m_state.globalMemory, &m_state.globalRegisters)
@@ -53,9 +103,196 @@ MilkdropPreset::MilkdropPreset(std::istream& presetData)
     Load(presetData);
 }
 
+MilkdropPreset::MilkdropPreset(const std::string& absoluteFilePath, const PrecompiledPreset& precompiledPreset)
+    : m_absoluteFilePath(absoluteFilePath)
+    , m_perFrameContext(m_state.globalMemory, &m_state.globalRegisters)
+    , m_perPixelContext(m_state.globalMemory, &m_state.globalRegisters)
+    , m_motionVectors(m_state)
+    , m_waveform(m_state)
+    , m_darkenCenter(m_state)
+    , m_border(m_state)
+{
+    Load(absoluteFilePath, precompiledPreset);
+}
+
+void MilkdropPreset::Validate(const std::string& absoluteFilePath)
+{
+    PresetFileParser parser;
+
+    if (!parser.Read(absoluteFilePath))
+    {
+        throw MilkdropPresetLoadException("[MilkdropPreset] Could not parse preset file \"" + absoluteFilePath + "\".");
+    }
+
+    // Validation may run on the worker threads of several playlists while presets and sprites are
+    // compiled on the render threads. The projectm-eval compiler is reentrant, as all compiler state
+    // is kept in the context, so no lock is needed. The context gets its own memory and registers
+    // instead of the built-in global ones, so nothing is shared with running presets or sprites.
+
+    struct PooledMemory {
+        ~PooledMemory()
+        {
+            EvalMemoryPool::Instance().Release(buffer);
+        }
+
+        projectm_eval_mem_buffer buffer{EvalMemoryPool::Instance().Acquire()};
+    } memory;
+    PRJM_EVAL_F registers[100]{};
+    std::unique_ptr<projectm_eval_context, decltype(&projectm_eval_context_destroy)> context(
+        projectm_eval_context_create(memory.buffer, &registers), &projectm_eval_context_destroy);
+
+    for (const auto& codeBlock : PresetFileParser::CodeBlocks())
+    {
+        if (codeBlock.isShader)
+        {
+            continue;
+        }
+
+        auto code = parser.GetCode(codeBlock.keyPrefix);
+        if (code.empty())
+        {
+            continue;
+        }
+
+        auto* compiledCode = projectm_eval_code_compile(context.get(), code.c_str());
+        if (compiledCode == nullptr)
+        {
+            std::string error = "[MilkdropPreset] Could not compile " + codeBlock.name + " code";
+            int line{};
+            int col{};
+            auto* errmsg = projectm_eval_get_error(context.get(), &line, &col);
+            if (errmsg)
+            {
+                error += ": ";
+                error += errmsg;
+                error += "(L" + std::to_string(line) + " C" + std::to_string(col) + ")";
+            }
+            throw MilkdropCompileException(error);
+        }
+
+        projectm_eval_code_destroy(compiledCode);
+    }
+
+    int warpShaderVersion{2};
+    int compositeShaderVersion{2};
+    parser.GetShaderVersions(parser.GetInt("MILKDROP_PRESET_VERSION", 100), warpShaderVersion, compositeShaderVersion);
+
+    const auto warpShader = parser.GetCode("warp_");
+    if (warpShaderVersion > 0 && !warpShader.empty())
+    {
+        MilkdropShader::Validate(MilkdropShader::ShaderType::WarpShader, warpShader);
+    }
+
+    const auto compositeShader = parser.GetCode("comp_");
+    if (compositeShaderVersion > 0 && !compositeShader.empty())
+    {
+        MilkdropShader::Validate(MilkdropShader::ShaderType::CompositeShader, compositeShader);
+    }
+}
+
+auto MilkdropPreset::ReadMetadata(const std::string& absoluteFilePath) -> PresetMetadata
+{
+    using Clock = std::chrono::steady_clock;
+
+    PresetMetadata metadata;
+    PresetFileParser parser;
+
+    auto parseStart = Clock::now();
+    if (!parser.Read(absoluteFilePath))
+    {
+        throw MilkdropPresetLoadException("[MilkdropPreset] Could not parse preset file \"" + absoluteFilePath + "\".");
+    }
+    metadata.parseTime = std::chrono::duration<double>(Clock::now() - parseStart).count();
+
+    metadata.hasPerPixelCode = !parser.GetCode("per_pixel_").empty();
+
+    // Defaults and keys as in CustomWaveform::Initialize() and CustomShape::Initialize().
+    for (int i = 0; i < CustomWaveformCount; i++)
+    {
+        const std::string wavePrefix = "wavecode_" + std::to_string(i) + "_";
+        if (!parser.GetBool(wavePrefix + "enabled", false))
+        {
+            continue;
+        }
+
+        int samples = std::max(0, std::min(parser.GetInt(wavePrefix + "samples", WaveformMaxPoints), WaveformMaxPoints));
+        metadata.customWaveCount++;
+        metadata.maxWaveSamples = std::max(metadata.maxWaveSamples, static_cast<uint32_t>(samples));
+    }
+
+    for (int i = 0; i < CustomShapeCount; i++)
+    {
+        const std::string shapePrefix = "shapecode_" + std::to_string(i) + "_";
+        if (!parser.GetBool(shapePrefix + "enabled", false))
+        {
+            continue;
+        }
+
+        int instances = std::max(0, parser.GetInt(shapePrefix + "num_inst", 1));
+        metadata.customShapeCount++;
+        metadata.maxShapeInstances = std::max(metadata.maxShapeInstances, static_cast<uint32_t>(instances));
+    }
+
+    int warpShaderVersion{2};
+    int compositeShaderVersion{2};
+    parser.GetShaderVersions(parser.GetInt("MILKDROP_PRESET_VERSION", 100), warpShaderVersion, compositeShaderVersion);
+
+    std::set<std::string> textures;
+    auto translateShader = [&](MilkdropShader::ShaderType type, const std::string& code) {
+        auto translateStart = Clock::now();
+        try
+        {
+            auto precompiled = MilkdropShader::Precompile(type, code);
+
+            metadata.blurLevel = std::max(metadata.blurLevel, static_cast<uint32_t>(precompiled.maxBlurLevel));
+            for (const auto& samplerName : precompiled.samplerNames)
+            {
+                // Strip the filter/wrap mode prefix, as in MilkdropShader::LoadTexturesAndCompile().
+                std::string baseName = samplerName;
+                if (samplerName.length() > 3 && samplerName.at(2) == '_')
+                {
+                    baseName = samplerName.substr(3);
+                }
+
+                std::string lowerCaseName = Utils::ToLower(baseName);
+
+                // Not loaded from a file, but rendered by the preset itself.
+                if (lowerCaseName != "main" && lowerCaseName != "blur1" && lowerCaseName != "blur2" && lowerCaseName != "blur3")
+                {
+                    textures.insert(lowerCaseName);
+                }
+            }
+        }
+        catch (Renderer::ShaderException& ex)
+        {
+            LOG_DEBUG("[MilkdropPreset] Could not translate shader of \"" + absoluteFilePath + "\": " + ex.message());
+        }
+        metadata.shaderTranslationTime += std::chrono::duration<double>(Clock::now() - translateStart).count();
+    };
+
+    const auto warpShader = parser.GetCode("warp_");
+    if (warpShaderVersion > 0 && !warpShader.empty())
+    {
+        metadata.hasWarpShader = true;
+        translateShader(MilkdropShader::ShaderType::WarpShader, warpShader);
+    }
+
+    const auto compositeShader = parser.GetCode("comp_");
+    if (compositeShaderVersion > 0 && !compositeShader.empty())
+    {
+        metadata.hasCompositeShader = true;
+        translateShader(MilkdropShader::ShaderType::CompositeShader, compositeShader);
+    }
+
+    metadata.textures.assign(textures.begin(), textures.end());
+
+    return metadata;
+}
+
 void MilkdropPreset::Initialize(const Renderer::RenderContext& renderContext)
 {
     assert(renderContext.textureManager);
+    assert(renderContext.randomGenerator);
     m_state.renderContext = renderContext;
     m_state.blurTexture.Initialize(renderContext);
     m_state.LoadShaders();
@@ -63,7 +300,8 @@ void MilkdropPreset::Initialize(const Renderer::RenderContext& renderContext)
     // Initialize variables and code now we have a proper render state.
     CompileCodeAndRunInitExpressions();
 
-    // Update framebuffer and texture sizes if needed
+    // Update framebuffer and texture formats and sizes if needed
+    SetRenderTargetQuality(renderContext.renderTargetQuality);
     m_framebuffer.SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
     m_motionVectorUVMap->SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
     if (m_state.mainTexture.expired())
@@ -80,7 +318,8 @@ void MilkdropPreset::RenderFrame(const libprojectM::Audio::FrameAudioData& audio
     m_state.audioData = audioData;
     m_state.renderContext = renderContext;
 
-    // Update framebuffer and u/v texture size if needed
+    // Update framebuffer and u/v texture formats and size if needed
+    SetRenderTargetQuality(renderContext.renderTargetQuality);
     if (m_framebuffer.SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY))
     {
         m_motionVectorUVMap->SetSize(renderContext.viewportSizeX, renderContext.viewportSizeY);
@@ -118,11 +357,14 @@ void MilkdropPreset::RenderFrame(const libprojectM::Audio::FrameAudioData& audio
     // Remove the u/v texture from the framebuffer.
     m_framebuffer.RemoveColorAttachment(m_currentFrameBuffer, 1);
 
-    // Update blur textures
+    // Update blur textures, but only the levels read by the composite shader in this frame
+    // or the warp shader in the next one. Skipped entirely if neither samples any blur texture.
     {
         const auto warpedImage = m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0);
         assert(warpedImage.get());
-        m_state.blurTexture.Update(*warpedImage, m_perFrameContext);
+        m_state.blurTexture.SetMode(renderContext.fastBlur ? BlurTexture::Mode::Fast : BlurTexture::Mode::Classic);
+        m_state.blurTexture.Update(*warpedImage, m_perFrameContext,
+                                   std::max(m_perPixelMesh.RequiredBlurLevel(), m_finalComposite.RequiredBlurLevel()));
     }
 
     // Draw audio-data-related stuff
@@ -159,6 +401,19 @@ void MilkdropPreset::RenderFrame(const libprojectM::Audio::FrameAudioData& audio
         m_flipTexture.Draw(*renderContext.shaderCache, m_framebuffer.GetColorAttachmentTexture(m_previousFrameBuffer, 0), m_framebuffer, m_previousFrameBuffer, true, false);
     }
 
+    // Estimate the render target traffic: both flips, the warp mesh writing the main image and
+    // the u/v map, the final composite and an optional third flip for the old-school filters.
+    {
+        auto const pixels = static_cast<size_t>(m_framebuffer.Width()) * static_cast<size_t>(m_framebuffer.Height());
+        auto const mainImageBytes = pixels * MainImageFormat(m_renderTargetQuality).bytesPerPixel;
+        auto const uvMapBytes = pixels * MotionVectorUVMapFormat(m_renderTargetQuality).bytesPerPixel;
+        size_t const fullScreenPasses = m_finalComposite.HasCompositeShader() ? 4 : 5;
+
+        m_state.blurTexture.LastUpdateBandwidth(m_lastFrameBandwidth.bytesRead, m_lastFrameBandwidth.bytesWritten);
+        m_lastFrameBandwidth.bytesRead += fullScreenPasses * mainImageBytes;
+        m_lastFrameBandwidth.bytesWritten += fullScreenPasses * mainImageBytes + uvMapBytes;
+    }
+
     // Swap framebuffer IDs for the next frame.
     std::swap(m_currentFrameBuffer, m_previousFrameBuffer);
 
@@ -187,6 +442,64 @@ void MilkdropPreset::BindFramebuffer()
     }
 }
 
+auto MilkdropPreset::TextureMemory() const -> size_t
+{
+    // Two main images, the flip texture and the motion vector u/v map, all with the viewport size.
+    auto pixels = static_cast<size_t>(m_framebuffer.Width()) * static_cast<size_t>(m_framebuffer.Height());
+    return pixels * (MainImageFormat(m_renderTargetQuality).bytesPerPixel * 3 + MotionVectorUVMapFormat(m_renderTargetQuality).bytesPerPixel) +
+           m_state.blurTexture.TextureMemory();
+}
+
+auto MilkdropPreset::LastFrameBandwidth() const -> FrameBandwidth
+{
+    return m_lastFrameBandwidth;
+}
+
+auto MilkdropPreset::Reset(const Renderer::RenderContext& renderContext) -> bool
+{
+    m_state.renderContext = renderContext;
+    m_state.audioData = {};
+
+    // Clear all expression state shared between the code contexts.
+    projectm_eval_memory_buffer_clear(m_state.globalMemory);
+    std::fill(std::begin(m_state.globalRegisters), std::end(m_state.globalRegisters), 0.0);
+
+    projectm_eval_context_reset_variables(m_perFrameContext.perFrameCodeContext);
+    projectm_eval_context_free_memory(m_perFrameContext.perFrameCodeContext);
+    projectm_eval_context_reset_variables(m_perPixelContext.perPixelCodeContext);
+    projectm_eval_context_free_memory(m_perPixelContext.perPixelCodeContext);
+
+    // Run the init code again, in the same order as on the first load.
+    m_perFrameContext.LoadStateVariables(m_state);
+    m_perFrameContext.EvaluateInitCode(m_state);
+
+    for (auto& wave : m_customWaveforms)
+    {
+        wave->ResetState(m_perFrameContext);
+    }
+
+    for (auto& shape : m_customShapes)
+    {
+        shape->ResetState();
+    }
+
+    // Start with a black image, same as a newly created preset.
+    if (m_framebuffer.Width() > 0 && m_framebuffer.Height() > 0)
+    {
+        glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+        for (int framebufferIndex = 0; framebufferIndex < 2; framebufferIndex++)
+        {
+            m_framebuffer.Bind(framebufferIndex);
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        Renderer::Framebuffer::Unbind();
+    }
+
+    m_isFirstFrame = true;
+
+    return true;
+}
+
 void MilkdropPreset::PerFrameUpdate()
 {
     m_perFrameContext.LoadStateVariables(m_state);
@@ -235,14 +548,36 @@ void MilkdropPreset::Load(std::istream& stream)
     InitializePreset(parser);
 }
 
+void MilkdropPreset::Load(const std::string& pathname, const PrecompiledPreset& precompiledPreset)
+{
+    LOG_DEBUG("[MilkdropPreset] Loading precompiled preset \"" + pathname + "\".")
+
+    SetFilename(ParseFilename(pathname));
+
+    PresetFileParser parser;
+
+    if (!parser.ReadData(precompiledPreset.values) && precompiledPreset.code.empty())
+    {
+        const std::string error = "[MilkdropPreset] Could not parse precompiled preset \"" + pathname + "\".";
+        LOG_ERROR(error)
+        throw MilkdropPresetLoadException(error);
+    }
+
+    for (const auto& code : precompiledPreset.code)
+    {
+        parser.SetCode(code.first, code.second);
+    }
+
+    m_state.precompiledWarpShader = precompiledPreset.warpShader;
+    m_state.precompiledCompositeShader = precompiledPreset.compositeShader;
+
+    InitializePreset(parser);
+}
+
 void MilkdropPreset::InitializePreset(PresetFileParser& parsedFile)
 {
     // Create the offscreen rendering surfaces.
-    m_motionVectorUVMap = std::make_shared<Renderer::TextureAttachment>(GL_RG16F, GL_RG, GL_FLOAT, 0, 0);
-    m_framebuffer.CreateColorAttachment(0, 0); // Main image 1
-    m_framebuffer.CreateColorAttachment(1, 0); // Main image 2
-
-    Renderer::Framebuffer::Unbind();
+    CreateRenderTargets();
 
     // Load global init variables into the state
     m_state.Initialize(parsedFile);
@@ -271,12 +606,82 @@ void MilkdropPreset::InitializePreset(PresetFileParser& parsedFile)
     LoadShaderCode();
 }
 
+void MilkdropPreset::SetRenderTargetQuality(Renderer::RenderTargetQuality quality)
+{
+    if (quality == m_renderTargetQuality)
+    {
+        return;
+    }
+
+    m_renderTargetQuality = quality;
+    CreateRenderTargets();
+    m_isFirstFrame = true;
+}
+
+void MilkdropPreset::CreateRenderTargets()
+{
+    auto const mainImageFormat = MainImageFormat(m_renderTargetQuality);
+    auto const uvMapFormat = MotionVectorUVMapFormat(m_renderTargetQuality);
+
+    m_motionVectorUVMap = std::make_shared<Renderer::TextureAttachment>(uvMapFormat.internalFormat, uvMapFormat.format, uvMapFormat.type,
+                                                                        m_framebuffer.Width(), m_framebuffer.Height());
+
+    for (int framebufferIndex = 0; framebufferIndex < 2; framebufferIndex++)
+    {
+        m_framebuffer.RemoveColorAttachment(framebufferIndex, 0);
+        m_framebuffer.CreateColorAttachment(framebufferIndex, 0, mainImageFormat.internalFormat, mainImageFormat.format, mainImageFormat.type);
+    }
+
+    // The flip texture swaps its attachment with the main images, so it must use the same format.
+    m_flipTexture.SetFormat(mainImageFormat.internalFormat, mainImageFormat.format, mainImageFormat.type);
+
+    Renderer::Framebuffer::Unbind();
+}
+
+auto MilkdropPreset::DownstreamVariables() const -> std::set<std::string>
+{
+    std::set<std::string> variables;
+    auto addIdentifiers = [&variables](const std::string& code) {
+        auto identifiers = ExpressionOptimizer::ReferencedIdentifiers(code);
+        variables.insert(identifiers.begin(), identifiers.end());
+    };
+
+    addIdentifiers(m_state.perPixelCode);
+    for (int i = 0; i < CustomWaveformCount; i++)
+    {
+        addIdentifiers(m_state.customWaveInitCode[i]);
+        addIdentifiers(m_state.customWavePerFrameCode[i]);
+        addIdentifiers(m_state.customWavePerPointCode[i]);
+    }
+    for (int i = 0; i < CustomShapeCount; i++)
+    {
+        addIdentifiers(m_state.customShapeInitCode[i]);
+        addIdentifiers(m_state.customShapePerFrameCode[i]);
+    }
+    addIdentifiers(m_state.warpShader);
+    addIdentifiers(m_state.compositeShader);
+
+    // Shaders can also read the Q variables through the packed _qa to _qh uniforms.
+    for (int uniform = 0; uniform < QVarCount / 4; uniform++)
+    {
+        if (variables.find("_q" + std::string(1, static_cast<char>('a' + uniform))) != variables.end())
+        {
+            for (int component = 1; component <= 4; component++)
+            {
+                variables.insert("q" + std::to_string(uniform * 4 + component));
+            }
+        }
+    }
+
+    return variables;
+}
+
 void MilkdropPreset::CompileCodeAndRunInitExpressions()
 {
     // Per-frame init and code
     m_perFrameContext.LoadStateVariables(m_state);
     m_perFrameContext.EvaluateInitCode(m_state);
-    m_perFrameContext.CompilePerFrameCode(m_state.perFrameCode);
+    m_perFrameContext.CompilePerFrameCode(m_state.perFrameCode, DownstreamVariables());
 
     // Per-vertex code
     m_perPixelContext.CompilePerPixelCode(m_state.perPixelCode);
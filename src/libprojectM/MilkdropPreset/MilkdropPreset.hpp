@@ -33,12 +33,14 @@
 #include "PerPixelContext.hpp"
 #include "PerPixelMesh.hpp"
 #include "Preset.hpp"
+#include "PresetFactory.hpp"
 #include "Waveform.hpp"
 
 #include <Renderer/CopyTexture.hpp>
 #include <Renderer/Framebuffer.hpp>
 
 #include <memory>
+#include <set>
 #include <string>
 
 namespace libprojectM {
@@ -47,6 +49,7 @@ class PresetFileParser;
 namespace MilkdropPreset {
 
 class Factory;
+struct PrecompiledPreset;
 
 class MilkdropPreset : public ::libprojectM::Preset
 {
@@ -66,6 +69,41 @@ public:
      */
     MilkdropPreset(std::istream& presetData);
 
+    /**
+     * @brief Loads a MilkdropPreset from precompiled bundle data.
+     * @param absoluteFilePath The absolute file path of the preset source file.
+     * @param precompiledPreset The precompiled preset data loaded from a bundle.
+     */
+    MilkdropPreset(const std::string& absoluteFilePath, const PrecompiledPreset& precompiledPreset);
+
+    /**
+     * @brief Checks a preset file for errors without creating a preset instance.
+     *
+     * Parses the file, compiles all expression code and translates the preset shaders into GLSL.
+     * None of these steps require an OpenGL context, so this function can be called from any
+     * thread. Shader translation errors are reported as well, even though a preset with a broken
+     * shader would still load with a fallback shader.
+     *
+     * @param absoluteFilePath The absolute path of the preset file to check.
+     * @throws MilkdropPresetLoadException Thrown if the file can't be read or parsed.
+     * @throws MilkdropCompileException Thrown if any expression code fails to compile.
+     * @throws Renderer::ShaderException Thrown if a preset shader can't be translated.
+     */
+    static void Validate(const std::string& absoluteFilePath);
+
+    /**
+     * @brief Reads the properties of a preset file without creating a preset instance.
+     *
+     * Parses the file and translates the preset shaders into GLSL to find the referenced textures
+     * and blur levels, measuring the time spent in both steps. Doesn't require an OpenGL context.
+     * Shaders which can't be translated are still reported as present, but don't add any textures.
+     *
+     * @param absoluteFilePath The absolute path of the preset file to read.
+     * @return The preset properties.
+     * @throws MilkdropPresetLoadException Thrown if the file can't be read or parsed.
+     */
+    static auto ReadMetadata(const std::string& absoluteFilePath) -> PresetMetadata;
+
     /**
      * @brief Initializes the preset with rendering-related data.
      * @param renderContext The initial render context.
@@ -86,6 +124,12 @@ public:
 
     void BindFramebuffer() override;
 
+    auto TextureMemory() const -> size_t override;
+
+    auto LastFrameBandwidth() const -> FrameBandwidth override;
+
+    auto Reset(const Renderer::RenderContext& renderContext) -> bool override;
+
 private:
     void PerFrameUpdate();
 
@@ -93,8 +137,30 @@ private:
 
     void Load(std::istream& stream);
 
+    void Load(const std::string& pathname, const PrecompiledPreset& precompiledPreset);
+
     void InitializePreset(PresetFileParser& parsedFile);
 
+    /**
+     * @brief Switches the render targets to the formats used for the given quality setting.
+     * Recreates the textures if the quality changed, discarding the previous frame.
+     * @param quality The requested render target quality.
+     */
+    void SetRenderTargetQuality(Renderer::RenderTargetQuality quality);
+
+    /**
+     * @brief Creates the main images, the flip texture and the motion vector u/v map.
+     * Uses the formats of the current render target quality and the current framebuffer size.
+     */
+    void CreateRenderTargets();
+
+    /**
+     * @brief Returns all identifiers used in code and shaders which run after the per-frame code.
+     * Used to determine which Q variables written by the per-frame code are actually read.
+     * @return The lower-case identifiers.
+     */
+    auto DownstreamVariables() const -> std::set<std::string>;
+
     void CompileCodeAndRunInitExpressions();
 
     /**
@@ -129,6 +195,9 @@ private:
     FinalComposite m_finalComposite; //!< Final composite shader or filters.
 
     bool m_isFirstFrame{true}; //!< Controls drawing the motion vectors starting with the second frame.
+
+    Renderer::RenderTargetQuality m_renderTargetQuality{Renderer::RenderTargetQuality::Default}; //!< Quality setting the render targets were created with.
+    FrameBandwidth m_lastFrameBandwidth;                                                         //!< Estimated render target traffic of the last frame.
 };
 
 } // namespace MilkdropPreset
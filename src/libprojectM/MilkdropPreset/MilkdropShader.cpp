@@ -5,6 +5,8 @@
 
 #include <MilkdropStaticShaders.hpp>
 
+#include <Renderer/TextureSamplerDescriptor.hpp>
+
 #include <GLSLGenerator.h>
 #include <HLSLParser.h>
 #include <Logging.hpp>
@@ -21,12 +23,15 @@ namespace MilkdropPreset {
 
 using libprojectM::MilkdropPreset::MilkdropStaticShaders;
 
-static auto floatRand = []() { return static_cast<float>(rand() % 7381) / 7380.0f; };
-
 MilkdropShader::MilkdropShader(ShaderType type)
     : m_type(type)
-    , m_randValues({floatRand(), floatRand(), floatRand(), floatRand()})
 {
+}
+
+void MilkdropShader::GenerateRandomValues()
+{
+    m_randValues = {FloatRand(), FloatRand(), FloatRand(), FloatRand()};
+
     unsigned int index = 0;
     do
     {
@@ -34,15 +39,15 @@ MilkdropShader::MilkdropShader(ShaderType type)
         {
             float const m_randTranslationMult = 1;
             float const rotMult = 0.9f * powf(index / 8.0f, 3.2f);
-            m_randTranslation[index].x = (floatRand() * 2 - 1) * m_randTranslationMult;
-            m_randTranslation[index].y = (floatRand() * 2 - 1) * m_randTranslationMult;
-            m_randTranslation[index].z = (floatRand() * 2 - 1) * m_randTranslationMult;
-            m_randRotationCenters[index].x = floatRand() * 6.28f;
-            m_randRotationCenters[index].y = floatRand() * 6.28f;
-            m_randRotationCenters[index].z = floatRand() * 6.28f;
-            m_randRotationSpeeds[index].x = (floatRand() * 2 - 1) * rotMult;
-            m_randRotationSpeeds[index].y = (floatRand() * 2 - 1) * rotMult;
-            m_randRotationSpeeds[index].z = (floatRand() * 2 - 1) * rotMult;
+            m_randTranslation[index].x = (FloatRand() * 2 - 1) * m_randTranslationMult;
+            m_randTranslation[index].y = (FloatRand() * 2 - 1) * m_randTranslationMult;
+            m_randTranslation[index].z = (FloatRand() * 2 - 1) * m_randTranslationMult;
+            m_randRotationCenters[index].x = FloatRand() * 6.28f;
+            m_randRotationCenters[index].y = FloatRand() * 6.28f;
+            m_randRotationCenters[index].z = FloatRand() * 6.28f;
+            m_randRotationSpeeds[index].x = (FloatRand() * 2 - 1) * rotMult;
+            m_randRotationSpeeds[index].y = (FloatRand() * 2 - 1) * rotMult;
+            m_randRotationSpeeds[index].z = (FloatRand() * 2 - 1) * rotMult;
             index++;
         }
     } while (index < sizeof(m_randTranslation) / sizeof(m_randTranslation[0]));
@@ -54,13 +59,27 @@ void MilkdropShader::LoadCode(const std::string& presetShaderCode)
     m_preprocessedCode = m_fragmentShaderCode;
 
     GetReferencedSamplers(m_preprocessedCode);
-    PreprocessPresetShader(m_preprocessedCode);
+    PreprocessPresetShader(m_type, m_preprocessedCode);
+}
+
+void MilkdropShader::LoadPrecompiledCode(const std::string& presetShaderCode, const Precompiled& precompiled)
+{
+    m_fragmentShaderCode = presetShaderCode;
+    m_preprocessedCode = precompiled.preprocessedCode;
+    m_samplerNames = precompiled.samplerNames;
+    m_maxBlurLevelRequired = precompiled.maxBlurLevel;
+    m_precompiledDeclarationKey = precompiled.declarationKey;
+    m_precompiledGlslSource = precompiled.glslSource;
 }
 
 void MilkdropShader::LoadTexturesAndCompile(PresetState& presetState)
 {
     std::locale loc;
 
+    // Derive this shader's own generator from the instance generator, so seeded instances render reproducibly.
+    m_randomGenerator.Seed(presetState.renderContext.randomGenerator->NextSeed());
+    GenerateRandomValues();
+
     // Now request the textures and descriptors from the texture manager.
     for (const auto& name : m_samplerNames)
     {
@@ -124,7 +143,7 @@ void MilkdropShader::LoadTexturesAndCompile(PresetState& presetState)
                 }
 
                 // Slot empty, request a new random texture.
-                auto desc = presetState.renderContext.textureManager->GetRandomTexture(name);
+                auto desc = presetState.renderContext.textureManager->GetRandomTexture(name, *presetState.renderContext.randomGenerator);
 
                 // Also store a copy in preset state!
                 presetState.randomTextureDescriptors.insert({randomSlot, desc});
@@ -165,10 +184,10 @@ void MilkdropShader::LoadVariables(const PresetState& presetState, const PerFram
 
     m_shader.SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
 
-    m_shader.SetUniformFloat4("rand_frame", {floatRand(),
-                                             floatRand(),
-                                             floatRand(),
-                                             floatRand()});
+    m_shader.SetUniformFloat4("rand_frame", {FloatRand(),
+                                             FloatRand(),
+                                             FloatRand(),
+                                             FloatRand()});
     m_shader.SetUniformFloat4("rand_preset", {m_randValues[0],
                                               m_randValues[1],
                                               m_randValues[2],
@@ -256,11 +275,11 @@ void MilkdropShader::LoadVariables(const PresetState& presetState, const PerFram
     // the last 4 are totally random, each frame
     for (int i = 20; i < 24; i++)
     {
-        glm::mat4 const rotationX = glm::rotate(glm::mat4(1.0f), floatRand() * 6.28f, glm::vec3(1.0f, 0.0f, 0.0f));
-        glm::mat4 const rotationY = glm::rotate(glm::mat4(1.0f), floatRand() * 6.28f, glm::vec3(0.0f, 1.0f, 0.0f));
-        glm::mat4 const rotationZ = glm::rotate(glm::mat4(1.0f), floatRand() * 6.28f, glm::vec3(0.0f, 0.0f, 1.0f));
+        glm::mat4 const rotationX = glm::rotate(glm::mat4(1.0f), FloatRand() * 6.28f, glm::vec3(1.0f, 0.0f, 0.0f));
+        glm::mat4 const rotationY = glm::rotate(glm::mat4(1.0f), FloatRand() * 6.28f, glm::vec3(0.0f, 1.0f, 0.0f));
+        glm::mat4 const rotationZ = glm::rotate(glm::mat4(1.0f), FloatRand() * 6.28f, glm::vec3(0.0f, 0.0f, 1.0f));
 
-        glm::mat4 const randomTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(floatRand(), floatRand(), floatRand()));
+        glm::mat4 const randomTranslation = glm::translate(glm::mat4(1.0f), glm::vec3(FloatRand(), FloatRand(), FloatRand()));
 
         tempMatrices[i] = randomTranslation * rotationX;
         tempMatrices[i] = rotationZ * tempMatrices[i];
@@ -329,10 +348,78 @@ auto MilkdropShader::Shader() -> Renderer::Shader&
     return m_shader;
 }
 
-void MilkdropShader::PreprocessPresetShader(std::string& program)
+auto MilkdropShader::RequiredBlurLevel() const -> BlurTexture::BlurLevel
+{
+    return m_maxBlurLevelRequired;
+}
+
+void MilkdropShader::Validate(ShaderType type, const std::string& presetShaderCode)
+{
+    std::string program = presetShaderCode;
+
+    auto samplerNames = ReferencedSamplerNames(Utils::StripComments(program));
+    PreprocessPresetShader(type, program);
+
+    // Without a texture manager, declare every referenced sampler as a generic texture, and all
+    // blur textures.
+    std::set<std::string> samplerDeclarations;
+    std::set<std::string> texSizeDeclarations;
+    GenericDeclarations(samplerNames, BlurTexture::BlurLevel::Blur3, samplerDeclarations, texSizeDeclarations);
+
+    TranslateToGLSL(type, program, samplerDeclarations, texSizeDeclarations);
+}
+
+auto MilkdropShader::Precompile(ShaderType type, const std::string& presetShaderCode) -> Precompiled
+{
+    Precompiled precompiled;
+
+    std::string const stripped = Utils::StripComments(presetShaderCode);
+    precompiled.samplerNames = ReferencedSamplerNames(stripped);
+    precompiled.maxBlurLevel = ReferencedBlurLevel(stripped);
+
+    // Directly referenced blur samplers also raise the blur level, see LoadTexturesAndCompile().
+    for (const auto& name : precompiled.samplerNames)
+    {
+        std::string baseName = name;
+        if (name.length() > 3 && name.at(2) == '_')
+        {
+            baseName = name.substr(3);
+        }
+
+        std::string lowerCaseName = Utils::ToLower(baseName);
+        if (lowerCaseName == "blur3")
+        {
+            precompiled.maxBlurLevel = BlurTexture::BlurLevel::Blur3;
+        }
+        else if (lowerCaseName == "blur2" && precompiled.maxBlurLevel < BlurTexture::BlurLevel::Blur2)
+        {
+            precompiled.maxBlurLevel = BlurTexture::BlurLevel::Blur2;
+        }
+        else if (lowerCaseName == "blur1" && precompiled.maxBlurLevel < BlurTexture::BlurLevel::Blur1)
+        {
+            precompiled.maxBlurLevel = BlurTexture::BlurLevel::Blur1;
+        }
+    }
+    AddBlurSamplerNames(precompiled.maxBlurLevel, precompiled.samplerNames);
+
+    precompiled.preprocessedCode = presetShaderCode;
+    PreprocessPresetShader(type, precompiled.preprocessedCode);
+
+    // Declare the uniforms like the texture manager would if all textures can be found.
+    std::set<std::string> samplerDeclarations;
+    std::set<std::string> texSizeDeclarations;
+    GenericDeclarations(precompiled.samplerNames, precompiled.maxBlurLevel, samplerDeclarations, texSizeDeclarations);
+
+    precompiled.glslSource = TranslateToGLSL(type, precompiled.preprocessedCode, samplerDeclarations, texSizeDeclarations);
+    precompiled.declarationKey = DeclarationKey(samplerDeclarations, texSizeDeclarations);
+
+    return precompiled;
+}
+
+void MilkdropShader::PreprocessPresetShader(ShaderType type, std::string& program)
 {
     std::string shaderTypeString = "composite";
-    if (m_type == ShaderType::WarpShader)
+    if (type == ShaderType::WarpShader)
     {
         shaderTypeString = "warp";
     }
@@ -378,7 +465,7 @@ void MilkdropShader::PreprocessPresetShader(std::string& program)
     found = stripped.find("shader_body");
     if (found != std::string::npos)
     {
-        if (m_type == ShaderType::WarpShader)
+        if (type == ShaderType::WarpShader)
         {
             program.replace(int(found), 11, R"(
 void PS(float4 _vDiffuse : COLOR,
@@ -409,7 +496,7 @@ void PS(float4 _vDiffuse : COLOR,
     if (found != std::string::npos)
     {
         std::string progMain = "{\nfloat3 ret = 0;\n";
-        if (m_type == ShaderType::WarpShader)
+        if (type == ShaderType::WarpShader)
         {
             progMain.append("_mv_tex_coords.xy = _uv.xy;\n");
         }
@@ -488,7 +575,7 @@ void PS(float4 _vDiffuse : COLOR,
     // to unwrap the packed 4-element uniforms into single values.
     fullSource.append(MilkdropStaticShaders::Get()->GetPresetShaderHeader());
 
-    if (m_type == ShaderType::WarpShader)
+    if (type == ShaderType::WarpShader)
     {
         fullSource.append("#define rad _rad_ang.x\n"
                           "#define ang _rad_ang.y\n"
@@ -511,56 +598,71 @@ void PS(float4 _vDiffuse : COLOR,
 
 void MilkdropShader::GetReferencedSamplers(const std::string& program)
 {
+    // Strip comments so that commented-out sampler/texsize declarations are not matched.
+    std::string const stripped = Utils::StripComments(program);
+
     // Look up samplers referenced in the shader program
-    m_samplerNames.clear();
+    m_samplerNames = ReferencedSamplerNames(stripped);
 
-    // "main" should always be present.
-    m_samplerNames.insert("main");
+    auto blurLevel = ReferencedBlurLevel(stripped);
+    if (blurLevel != BlurTexture::BlurLevel::None)
+    {
+        UpdateMaxBlurLevel(blurLevel);
+    }
+    else
+    {
+        m_maxBlurLevelRequired = BlurTexture::BlurLevel::None;
+    }
+}
 
-    // Strip comments so that commented-out sampler/texsize declarations are not matched.
-    std::string const stripped = Utils::StripComments(program);
+auto MilkdropShader::ReferencedSamplerNames(const std::string& strippedProgram) -> std::set<std::string>
+{
+    std::set<std::string> samplerNames;
+
+    // "main" should always be present.
+    samplerNames.insert("main");
 
     // Search for sampler usage
-    auto found = stripped.find("sampler_", 0);
+    auto found = strippedProgram.find("sampler_", 0);
     while (found != std::string::npos)
     {
         found += 8;
-        size_t const end = stripped.find_first_of(" ;,\n\r)", found);
+        size_t const end = strippedProgram.find_first_of(" ;,\n\r)", found);
 
         if (end != std::string::npos)
         {
-            std::string const sampler = stripped.substr(static_cast<int>(found), static_cast<int>(end - found));
+            std::string const sampler = strippedProgram.substr(static_cast<int>(found), static_cast<int>(end - found));
             // Skip "sampler_state", as it's a reserved word and not a sampler.
             if (sampler != "state")
             {
-                m_samplerNames.insert(sampler);
+                samplerNames.insert(sampler);
             }
         }
 
-        found = stripped.find("sampler_", found);
+        found = strippedProgram.find("sampler_", found);
     }
 
     // Also search for texsize usage, some presets don't reference the sampler.
-    found = stripped.find("texsize_", 0);
+    found = strippedProgram.find("texsize_", 0);
     while (found != std::string::npos)
     {
         found += 8;
-        size_t const end = stripped.find_first_of(" ;,.\n\r)", found);
+        size_t const end = strippedProgram.find_first_of(" ;,.\n\r)", found);
 
         if (end != std::string::npos)
         {
-            std::string const sampler = stripped.substr(static_cast<int>(found), static_cast<int>(end - found));
-            m_samplerNames.insert(sampler);
+            std::string const sampler = strippedProgram.substr(static_cast<int>(found), static_cast<int>(end - found));
+            samplerNames.insert(sampler);
         }
 
-        found = stripped.find("texsize_", found);
+        found = strippedProgram.find("texsize_", found);
     }
 
     {
         // Remove duplicate mentions or "randXX" names, keeping the long forms only (first one will determine the actual texture loaded).
-        auto samplerName = m_samplerNames.begin();
+        auto samplerName = samplerNames.begin();
         std::locale loc;
-        while (samplerName != m_samplerNames.end())
+        while (samplerName != samplerNames.end())
         {
             std::string lowerCaseName = Utils::ToLower(*samplerName);
             if (lowerCaseName.length() == 6 &&
@@ -568,14 +670,14 @@ void MilkdropShader::GetReferencedSamplers(const std::string& program)
             {
                 auto additionalName = samplerName;
                 additionalName++;
-                if (additionalName != m_samplerNames.end())
+                if (additionalName != samplerNames.end())
                 {
                     std::string addLowerCaseName = Utils::ToLower(*additionalName);
                     if (addLowerCaseName.length() > 7 &&
                         addLowerCaseName.substr(0, 6) == lowerCaseName &&
                         addLowerCaseName[6] == '_')
                     {
-                        samplerName = m_samplerNames.erase(samplerName);
+                        samplerName = samplerNames.erase(samplerName);
                     }
                 }
             }
@@ -583,28 +685,166 @@ void MilkdropShader::GetReferencedSamplers(const std::string& program)
         }
     }
 
-    if (stripped.find("GetBlur3") != std::string::npos)
+    return samplerNames;
+}
+
+auto MilkdropShader::ReferencedBlurLevel(const std::string& strippedProgram) -> BlurTexture::BlurLevel
+{
+    if (strippedProgram.find("GetBlur3") != std::string::npos)
     {
-        UpdateMaxBlurLevel(BlurTexture::BlurLevel::Blur3);
+        return BlurTexture::BlurLevel::Blur3;
     }
-    else if (stripped.find("GetBlur2") != std::string::npos)
+    if (strippedProgram.find("GetBlur2") != std::string::npos)
     {
-        UpdateMaxBlurLevel(BlurTexture::BlurLevel::Blur2);
+        return BlurTexture::BlurLevel::Blur2;
     }
-    else if (stripped.find("GetBlur1") != std::string::npos)
+    if (strippedProgram.find("GetBlur1") != std::string::npos)
     {
-        UpdateMaxBlurLevel(BlurTexture::BlurLevel::Blur1);
+        return BlurTexture::BlurLevel::Blur1;
     }
-    else
+
+    return BlurTexture::BlurLevel::None;
+}
+
+void MilkdropShader::AddBlurSamplerNames(BlurTexture::BlurLevel blurLevel, std::set<std::string>& samplerNames)
+{
+    if (blurLevel == BlurTexture::BlurLevel::Blur3)
     {
-        m_maxBlurLevelRequired = BlurTexture::BlurLevel::None;
+        samplerNames.insert("blur1");
+        samplerNames.insert("blur2");
+        samplerNames.insert("blur3");
+    }
+    else if (blurLevel == BlurTexture::BlurLevel::Blur2)
+    {
+        samplerNames.insert("blur1");
+        samplerNames.insert("blur2");
+    }
+    else if (blurLevel == BlurTexture::BlurLevel::Blur1)
+    {
+        samplerNames.insert("blur1");
     }
 }
 
+void MilkdropShader::GenericDeclarations(const std::set<std::string>& samplerNames, BlurTexture::BlurLevel blurLevel,
+                                         std::set<std::string>& samplerDeclarations, std::set<std::string>& texSizeDeclarations)
+{
+    std::locale loc;
+    for (const auto& name : samplerNames)
+    {
+        std::string baseName = name;
+        if (name.length() > 3 && name.at(2) == '_')
+        {
+            baseName = name.substr(3);
+        }
+
+        std::string lowerCaseName = Utils::ToLower(baseName);
+        if (lowerCaseName == "blur1" || lowerCaseName == "blur2" || lowerCaseName == "blur3")
+        {
+            continue;
+        }
+
+        if (lowerCaseName == "main")
+        {
+            samplerDeclarations.insert(Renderer::TextureSamplerDescriptor::SamplerDeclaration(name, false));
+            texSizeDeclarations.insert(Renderer::TextureSamplerDescriptor::TexSizeDeclaration("main"));
+            continue;
+        }
+
+        // Random textures use the full name for the texsize uniform.
+        std::string sizeName = baseName;
+        if (lowerCaseName.length() >= 6 &&
+            lowerCaseName.substr(0, 4) == "rand" && std::isdigit(lowerCaseName.at(4), loc) && std::isdigit(lowerCaseName.at(5), loc) &&
+            std::stoi(lowerCaseName.substr(4, 2)) <= 15)
+        {
+            sizeName = name;
+        }
+
+        // Only the noise volume textures are 3D textures.
+        samplerDeclarations.insert(Renderer::TextureSamplerDescriptor::SamplerDeclaration(name, lowerCaseName.substr(0, 8) == "noisevol"));
+        texSizeDeclarations.insert(Renderer::TextureSamplerDescriptor::TexSizeDeclaration(sizeName));
+    }
+
+    if (blurLevel >= BlurTexture::BlurLevel::Blur1)
+    {
+        samplerDeclarations.insert(Renderer::TextureSamplerDescriptor::SamplerDeclaration("blur1", false));
+    }
+    if (blurLevel >= BlurTexture::BlurLevel::Blur2)
+    {
+        samplerDeclarations.insert(Renderer::TextureSamplerDescriptor::SamplerDeclaration("blur2", false));
+    }
+    if (blurLevel >= BlurTexture::BlurLevel::Blur3)
+    {
+        samplerDeclarations.insert(Renderer::TextureSamplerDescriptor::SamplerDeclaration("blur3", false));
+    }
+}
+
+auto MilkdropShader::DeclarationKey(const std::set<std::string>& samplerDeclarations,
+                                    const std::set<std::string>& texSizeDeclarations) -> std::string
+{
+    std::string key = std::to_string(static_cast<int>(MilkdropStaticShaders::Get()->GetGlslGeneratorVersion())) + "\n";
+    for (const auto& declaration : samplerDeclarations)
+    {
+        key.append(declaration);
+    }
+    for (const auto& declaration : texSizeDeclarations)
+    {
+        key.append(declaration);
+    }
+
+    return key;
+}
+
 void MilkdropShader::TranspileHLSLShader(const PresetState& presetState, std::string& program)
 {
-    std::string shaderTypeString = "composite";
+    // Collect unique samplers and texsize uniforms
+    std::set<std::string> samplerDeclarations;
+    std::set<std::string> texSizeDeclarations;
+    for (const auto& desc : m_mainTextureDescriptors)
+    {
+        samplerDeclarations.insert(desc.SamplerDeclaration());
+        texSizeDeclarations.insert(desc.TexSizeDeclaration());
+    }
+    for (const auto& desc : presetState.blurTexture.GetDescriptorsForBlurLevel(m_maxBlurLevelRequired))
+    {
+        samplerDeclarations.insert(desc.SamplerDeclaration());
+        // No texsize_blur1 etc.
+    }
+    for (const auto& desc : m_textureSamplerDescriptors)
+    {
+        samplerDeclarations.insert(desc.SamplerDeclaration());
+        texSizeDeclarations.insert(desc.TexSizeDeclaration());
+    }
+
+    // Precompiled code can only be used if the uniforms are declared exactly the same way.
+    std::string glslSource;
+    if (!m_precompiledGlslSource.empty() &&
+        m_precompiledDeclarationKey == DeclarationKey(samplerDeclarations, texSizeDeclarations))
+    {
+        glslSource = m_precompiledGlslSource;
+    }
+    else
+    {
+        glslSource = TranslateToGLSL(m_type, program, samplerDeclarations, texSizeDeclarations);
+    }
+
+    // Now we have GLSL source for the preset shader program (hopefully it's valid!)
+    // Compile the preset shader fragment shader with the standard vertex shader and cross our fingers.
     if (m_type == ShaderType::WarpShader)
+    {
+        m_shader.CompileProgram(MilkdropStaticShaders::Get()->GetPresetWarpVertexShader(), glslSource);
+    }
+    else
+    {
+        m_shader.CompileProgram(MilkdropStaticShaders::Get()->GetPresetCompVertexShader(), glslSource);
+    }
+}
+
+auto MilkdropShader::TranslateToGLSL(ShaderType type, const std::string& program,
+                                     const std::set<std::string>& samplerDeclarations,
+                                     const std::set<std::string>& texSizeDeclarations) -> std::string
+{
+    std::string shaderTypeString = "composite";
+    if (type == ShaderType::WarpShader)
     {
         shaderTypeString = "warp";
     }
@@ -640,25 +880,6 @@ void MilkdropShader::TranspileHLSLShader(const PresetState& presetState, std::st
         sourcePreprocessed.replace(matches.position(), matches.length(), "");
     }
 
-    // Collect unique samplers and texsize uniforms
-    std::set<std::string> samplerDeclarations;
-    std::set<std::string> texSizeDeclarations;
-    for (const auto& desc : m_mainTextureDescriptors)
-    {
-        samplerDeclarations.insert(desc.SamplerDeclaration());
-        texSizeDeclarations.insert(desc.TexSizeDeclaration());
-    }
-    for (const auto& desc : presetState.blurTexture.GetDescriptorsForBlurLevel(m_maxBlurLevelRequired))
-    {
-        samplerDeclarations.insert(desc.SamplerDeclaration());
-        // No texsize_blur1 etc.
-    }
-    for (const auto& desc : m_textureSamplerDescriptors)
-    {
-        samplerDeclarations.insert(desc.SamplerDeclaration());
-        texSizeDeclarations.insert(desc.TexSizeDeclaration());
-    }
-
     // Now insert them on top.
     for (const auto& texSizeDeclaration : texSizeDeclarations)
     {
@@ -690,16 +911,7 @@ void MilkdropShader::TranspileHLSLShader(const PresetState& presetState, std::st
 
     LOG_TRACE("[MilkdropShader] Transpiled GLSL " + shaderTypeString + " shader code:\n" + std::string(generator.GetResult()));
 
-    // Now we have GLSL source for the preset shader program (hopefully it's valid!)
-    // Compile the preset shader fragment shader with the standard vertex shader and cross our fingers.
-    if (m_type == ShaderType::WarpShader)
-    {
-        m_shader.CompileProgram(MilkdropStaticShaders::Get()->GetPresetWarpVertexShader(), generator.GetResult());
-    }
-    else
-    {
-        m_shader.CompileProgram(MilkdropStaticShaders::Get()->GetPresetCompVertexShader(), generator.GetResult());
-    }
+    return generator.GetResult();
 }
 
 void MilkdropShader::UpdateMaxBlurLevel(BlurTexture::BlurLevel requestedLevel)
@@ -711,21 +923,12 @@ void MilkdropShader::UpdateMaxBlurLevel(BlurTexture::BlurLevel requestedLevel)
 
     m_maxBlurLevelRequired = requestedLevel;
 
-    if (m_maxBlurLevelRequired == BlurTexture::BlurLevel::Blur3)
-    {
-        m_samplerNames.insert("blur1");
-        m_samplerNames.insert("blur2");
-        m_samplerNames.insert("blur3");
-    }
-    else if (m_maxBlurLevelRequired == BlurTexture::BlurLevel::Blur2)
-    {
-        m_samplerNames.insert("blur1");
-        m_samplerNames.insert("blur2");
-    }
-    else
-    {
-        m_samplerNames.insert("blur1");
-    }
+    AddBlurSamplerNames(m_maxBlurLevelRequired, m_samplerNames);
+}
+
+auto MilkdropShader::FloatRand() -> float
+{
+    return m_randomGenerator.NextFloat();
 }
 
 } // namespace MilkdropPreset
@@ -9,6 +9,7 @@
 
 #include "BlurTexture.hpp"
 
+#include <Renderer/RandomNumberGenerator.hpp>
 #include <Renderer/Shader.hpp>
 #include <Renderer/TextureManager.hpp>
 
@@ -34,6 +35,20 @@ public:
         CompositeShader //!< Composite shader
     };
 
+    /**
+     * @brief Shader data which doesn't depend on the render context.
+     *
+     * Created by Precompile() and stored in preset bundles, so loading a preset doesn't need to
+     * preprocess and translate the shader code again.
+     */
+    struct Precompiled {
+        std::string preprocessedCode;                                       //!< The preprocessed preset shader code. Empty if not available.
+        std::set<std::string> samplerNames;                                 //!< All sampler names referenced in the shader code.
+        BlurTexture::BlurLevel maxBlurLevel{BlurTexture::BlurLevel::None}; //!< Max blur level of main texture required by this shader.
+        std::string declarationKey;                                         //!< Generator version and uniform declarations used for glslSource.
+        std::string glslSource;                                             //!< The translated GLSL fragment shader.
+    };
+
     /**
      * constructor.
      * @param type The preset shader type.
@@ -46,6 +61,17 @@ public:
      */
     void LoadCode(const std::string& presetShaderCode);
 
+    /**
+     * @brief Loads previously preprocessed and translated shader code.
+     *
+     * The translated GLSL source is only used if the textures available at compile time result in
+     * the same uniform declarations. Otherwise, the preprocessed code is translated again.
+     *
+     * @param presetShaderCode The original preset shader code.
+     * @param precompiled The data returned by Precompile() for the same shader code.
+     */
+    void LoadPrecompiledCode(const std::string& presetShaderCode, const Precompiled& precompiled);
+
     /**
      * @brief Loads the required texture references into the shader.
      * Binds the underlying shader program.
@@ -67,12 +93,45 @@ public:
      */
     auto Shader() -> Renderer::Shader&;
 
+    /**
+     * @brief Returns the highest blur level sampled by this shader.
+     * @return The blur level required by the shader code.
+     */
+    auto RequiredBlurLevel() const -> BlurTexture::BlurLevel;
+
+    /**
+     * @brief Checks if the given preset shader code can be translated into GLSL.
+     *
+     * Runs the same preprocessing and HLSL-to-GLSL translation as LoadCode() and
+     * LoadTexturesAndCompile(), but declares all referenced samplers as generic textures and
+     * doesn't compile the result. Does not require an OpenGL context.
+     *
+     * @throws Renderer::ShaderException Thrown if the shader code can't be translated.
+     * @param type The preset shader type.
+     * @param presetShaderCode The preset shader code.
+     */
+    static void Validate(ShaderType type, const std::string& presetShaderCode);
+
+    /**
+     * @brief Preprocesses and translates the preset shader code without an OpenGL context.
+     *
+     * The uniforms are declared as the built-in texture manager would declare them, so the
+     * GLSL source can be used as-is if all referenced textures are found at load time.
+     *
+     * @throws Renderer::ShaderException Thrown if the shader code can't be translated.
+     * @param type The preset shader type.
+     * @param presetShaderCode The preset shader code.
+     * @return The precompiled shader data.
+     */
+    static auto Precompile(ShaderType type, const std::string& presetShaderCode) -> Precompiled;
+
 private:
     /**
      * @brief Prepares the shader code to be translated into GLSL.
+     * @param type The preset shader type.
      * @param program The program code to work on.
      */
-    void PreprocessPresetShader(std::string& program);
+    static void PreprocessPresetShader(ShaderType type, std::string& program);
 
     /**
      * @brief Searches for sampler references in the program and stores them in m_samplerNames.
@@ -81,12 +140,64 @@ private:
     void GetReferencedSamplers(const std::string& program);
 
     /**
-     * @brief Translates the HLSL shader into GLSL.
+     * @brief Returns the names of all samplers referenced in the program.
+     * @param strippedProgram The program code without comments.
+     * @return The referenced sampler names, always including "main".
+     */
+    static auto ReferencedSamplerNames(const std::string& strippedProgram) -> std::set<std::string>;
+
+    /**
+     * @brief Returns the blur level required by the GetBlur1/2/3() calls in the program.
+     * @param strippedProgram The program code without comments.
+     * @return The highest blur level used in the program.
+     */
+    static auto ReferencedBlurLevel(const std::string& strippedProgram) -> BlurTexture::BlurLevel;
+
+    /**
+     * @brief Adds the blur sampler names required for the given blur level.
+     * @param blurLevel The required blur level.
+     * @param samplerNames The sampler name list to add the names to.
+     */
+    static void AddBlurSamplerNames(BlurTexture::BlurLevel blurLevel, std::set<std::string>& samplerNames);
+
+    /**
+     * @brief Declares the given samplers the way the built-in texture manager would.
+     * @param samplerNames The referenced sampler names.
+     * @param blurLevel The blur level up to which blur samplers are declared.
+     * @param samplerDeclarations The sampler uniform declarations to add to.
+     * @param texSizeDeclarations The texture size uniform declarations to add to.
+     */
+    static void GenericDeclarations(const std::set<std::string>& samplerNames, BlurTexture::BlurLevel blurLevel,
+                                    std::set<std::string>& samplerDeclarations, std::set<std::string>& texSizeDeclarations);
+
+    /**
+     * @brief Creates a key identifying the inputs of TranslateToGLSL() besides the program itself.
+     * @param samplerDeclarations The sampler uniform declarations.
+     * @param texSizeDeclarations The texture size uniform declarations.
+     * @return A string containing the GLSL generator version and all declarations.
+     */
+    static auto DeclarationKey(const std::set<std::string>& samplerDeclarations,
+                               const std::set<std::string>& texSizeDeclarations) -> std::string;
+
+    /**
+     * @brief Translates the HLSL shader into GLSL and compiles it.
      * @param presetState The preset state to pull the blur textures from.
      * @param program The shader to transpile.
      */
     void TranspileHLSLShader(const PresetState& presetState, std::string& program);
 
+    /**
+     * @brief Translates the HLSL shader into GLSL.
+     * @param type The preset shader type.
+     * @param program The preprocessed shader to transpile.
+     * @param samplerDeclarations The sampler uniform declarations to add to the program.
+     * @param texSizeDeclarations The texture size uniform declarations to add to the program.
+     * @return The GLSL fragment shader source.
+     */
+    static auto TranslateToGLSL(ShaderType type, const std::string& program,
+                                const std::set<std::string>& samplerDeclarations,
+                                const std::set<std::string>& texSizeDeclarations) -> std::string;
+
     /**
      * @brief Updates the requested blur level if higher than before.
      * Also adds the required samplers.
@@ -94,15 +205,31 @@ private:
      */
     void UpdateMaxBlurLevel(BlurTexture::BlurLevel requestedLevel);
 
+    /**
+     * @brief Generates the random values which stay constant for the lifetime of the shader.
+     */
+    void GenerateRandomValues();
+
+    /**
+     * @brief Returns a random value between 0 and 1.
+     * Uses the per-shader generator, so shaders of different instances can be used on different threads.
+     * @return The random value.
+     */
+    auto FloatRand() -> float;
+
     ShaderType m_type{ShaderType::WarpShader}; //!< Type of this shader.
     std::string m_fragmentShaderCode;          //!< The original preset fragment shader code.
     std::string m_preprocessedCode;            //!< The preprocessed preset shader code.
+    std::string m_precompiledDeclarationKey;   //!< Declaration key of the precompiled GLSL source.
+    std::string m_precompiledGlslSource;       //!< Precompiled GLSL source, used if the declarations match.
 
     std::set<std::string> m_samplerNames;                                        //!< All sampler names referenced in the shader code.
     std::vector<Renderer::TextureSamplerDescriptor> m_mainTextureDescriptors;              //!< Descriptors for all main texture references.
     std::vector<Renderer::TextureSamplerDescriptor> m_textureSamplerDescriptors;           //!< Descriptors of all referenced samplers in the shader code.
     BlurTexture::BlurLevel m_maxBlurLevelRequired{BlurTexture::BlurLevel::None}; //!< Max blur level of main texture required by this shader.
 
+    Renderer::RandomNumberGenerator m_randomGenerator; //!< Random number generator, one per shader to avoid the global rand() state. Seeded from the render context.
+
     std::array<float, 4> m_randValues{};               //!< Random values which don't change every frame.
     std::array<glm::vec3, 20> m_randTranslation{};     //!< Random translation vectors which don't change every frame.
     std::array<glm::vec3, 20> m_randRotationCenters{}; //!< Random rotation center vectors which don't change every frame.
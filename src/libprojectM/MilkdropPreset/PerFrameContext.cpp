@@ -1,11 +1,13 @@
 #include "PerFrameContext.hpp"
 
+#include "ExpressionOptimizer.hpp"
 #include "MilkdropPresetExceptions.hpp"
 
 #include <Logging.hpp>
 
-#define REG_VAR(var) \
-    var = projectm_eval_context_register_variable(perFrameCodeContext, #var);
+#define REG_VAR(var)                                                      \
+    var = projectm_eval_context_register_variable(perFrameCodeContext, #var); \
+    builtinVariables.insert(#var);
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -64,6 +66,7 @@ void PerFrameContext::RegisterBuiltinVariables()
     {
         std::string qvar = "q" + std::to_string(q + 1);
         q_vars[q] = projectm_eval_context_register_variable(perFrameCodeContext, qvar.c_str());
+        builtinVariables.insert(qvar);
     }
     REG_VAR(progress);
     REG_VAR(ob_size);
@@ -235,13 +238,42 @@ void PerFrameContext::LoadStateVariables(PresetState& state)
     *blur1_edge_darken = static_cast<PRJM_EVAL_F>(state.blur1EdgeDarken);
 }
 
-void PerFrameContext::CompilePerFrameCode(const std::string& perFrameCode)
+void PerFrameContext::CompilePerFrameCode(const std::string& perFrameCode, const std::set<std::string>& downstreamVariables)
 {
     if (perFrameCode.empty())
     {
         return;
     }
 
+    // Writes to Q variables which no other code or shader reads can be removed.
+    std::set<std::string> externalVariables(builtinVariables);
+    for (int q = 0; q < QVarCount; q++)
+    {
+        std::string qvar = "q" + std::to_string(q + 1);
+        if (downstreamVariables.find(qvar) == downstreamVariables.end())
+        {
+            externalVariables.erase(qvar);
+        }
+    }
+
+    auto optimizedCode = ExpressionOptimizer::OptimizePerFrameCode(perFrameCode, externalVariables);
+    if (optimizedCode.empty())
+    {
+        return;
+    }
+
+    if (optimizedCode != perFrameCode)
+    {
+        perFrameCodeHandle = projectm_eval_code_compile(perFrameCodeContext, optimizedCode.c_str());
+        if (perFrameCodeHandle != nullptr)
+        {
+            return;
+        }
+
+        // Compile the original code to get the proper error message.
+        LOG_DEBUG("[PerFrameContext] Optimized per-frame code failed to compile:\n" + optimizedCode);
+    }
+
     perFrameCodeHandle = projectm_eval_code_compile(perFrameCodeContext, perFrameCode.c_str());
     if (perFrameCodeHandle == nullptr)
     {
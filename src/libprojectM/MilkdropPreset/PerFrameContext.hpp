@@ -4,6 +4,9 @@
 
 #include <projectm-eval.h>
 
+#include <set>
+#include <string>
+
 namespace libprojectM {
 namespace MilkdropPreset {
 
@@ -52,11 +55,12 @@ public:
     void EvaluateInitCode(PresetState& state);
 
     /**
-     * @brief Compiles the per-frame code and stores the code handle in the class.
+     * @brief Optimizes and compiles the per-frame code and stores the code handle in the class.
      * @throws MilkdropCompileException Thrown if the per-frame code couldn't be compiled.
      * @param perFrameCode The code to compile.
+     * @param downstreamVariables Lower-case identifiers used in code and shaders which read the per-frame Q variables.
      */
-    void CompilePerFrameCode(const std::string& perFrameCode);
+    void CompilePerFrameCode(const std::string& perFrameCode, const std::set<std::string>& downstreamVariables);
 
     /**
      * @brief Executes the per-frame code with the current state.
@@ -65,6 +69,7 @@ public:
 
     projectm_eval_context* perFrameCodeContext{nullptr}; //!< The code runtime context, holds memory buffers and variables.
     projectm_eval_code* perFrameCodeHandle{nullptr}; //!< The compiled per-frame code handle.
+    std::set<std::string> builtinVariables;          //!< Names of all registered built-in variables.
 
     PRJM_EVAL_F* zoom{};
     PRJM_EVAL_F* zoomexp{};
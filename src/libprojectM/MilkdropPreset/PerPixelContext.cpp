@@ -1,12 +1,14 @@
 #include "PerPixelContext.hpp"
 
+#include "ExpressionOptimizer.hpp"
 #include "MilkdropPresetExceptions.hpp"
 #include "PerFrameContext.hpp"
 
 #include <Logging.hpp>
 
-#define REG_VAR(var) \
-    var = projectm_eval_context_register_variable(perPixelCodeContext, #var);
+#define REG_VAR(var)                                                      \
+    var = projectm_eval_context_register_variable(perPixelCodeContext, #var); \
+    builtinVariables.insert(#var);
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -23,6 +25,11 @@ PerPixelContext::~PerPixelContext()
         projectm_eval_code_destroy(perPixelCodeHandle);
     }
 
+    if (perPixelPrologueCodeHandle != nullptr)
+    {
+        projectm_eval_code_destroy(perPixelPrologueCodeHandle);
+    }
+
     if (perPixelCodeContext != nullptr)
     {
         projectm_eval_context_destroy(perPixelCodeContext);
@@ -60,6 +67,7 @@ void PerPixelContext::RegisterBuiltinVariables()
     {
         std::string qvar = "q" + std::to_string(q + 1);
         q_vars[q] = projectm_eval_context_register_variable(perPixelCodeContext, qvar.c_str());
+        builtinVariables.insert(qvar);
     }
     REG_VAR(progress);
     REG_VAR(meshx);
@@ -106,6 +114,38 @@ void PerPixelContext::CompilePerPixelCode(const std::string& perPixelCode)
         return;
     }
 
+    // These are set by the mesh for each vertex, everything else is the same for the whole frame.
+    static const std::set<std::string> perVertexVariables{"x", "y", "rad", "ang"};
+
+    std::string prologueCode;
+    auto optimizedCode = ExpressionOptimizer::OptimizePerPixelCode(perPixelCode, builtinVariables, perVertexVariables, prologueCode);
+    if (optimizedCode.empty())
+    {
+        return;
+    }
+
+    if (optimizedCode != perPixelCode)
+    {
+        perPixelCodeHandle = projectm_eval_code_compile(perPixelCodeContext, optimizedCode.c_str());
+        if (perPixelCodeHandle != nullptr && !prologueCode.empty())
+        {
+            perPixelPrologueCodeHandle = projectm_eval_code_compile(perPixelCodeContext, prologueCode.c_str());
+            if (perPixelPrologueCodeHandle == nullptr)
+            {
+                projectm_eval_code_destroy(perPixelCodeHandle);
+                perPixelCodeHandle = nullptr;
+            }
+        }
+
+        if (perPixelCodeHandle != nullptr)
+        {
+            return;
+        }
+
+        // Compile the original code to get the proper error message.
+        LOG_DEBUG("[PerPixelContext] Optimized per-pixel code failed to compile:\n" + prologueCode + optimizedCode);
+    }
+
     perPixelCodeHandle = projectm_eval_code_compile(perPixelCodeContext, perPixelCode.c_str());
     if (perPixelCodeHandle == nullptr)
     {
@@ -128,6 +168,14 @@ void PerPixelContext::CompilePerPixelCode(const std::string& perPixelCode)
     }
 }
 
+void PerPixelContext::ExecutePerPixelPrologueCode()
+{
+    if (perPixelPrologueCodeHandle != nullptr)
+    {
+        projectm_eval_code_execute(perPixelPrologueCodeHandle);
+    }
+}
+
 void PerPixelContext::ExecutePerPixelCode()
 {
     if (perPixelCodeHandle != nullptr)
@@ -4,6 +4,9 @@
 
 #include <projectm-eval.h>
 
+#include <set>
+#include <string>
+
 namespace libprojectM {
 namespace MilkdropPreset {
 
@@ -47,19 +50,31 @@ public:
     void LoadPerFrameQVariables(PresetState& state, PerFrameContext& perFrameState);
 
     /**
-     * @brief Compiles the per-pixel code and stores the code handle in the class.
+     * @brief Optimizes and compiles the per-pixel code and stores the code handles in the class.
+     *
+     * Parts of the code which only depend on per-frame values are moved into a prologue, which
+     * needs to be executed once per frame with ExecutePerPixelPrologueCode().
+     *
      * @throws MilkdropCompileException Thrown if the per-pixel code couldn't be compiled.
      * @param perPixelCode The code to compile.
      */
     void CompilePerPixelCode(const std::string& perPixelCode);
 
+    /**
+     * @brief Executes the per-pixel prologue code.
+     * Call once per frame before the first ExecutePerPixelCode() call, with all per-frame values set.
+     */
+    void ExecutePerPixelPrologueCode();
+
     /**
      * @brief Executes the per-pixel code with the current state.
      */
     void ExecutePerPixelCode();
 
-    projectm_eval_context* perPixelCodeContext{nullptr}; //!< The code runtime context, holds memory buffers and variables.
-    projectm_eval_code* perPixelCodeHandle{nullptr};     //!< The compiled per-pixel code handle.
+    projectm_eval_context* perPixelCodeContext{nullptr};     //!< The code runtime context, holds memory buffers and variables.
+    projectm_eval_code* perPixelCodeHandle{nullptr};         //!< The compiled per-pixel code handle.
+    projectm_eval_code* perPixelPrologueCodeHandle{nullptr}; //!< The compiled per-frame invariant part of the per-pixel code.
+    std::set<std::string> builtinVariables;                  //!< Names of all registered built-in variables.
 
     PRJM_EVAL_F* zoom{};
     PRJM_EVAL_F* zoomexp{};
@@ -53,7 +53,14 @@ void PerPixelMesh::LoadWarpShader(const PresetState& presetState)
             try
             {
                 m_warpShader = std::make_unique<MilkdropShader>(MilkdropShader::ShaderType::WarpShader);
-                m_warpShader->LoadCode(presetState.warpShader);
+                if (!presetState.precompiledWarpShader.preprocessedCode.empty())
+                {
+                    m_warpShader->LoadPrecompiledCode(presetState.warpShader, presetState.precompiledWarpShader);
+                }
+                else
+                {
+                    m_warpShader->LoadCode(presetState.warpShader);
+                }
                 LOG_DEBUG("[PerPixelMesh] Successfully loaded preset warp shader code.");
             }
             catch (Renderer::ShaderException& ex)
@@ -105,6 +112,16 @@ void PerPixelMesh::Draw(const PresetState& presetState,
     WarpedBlit(presetState, perFrameContext);
 }
 
+auto PerPixelMesh::RequiredBlurLevel() const -> BlurTexture::BlurLevel
+{
+    if (!m_warpShader)
+    {
+        return BlurTexture::BlurLevel::None;
+    }
+
+    return m_warpShader->RequiredBlurLevel();
+}
+
 void PerPixelMesh::InitializeMesh(const PresetState& presetState)
 {
     if (m_gridSizeX != presetState.renderContext.perPixelMeshX ||
@@ -211,6 +228,23 @@ void PerPixelMesh::CalculateMesh(const PresetState& presetState, const PerFrameC
     float sx = static_cast<float>(*perFrameContext.sx);
     float sy = static_cast<float>(*perFrameContext.sy);
 
+    // Compute the per-frame invariant expressions of the per-pixel code once.
+    if (perPixelContext.perPixelCodeHandle && perPixelContext.perPixelPrologueCodeHandle)
+    {
+        *perPixelContext.zoom = static_cast<double>(*perFrameContext.zoom);
+        *perPixelContext.zoomexp = static_cast<double>(*perFrameContext.zoomexp);
+        *perPixelContext.rot = static_cast<double>(*perFrameContext.rot);
+        *perPixelContext.warp = static_cast<double>(*perFrameContext.warp);
+        *perPixelContext.cx = static_cast<double>(*perFrameContext.cx);
+        *perPixelContext.cy = static_cast<double>(*perFrameContext.cy);
+        *perPixelContext.dx = static_cast<double>(*perFrameContext.dx);
+        *perPixelContext.dy = static_cast<double>(*perFrameContext.dy);
+        *perPixelContext.sx = static_cast<double>(*perFrameContext.sx);
+        *perPixelContext.sy = static_cast<double>(*perFrameContext.sy);
+
+        perPixelContext.ExecutePerPixelPrologueCode();
+    }
+
     int vertex = 0;
 
     // Can't make this multithreaded as per-pixel code may use gmegabuf or regXX vars.
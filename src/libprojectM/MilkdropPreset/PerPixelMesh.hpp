@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BlurTexture.hpp"
+
 #include <Renderer/Mesh.hpp>
 #include <Renderer/Shader.hpp>
 
@@ -51,6 +53,11 @@ public:
               const PerFrameContext& perFrameContext,
               PerPixelContext& perPixelContext);
 
+    /**
+     * @brief Returns the highest blur level sampled by the warp shader.
+     * @return The required blur level, or BlurLevel::None if no warp shader is used.
+     */
+    auto RequiredBlurLevel() const -> BlurTexture::BlurLevel;
 
 private:
     /**
@@ -0,0 +1,529 @@
+#include "PresetBundle.hpp"
+
+#include "MilkdropPresetExceptions.hpp"
+#include "PresetFileParser.hpp"
+
+#include <Logging.hpp>
+#include <Utils.hpp>
+
+#include <fstream>
+#include <stdexcept>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+namespace {
+
+constexpr char BundleMagic[8] = {'P', 'M', 'B', 'U', 'N', 'D', 'L', 'E'};
+
+/**
+ * @brief Removes a file, ignoring any errors.
+ */
+void RemoveFile(const std::string& filename)
+{
+    try
+    {
+        remove(filename);
+    }
+    catch (std::exception&)
+    {
+    }
+}
+
+/**
+ * @brief Checks if the key is a numbered line of one of the code blocks.
+ */
+auto IsCodeLine(const std::string& key) -> bool
+{
+    for (const auto& codeBlock : PresetFileParser::CodeBlocks())
+    {
+        const auto& prefix = codeBlock.keyPrefix;
+        if (key.length() <= prefix.length() || key.compare(0, prefix.length(), prefix) != 0)
+        {
+            continue;
+        }
+
+        if (key.find_first_not_of("0123456789", prefix.length()) == std::string::npos)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WriteUInt32(std::string& out, uint32_t value)
+{
+    for (int byte = 0; byte < 4; byte++)
+    {
+        out.push_back(static_cast<char>((value >> (byte * 8)) & 0xFF));
+    }
+}
+
+void WriteUInt64(std::string& out, uint64_t value)
+{
+    for (int byte = 0; byte < 8; byte++)
+    {
+        out.push_back(static_cast<char>((value >> (byte * 8)) & 0xFF));
+    }
+}
+
+void WriteString(std::string& out, const std::string& value)
+{
+    WriteUInt32(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+void WriteShader(std::string& out, const MilkdropShader::Precompiled& shader)
+{
+    WriteString(out, shader.preprocessedCode);
+    WriteUInt32(out, static_cast<uint32_t>(shader.samplerNames.size()));
+    for (const auto& samplerName : shader.samplerNames)
+    {
+        WriteString(out, samplerName);
+    }
+    WriteUInt32(out, static_cast<uint32_t>(shader.maxBlurLevel));
+    WriteString(out, shader.declarationKey);
+    WriteString(out, shader.glslSource);
+}
+
+/**
+ * @brief Reads values from a bundle data block, checking the bounds of each read.
+ */
+class BundleReader
+{
+public:
+    BundleReader(const char* data, size_t size)
+        : m_data(data)
+        , m_size(size)
+    {
+    }
+
+    auto ReadUInt32(uint32_t& value) -> bool
+    {
+        if (m_size - m_position < 4)
+        {
+            return false;
+        }
+
+        value = 0;
+        for (int byte = 0; byte < 4; byte++)
+        {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(m_data[m_position++])) << (byte * 8);
+        }
+        return true;
+    }
+
+    auto ReadUInt64(uint64_t& value) -> bool
+    {
+        if (m_size - m_position < 8)
+        {
+            return false;
+        }
+
+        value = 0;
+        for (int byte = 0; byte < 8; byte++)
+        {
+            value |= static_cast<uint64_t>(static_cast<unsigned char>(m_data[m_position++])) << (byte * 8);
+        }
+        return true;
+    }
+
+    auto ReadString(std::string& value) -> bool
+    {
+        uint32_t length{};
+        if (!ReadUInt32(length) || m_size - m_position < length)
+        {
+            return false;
+        }
+
+        value.assign(m_data + m_position, length);
+        m_position += length;
+        return true;
+    }
+
+    auto ReadShader(MilkdropShader::Precompiled& shader) -> bool
+    {
+        uint32_t samplerCount{};
+        if (!ReadString(shader.preprocessedCode) || !ReadUInt32(samplerCount))
+        {
+            return false;
+        }
+
+        for (uint32_t index = 0; index < samplerCount; index++)
+        {
+            std::string samplerName;
+            if (!ReadString(samplerName))
+            {
+                return false;
+            }
+            shader.samplerNames.insert(std::move(samplerName));
+        }
+
+        uint32_t blurLevel{};
+        if (!ReadUInt32(blurLevel) || blurLevel > static_cast<uint32_t>(BlurTexture::BlurLevel::Blur3))
+        {
+            return false;
+        }
+        shader.maxBlurLevel = static_cast<BlurTexture::BlurLevel>(blurLevel);
+
+        return ReadString(shader.declarationKey) && ReadString(shader.glslSource);
+    }
+
+    auto AtEnd() const -> bool
+    {
+        return m_position == m_size;
+    }
+
+private:
+    const char* m_data{nullptr}; //!< The data to read from.
+    size_t m_size{0};            //!< Size of the data in bytes.
+    size_t m_position{0};        //!< Current read position.
+};
+
+} // namespace
+
+auto PresetBundle::Open(const std::string& bundleFilename) -> bool
+{
+    m_filename.clear();
+    m_contents.clear();
+
+    std::ifstream file(bundleFilename, std::ios::binary);
+    if (!file.good())
+    {
+        LOG_ERROR("[PresetBundle] Could not open preset bundle \"" + bundleFilename + "\".");
+        return false;
+    }
+
+    char header[24];
+    if (!file.read(header, sizeof(header)) || std::string(header, 8) != std::string(BundleMagic, 8))
+    {
+        LOG_ERROR("[PresetBundle] File \"" + bundleFilename + "\" is not a preset bundle.");
+        return false;
+    }
+
+    BundleReader headerReader(header + 8, sizeof(header) - 8);
+    uint32_t version{};
+    uint32_t presetCount{};
+    uint64_t tableSize{};
+    headerReader.ReadUInt32(version);
+    headerReader.ReadUInt32(presetCount);
+    headerReader.ReadUInt64(tableSize);
+    if (version != FormatVersion)
+    {
+        LOG_ERROR("[PresetBundle] Preset bundle \"" + bundleFilename + "\" has unsupported version " + std::to_string(version) + ".");
+        return false;
+    }
+
+    file.seekg(0, std::ios::end);
+    auto bundleSize = static_cast<uint64_t>(file.tellg());
+    file.seekg(sizeof(header), std::ios::beg);
+    if (tableSize > bundleSize - sizeof(header))
+    {
+        LOG_ERROR("[PresetBundle] Preset bundle \"" + bundleFilename + "\" has a damaged table of contents.");
+        return false;
+    }
+
+    std::vector<char> tableData(static_cast<size_t>(tableSize));
+    if (!file.read(tableData.data(), static_cast<std::streamsize>(tableData.size())))
+    {
+        LOG_ERROR("[PresetBundle] Preset bundle \"" + bundleFilename + "\" has a damaged table of contents.");
+        return false;
+    }
+
+    BundleReader reader(tableData.data(), tableData.size());
+
+    std::unordered_map<std::string, TableEntry> contents;
+    for (uint32_t index = 0; index < presetCount; index++)
+    {
+        std::string presetFilename;
+        TableEntry entry;
+        uint64_t modifiedTime{};
+        if (!reader.ReadString(presetFilename) ||
+            !reader.ReadUInt64(entry.sourceSize) ||
+            !reader.ReadUInt64(modifiedTime) ||
+            !reader.ReadUInt64(entry.offset) ||
+            !reader.ReadUInt64(entry.size) ||
+            entry.offset > bundleSize || entry.size > bundleSize - entry.offset)
+        {
+            LOG_ERROR("[PresetBundle] Preset bundle \"" + bundleFilename + "\" has a damaged table of contents.");
+            return false;
+        }
+
+        entry.sourceModifiedTime = static_cast<int64_t>(modifiedTime);
+        contents.emplace(std::move(presetFilename), entry);
+    }
+
+    m_filename = bundleFilename;
+    m_contents = std::move(contents);
+
+    LOG_DEBUG("[PresetBundle] Opened preset bundle \"" + bundleFilename + "\" with " + std::to_string(m_contents.size()) + " presets.");
+
+    return true;
+}
+
+auto PresetBundle::Contains(const std::string& presetFilename) const -> bool
+{
+    return m_contents.find(presetFilename) != m_contents.end();
+}
+
+auto PresetBundle::Load(const std::string& presetFilename, PrecompiledPreset& preset) const -> bool
+{
+    auto tableEntry = m_contents.find(presetFilename);
+    if (tableEntry == m_contents.end())
+    {
+        return false;
+    }
+
+    const auto& entry = tableEntry->second;
+
+    // If the source file is gone, the bundled copy is all we have.
+    uint64_t sourceSize{};
+    int64_t sourceModifiedTime{};
+    if (Utils::GetFileInfo(presetFilename, sourceSize, sourceModifiedTime) &&
+        (sourceSize != entry.sourceSize || sourceModifiedTime != entry.sourceModifiedTime))
+    {
+        LOG_DEBUG("[PresetBundle] Bundled preset \"" + presetFilename + "\" is stale, loading source file.");
+        return false;
+    }
+
+    std::ifstream file(m_filename, std::ios::binary);
+    std::vector<char> data(static_cast<size_t>(entry.size));
+    if (!file.seekg(static_cast<std::streamoff>(entry.offset)) ||
+        !file.read(data.data(), static_cast<std::streamsize>(data.size())))
+    {
+        LOG_ERROR("[PresetBundle] Could not read preset \"" + presetFilename + "\" from bundle \"" + m_filename + "\".");
+        return false;
+    }
+
+    BundleReader reader(data.data(), data.size());
+    PrecompiledPreset loadedPreset;
+
+    std::string values;
+    uint32_t codeCount{};
+    bool valid = reader.ReadString(values) && reader.ReadUInt32(codeCount);
+    for (uint32_t index = 0; valid && index < codeCount; index++)
+    {
+        std::string prefix;
+        std::string code;
+        valid = reader.ReadString(prefix) && reader.ReadString(code);
+        loadedPreset.code.emplace_back(std::move(prefix), std::move(code));
+    }
+    valid = valid &&
+            reader.ReadShader(loadedPreset.warpShader) &&
+            reader.ReadShader(loadedPreset.compositeShader) &&
+            reader.AtEnd();
+
+    if (!valid)
+    {
+        LOG_ERROR("[PresetBundle] Data of preset \"" + presetFilename + "\" in bundle \"" + m_filename + "\" is damaged.");
+        return false;
+    }
+
+    loadedPreset.values.assign(values.begin(), values.end());
+    preset = std::move(loadedPreset);
+
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief Precompiles the contents of a parsed preset.
+ * @param parser The parser with the preset data.
+ * @param presetName The preset name used in log messages.
+ * @return The precompiled preset.
+ */
+auto PrecompileParsedPreset(PresetFileParser& parser, const std::string& presetName) -> PrecompiledPreset
+{
+    // Only used in debug log messages.
+    static_cast<void>(presetName);
+
+    PrecompiledPreset preset;
+
+    // Store code blocks assembled, and all other values as they are.
+    for (const auto& value : parser.PresetValues())
+    {
+        if (IsCodeLine(value.first))
+        {
+            continue;
+        }
+
+        preset.values.insert(preset.values.end(), value.first.begin(), value.first.end());
+        preset.values.push_back('=');
+        preset.values.insert(preset.values.end(), value.second.begin(), value.second.end());
+        preset.values.push_back('\n');
+    }
+
+    for (const auto& codeBlock : PresetFileParser::CodeBlocks())
+    {
+        auto code = parser.GetCode(codeBlock.keyPrefix);
+        if (!code.empty())
+        {
+            preset.code.emplace_back(codeBlock.keyPrefix, std::move(code));
+        }
+    }
+
+    int warpShaderVersion{2};
+    int compositeShaderVersion{2};
+    parser.GetShaderVersions(parser.GetInt("MILKDROP_PRESET_VERSION", 100), warpShaderVersion, compositeShaderVersion);
+
+    const auto warpShader = parser.GetCode("warp_");
+    if (warpShaderVersion > 0 && !warpShader.empty())
+    {
+        try
+        {
+            preset.warpShader = MilkdropShader::Precompile(MilkdropShader::ShaderType::WarpShader, warpShader);
+        }
+        catch (Renderer::ShaderException& ex)
+        {
+            LOG_DEBUG("[PresetBundle] Could not precompile warp shader of \"" + presetName + "\": " + ex.message());
+        }
+    }
+
+    const auto compositeShader = parser.GetCode("comp_");
+    if (compositeShaderVersion > 0 && !compositeShader.empty())
+    {
+        try
+        {
+            preset.compositeShader = MilkdropShader::Precompile(MilkdropShader::ShaderType::CompositeShader, compositeShader);
+        }
+        catch (Renderer::ShaderException& ex)
+        {
+            LOG_DEBUG("[PresetBundle] Could not precompile composite shader of \"" + presetName + "\": " + ex.message());
+        }
+    }
+
+    return preset;
+}
+
+} // namespace
+
+auto PresetBundle::Precompile(const std::string& presetFilename) -> PrecompiledPreset
+{
+    PresetFileParser parser;
+    if (!parser.Read(presetFilename))
+    {
+        throw MilkdropPresetLoadException("[PresetBundle] Could not parse preset file \"" + presetFilename + "\".");
+    }
+
+    return PrecompileParsedPreset(parser, presetFilename);
+}
+
+auto PresetBundle::Precompile(std::istream& presetData) -> PrecompiledPreset
+{
+    PresetFileParser parser;
+    if (!parser.Read(presetData))
+    {
+        throw MilkdropPresetLoadException("[PresetBundle] Could not parse preset data.");
+    }
+
+    return PrecompileParsedPreset(parser, "stream");
+}
+
+auto PresetBundle::Write(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename) -> uint32_t
+{
+    struct BundledPreset {
+        std::string filename;
+        uint64_t sourceSize{0};
+        int64_t sourceModifiedTime{0};
+        std::string data;
+    };
+
+    std::vector<BundledPreset> bundledPresets;
+    for (const auto& presetFilename : presetFilenames)
+    {
+        BundledPreset bundledPreset;
+        bundledPreset.filename = presetFilename;
+        if (!Utils::GetFileInfo(presetFilename, bundledPreset.sourceSize, bundledPreset.sourceModifiedTime))
+        {
+            LOG_WARN("[PresetBundle] Skipping preset \"" + presetFilename + "\": Not a regular file.");
+            continue;
+        }
+
+        PrecompiledPreset preset;
+        try
+        {
+            preset = Precompile(presetFilename);
+        }
+        catch (MilkdropPresetLoadException& ex)
+        {
+            LOG_WARN("[PresetBundle] Skipping preset: " + ex.message());
+            continue;
+        }
+
+        auto& data = bundledPreset.data;
+        WriteString(data, std::string(preset.values.begin(), preset.values.end()));
+        WriteUInt32(data, static_cast<uint32_t>(preset.code.size()));
+        for (const auto& code : preset.code)
+        {
+            WriteString(data, code.first);
+            WriteString(data, code.second);
+        }
+        WriteShader(data, preset.warpShader);
+        WriteShader(data, preset.compositeShader);
+
+        bundledPresets.push_back(std::move(bundledPreset));
+    }
+
+    std::string header(BundleMagic, sizeof(BundleMagic));
+    WriteUInt32(header, FormatVersion);
+    WriteUInt32(header, static_cast<uint32_t>(bundledPresets.size()));
+
+    // Calculate the table size first, as it determines the data offsets.
+    uint64_t tableSize{0};
+    for (const auto& bundledPreset : bundledPresets)
+    {
+        tableSize += 4 + bundledPreset.filename.size() + 4 * 8;
+    }
+    WriteUInt64(header, tableSize);
+
+    std::string table;
+    uint64_t offset = header.size() + tableSize;
+    for (const auto& bundledPreset : bundledPresets)
+    {
+        WriteString(table, bundledPreset.filename);
+        WriteUInt64(table, bundledPreset.sourceSize);
+        WriteUInt64(table, static_cast<uint64_t>(bundledPreset.sourceModifiedTime));
+        WriteUInt64(table, offset);
+        WriteUInt64(table, bundledPreset.data.size());
+        offset += bundledPreset.data.size();
+    }
+
+    // Write to a temporary file first, so an existing bundle is only replaced by a complete one.
+    const std::string temporaryFilename = bundleFilename + ".tmp";
+    {
+        std::ofstream file(temporaryFilename, std::ios::binary | std::ios::trunc);
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(table.data(), static_cast<std::streamsize>(table.size()));
+        for (const auto& bundledPreset : bundledPresets)
+        {
+            file.write(bundledPreset.data.data(), static_cast<std::streamsize>(bundledPreset.data.size()));
+        }
+
+        file.close();
+        if (!file.good())
+        {
+            RemoveFile(temporaryFilename);
+            throw std::runtime_error("[PresetBundle] Could not write preset bundle \"" + bundleFilename + "\".");
+        }
+    }
+
+    try
+    {
+        rename(temporaryFilename, bundleFilename);
+    }
+    catch (std::exception&)
+    {
+        RemoveFile(temporaryFilename);
+        throw std::runtime_error("[PresetBundle] Could not replace preset bundle \"" + bundleFilename + "\".");
+    }
+
+    return static_cast<uint32_t>(bundledPresets.size());
+}
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
@@ -0,0 +1,129 @@
+/**
+ * @file PresetBundle.hpp
+ * @brief Reads and writes files containing many precompiled Milkdrop presets.
+ */
+#pragma once
+
+#include "MilkdropShader.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+
+/**
+ * @brief Preset data which can be loaded without any text processing.
+ */
+struct PrecompiledPreset {
+    std::vector<char> values;                               //!< All values except code lines as "key=value" lines, ready for PresetFileParser::ReadData().
+    std::vector<std::pair<std::string, std::string>> code;  //!< Assembled code blocks as prefix/code pairs.
+    MilkdropShader::Precompiled warpShader;                 //!< The precompiled warp shader. Empty if not used or not translatable.
+    MilkdropShader::Precompiled compositeShader;            //!< The precompiled composite shader. Empty if not used or not translatable.
+};
+
+/**
+ * @brief A file containing many precompiled Milkdrop presets.
+ *
+ * Each preset is stored with its parsed values, the assembled code blocks and the preprocessed and
+ * translated warp and composite shaders. The size and modification time of the source file are
+ * recorded as well. If the source file was changed afterwards, the bundled preset is considered
+ * stale and won't be loaded, so the preset is loaded from the .milk file as usual.
+ *
+ * File layout, all integers are stored little-endian and strings as an uint32 length followed by
+ * the characters:
+ * - Header: the 8 characters "PMBUNDLE", the uint32 format version, the uint32 preset count and
+ *   the uint64 size of the table of contents.
+ * - Table of contents: for each preset the filename, the uint64 source file size, the int64 source
+ *   modification time, and the uint64 offset and size of the preset data.
+ * - The preset data blocks.
+ *
+ * Opening a bundle only reads the table of contents. Preset data is read from the file on demand.
+ */
+class PresetBundle
+{
+public:
+    static constexpr uint32_t FormatVersion = 1; //!< Current bundle format version.
+
+    /**
+     * @brief Reads the table of contents of a bundle file.
+     * @param bundleFilename The bundle file to open.
+     * @return True if the bundle was opened, false if it can't be read or has an unsupported format.
+     */
+    auto Open(const std::string& bundleFilename) -> bool;
+
+    /**
+     * @brief Returns whether the bundle contains the given preset, regardless of its source file state.
+     * @param presetFilename The preset filename as passed to Write().
+     * @return True if the preset is in the bundle, false if not.
+     */
+    auto Contains(const std::string& presetFilename) const -> bool;
+
+    /**
+     * @brief Reads a precompiled preset from the bundle.
+     *
+     * Safe to call from multiple threads, as each call reads the data with its own file stream.
+     *
+     * @param presetFilename The preset filename as passed to Write().
+     * @param preset [out] Receives the precompiled preset data.
+     * @return True if the preset was loaded, false if it's not in the bundle, the source file was
+     *         changed or the data couldn't be read.
+     */
+    auto Load(const std::string& presetFilename, PrecompiledPreset& preset) const -> bool;
+
+    /**
+     * @brief Parses a preset file and precompiles all code and shaders.
+     *
+     * Doesn't use any OpenGL functions. Shaders which can't be translated are left empty and will
+     * be processed as usual when the preset is loaded.
+     *
+     * @throws MilkdropPresetLoadException Thrown if the preset file can't be read or parsed.
+     * @param presetFilename The preset file to compile.
+     * @return The precompiled preset.
+     */
+    static auto Precompile(const std::string& presetFilename) -> PrecompiledPreset;
+
+    /**
+     * @brief Parses preset data from a stream and precompiles all code and shaders.
+     *
+     * Same as the file-based overload, e.g. used to prepare built-in presets on a worker thread.
+     *
+     * @throws MilkdropPresetLoadException Thrown if the preset data can't be parsed.
+     * @param presetData The stream with the preset file contents.
+     * @return The precompiled preset.
+     */
+    static auto Precompile(std::istream& presetData) -> PrecompiledPreset;
+
+    /**
+     * @brief Precompiles the given presets and writes them into a new bundle file.
+     *
+     * Presets which can't be parsed are skipped and will be loaded from the source file.
+     *
+     * @throws std::runtime_error Thrown if the bundle file can't be written.
+     * @param presetFilenames The preset files to add.
+     * @param bundleFilename The bundle file to write. Will be overwritten if it exists.
+     * @return The number of presets written to the bundle.
+     */
+    static auto Write(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename) -> uint32_t;
+
+private:
+    /**
+     * A single table of contents entry.
+     */
+    struct TableEntry {
+        uint64_t sourceSize{0};       //!< Size of the source file when the bundle was written.
+        int64_t sourceModifiedTime{0}; //!< Modification time of the source file when the bundle was written.
+        uint64_t offset{0};           //!< Offset of the preset data in the bundle file.
+        uint64_t size{0};             //!< Size of the preset data in bytes.
+    };
+
+    std::string m_filename;                                   //!< The bundle filename.
+    std::unordered_map<std::string, TableEntry> m_contents; //!< The table of contents, keyed by preset filename.
+};
+
+} // namespace MilkdropPreset
+} // namespace libprojectM
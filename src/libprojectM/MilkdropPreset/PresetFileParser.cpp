@@ -1,13 +1,80 @@
 #include "PresetFileParser.hpp"
 
+#include "Constants.hpp"
+
 #include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <fstream>
-#include <sstream>
-#include <vector>
+#include <utility>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
+namespace {
+
+constexpr size_t InitialSlotCount = 256; //!< Initial hash table size, enough for most presets. Must be a power of two.
+constexpr size_t MaxCodeLineDigits = 5;  //!< Maximum number of digits in a code line number, as in Milkdrop.
+
+/**
+ * @brief Converts ASCII letters A-Z to lower-case, leaving all other characters as-is.
+ */
+inline auto ToLowerChar(char character) -> char
+{
+    return (character >= 'A' && character <= 'Z') ? static_cast<char>(character - 'A' + 'a') : character;
+}
+
+/**
+ * @brief Calculates a case-insensitive FNV-1a hash.
+ */
+inline auto HashKey(const char* key, size_t length) -> size_t
+{
+    uint32_t hash = 2166136261U;
+    for (size_t index = 0; index < length; index++)
+    {
+        hash ^= static_cast<unsigned char>(ToLowerChar(key[index]));
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+} // namespace
+
+auto PresetFileParser::CodeBlocks() -> const std::vector<CodeBlock>&
+{
+    static const std::vector<CodeBlock> codeBlocks = [] {
+        std::vector<CodeBlock> blocks{
+            {CodeBlockType::PerFrameInit, 0, "per_frame_init_", "per-frame init", false},
+            {CodeBlockType::PerFrame, 0, "per_frame_", "per-frame", false},
+            {CodeBlockType::PerPixel, 0, "per_pixel_", "per-pixel", false}};
+
+        for (int i = 0; i < CustomWaveformCount; i++)
+        {
+            const std::string wavePrefix = "wave_" + std::to_string(i) + "_";
+            const std::string waveName = "custom wave " + std::to_string(i);
+            blocks.push_back({CodeBlockType::CustomWaveInit, i, wavePrefix + "init", waveName + " init", false});
+            blocks.push_back({CodeBlockType::CustomWavePerFrame, i, wavePrefix + "per_frame", waveName + " per-frame", false});
+            blocks.push_back({CodeBlockType::CustomWavePerPoint, i, wavePrefix + "per_point", waveName + " per-point", false});
+        }
+
+        for (int i = 0; i < CustomShapeCount; i++)
+        {
+            const std::string shapePrefix = "shape_" + std::to_string(i) + "_";
+            const std::string shapeName = "custom shape " + std::to_string(i);
+            blocks.push_back({CodeBlockType::CustomShapeInit, i, shapePrefix + "init", shapeName + " init", false});
+            blocks.push_back({CodeBlockType::CustomShapePerFrame, i, shapePrefix + "per_frame", shapeName + " per-frame", false});
+        }
+
+        blocks.push_back({CodeBlockType::WarpShader, 0, "warp_", "warp shader", true});
+        blocks.push_back({CodeBlockType::CompositeShader, 0, "comp_", "composite shader", true});
+
+        return blocks;
+    }();
+
+    return codeBlocks;
+}
+
 auto PresetFileParser::Read(const std::string& presetFile) -> bool
 {
     std::ifstream presetStream(presetFile.c_str(), std::ios_base::in | std::ios_base::binary);
@@ -38,106 +105,130 @@ auto PresetFileParser::Read(std::istream& presetStream) -> bool
         return false;
     }
 
-    size_t startPos{0}; //!< Starting position of current line
-    size_t pos{0};      //!< Current read position
-
-    auto parseLineIfDataAvailable = [this, &pos, &startPos, &presetFileContents]() {
-        if (pos > startPos)
-        {
-            auto beg = presetFileContents.begin();
-            std::string line(beg + startPos, beg + pos);
-            ParseLine(line);
-        }
-    };
+    return ReadData(std::move(presetFileContents));
+}
 
-    while (pos < presetFileContents.size())
+auto PresetFileParser::ReadData(std::vector<char> presetData) -> bool
+{
+    if (presetData.size() > maxFileSize)
     {
-        switch (presetFileContents[pos])
-        {
-            case '\r':
-            case '\n':
-                // EOL, skip over CRLF
-                parseLineIfDataAvailable();
-                startPos = pos + 1;
-                break;
-
-            case '\0':
-                // Null char is not expected. Could be a random binary file.
-                return false;
-        }
-
-        ++pos;
+        return false;
     }
 
-    parseLineIfDataAvailable();
+    // Terminate the last value.
+    presetData.push_back('\0');
+    m_buffer = std::move(presetData);
 
-    return !m_presetValues.empty();
+    return Parse();
 }
 
 auto PresetFileParser::GetCode(const std::string& keyPrefix) const -> std::string
 {
-    auto lowerKey = ToLower(keyPrefix);
+    if (!m_assembledCode.empty())
+    {
+        std::string lowerCasePrefix(keyPrefix);
+        std::transform(lowerCasePrefix.begin(), lowerCasePrefix.end(), lowerCasePrefix.begin(), ToLowerChar);
 
-    std::stringstream code;                        //!< The parsed code
-    std::string key(lowerKey.length() + 5, '\0'); //!< Allocate a string that can hold up to 5 digits.
+        auto assembledCode = m_assembledCode.find(lowerCasePrefix);
+        if (assembledCode != m_assembledCode.end())
+        {
+            return assembledCode->second;
+        }
+    }
+
+    auto slot = FindSlot(m_codeGroupSlots, m_codeGroups, keyPrefix.c_str(), keyPrefix.length());
+    if (m_codeGroupSlots.empty() || m_codeGroupSlots[slot] == 0)
+    {
+        return {};
+    }
 
-    key.replace(0, lowerKey.length(), lowerKey);
+    const auto& lines = m_codeGroups[m_codeGroupSlots[slot] - 1].lines;
 
-    for (int index{1}; index <= 99999; ++index)
+    size_t codeLength{0};
+    for (auto entryIndex : lines)
     {
-        key.replace(lowerKey.length(), 5, std::to_string(index));
-        if (m_presetValues.find(key) == m_presetValues.end())
+        if (entryIndex == 0)
         {
             break;
         }
+        codeLength += m_entries[entryIndex - 1].value.length + 1;
+    }
 
-        auto line = m_presetValues.at(key);
+    std::string code;
+    code.reserve(codeLength);
+
+    // Lines are appended until the first gap in numbering.
+    for (auto entryIndex : lines)
+    {
+        if (entryIndex == 0)
+        {
+            break;
+        }
+
+        const auto& value = m_entries[entryIndex - 1].value;
+        const char* line = m_buffer.data() + value.offset;
+        size_t length = value.length;
 
         // Remove backtick char in shader code
-        if (!line.empty() && line.at(0) == '`')
+        if (length > 0 && line[0] == '`')
         {
-            line.erase(0, 1);
+            line++;
+            length--;
         }
-        code << line << std::endl;
+
+        code.append(line, length);
+        code.push_back('\n');
     }
 
-    auto codeStr = code.str();
+    return code;
+}
+
+void PresetFileParser::SetCode(const std::string& keyPrefix, std::string code)
+{
+    std::string lowerCasePrefix(keyPrefix);
+    std::transform(lowerCasePrefix.begin(), lowerCasePrefix.end(), lowerCasePrefix.begin(), ToLowerChar);
 
-    return codeStr;
+    m_assembledCode[lowerCasePrefix] = std::move(code);
 }
 
 auto PresetFileParser::GetInt(const std::string& key, int defaultValue) -> int
 {
-    auto lowerKey = ToLower(key);
-    if (m_presetValues.find(lowerKey) != m_presetValues.end())
+    const auto* value = FindValue(key);
+    if (value == nullptr)
     {
-        try
-        {
-            return std::stoi(m_presetValues.at(lowerKey));
-        }
-        catch (std::logic_error&)
-        {
-        }
+        return defaultValue;
     }
 
-    return defaultValue;
+    // Same conversion rules as std::stoi(), but without exceptions or copying the value.
+    char* end{nullptr};
+    errno = 0;
+    long number = std::strtol(value, &end, 10);
+    if (end == value || errno == ERANGE || number < INT_MIN || number > INT_MAX)
+    {
+        return defaultValue;
+    }
+
+    return static_cast<int>(number);
 }
 
 auto PresetFileParser::GetFloat(const std::string& key, float defaultValue) -> float
 {
-    auto lowerKey = ToLower(key);
-    if (m_presetValues.find(lowerKey) != m_presetValues.end())
+    const auto* value = FindValue(key);
+    if (value == nullptr)
     {
-        try
-        {
-            return std::stof(m_presetValues.at(lowerKey));
-        }
-        catch (std::logic_error&)
-        {
-        }
+        return defaultValue;
     }
 
-    return defaultValue;
+    // Same conversion rules as std::stof(), but without exceptions or copying the value.
+    char* end{nullptr};
+    errno = 0;
+    float number = std::strtof(value, &end);
+    if (end == value || errno == ERANGE)
+    {
+        return defaultValue;
+    }
+
+    return number;
 }
 
 auto PresetFileParser::GetBool(const std::string& key, bool defaultValue) -> bool
@@ -147,49 +238,252 @@ auto PresetFileParser::GetBool(const std::string& key, bool defaultValue) -> boo
 
 auto PresetFileParser::GetString(const std::string& key, const std::string& defaultValue) -> std::string
 {
-    auto lowerKey = ToLower(key);
-    if (m_presetValues.find(lowerKey) != m_presetValues.end())
+    const auto* value = FindValue(key);
+    if (value == nullptr)
     {
-        return m_presetValues.at(lowerKey);
+        return defaultValue;
     }
 
-    return defaultValue;
+    return value;
 }
 
-const std::map<std::string, std::string>& PresetFileParser::PresetValues() const
+void PresetFileParser::GetShaderVersions(int presetVersion, int& warpShaderVersion, int& compositeShaderVersion)
 {
+    if (presetVersion < 200)
+    {
+        // Milkdrop 1.x did not use shaders.
+        warpShaderVersion = 0;
+        compositeShaderVersion = 0;
+    }
+    else if (presetVersion == 200)
+    {
+        // Milkdrop 2.0 only supported a single shader language level variable.
+        warpShaderVersion = GetInt("PSVERSION", warpShaderVersion);
+        compositeShaderVersion = GetInt("PSVERSION", compositeShaderVersion);
+    }
+    else
+    {
+        warpShaderVersion = GetInt("PSVERSION_WARP", warpShaderVersion);
+        compositeShaderVersion = GetInt("PSVERSION_COMP", compositeShaderVersion);
+    }
+}
+
+auto PresetFileParser::PresetValues() const -> const ValueMap&
+{
+    if (!m_presetValuesValid)
+    {
+        m_presetValues.clear();
+        for (const auto& entry : m_entries)
+        {
+            m_presetValues.emplace(std::string(m_buffer.data() + entry.key.offset, entry.key.length),
+                                   std::string(m_buffer.data() + entry.value.offset, entry.value.length));
+        }
+        m_presetValuesValid = true;
+    }
+
     return m_presetValues;
 }
 
-void PresetFileParser::ParseLine(const std::string& line)
+auto PresetFileParser::Parse() -> bool
+{
+    m_entries.clear();
+    m_entrySlots.assign(InitialSlotCount, 0);
+    m_codeGroups.clear();
+    m_codeGroupSlots.assign(InitialSlotCount, 0);
+    m_assembledCode.clear();
+    m_presetValuesValid = false;
+
+    // The buffer has an additional null character at the end.
+    auto dataSize = static_cast<uint32_t>(m_buffer.size() - 1);
+
+    uint32_t startPos{0}; //!< Starting position of current line
+
+    for (uint32_t pos = 0; pos < dataSize; ++pos)
+    {
+        switch (m_buffer[pos])
+        {
+            case '\r':
+            case '\n':
+                // EOL, skip over CRLF. Terminating the line makes each value a C string.
+                m_buffer[pos] = '\0';
+                if (pos > startPos)
+                {
+                    ParseLine(startPos, pos);
+                }
+                startPos = pos + 1;
+                break;
+
+            case '\0':
+                // Null char is not expected. Could be a random binary file.
+                return false;
+        }
+    }
+
+    if (dataSize > startPos)
+    {
+        ParseLine(startPos, dataSize);
+    }
+
+    return !m_entries.empty();
+}
+
+void PresetFileParser::ParseLine(uint32_t start, uint32_t end)
 {
     // Search for first delimiter, either space or equal
-    auto varNameDelimiterPos = line.find_first_of(" =");
+    auto delimiterPos = start;
+    while (delimiterPos < end && m_buffer[delimiterPos] != ' ' && m_buffer[delimiterPos] != '=')
+    {
+        delimiterPos++;
+    }
 
-    if (varNameDelimiterPos == std::string::npos || varNameDelimiterPos == 0)
+    if (delimiterPos == end || delimiterPos == start)
     {
         // Empty line, delimiter at start of line or no delimiter found, skip.
         return;
     }
 
     // Convert key to lower case, as INI functions are not case-sensitive.
-    std::string varName(ToLower(std::string(line.begin(), line.begin() + varNameDelimiterPos)));
-    std::string value(line.begin() + varNameDelimiterPos + 1, line.end());
+    for (auto pos = start; pos < delimiterPos; pos++)
+    {
+        m_buffer[pos] = ToLowerChar(m_buffer[pos]);
+    }
+
+    Entry entry;
+    entry.key = {start, delimiterPos - start};
+    entry.value = {delimiterPos + 1, end - delimiterPos - 1};
 
     // Only add first occurrence to mimic Milkdrop behaviour
-    if (!varName.empty() && m_presetValues.find(varName) == m_presetValues.end())
+    auto slot = FindSlot(m_entrySlots, m_entries, m_buffer.data() + start, entry.key.length);
+    if (m_entrySlots[slot] != 0)
     {
-        m_presetValues.emplace(std::move(varName), std::move(value));
+        return;
     }
+
+    m_entries.push_back(entry);
+    InsertSlot(m_entrySlots, m_entries, slot);
+
+    AddCodeLine(static_cast<uint32_t>(m_entries.size() - 1));
 }
 
-auto PresetFileParser::ToLower(std::string str) -> std::string
+void PresetFileParser::AddCodeLine(uint32_t entryIndex)
 {
-    std::transform(str.begin(), str.end(), str.begin(),
-                   [](unsigned char c){ return std::tolower(c); }
-    );
+    const auto& key = m_entries[entryIndex].key;
+    const char* keyData = m_buffer.data() + key.offset;
+
+    size_t digits{0};
+    while (digits < key.length && keyData[key.length - digits - 1] >= '0' && keyData[key.length - digits - 1] <= '9')
+    {
+        digits++;
+    }
+
+    // GetCode() only looks for line numbers from 1 to 99999 without leading zeros.
+    if (digits == 0 || digits > MaxCodeLineDigits || keyData[key.length - digits] == '0')
+    {
+        return;
+    }
+
+    size_t lineNumber{0};
+    for (size_t index = key.length - digits; index < key.length; index++)
+    {
+        lineNumber = lineNumber * 10 + static_cast<size_t>(keyData[index] - '0');
+    }
+
+    auto prefixLength = static_cast<uint32_t>(key.length - digits);
+    auto slot = FindSlot(m_codeGroupSlots, m_codeGroups, keyData, prefixLength);
+    if (m_codeGroupSlots[slot] == 0)
+    {
+        CodeGroup group;
+        group.key = {key.offset, prefixLength};
+        m_codeGroups.push_back(std::move(group));
+        InsertSlot(m_codeGroupSlots, m_codeGroups, slot);
+        slot = FindSlot(m_codeGroupSlots, m_codeGroups, keyData, prefixLength);
+    }
+
+    auto& lines = m_codeGroups[m_codeGroupSlots[slot] - 1].lines;
+    if (lines.size() < lineNumber)
+    {
+        lines.resize(lineNumber, 0);
+    }
+    lines[lineNumber - 1] = entryIndex + 1;
+}
+
+auto PresetFileParser::FindValue(const std::string& key) const -> const char*
+{
+    if (m_entrySlots.empty())
+    {
+        return nullptr;
+    }
+
+    auto slot = FindSlot(m_entrySlots, m_entries, key.c_str(), key.length());
+    if (m_entrySlots[slot] == 0)
+    {
+        return nullptr;
+    }
+
+    return m_buffer.data() + m_entries[m_entrySlots[slot] - 1].value.offset;
+}
+
+template<typename ItemType>
+auto PresetFileParser::FindSlot(const std::vector<uint32_t>& slots, const std::vector<ItemType>& items,
+                                const char* key, size_t length) const -> size_t
+{
+    if (slots.empty())
+    {
+        return 0;
+    }
+
+    const size_t mask = slots.size() - 1;
+    size_t slot = HashKey(key, length) & mask;
+
+    // Linear probing. The table is never more than half full, so there's always an empty slot.
+    while (slots[slot] != 0)
+    {
+        const auto& itemKey = items[slots[slot] - 1].key;
+        if (itemKey.length == length)
+        {
+            const char* itemKeyData = m_buffer.data() + itemKey.offset;
+            size_t index{0};
+            while (index < length && itemKeyData[index] == ToLowerChar(key[index]))
+            {
+                index++;
+            }
+            if (index == length)
+            {
+                return slot;
+            }
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+template<typename ItemType>
+void PresetFileParser::InsertSlot(std::vector<uint32_t>& slots, const std::vector<ItemType>& items, size_t slot)
+{
+    slots[slot] = static_cast<uint32_t>(items.size());
+
+    if (items.size() * 2 <= slots.size())
+    {
+        return;
+    }
+
+    // Grow and rehash. Keys are unique, so each item goes into the first free slot.
+    std::vector<uint32_t> newSlots(slots.size() * 2, 0);
+    const size_t mask = newSlots.size() - 1;
+    for (size_t index = 0; index < items.size(); index++)
+    {
+        const auto& key = items[index].key;
+        size_t newSlot = HashKey(m_buffer.data() + key.offset, key.length) & mask;
+        while (newSlots[newSlot] != 0)
+        {
+            newSlot = (newSlot + 1) & mask;
+        }
+        newSlots[newSlot] = static_cast<uint32_t>(index + 1);
+    }
 
-    return str;
+    slots = std::move(newSlots);
 }
 
 } // namespace MilkdropPreset
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <istream>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -12,8 +15,12 @@ namespace MilkdropPreset {
  * Reads in the file as key/value pairs, where the key is either separated from the value by an equal sign or a space.
  * Lines not matching this pattern are simply ignored, e.g. the [preset00] INI section.
  *
+ * The file is read into a single buffer and scanned once. Keys and values are stored as offsets into this buffer in
+ * a flat open-addressing hash table, and numbered code lines (e.g. "per_frame_1" to "per_frame_N") are grouped by
+ * their prefix during the scan. Lookups are case-insensitive and don't allocate memory.
+ *
  * Values and code blocks can easily be accessed via the helper functions. It is also possible to access the parsed
- * map contents directly if required.
+ * values as a map if required.
  */
 class PresetFileParser
 {
@@ -22,6 +29,43 @@ public:
 
     static constexpr size_t maxFileSize = 0x100000; //!< Maximum size of a preset file. Used for sanity checks.
 
+    /**
+     * @brief Kinds of code blocks in a Milkdrop preset file.
+     */
+    enum class CodeBlockType : uint8_t
+    {
+        PerFrameInit,        //!< Per-frame init expression code.
+        PerFrame,            //!< Per-frame expression code.
+        PerPixel,            //!< Per-pixel (per-vertex) expression code.
+        CustomWaveInit,      //!< Custom waveform init expression code.
+        CustomWavePerFrame,  //!< Custom waveform per-frame expression code.
+        CustomWavePerPoint,  //!< Custom waveform per-point expression code.
+        CustomShapeInit,     //!< Custom shape init expression code.
+        CustomShapePerFrame, //!< Custom shape per-frame expression code.
+        WarpShader,          //!< Warp shader HLSL code.
+        CompositeShader      //!< Composite shader HLSL code.
+    };
+
+    /**
+     * @brief A block of numbered code lines in a Milkdrop preset file.
+     */
+    struct CodeBlock {
+        CodeBlockType type{CodeBlockType::PerFrame}; //!< The kind of code in this block.
+        int index{0};                                //!< Custom waveform or shape index, 0 for all other blocks.
+        std::string keyPrefix;                       //!< The key prefix passed to GetCode(), e.g. "per_frame_".
+        std::string name;                            //!< Human-readable block name for messages, e.g. "custom wave 2 init".
+        bool isShader{false};                        //!< True for HLSL shader code, false for expression code.
+    };
+
+    /**
+     * @brief Returns all code blocks a Milkdrop preset file can contain.
+     *
+     * This is the only definition of the code block keys. It is used when loading, validating and bundling presets.
+     *
+     * @return A list of all code blocks, expression code first.
+     */
+    static auto CodeBlocks() -> const std::vector<CodeBlock>&;
+
     /**
      * @brief Reads the preset file into an internal map to prepare for parsing.
      * @return True if the file was parsed successfully, false if an error occurred or no line could be parsed.
@@ -34,6 +78,16 @@ public:
      */
     [[nodiscard]] auto Read(std::istream& presetStream) -> bool;
 
+    /**
+     * @brief Parses preset data which is already in memory.
+     *
+     * The parser takes ownership of the data and parses it in place, so no copy is made if the buffer is moved in.
+     *
+     * @param presetData The preset file contents.
+     * @return True if the data was parsed successfully, false if an error occurred or no line could be parsed.
+     */
+    [[nodiscard]] auto ReadData(std::vector<char> presetData) -> bool;
+
     /**
      * @brief Returns a block of code, ready for parsing or use in shader compilation.
      *
@@ -50,6 +104,17 @@ public:
      */
     [[nodiscard]] auto GetCode(const std::string& keyPrefix) const -> std::string;
 
+    /**
+     * @brief Stores an already assembled code block.
+     *
+     * Used when loading precompiled presets. GetCode() will return the stored code for this prefix instead of
+     * assembling it from the numbered lines. Call after reading the preset data.
+     *
+     * @param keyPrefix The key prefix of the code block.
+     * @param code The code, as returned by GetCode().
+     */
+    void SetCode(const std::string& keyPrefix, std::string code);
+
     /**
      * @brief Returns the given key value as an integer.
      *
@@ -101,32 +166,114 @@ public:
     [[nodiscard]] auto GetString(const std::string& key, const std::string& defaultValue) -> std::string;
 
     /**
-     * @brief Returns a reference to the internal value map.
-     * @return A reference to the internal value map.
+     * @brief Reads the warp and composite shader versions valid for the given preset version.
+     *
+     * Milkdrop 1.x presets have no shaders, so both versions are set to 0. Milkdrop 2.0 presets
+     * use PSVERSION for both shaders, later versions PSVERSION_WARP and PSVERSION_COMP.
+     *
+     * @param presetVersion The value of MILKDROP_PRESET_VERSION.
+     * @param warpShaderVersion [in,out] The default warp shader version, receives the parsed value.
+     * @param compositeShaderVersion [in,out] The default composite shader version, receives the parsed value.
+     */
+    void GetShaderVersions(int presetVersion, int& warpShaderVersion, int& compositeShaderVersion);
+
+    /**
+     * @brief Returns all parsed values as a map.
+     *
+     * The map is created on the first call, so this function should only be used for debugging and testing.
+     *
+     * @return A reference to the value map.
      */
     auto PresetValues() const -> const ValueMap&;
 
-protected:
+private:
+    /**
+     * A range of characters in the file buffer.
+     */
+    struct BufferRange {
+        uint32_t offset{0}; //!< Offset of the first character in the buffer.
+        uint32_t length{0}; //!< Number of characters.
+    };
+
+    /**
+     * A single key/value pair.
+     */
+    struct Entry {
+        BufferRange key;   //!< The lower-case key.
+        BufferRange value; //!< The value, followed by a null character in the buffer.
+    };
+
     /**
-     * @brief Parses a single line and stores the result in the value map.
+     * All numbered lines sharing the same key prefix.
+     */
+    struct CodeGroup {
+        BufferRange key;             //!< The lower-case key prefix.
+        std::vector<uint32_t> lines; //!< Entry index + 1 for each line number, starting at 1. 0 if the line is missing.
+    };
+
+    /**
+     * @brief Scans the buffer and fills the hash tables.
+     * @return True if the data was parsed successfully, false if an error occurred or no line could be parsed.
+     */
+    auto Parse() -> bool;
+
+    /**
+     * @brief Parses a single line and stores the result in the value table.
      *
      * The function doesn't really care about invalid lines with random text or comments. The first "word"
-     * is added as key to the map, but will not be used afterwards.
+     * is added as key to the table, but will not be used afterwards.
      *
-     * @param line The line to parse.
+     * @param start The buffer offset of the first character in the line.
+     * @param end The buffer offset after the last character in the line.
      */
-    void ParseLine(const std::string& line);
+    void ParseLine(uint32_t start, uint32_t end);
 
-private:
     /**
-     * @brief Converts the string to lower-case.
-     * Only letters A-Z are converted to a-z by default.
-     * @param str The original string.
-     * @return The lower-case string.
+     * @brief Adds a numbered line to its code group.
+     * @param entryIndex The index of the line's entry.
      */
-    static auto ToLower(std::string str) -> std::string;
+    void AddCodeLine(uint32_t entryIndex);
+
+    /**
+     * @brief Returns a null-terminated pointer to the value of the given key.
+     * @param key The key to look up, case-insensitive.
+     * @return A pointer to the value or nullptr if the key doesn't exist.
+     */
+    auto FindValue(const std::string& key) const -> const char*;
+
+    /**
+     * @brief Finds the slot of a key in a hash table.
+     * @tparam ItemType Item type with a "key" member of type BufferRange.
+     * @param slots The hash table slots, each containing an item index + 1 or 0 if unused.
+     * @param items The items referenced by the slots.
+     * @param key Pointer to the key characters. Compared case-insensitively.
+     * @param length The key length.
+     * @return The index of the slot containing the key, or of the empty slot where it should be inserted.
+     */
+    template<typename ItemType>
+    auto FindSlot(const std::vector<uint32_t>& slots, const std::vector<ItemType>& items,
+                  const char* key, size_t length) const -> size_t;
+
+    /**
+     * @brief Inserts an item into a hash table, growing it if required.
+     * @tparam ItemType Item type with a "key" member of type BufferRange.
+     * @param slots The hash table slots.
+     * @param items The items referenced by the slots. The new item must already be added as last element.
+     * @param slot The empty slot returned by FindSlot() for the new item.
+     */
+    template<typename ItemType>
+    void InsertSlot(std::vector<uint32_t>& slots, const std::vector<ItemType>& items, size_t slot);
+
+    std::vector<char> m_buffer;             //!< The preset file contents, modified in place during parsing.
+    std::vector<Entry> m_entries;           //!< All key/value pairs in file order.
+    std::vector<uint32_t> m_entrySlots;     //!< Hash table for m_entries.
+    std::vector<CodeGroup> m_codeGroups;    //!< All code line groups.
+    std::vector<uint32_t> m_codeGroupSlots; //!< Hash table for m_codeGroups.
+
+    std::map<std::string, std::string> m_assembledCode; //!< Preassembled code blocks, keyed by lower-case prefix.
 
-    ValueMap m_presetValues; //!< Map with preset keys and their value.
+    mutable ValueMap m_presetValues;          //!< Values as map, created on demand.
+    mutable bool m_presetValuesValid{false}; //!< True if m_presetValues is up to date.
 };
 
 } // namespace MilkdropPreset
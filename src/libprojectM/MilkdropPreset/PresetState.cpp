@@ -1,5 +1,6 @@
 #include "PresetState.hpp"
 
+#include "EvalMemoryPool.hpp"
 #include "MilkdropStaticShaders.hpp"
 #include "PresetFileParser.hpp"
 
@@ -8,6 +9,7 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <random>
+#include <utility>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -16,7 +18,7 @@ const glm::mat4 PresetState::orthogonalProjection = glm::ortho(-1.0f, 1.0f, 1.0f
 const glm::mat4 PresetState::orthogonalProjectionFlipped = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, -40.0f, 40.0f);
 
 PresetState::PresetState()
-    : globalMemory(projectm_eval_memory_buffer_create())
+    : globalMemory(EvalMemoryPool::Instance().Acquire())
 {
     std::random_device randomDevice;
     std::mt19937 randomGenerator(randomDevice());
@@ -30,7 +32,7 @@ PresetState::PresetState()
 
 PresetState::~PresetState()
 {
-    projectm_eval_memory_buffer_destroy(globalMemory);
+    EvalMemoryPool::Instance().Release(globalMemory);
 }
 
 void PresetState::Initialize(PresetFileParser& parsedFile)
@@ -115,49 +117,55 @@ void PresetState::Initialize(PresetFileParser& parsedFile)
 
     // Versions:
     presetVersion = parsedFile.GetInt("MILKDROP_PRESET_VERSION", presetVersion);
-    if (presetVersion < 200)
-    {
-        // Milkdrop 1.x did not use shaders.
-        warpShaderVersion = 0;
-        compositeShaderVersion = 0;
-    }
-    else if (presetVersion == 200)
-    {
-        // Milkdrop 2.0 only supported a single shader language level variable.
-        warpShaderVersion = parsedFile.GetInt("PSVERSION", warpShaderVersion);
-        compositeShaderVersion = parsedFile.GetInt("PSVERSION", compositeShaderVersion);
-    }
-    else
-    {
-        warpShaderVersion = parsedFile.GetInt("PSVERSION_WARP", warpShaderVersion);
-        compositeShaderVersion = parsedFile.GetInt("PSVERSION_COMP", compositeShaderVersion);
-    }
+    parsedFile.GetShaderVersions(presetVersion, warpShaderVersion, compositeShaderVersion);
 
     // Code:
-    perFrameInitCode = parsedFile.GetCode("per_frame_init_");
-    perFrameCode = parsedFile.GetCode("per_frame_");
-    perPixelCode = parsedFile.GetCode("per_pixel_");
-
-    // Custom waveform code:
-    for (int i = 0; i < CustomWaveformCount; i++)
+    for (const auto& codeBlock : PresetFileParser::CodeBlocks())
     {
-        std::string const wavePrefix = "wave_" + std::to_string(i) + "_";
-        customWaveInitCode[i] = parsedFile.GetCode(wavePrefix + "init");
-        customWavePerFrameCode[i] = parsedFile.GetCode(wavePrefix + "per_frame");
-        customWavePerPointCode[i] = parsedFile.GetCode(wavePrefix + "per_point");
+        auto code = parsedFile.GetCode(codeBlock.keyPrefix);
+        switch (codeBlock.type)
+        {
+            case PresetFileParser::CodeBlockType::PerFrameInit:
+                perFrameInitCode = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::PerFrame:
+                perFrameCode = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::PerPixel:
+                perPixelCode = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::CustomWaveInit:
+                customWaveInitCode[codeBlock.index] = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::CustomWavePerFrame:
+                customWavePerFrameCode[codeBlock.index] = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::CustomWavePerPoint:
+                customWavePerPointCode[codeBlock.index] = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::CustomShapeInit:
+                customShapeInitCode[codeBlock.index] = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::CustomShapePerFrame:
+                customShapePerFrameCode[codeBlock.index] = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::WarpShader:
+                warpShader = std::move(code);
+                break;
+
+            case PresetFileParser::CodeBlockType::CompositeShader:
+                compositeShader = std::move(code);
+                break;
+        }
     }
-
-    // Custom shape code:
-    for (int i = 0; i < CustomShapeCount; i++)
-    {
-        std::string const shapePrefix = "shape_" + std::to_string(i) + "_";
-        customShapeInitCode[i] = parsedFile.GetCode(shapePrefix + "init");
-        customShapePerFrameCode[i] = parsedFile.GetCode(shapePrefix + "per_frame");
-    }
-
-    // Shader code:
-    warpShader = parsedFile.GetCode("warp_");
-    compositeShader = parsedFile.GetCode("comp_");
 }
 
 void PresetState::LoadShaders()
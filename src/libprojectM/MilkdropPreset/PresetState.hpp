@@ -8,6 +8,7 @@
 #include "Constants.hpp"
 
 #include "BlurTexture.hpp"
+#include "MilkdropShader.hpp"
 
 #include <Audio/FrameAudioData.hpp>
 
@@ -132,7 +133,7 @@ public:
 
     std::array<float, 4> hueRandomOffsets; //!< Per-preset constant offsets for the hue animation
 
-    projectm_eval_mem_buffer globalMemory{nullptr};  //!< gmegabuf data. Using per-frame buffers in projectM to reduce interference.
+    projectm_eval_mem_buffer globalMemory{nullptr};  //!< gmegabuf data. Using per-frame buffers in projectM to reduce interference. Taken from EvalMemoryPool.
     double globalRegisters[100]{};                   //!< Global reg00-reg99 variables.
     std::array<double, QVarCount> frameQVariables{}; //!< Q variables after per-frame code evaluation.
 
@@ -153,6 +154,9 @@ public:
     std::string warpShader;      //!< Warp shader code.
     std::string compositeShader; //!< Composite shader code.
 
+    MilkdropShader::Precompiled precompiledWarpShader;      //!< Precompiled warp shader, if loaded from a preset bundle.
+    MilkdropShader::Precompiled precompiledCompositeShader; //!< Precompiled composite shader, if loaded from a preset bundle.
+
     std::weak_ptr<Renderer::Shader> untexturedShader; //!< Shader used to draw untextured primitives, e.g. waveforms.
     std::weak_ptr<Renderer::Shader> texturedShader;   //!< Shader used to draw textured primitives, e.g. textured shapes and the warp mesh.
 
@@ -0,0 +1,45 @@
+precision mediump float;
+
+in vec2 fragment_texture;
+
+uniform sampler2D texture_sampler;
+uniform vec4 _c0; // source texsize (.xy), and inverse (.zw)
+uniform vec4 _c1; // scale, bias, edge_darken_c1, edge_darken_c2
+uniform vec4 _c2; // edge_darken_c3, sample spread
+
+out vec4 color;
+
+void main(){
+    // SINGLE DOWNSAMPLING PASS:
+    #define srctexsize _c0
+    #define fscale _c1.x
+    #define fbias  _c1.y
+    #define edge_darken_c1 _c1.z
+    #define edge_darken_c2 _c1.w
+    #define edge_darken_c3 _c2.x
+    #define spread _c2.y
+
+    // Each bilinear sample placed between texels averages 2x2 source texels,
+    // so the 4x4 samples cover a box of 8x8 source texels (without spread).
+    vec3 blur = vec3(0.0);
+    for (int y = -3; y <= 3; y += 2)
+    {
+        for (int x = -3; x <= 3; x += 2)
+        {
+            blur += texture(texture_sampler, fragment_texture + vec2(float(x), float(y)) * spread * srctexsize.zw).xyz;
+        }
+    }
+    blur *= 1.0 / 16.0;
+
+    blur = blur * fscale + fbias;
+
+    // tone it down at the edges (only happens on the blur1 pass!)
+    float t = min(min(fragment_texture.x, fragment_texture.y),
+    1.0 - max(fragment_texture.x, fragment_texture.y));
+    t = sqrt(t);
+    t = edge_darken_c1 + edge_darken_c2 * clamp(t * edge_darken_c3, 0.0, 1.0);
+    blur *= t;
+
+    color.xyz = blur;
+    color.w = 1.0;
+}
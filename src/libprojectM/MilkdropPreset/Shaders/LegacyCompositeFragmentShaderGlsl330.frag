@@ -0,0 +1,41 @@
+// Video echo, gamma adjustment and the Milkdrop 1 filters in a single pass.
+// The active effects are enabled by prepending the VIDEO_ECHO, BRIGHTEN, DARKEN, SOLARIZE and INVERT defines.
+precision mediump float;
+
+in vec4 fragment_color;
+in vec2 fragment_texture;
+
+uniform sampler2D texture_sampler;
+uniform vec4 main_weight; // Gamma-adjusted color weight and, in alpha, the number of passes drawing the main image.
+uniform vec4 echo_weight; // Same for the echo image.
+uniform float echo_zoom;
+uniform vec2 echo_flip; // 1.0 to flip the echo image horizontally/vertically, 0.0 otherwise.
+
+out vec4 color;
+
+void main(){
+    vec4 result = main_weight * texture(texture_sampler, fragment_texture);
+
+#ifdef VIDEO_ECHO
+    vec2 echoUv = 0.5 + (fragment_texture - 0.5) / echo_zoom;
+    echoUv = mix(echoUv, 1.0 - echoUv, echo_flip);
+    result += echo_weight * texture(texture_sampler, echoUv);
+#endif
+
+    // All additive passes draw non-negative values, so clamping once equals clamping after each pass.
+    color = clamp(fragment_color * result, 0.0, 1.0);
+
+    // Filters, equivalent to drawing white quads with the blend modes used by Milkdrop.
+#ifdef BRIGHTEN
+    color = 1.0 - (1.0 - color) * (1.0 - color);
+#endif
+#ifdef DARKEN
+    color = color * color;
+#endif
+#ifdef SOLARIZE
+    color = 2.0 * color * (1.0 - color);
+#endif
+#ifdef INVERT
+    color = 1.0 - color;
+#endif
+}
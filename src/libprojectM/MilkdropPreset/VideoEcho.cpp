@@ -1,6 +1,13 @@
 #include "VideoEcho.hpp"
 
+#include "MilkdropStaticShaders.hpp"
+
+#include <Logging.hpp>
 #include <Renderer/BlendMode.hpp>
+#include <Renderer/ShaderCache.hpp>
+
+#include <algorithm>
+#include <utility>
 
 namespace libprojectM {
 namespace MilkdropPreset {
@@ -13,7 +20,51 @@ VideoEcho::VideoEcho(const PresetState& presetState)
     m_echoMesh.SetVertexCount(4);
 }
 
-void VideoEcho::Draw()
+void VideoEcho::CompileShader()
+{
+    // Effects are enabled in the fragment shader via defines.
+    std::string defines;
+    std::string cacheKey = "milkdrop_legacy_composite";
+    for (const auto& effect : {std::make_pair(m_presetState.videoEchoAlpha > 0.001f, "VIDEO_ECHO"),
+                               std::make_pair(m_presetState.brighten, "BRIGHTEN"),
+                               std::make_pair(m_presetState.darken, "DARKEN"),
+                               std::make_pair(m_presetState.solarize, "SOLARIZE"),
+                               std::make_pair(m_presetState.invert, "INVERT")})
+    {
+        if (effect.first)
+        {
+            defines.append("#define ").append(effect.second).append("\n");
+            cacheKey.append("_").append(effect.second);
+        }
+    }
+
+    auto& shaderCache = *m_presetState.renderContext.shaderCache;
+    m_shader = shaderCache.Get(cacheKey);
+    if (m_shader)
+    {
+        return;
+    }
+
+    auto staticShaders = MilkdropStaticShaders::Get();
+
+    // Defines must follow the version header in the first line.
+    auto fragmentShader = staticShaders->GetLegacyCompositeFragmentShader();
+    fragmentShader.insert(fragmentShader.find('\n') + 1, defines);
+
+    try
+    {
+        auto shader = std::make_shared<Renderer::Shader>();
+        shader->CompileProgram(staticShaders->GetTexturedDrawVertexShader(), fragmentShader);
+        shaderCache.Insert(cacheKey, shader);
+        m_shader = std::move(shader);
+    }
+    catch (Renderer::ShaderException& ex)
+    {
+        LOG_WARN("[VideoEcho] Could not compile the single-pass shader, using multiple passes: " + ex.message());
+    }
+}
+
+auto VideoEcho::Draw() -> bool
 {
     float const aspect = m_presetState.renderContext.viewportSizeX / static_cast<float>(m_presetState.renderContext.viewportSizeY * m_presetState.renderContext.invAspectY);
     float aspectMultX = 1.0f;
@@ -57,7 +108,7 @@ void VideoEcho::Draw()
                      1.0f};
     }
 
-    auto shader = m_presetState.texturedShader.lock();
+    auto shader = m_shader ? m_shader : m_presetState.texturedShader.lock();
     shader->Bind();
     shader->SetUniformMat4x4("vertex_transformation", PresetState::orthogonalProjection);
     shader->SetUniformInt("texture_sampler", 0);
@@ -69,7 +120,11 @@ void VideoEcho::Draw()
         m_sampler.Bind(0);
     }
 
-    if (m_presetState.videoEchoAlpha > 0.001f)
+    if (m_shader)
+    {
+        DrawSinglePass();
+    }
+    else if (m_presetState.videoEchoAlpha > 0.001f)
     {
         DrawVideoEcho();
     }
@@ -87,6 +142,58 @@ void VideoEcho::Draw()
         mainTexture->Unbind(0);
         Renderer::Sampler::Unbind(0);
     }
+
+    return m_shader != nullptr;
+}
+
+void VideoEcho::DrawSinglePass()
+{
+    // The shader derives the echo texture coordinates from these.
+    m_echoMesh.UVs().Set({{0.0f, 0.0f},
+                          {1.0f, 0.0f},
+                          {0.0f, 1.0f},
+                          {1.0f, 1.0f}});
+
+    // Weights equal to the sum of the vertex color factors of the passes drawn by DrawVideoEcho() or
+    // DrawGammaAdjustment(). As all vertex colors have an alpha of 1, the alpha weight is the pass count.
+    float const gammaAdj = m_presetState.gammaAdj;
+    glm::vec4 mainWeight{};
+    glm::vec4 echoWeight{};
+    if (m_presetState.videoEchoAlpha > 0.001f)
+    {
+        float const videoEchoAlpha = m_presetState.videoEchoAlpha;
+        auto const videoEchoOrientation = m_presetState.videoEchoOrientation % 4;
+
+        // Both images are drawn once, then redrawn for each started gamma unit above 1.
+        int const redrawCount = (gammaAdj > 0.001f) ? static_cast<int>(gammaAdj - 0.0001f) : 0;
+        float gamma = 1.0f;
+        if (redrawCount > 0)
+        {
+            gamma += static_cast<float>(redrawCount - 1) + gammaAdj - static_cast<float>(redrawCount);
+        }
+        auto const passCount = static_cast<float>(1 + redrawCount);
+
+        mainWeight = {glm::vec3((1.0f - videoEchoAlpha) * gamma), passCount};
+        echoWeight = {glm::vec3(videoEchoAlpha * gamma), passCount};
+
+        m_shader->SetUniformFloat("echo_zoom", m_presetState.videoEchoZoom);
+        m_shader->SetUniformFloat2("echo_flip", {videoEchoOrientation % 2 == 1 ? 1.0f : 0.0f,
+                                                 videoEchoOrientation >= 2 ? 1.0f : 0.0f});
+    }
+    else
+    {
+        // The image is drawn once per started gamma unit, adding up to the gamma value.
+        int const redrawCount = static_cast<int>(gammaAdj - 0.0001f) + 1;
+        mainWeight = {glm::vec3(std::max(gammaAdj, 0.0f)), static_cast<float>(std::max(redrawCount, 0))};
+    }
+
+    m_shader->SetUniformFloat4("main_weight", mainWeight);
+    m_shader->SetUniformFloat4("echo_weight", echoWeight);
+
+    Renderer::BlendMode::SetBlendActive(false);
+
+    m_echoMesh.Update();
+    m_echoMesh.Draw();
 }
 
 void VideoEcho::DrawVideoEcho()
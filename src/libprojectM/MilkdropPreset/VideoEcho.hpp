@@ -4,12 +4,19 @@
 #include "PresetState.hpp"
 
 #include <Renderer/Mesh.hpp>
+#include <Renderer/Shader.hpp>
+
+#include <memory>
 
 namespace libprojectM {
 namespace MilkdropPreset {
 
 /**
  * @brief Renders a video "echo" (ghost image) effect and gamma adjustments.
+ *
+ * If CompileShader() was successful, the effect is drawn in a single pass together with the
+ * enabled Milkdrop 1 filters, using a fragment shader specialized for the preset's settings.
+ * Otherwise, the original blending passes are used and the filters have to be drawn separately.
  */
 class VideoEcho
 {
@@ -17,9 +24,24 @@ public:
 	VideoEcho() = delete;
     explicit VideoEcho(const PresetState& presetState);
 
-	void Draw();
+    /**
+     * @brief Compiles the single-pass shader for the preset's echo, gamma and filter settings.
+     * Each combination of effects is only compiled once and then taken from the shader cache.
+     */
+    void CompileShader();
+
+    /**
+     * @brief Draws the effect.
+     * @return true if the enabled filters were applied as well, false if they still need to be drawn.
+     */
+	auto Draw() -> bool;
 
 private:
+    /**
+     * @brief Draws the echo, gamma adjustment and filters with the single-pass shader.
+     */
+    void DrawSinglePass();
+
     void DrawVideoEcho();
 
     void DrawGammaAdjustment();
@@ -29,6 +51,7 @@ private:
     std::array<std::array<float, 3>, 4> m_shade; // !< Random, changing color values for the four corners
     Renderer::Mesh m_echoMesh; //!< The video echo/gamma adj mesh
     Renderer::Sampler m_sampler{GL_CLAMP_TO_EDGE, GL_LINEAR};
+    std::shared_ptr<Renderer::Shader> m_shader; //!< The single-pass shader, or nullptr if multiple passes are used.
 };
 
 } // namespace MilkdropPreset
@@ -54,9 +54,9 @@ void Waveform::Draw(const PerFrameContext& presetPerFrameContext)
         Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
     }
 
-    auto smoothedVertices = m_waveformMath->GetVertices(m_presetState, presetPerFrameContext);
+    m_waveformMath->GetVertices(m_presetState, presetPerFrameContext, m_smoothedVertices);
 
-    for (auto& smoothedWave : smoothedVertices)
+    for (auto& smoothedWave : m_smoothedVertices)
     {
         if (smoothedWave.empty())
         {
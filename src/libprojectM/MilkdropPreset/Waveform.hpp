@@ -6,6 +6,7 @@
 
 #include <Renderer/Mesh.hpp>
 
+#include <array>
 #include <memory>
 
 namespace libprojectM {
@@ -33,6 +34,8 @@ private:
 
     std::unique_ptr<Waveforms::WaveformMath> m_waveformMath; //!< The waveform vertex math implementation.
 
+    std::array<Waveforms::WaveformMath::VertexList, 2> m_smoothedVertices; //!< Waveform vertices, kept to reuse the allocated memory in each frame.
+
     float m_tempAlpha{0.0f}; //!< Calculated alpha value.
     int m_samples{};         //!< Number of samples in the current waveform. Depends on the mode.
 };
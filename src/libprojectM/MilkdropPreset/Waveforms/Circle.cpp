@@ -29,10 +29,11 @@ void Circle::GenerateVertices(const PresetState& presetState,
 
     const float inverseSamplesMinusOne{1.0f / static_cast<float>(m_samples)};
 
+    m_angles.Update(m_samples, inverseSamplesMinusOne * 6.28f, presetState.renderContext.time * 0.2f);
+
     for (int i = 0; i < m_samples; i++)
     {
         float radius = 0.5f + 0.4f * m_pcmDataR[i + sampleOffset] + m_mysteryWaveParam;
-        float const angle = static_cast<float>(i) * inverseSamplesMinusOne * 6.28f + presetState.renderContext.time * 0.2f;
         if (i < m_samples / 10)
         {
             float mix = static_cast<float>(i) / (static_cast<float>(m_samples) * 0.1f);
@@ -42,8 +43,8 @@ void Circle::GenerateVertices(const PresetState& presetState,
         }
 
         m_wave1Vertices[i] = {
-            radius * cosf(angle) * m_aspectY + m_waveX,
-            radius * sinf(angle) * m_aspectX + m_waveY};
+            radius * m_angles.Cosine(i) * m_aspectY + m_waveX,
+            radius * m_angles.Sine(i) * m_aspectX + m_waveY};
     }
 }
 
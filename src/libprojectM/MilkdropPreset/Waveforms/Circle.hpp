@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Waveforms/UnitCircleTable.hpp"
 #include "Waveforms/WaveformMath.hpp"
 
 namespace libprojectM {
@@ -15,6 +16,9 @@ protected:
     auto UsesNormalizedMysteryParam() -> bool override;
     void GenerateVertices(const PresetState& presetState,
                           const PerFrameContext& presetPerFrameContext) override;
+
+private:
+    UnitCircleTable m_angles; //!< Cosine and sine of each sample angle.
 };
 
 } // namespace Waveforms
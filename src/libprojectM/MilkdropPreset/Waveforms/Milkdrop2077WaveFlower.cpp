@@ -25,10 +25,18 @@ void Milkdrop2077WaveFlower::GenerateVertices(const PresetState& presetState,
     float const invertedSamplesMinusOne = 1.0f / static_cast<float>(m_samples - 1);
     float const tenthSamples = static_cast<float>(m_samples) * 0.1f;
 
+    // The angle is i * step + time * 0.2, scaled by pi for X and shifted by -time / 3 for Y.
+    float const angleStep = invertedSamplesMinusOne * 6.28f;
+    float const angleOffset = presetState.renderContext.time * 0.2f;
+    m_petalAngles.Update(m_samples, angleStep * 3.1416f, angleOffset * 3.1416f);
+    m_rotatedAngles.Update(m_samples, angleStep, angleOffset - presetState.renderContext.time / 3.0f);
+
+    float const centerX = m_waveX * cosf(3.1416f);
+    float const centerY = m_waveY * cosf(3.1416f);
+
     for (int sample = 0; sample < m_samples; sample++)
     {
         float radius = 0.7f + 0.7f * m_pcmDataR[sample + sampleOffset] + m_mysteryWaveParam;
-        float angle = static_cast<float>(sample) * invertedSamplesMinusOne * 6.28f + presetState.renderContext.time * 0.2f;
         if (static_cast<float>(sample) < static_cast<float>(m_samples) / radius)
         {
             float mix = static_cast<float>(sample) / tenthSamples;
@@ -40,8 +48,8 @@ void Milkdrop2077WaveFlower::GenerateVertices(const PresetState& presetState,
         }
 
         m_wave1Vertices[sample] = {
-            radius * cosf(angle * 3.1416f) * m_aspectY / 1.5f + m_waveX * cosf(3.1416f),
-            radius * sinf(angle - presetState.renderContext.time / 3.0f) * m_aspectX / 1.5f + m_waveY * cosf(3.1416f)};
+            radius * m_petalAngles.Cosine(sample) * m_aspectY / 1.5f + centerX,
+            radius * m_rotatedAngles.Sine(sample) * m_aspectX / 1.5f + centerY};
     }
 }
 
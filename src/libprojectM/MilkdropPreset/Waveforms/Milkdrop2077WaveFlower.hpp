@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Waveforms/UnitCircleTable.hpp"
 #include "Waveforms/WaveformMath.hpp"
 
 namespace libprojectM {
@@ -14,6 +15,10 @@ public:
 protected:
     void GenerateVertices(const PresetState& presetState,
                           const PerFrameContext& presetPerFrameContext) override;
+
+private:
+    UnitCircleTable m_petalAngles;   //!< Cosine of the sample angles used for the X coordinate.
+    UnitCircleTable m_rotatedAngles; //!< Sine of the sample angles used for the Y coordinate.
 };
 
 } // namespace Waveforms
@@ -25,10 +25,11 @@ void Milkdrop2077WaveStar::GenerateVertices(const PresetState& presetState,
     float const invertedSamplesMinusOne = 1.0f / static_cast<float>(m_samples - 1);
     float const tenthSamples = static_cast<float>(m_samples) * 0.1f;
 
+    m_angles.Update(m_samples, invertedSamplesMinusOne * 6.28f, presetState.renderContext.time * 0.2f);
+
     for (int sample = 0; sample < m_samples; sample++)
     {
         float radius = 0.7f + 0.4f * m_pcmDataR[sample + sampleOffset] + m_mysteryWaveParam;
-        float const angle = static_cast<float>(sample) * invertedSamplesMinusOne * 6.28f + presetState.renderContext.time * 0.2f;
         if (static_cast<float>(sample) < m_samples / radius)
         {
             float mix = static_cast<float>(sample) / tenthSamples;
@@ -37,8 +38,8 @@ void Milkdrop2077WaveStar::GenerateVertices(const PresetState& presetState,
             float const radius2 = 0.5f + 0.4f * m_pcmDataR[sample + m_samples - sampleOffset] + m_mysteryWaveParam;
             radius = radius2 * (1.0f - mix) + radius * mix;
         }
-        m_wave1Vertices[sample] = {radius * cosf(angle) * m_aspectY + m_waveX,
-                                   radius * sinf(angle) * m_aspectX + m_waveY};
+        m_wave1Vertices[sample] = {radius * m_angles.Cosine(sample) * m_aspectY + m_waveX,
+                                   radius * m_angles.Sine(sample) * m_aspectX + m_waveY};
     }
 }
 
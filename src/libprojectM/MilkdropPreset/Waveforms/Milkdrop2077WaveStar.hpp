@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Waveforms/UnitCircleTable.hpp"
 #include "Waveforms/WaveformMath.hpp"
 
 namespace libprojectM {
@@ -14,6 +15,9 @@ public:
 protected:
     void GenerateVertices(const PresetState& presetState,
                           const PerFrameContext& presetPerFrameContext) override;
+
+private:
+    UnitCircleTable m_angles; //!< Cosine and sine of each sample angle.
 };
 
 } // namespace Waveforms
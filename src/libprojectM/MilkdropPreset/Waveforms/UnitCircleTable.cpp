@@ -0,0 +1,37 @@
+#include "Waveforms/UnitCircleTable.hpp"
+
+#include <cmath>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+namespace Waveforms {
+
+void UnitCircleTable::Update(int count, float angleStep, float angleOffset)
+{
+    if (count != m_count || angleStep != m_angleStep)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            float const angle = static_cast<float>(i) * angleStep;
+            m_baseCosines[i] = cosf(angle);
+            m_baseSines[i] = sinf(angle);
+        }
+
+        m_count = count;
+        m_angleStep = angleStep;
+    }
+
+    // cos(a + b) = cos(a) * cos(b) - sin(a) * sin(b), sin(a + b) = sin(a) * cos(b) + cos(a) * sin(b)
+    float const cosineOffset = cosf(angleOffset);
+    float const sineOffset = sinf(angleOffset);
+
+    for (int i = 0; i < count; i++)
+    {
+        m_cosines[i] = m_baseCosines[i] * cosineOffset - m_baseSines[i] * sineOffset;
+        m_sines[i] = m_baseSines[i] * cosineOffset + m_baseCosines[i] * sineOffset;
+    }
+}
+
+} // namespace Waveforms
+} // namespace MilkdropPreset
+} // namespace libprojectM
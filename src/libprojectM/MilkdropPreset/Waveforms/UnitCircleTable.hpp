@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Constants.hpp"
+
+#include <array>
+
+namespace libprojectM {
+namespace MilkdropPreset {
+namespace Waveforms {
+
+/**
+ * @brief Cosine and sine values of evenly spaced angles around a circle.
+ *
+ * Circular waveforms need the cosine and sine of i * angleStep + angleOffset for each sample,
+ * where only the offset changes between frames. The table calculates the values for a zero
+ * offset once, and then rotates them by the offset on each update. This only needs
+ * multiplications and additions the compiler can vectorize, instead of two trigonometric
+ * function calls per sample.
+ */
+class UnitCircleTable
+{
+public:
+    /**
+     * @brief Calculates the cosine and sine values for the given angles.
+     * @param count The number of angles. Must not exceed WaveformMaxPoints.
+     * @param angleStep The angle difference between two neighboring entries.
+     * @param angleOffset The angle of the first entry.
+     */
+    void Update(int count, float angleStep, float angleOffset);
+
+    /**
+     * @brief Returns the cosine of the angle at the given index.
+     * @param index The angle index.
+     * @return The cosine of index * angleStep + angleOffset.
+     */
+    auto Cosine(int index) const -> float
+    {
+        return m_cosines[index];
+    }
+
+    /**
+     * @brief Returns the sine of the angle at the given index.
+     * @param index The angle index.
+     * @return The sine of index * angleStep + angleOffset.
+     */
+    auto Sine(int index) const -> float
+    {
+        return m_sines[index];
+    }
+
+private:
+    int m_count{};       //!< Number of angles in the base table.
+    float m_angleStep{}; //!< Angle step of the base table.
+
+    std::array<float, WaveformMaxPoints> m_baseCosines{}; //!< Cosines of the angles with zero offset.
+    std::array<float, WaveformMaxPoints> m_baseSines{};   //!< Sines of the angles with zero offset.
+    std::array<float, WaveformMaxPoints> m_cosines{};     //!< Cosines of the angles for the current offset.
+    std::array<float, WaveformMaxPoints> m_sines{};       //!< Sines of the angles for the current offset.
+};
+
+} // namespace Waveforms
+} // namespace MilkdropPreset
+} // namespace libprojectM
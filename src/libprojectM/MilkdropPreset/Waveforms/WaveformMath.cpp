@@ -10,8 +10,9 @@ namespace libprojectM {
 namespace MilkdropPreset {
 namespace Waveforms {
 
-auto WaveformMath::GetVertices(const PresetState& presetState,
-                               const PerFrameContext& presetPerFrameContext) -> std::array<VertexList, 2>
+void WaveformMath::GetVertices(const PresetState& presetState,
+                               const PerFrameContext& presetPerFrameContext,
+                               std::array<VertexList, 2>& smoothedVertices)
 {
     static_assert(WaveformMaxPoints >= libprojectM::Audio::SpectrumSamples, "WaveformMaxPoints is smaller than SpectrumSamples");
     static_assert(WaveformMaxPoints >= libprojectM::Audio::WaveformSamples, "WaveformMaxPoints is smaller than WaveformSamples");
@@ -52,7 +53,8 @@ auto WaveformMath::GetVertices(const PresetState& presetState,
      */
     float mix2 = presetState.waveSmoothing; // amount of previous sample to add to this sample
     float mix1 = scale * (1.0f - mix2);     // amount to scale this sample
-    // Scale and mix samples after the first one.
+    // Scale and mix samples after the first one. Each sample depends on the previous one, so this
+    // loop can't be vectorized, but both channels are processed in the same pass.
     for (size_t i = 1; i < m_pcmDataL.size(); ++i)
     {
         m_pcmDataL[i] = m_pcmDataL[i] * mix1 + m_pcmDataL[i - 1] * mix2;
@@ -84,11 +86,8 @@ auto WaveformMath::GetVertices(const PresetState& presetState,
 
     GenerateVertices(presetState, presetPerFrameContext);
 
-    std::array<VertexList, 2> smoothedVertices;
     SmoothWave(m_wave1Vertices, smoothedVertices.at(0));
     SmoothWave(m_wave2Vertices, smoothedVertices.at(1));
-
-    return smoothedVertices;
 }
 
 auto WaveformMath::IsLoop() -> bool
@@ -108,37 +107,52 @@ auto WaveformMath::UsesNormalizedMysteryParam() -> bool
 
 void WaveformMath::SmoothWave(const VertexList& inputVertices, VertexList& outputVertices)
 {
-    constexpr float c1{-0.15f};
-    constexpr float c2{1.15f};
-    constexpr float c3{1.15f};
-    constexpr float c4{-0.15f};
-    constexpr float inverseSum{1.0f / (c1 + c2 + c3 + c4)};
-
-    size_t outputIndex = 0;
-    size_t indexBelow = 0;
-    size_t indexAbove2 = 1;
-
     if (inputVertices.empty())
     {
         outputVertices.clear();
         return;
     }
 
-    outputVertices.resize(static_cast<size_t>(m_samples) * 2 - 1);
+    auto const sampleCount = static_cast<size_t>(m_samples);
+    outputVertices.resize(sampleCount * 2 - 1);
+
+    const auto* input = inputVertices.data();
+    auto* output = outputVertices.data();
+
+    auto smoothedPoint = [input](size_t indexBelow, size_t index, size_t indexAbove, size_t indexAbove2) -> Renderer::Point {
+        constexpr float c1{-0.15f};
+        constexpr float c2{1.15f};
+        constexpr float c3{1.15f};
+        constexpr float c4{-0.15f};
+        constexpr float inverseSum{1.0f / (c1 + c2 + c3 + c4)};
+
+        return {
+            (c1 * input[indexBelow].X() + c2 * input[index].X() + c3 * input[indexAbove].X() + c4 * input[indexAbove2].X()) * inverseSum,
+            (c1 * input[indexBelow].Y() + c2 * input[index].Y() + c3 * input[indexAbove].Y() + c4 * input[indexAbove2].Y()) * inverseSum};
+    };
+
+    // The neighbor indices only need to be clamped for the first and last point pair. Handling
+    // those separately leaves a loop without any index checks the compiler can vectorize.
+    if (sampleCount > 1)
+    {
+        output[0] = input[0];
+        output[1] = smoothedPoint(0, 0, 1, std::min<size_t>(sampleCount - 1, 2));
+    }
+
+    for (size_t inputIndex = 1; inputIndex + 2 < sampleCount; inputIndex++)
+    {
+        output[inputIndex * 2] = input[inputIndex];
+        output[inputIndex * 2 + 1] = smoothedPoint(inputIndex - 1, inputIndex, inputIndex + 1, inputIndex + 2);
+    }
 
-    for (size_t inputIndex = 0; inputIndex < static_cast<size_t>(m_samples) - 1; inputIndex++)
+    if (sampleCount > 2)
     {
-        size_t const indexAbove = indexAbove2;
-        indexAbove2 = std::min(static_cast<size_t>(m_samples) - 1, inputIndex + 2);
-        outputVertices[outputIndex] = inputVertices[inputIndex];
-        outputVertices[outputIndex + 1] = {
-            (c1 * inputVertices[indexBelow].X() + c2 * inputVertices[inputIndex].X() + c3 * inputVertices[indexAbove].X() + c4 * inputVertices[indexAbove2].X()) * inverseSum,
-            (c1 * inputVertices[indexBelow].Y() + c2 * inputVertices[inputIndex].Y() + c3 * inputVertices[indexAbove].Y() + c4 * inputVertices[indexAbove2].Y()) * inverseSum};
-        indexBelow = inputIndex;
-        outputIndex += 2;
+        size_t const inputIndex = sampleCount - 2;
+        output[inputIndex * 2] = input[inputIndex];
+        output[inputIndex * 2 + 1] = smoothedPoint(inputIndex - 1, inputIndex, inputIndex + 1, inputIndex + 1);
     }
 
-    outputVertices.at(outputIndex) = inputVertices.at(m_samples - 1);
+    output[sampleCount * 2 - 2] = input[sampleCount - 1];
 }
 
 } // namespace Waveforms
@@ -25,14 +25,16 @@ public:
 
     /**
      * @brief Calculates and smoothes the samples and outputs vertices ready for drawing.
-     * Depending on the waveform type, only the first set of vertices might be present.
+     * Depending on the waveform type, only the first set of vertices might be present, the second
+     * list is empty then. The lists are resized as needed, so the caller can keep them to reuse
+     * the allocated memory in the next frame.
      * @param presetState The preset state older, including the render context.
      * @param presetPerFrameContext The preset per-frame context.
-     * @return An array with either one or two sets of waveform vertices.
+     * @param smoothedVertices Receives either one or two sets of waveform vertices.
      */
-    auto GetVertices(const PresetState& presetState,
-                     const PerFrameContext& presetPerFrameContext)
-        -> std::array<VertexList, 2>;
+    void GetVertices(const PresetState& presetState,
+                     const PerFrameContext& presetPerFrameContext,
+                     std::array<VertexList, 2>& smoothedVertices);
 
     /**
      * @brief Indicates whether the waveform should be drawn as a closed line loop instead of a strip.
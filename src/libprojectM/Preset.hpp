@@ -5,6 +5,7 @@
 #include <Renderer/RenderContext.hpp>
 #include <Renderer/Texture.hpp>
 
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -13,6 +14,14 @@ namespace libprojectM {
 class Preset
 {
 public:
+    /**
+     * @brief Estimated render target memory traffic of a single frame.
+     */
+    struct FrameBandwidth {
+        size_t bytesRead{};    //!< Bytes read from render target textures.
+        size_t bytesWritten{}; //!< Bytes written to render target textures.
+    };
+
     virtual ~Preset() = default;
 
     /**
@@ -60,6 +69,43 @@ public:
      */
     virtual void BindFramebuffer() = 0;
 
+    /**
+     * @brief Returns the estimated video memory used by the preset's render targets.
+     * @return The allocated texture memory in bytes, or 0 if unknown.
+     */
+    virtual auto TextureMemory() const -> size_t
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Returns the estimated render target traffic of the last rendered frame.
+     *
+     * Each full-screen texture read or write is counted once, ignoring GPU caches, framebuffer
+     * compression and the geometry drawn on top.
+     *
+     * @return The estimated bytes read and written, or zeros if unknown.
+     */
+    virtual auto LastFrameBandwidth() const -> FrameBandwidth
+    {
+        return {};
+    }
+
+    /**
+     * @brief Restores the preset to the state right after Initialize() so it can be displayed again.
+     *
+     * Compiled code, shaders and textures are kept, only the runtime state like expression
+     * variables, memory and the last rendered image are reset.
+     *
+     * @param renderContext The current render context data.
+     * @return True if the preset was reset, false if the preset doesn't support being reused.
+     */
+    virtual auto Reset(const Renderer::RenderContext& renderContext) -> bool
+    {
+        static_cast<void>(renderContext);
+        return false;
+    }
+
     inline void SetFilename(const std::string& filename)
     {
         m_filename = filename;
@@ -0,0 +1,135 @@
+#include "PresetCache.hpp"
+
+#include "Logging.hpp"
+#include "Preset.hpp"
+#include "PresetFactory.hpp"
+#include "Utils.hpp"
+
+namespace libprojectM {
+
+PresetCache::~PresetCache()
+{
+    // Can't use "=default" in the header due to unique_ptr requiring the actual type declarations.
+}
+
+auto PresetCache::Take(const std::string& filename, const Renderer::RenderContext& renderContext) -> std::unique_ptr<Preset>
+{
+    for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+    {
+        if (entry->filename != filename)
+        {
+            continue;
+        }
+
+        Entry currentFile;
+        ReadFileInfo(filename, currentFile);
+        bool const fileChanged = currentFile.hasFileInfo != entry->hasFileInfo ||
+                                 currentFile.fileSize != entry->fileSize ||
+                                 currentFile.fileModificationTime != entry->fileModificationTime;
+
+        auto preset = std::move(entry->preset);
+        m_cachedBytes -= entry->bytes;
+        m_entries.erase(entry);
+
+        if (fileChanged)
+        {
+            LOG_DEBUG("[PresetCache] Discarding cached preset \"" + filename + "\", the file was changed");
+            break;
+        }
+
+        if (!preset->Reset(renderContext))
+        {
+            break;
+        }
+
+        m_hits++;
+        LOG_DEBUG("[PresetCache] Reusing cached preset \"" + filename + "\"");
+        return preset;
+    }
+
+    m_misses++;
+    return {};
+}
+
+void PresetCache::Store(const std::string& filename, std::unique_ptr<Preset> preset)
+{
+    if (!preset || filename.empty() || m_maxPresets == 0)
+    {
+        return;
+    }
+
+    auto bytes = preset->TextureMemory();
+    if (bytes > m_maxBytes)
+    {
+        return;
+    }
+
+    // Only keep the most recent instance of a preset.
+    for (auto entry = m_entries.begin(); entry != m_entries.end(); ++entry)
+    {
+        if (entry->filename == filename)
+        {
+            m_cachedBytes -= entry->bytes;
+            m_entries.erase(entry);
+            break;
+        }
+    }
+
+    Entry newEntry{filename, std::move(preset), bytes};
+    ReadFileInfo(filename, newEntry);
+
+    m_entries.push_front(std::move(newEntry));
+    m_cachedBytes += bytes;
+
+    Evict();
+}
+
+void PresetCache::SetLimits(uint32_t maxPresets, size_t maxBytes)
+{
+    m_maxPresets = maxPresets;
+    m_maxBytes = maxBytes;
+
+    Evict();
+}
+
+void PresetCache::Clear()
+{
+    m_entries.clear();
+    m_cachedBytes = 0;
+}
+
+auto PresetCache::GetStatistics() const -> Statistics
+{
+    Statistics statistics;
+    statistics.hits = m_hits;
+    statistics.misses = m_misses;
+    statistics.evictions = m_evictions;
+    statistics.cachedPresets = static_cast<uint32_t>(m_entries.size());
+    statistics.cachedBytes = m_cachedBytes;
+
+    return statistics;
+}
+
+void PresetCache::ReadFileInfo(const std::string& filename, Entry& entry)
+{
+    std::string path;
+    auto protocol = PresetFactory::Protocol(filename, path);
+    if (!protocol.empty() && protocol != "file")
+    {
+        return;
+    }
+
+    entry.hasFileInfo = Utils::GetFileInfo(path, entry.fileSize, entry.fileModificationTime);
+}
+
+void PresetCache::Evict()
+{
+    while (!m_entries.empty() && (m_entries.size() > m_maxPresets || m_cachedBytes > m_maxBytes))
+    {
+        m_cachedBytes -= m_entries.back().bytes;
+        m_entries.pop_back();
+        m_evictions++;
+    }
+}
+
+} // namespace libprojectM
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <Renderer/RenderContext.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+
+namespace libprojectM {
+
+class Preset;
+
+/**
+ * @brief Keeps recently used, fully initialized presets for fast re-activation.
+ *
+ * Presets which are no longer displayed are stored in the cache instead of being destroyed. If the
+ * same preset file is loaded again, the cached instance is reset and reused, skipping file parsing,
+ * code compilation, shader compilation and texture lookups. The size and modification time of the
+ * file are recorded when storing a preset, so presets whose file was changed since are discarded.
+ *
+ * The cache is bounded by the number of presets and the memory held by their render target
+ * textures. The least recently used presets are evicted first.
+ */
+class PresetCache
+{
+public:
+    static constexpr uint32_t DefaultMaxPresets = 4;              //!< Default max number of cached presets.
+    static constexpr size_t DefaultMaxBytes = 256 * 1024 * 1024; //!< Default max memory held by cached presets.
+
+    /**
+     * @brief Cache usage counters.
+     */
+    struct Statistics {
+        uint64_t hits{};          //!< Number of preset loads served from the cache.
+        uint64_t misses{};        //!< Number of preset loads which had to create a new preset.
+        uint64_t evictions{};     //!< Number of presets removed from the cache to stay within the limits.
+        uint32_t cachedPresets{}; //!< Number of presets currently in the cache.
+        size_t cachedBytes{};     //!< Estimated memory held by all cached presets.
+    };
+
+    PresetCache() = default;
+
+    ~PresetCache();
+
+    /**
+     * @brief Removes a preset from the cache and resets it for display.
+     *
+     * Counts a hit if the preset was found, its file is unchanged and it could be reset, otherwise
+     * a miss.
+     *
+     * @param filename The filename or URL the preset was loaded from.
+     * @param renderContext The current render context, passed to Preset::Reset().
+     * @return The cached preset, or nullptr if no usable preset was cached for the given filename.
+     */
+    auto Take(const std::string& filename, const Renderer::RenderContext& renderContext) -> std::unique_ptr<Preset>;
+
+    /**
+     * @brief Stores a preset which is no longer displayed.
+     *
+     * Presets without a filename, e.g. loaded from a stream, are destroyed. If the preset exceeds
+     * the cache limits on its own, it is destroyed as well.
+     *
+     * @param filename The filename or URL the preset was loaded from.
+     * @param preset The preset to store.
+     */
+    void Store(const std::string& filename, std::unique_ptr<Preset> preset);
+
+    /**
+     * @brief Sets the cache limits, evicting presets if needed.
+     * @param maxPresets Max number of cached presets. 0 disables the cache.
+     * @param maxBytes Max estimated memory held by all cached presets.
+     */
+    void SetLimits(uint32_t maxPresets, size_t maxBytes);
+
+    /**
+     * @brief Destroys all cached presets.
+     * Must be called if cached presets can no longer be reused, e.g. after texture paths changed.
+     */
+    void Clear();
+
+    /**
+     * @brief Returns the cache usage counters.
+     */
+    auto GetStatistics() const -> Statistics;
+
+private:
+    /**
+     * A cached preset with its memory usage at the time it was stored.
+     */
+    struct Entry {
+        std::string filename;           //!< The filename or URL the preset was loaded from.
+        std::unique_ptr<Preset> preset; //!< The cached preset.
+        size_t bytes{};                 //!< Estimated memory held by the preset.
+        bool hasFileInfo{};             //!< True if the preset file could be checked when storing it.
+        uint64_t fileSize{};            //!< Size of the preset file when storing the preset.
+        int64_t fileModificationTime{}; //!< Modification time of the preset file when storing the preset.
+    };
+
+    /**
+     * @brief Retrieves the size and modification time of the file a preset was loaded from.
+     * @param filename The filename or URL the preset was loaded from.
+     * @param entry The entry receiving the file information.
+     */
+    static void ReadFileInfo(const std::string& filename, Entry& entry);
+
+    /**
+     * @brief Removes the least recently used presets until the cache is within its limits.
+     */
+    void Evict();
+
+    uint32_t m_maxPresets{DefaultMaxPresets}; //!< Max number of cached presets.
+    size_t m_maxBytes{DefaultMaxBytes};       //!< Max estimated memory held by all cached presets.
+
+    std::list<Entry> m_entries; //!< Cached presets, most recently used first.
+    size_t m_cachedBytes{};     //!< Sum of the memory of all cached presets.
+    uint64_t m_hits{};          //!< Number of cache hits.
+    uint64_t m_misses{};        //!< Number of cache misses.
+    uint64_t m_evictions{};     //!< Number of evicted presets.
+};
+
+} // namespace libprojectM
@@ -2,6 +2,8 @@
 
 #include <Logging.hpp>
 
+#include <stdexcept>
+
 namespace libprojectM {
 
 std::string PresetFactory::Protocol(const std::string& url, std::string& path)
@@ -20,4 +22,32 @@ std::string PresetFactory::Protocol(const std::string& url, std::string& path)
     return url.substr(0, pos);
 }
 
+void PresetFactory::ValidatePresetFile(const std::string&)
+{
+}
+
+auto PresetFactory::AddPresetBundle(const std::string&) -> bool
+{
+    return false;
+}
+
+void PresetFactory::ClearPresetBundles()
+{
+}
+
+void PresetFactory::WritePresetBundle(const std::vector<std::string>&, const std::string&)
+{
+    throw std::runtime_error("[PresetFactory] Preset bundles are not supported for this preset type.");
+}
+
+auto PresetFactory::ReadPresetMetadata(const std::string&) -> PresetMetadata
+{
+    throw std::runtime_error("[PresetFactory] Preset metadata is not supported for this preset type.");
+}
+
+auto PresetFactory::PooledMemoryBuffers() const -> uint32_t
+{
+    return 0;
+}
+
 } // namespace libprojectM
@@ -2,10 +2,30 @@
 
 #include "Preset.hpp"
 
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace libprojectM {
 
+/**
+ * @brief Properties of a preset file which can be read without creating the preset.
+ */
+struct PresetMetadata {
+    bool hasWarpShader{false};         //!< True if the preset has a warp shader which is used.
+    bool hasCompositeShader{false};    //!< True if the preset has a composite shader which is used.
+    bool hasPerPixelCode{false};       //!< True if the preset has per-pixel expression code.
+    uint32_t customWaveCount{0};       //!< Number of enabled custom waveforms.
+    uint32_t customShapeCount{0};      //!< Number of enabled custom shapes.
+    uint32_t maxWaveSamples{0};        //!< Highest sample count of all enabled custom waveforms.
+    uint32_t maxShapeInstances{0};     //!< Highest instance count of all enabled custom shapes.
+    uint32_t blurLevel{0};             //!< Highest blur texture level used by the shaders, 0 to 3.
+    std::vector<std::string> textures; //!< Lower-case names of all textures referenced by the shaders, except main and blur.
+    double parseTime{0.0};             //!< Time in seconds spent reading and parsing the file.
+    double shaderTranslationTime{0.0}; //!< Time in seconds spent translating the shaders into GLSL.
+};
+
 class PresetFactory
 {
 
@@ -41,6 +61,66 @@ public:
      */
     virtual std::unique_ptr<Preset> LoadPresetFromStream(std::istream& data) = 0;
 
+    /**
+     * @brief Checks if a preset file can be loaded without actually creating the preset.
+     *
+     * Implementations must not use any OpenGL functions, as this method is meant to be called
+     * from background threads. The default implementation doesn't check anything.
+     *
+     * @param filename The preset filename
+     * @throws std::exception Thrown if the preset can't be loaded, with the reason in the message.
+     */
+    virtual void ValidatePresetFile(const std::string& filename);
+
+    /**
+     * @brief Adds a bundle of precompiled presets.
+     *
+     * Presets contained in the bundle are loaded from the precompiled data instead of the source
+     * file, unless the source file was modified after the bundle was written. The default
+     * implementation doesn't support bundles.
+     *
+     * @param bundleFilename The bundle file to add.
+     * @return True if the bundle was added, false if it can't be read or isn't supported by this factory.
+     */
+    virtual auto AddPresetBundle(const std::string& bundleFilename) -> bool;
+
+    /**
+     * @brief Removes all previously added preset bundles.
+     */
+    virtual void ClearPresetBundles();
+
+    /**
+     * @brief Precompiles the given presets and writes them into a bundle file.
+     *
+     * Must not use any OpenGL functions. The default implementation doesn't support bundles.
+     *
+     * @param presetFilenames The preset files to add to the bundle.
+     * @param bundleFilename The bundle file to write.
+     * @throws std::exception Thrown if the bundle can't be written, with the reason in the message.
+     */
+    virtual void WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename);
+
+    /**
+     * @brief Reads the properties of a preset file without creating the preset.
+     *
+     * Implementations must not use any OpenGL functions, as this method is meant to be called
+     * from background threads. The default implementation doesn't support metadata.
+     *
+     * @param filename The preset filename.
+     * @return The preset properties.
+     * @throws std::exception Thrown if the preset can't be read, with the reason in the message.
+     */
+    virtual auto ReadPresetMetadata(const std::string& filename) -> PresetMetadata;
+
+    /**
+     * @brief Returns the number of memory buffers this preset type keeps for reuse by future presets.
+     *
+     * The default implementation doesn't keep any buffers.
+     *
+     * @return The number of pooled buffers.
+     */
+    virtual auto PooledMemoryBuffers() const -> uint32_t;
+
     /**
      * Returns a space separated list of supported extensions
      * @return A space separated list of supported extensions
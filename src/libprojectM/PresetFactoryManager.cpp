@@ -101,6 +101,109 @@ std::unique_ptr<Preset> PresetFactoryManager::CreatePresetFromStream(const std::
     }
 }
 
+void PresetFactoryManager::ValidatePresetFile(const std::string& filename)
+{
+    try
+    {
+        const std::string extension = "." + ParseExtension(filename);
+
+        factory(extension).ValidatePresetFile(filename);
+    }
+    catch (const PresetFactoryException&)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        throw PresetFactoryException(e.what());
+    }
+    catch (...)
+    {
+        throw PresetFactoryException("[PresetFactoryManager] Uncaught preset factory exception.");
+    }
+}
+
+auto PresetFactoryManager::AddPresetBundle(const std::string& bundleFilename) -> bool
+{
+    for (auto* factory : m_factoryList)
+    {
+        if (factory->AddPresetBundle(bundleFilename))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void PresetFactoryManager::ClearPresetBundles()
+{
+    for (auto* factory : m_factoryList)
+    {
+        factory->ClearPresetBundles();
+    }
+}
+
+void PresetFactoryManager::WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename)
+{
+    if (presetFilenames.empty())
+    {
+        throw PresetFactoryException("[PresetFactoryManager] No preset files given for bundle \"" + bundleFilename + "\".");
+    }
+
+    try
+    {
+        const std::string extension = "." + ParseExtension(presetFilenames.front());
+
+        factory(extension).WritePresetBundle(presetFilenames, bundleFilename);
+    }
+    catch (const PresetFactoryException&)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        throw PresetFactoryException(e.what());
+    }
+    catch (...)
+    {
+        throw PresetFactoryException("[PresetFactoryManager] Uncaught preset factory exception.");
+    }
+}
+
+auto PresetFactoryManager::ReadPresetMetadata(const std::string& filename) -> PresetMetadata
+{
+    try
+    {
+        const std::string extension = "." + ParseExtension(filename);
+
+        return factory(extension).ReadPresetMetadata(filename);
+    }
+    catch (const PresetFactoryException&)
+    {
+        throw;
+    }
+    catch (const std::exception& e)
+    {
+        throw PresetFactoryException(e.what());
+    }
+    catch (...)
+    {
+        throw PresetFactoryException("[PresetFactoryManager] Uncaught preset factory exception.");
+    }
+}
+
+auto PresetFactoryManager::PooledMemoryBuffers() const -> uint32_t
+{
+    uint32_t pooledBuffers{};
+    for (const auto* factory : m_factoryList)
+    {
+        pooledBuffers += factory->PooledMemoryBuffers();
+    }
+
+    return pooledBuffers;
+}
+
 PresetFactory& PresetFactoryManager::factory(const std::string& extension)
 {
     if (!extensionHandled(extension))
@@ -81,6 +81,66 @@ public:
      */
     std::unique_ptr<Preset> CreatePresetFromStream(const std::string& extension, std::istream& data);
 
+    /**
+     * @brief Checks if a preset file can be loaded, without creating the preset.
+     *
+     * Does not require an OpenGL context and can be called from any thread, as long as
+     * initialize() isn't called at the same time.
+     *
+     * @param filename The filename/URL to check.
+     * @throws PresetFactoryException If the preset can't be loaded. Exception message contains
+     *                                additional details.
+     */
+    void ValidatePresetFile(const std::string& filename);
+
+    /**
+     * @brief Adds a bundle of precompiled presets.
+     *
+     * Each factory is asked to add the bundle, so the bundle format determines which presets it
+     * can hold. The bundles are removed when initialize() is called.
+     *
+     * @param bundleFilename The bundle file to add.
+     * @return True if a factory added the bundle, false if no factory could read it.
+     */
+    auto AddPresetBundle(const std::string& bundleFilename) -> bool;
+
+    /**
+     * @brief Removes all previously added preset bundles from all factories.
+     */
+    void ClearPresetBundles();
+
+    /**
+     * @brief Precompiles presets and writes them into a bundle file.
+     *
+     * The factory is selected by the extension of the first preset file. Presets which can't be
+     * parsed are skipped.
+     *
+     * @param presetFilenames The preset files to add to the bundle.
+     * @param bundleFilename The bundle file to write.
+     * @throws PresetFactoryException If the bundle can't be written. Exception message contains
+     *                                additional details.
+     */
+    void WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename);
+
+    /**
+     * @brief Reads the properties of a preset file, without creating the preset.
+     *
+     * Does not require an OpenGL context and can be called from any thread, as long as
+     * initialize() isn't called at the same time.
+     *
+     * @param filename The filename/URL to read.
+     * @return The preset properties.
+     * @throws PresetFactoryException If the preset can't be read. Exception message contains
+     *                                additional details.
+     */
+    auto ReadPresetMetadata(const std::string& filename) -> PresetMetadata;
+
+    /**
+     * @brief Returns the number of memory buffers all factories keep for reuse by future presets.
+     * @return The number of pooled buffers.
+     */
+    auto PooledMemoryBuffers() const -> uint32_t;
+
     std::vector<std::string> extensionsHandled() const;
 
 
@@ -23,12 +23,14 @@
 
 #include "Logging.hpp"
 #include "Preset.hpp"
+#include "PresetCache.hpp"
 #include "PresetFactoryManager.hpp"
 #include "TimeKeeper.hpp"
 
 #include <Audio/PCM.hpp>
 
 #include <Renderer/CopyTexture.hpp>
+#include <Renderer/OutputTargets.hpp>
 #include <Renderer/PresetTransition.hpp>
 #include <Renderer/ShaderCache.hpp>
 #include <Renderer/TextureManager.hpp>
@@ -36,10 +38,14 @@
 
 #include <UserSprites/SpriteManager.hpp>
 
+#include <algorithm>
+#include <random>
+
 namespace libprojectM {
 
 ProjectM::ProjectM()
     : m_presetFactoryManager(std::make_unique<PresetFactoryManager>())
+    , m_presetCache(std::make_unique<PresetCache>())
 {
     Initialize();
 }
@@ -62,7 +68,16 @@ void ProjectM::LoadPresetFile(const std::string& presetFilename, bool smoothTran
     try
     {
         m_textureManager->PurgeTextures();
-        StartPresetTransition(m_presetFactoryManager->CreatePresetFromFile(presetFilename), !smoothTransition);
+
+        auto preset = m_presetCache->Take(presetFilename, GetRenderContext());
+        if (preset)
+        {
+            StartPresetTransition(std::move(preset), presetFilename, !smoothTransition, true);
+        }
+        else
+        {
+            StartPresetTransition(m_presetFactoryManager->CreatePresetFromFile(presetFilename), presetFilename, !smoothTransition, false);
+        }
     }
     catch (const std::exception& ex)
     {
@@ -76,7 +91,7 @@ void ProjectM::LoadPresetData(std::istream& presetData, bool smoothTransition)
     try
     {
         m_textureManager->PurgeTextures();
-        StartPresetTransition(m_presetFactoryManager->CreatePresetFromStream(".milk", presetData), !smoothTransition);
+        StartPresetTransition(m_presetFactoryManager->CreatePresetFromStream(".milk", presetData), {}, !smoothTransition, false);
     }
     catch (const std::exception& ex)
     {
@@ -85,9 +100,67 @@ void ProjectM::LoadPresetData(std::istream& presetData, bool smoothTransition)
     }
 }
 
+auto ProjectM::ValidatePresetFile(const std::string& presetFilename, std::string& errorMessage) const -> bool
+{
+    try
+    {
+        m_presetFactoryManager->ValidatePresetFile(presetFilename);
+    }
+    catch (const std::exception& ex)
+    {
+        errorMessage = ex.what();
+        return false;
+    }
+
+    return true;
+}
+
+auto ProjectM::AddPresetBundle(const std::string& bundleFilename) -> bool
+{
+    return m_presetFactoryManager->AddPresetBundle(bundleFilename);
+}
+
+void ProjectM::ClearPresetBundles()
+{
+    m_presetFactoryManager->ClearPresetBundles();
+}
+
+auto ProjectM::WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename,
+                                 std::string& errorMessage) const -> bool
+{
+    try
+    {
+        m_presetFactoryManager->WritePresetBundle(presetFilenames, bundleFilename);
+    }
+    catch (const std::exception& ex)
+    {
+        errorMessage = ex.what();
+        return false;
+    }
+
+    return true;
+}
+
+auto ProjectM::ReadPresetMetadata(const std::string& presetFilename, PresetMetadata& metadata,
+                                  std::string& errorMessage) const -> bool
+{
+    try
+    {
+        metadata = m_presetFactoryManager->ReadPresetMetadata(presetFilename);
+    }
+    catch (const std::exception& ex)
+    {
+        errorMessage = ex.what();
+        return false;
+    }
+
+    return true;
+}
+
 void ProjectM::SetTexturePaths(std::vector<std::string> texturePaths)
 {
     m_textureSearchPaths = std::move(texturePaths);
+    m_presetCache->Clear();
     m_textureManager = std::make_unique<Renderer::TextureManager>(m_textureSearchPaths);
     if (m_textureLoadCallback)
     {
@@ -97,6 +170,7 @@ void ProjectM::SetTexturePaths(std::vector<std::string> texturePaths)
 
 void ProjectM::ResetTextures()
 {
+    m_presetCache->Clear();
     m_textureManager = std::make_unique<Renderer::TextureManager>(m_textureSearchPaths);
     if (m_textureLoadCallback)
     {
@@ -107,6 +181,7 @@ void ProjectM::ResetTextures()
 void ProjectM::SetTextureLoadCallback(Renderer::TextureLoadCallback callback)
 {
     m_textureLoadCallback = std::move(callback);
+    m_presetCache->Clear();
     if (m_textureManager)
     {
         m_textureManager->SetTextureLoadCallback(m_textureLoadCallback);
@@ -121,11 +196,25 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
         return;
     }
 
+    m_frameStartTime = std::chrono::steady_clock::now();
+
     // Update FPS and other timer values.
     m_timeKeeper->UpdateTimers();
+    m_displayFrameCount++;
+
+    // With a fixed simulation rate, display frames between two simulation steps only redraw the last preset output.
+    double secondsSinceLastSimulation{};
+    if (!AdvanceSimulationTime(secondsSinceLastSimulation))
+    {
+        DrawOutput(targetFramebufferObject, GetRenderContext(), m_audioStorage.GetFrameAudioData());
+
+        m_presetFrameCount++;
+        m_presetRenderTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_frameStartTime).count();
+        return;
+    }
 
     // Update and retrieve audio data
-    m_audioStorage.UpdateFrameAudioData(m_timeKeeper->SecondsSinceLastFrame(), m_frameCount);
+    m_audioStorage.UpdateFrameAudioData(secondsSinceLastSimulation, m_frameCount);
     auto audioData = m_audioStorage.GetFrameAudioData();
 
     // Check if the preset isn't locked, and we've not already notified the user
@@ -175,8 +264,11 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
     {
         if (m_transition->IsDone(m_timeKeeper->GetFrameTime()))
         {
+            RetireActivePreset();
             m_activePreset = std::move(m_transitioningPreset);
+            m_activePresetFilename = std::move(m_transitioningPresetFilename);
             m_transitioningPreset.reset();
+            m_transitioningPresetFilename.clear();
             m_transition.reset();
         }
         else
@@ -189,6 +281,45 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
     // ToDo: Call the to-be-implemented render method in Renderer
     m_activePreset->RenderFrame(audioData, renderContext);
 
+    DrawOutput(targetFramebufferObject, renderContext, audioData);
+
+    m_frameCount++;
+    m_previousFrameVolume = audioData.vol;
+
+    m_presetFrameCount++;
+    m_presetRenderTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_frameStartTime).count();
+}
+
+auto ProjectM::AdvanceSimulationTime(double& secondsSinceLastSimulation) -> bool
+{
+    m_secondsSinceLastSimulation += m_timeKeeper->SecondsSinceLastFrame();
+
+    if (m_simulationRate > 0 && !m_simulationStepRequired && m_activePreset)
+    {
+        double const simulationInterval = 1.0 / static_cast<double>(m_simulationRate);
+        if (m_secondsSinceLastSimulation < simulationInterval)
+        {
+            return false;
+        }
+
+        // Run at most one step per display frame. If the display is slower than the simulation
+        // rate, the step covers all time except one interval, so no backlog of steps builds up.
+        double const carry = std::min(m_secondsSinceLastSimulation - simulationInterval, simulationInterval);
+        secondsSinceLastSimulation = m_secondsSinceLastSimulation - carry;
+        m_secondsSinceLastSimulation = carry;
+        m_simulatedSeconds += secondsSinceLastSimulation;
+        return true;
+    }
+
+    secondsSinceLastSimulation = m_secondsSinceLastSimulation;
+    m_secondsSinceLastSimulation = 0.0;
+    m_simulationStepRequired = false;
+    m_simulatedSeconds += secondsSinceLastSimulation;
+    return true;
+}
+
+void ProjectM::DrawOutput(uint32_t targetFramebufferObject, const Renderer::RenderContext& renderContext, const Audio::FrameAudioData& audioData)
+{
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(targetFramebufferObject));
     glViewport(0, 0, renderContext.viewportSizeX, renderContext.viewportSizeY);
 
@@ -215,14 +346,33 @@ void ProjectM::RenderFrame(uint32_t targetFramebufferObject /*= 0*/)
     // Draw user sprites
     m_spriteManager->Draw(audioData, renderContext, targetFramebufferObject, {m_activePreset, m_transitioningPreset});
 
-    m_frameCount++;
-    m_previousFrameVolume = audioData.vol;
+    // Scale the finished image, including sprites, into all additional outputs.
+    m_outputTargets->Draw(targetFramebufferObject, renderContext.viewportSizeX, renderContext.viewportSizeY);
 }
 
 void ProjectM::Initialize()
 {
+    auto startTime = std::chrono::steady_clock::now();
+    auto phaseStartTime = startTime;
+
+    // Returns the time since the last call and starts the next phase.
+    auto phaseTime = [&phaseStartTime]() {
+        auto now = std::chrono::steady_clock::now();
+        auto duration = std::chrono::duration<double>(now - phaseStartTime).count();
+        phaseStartTime = now;
+        return duration;
+    };
+
+    std::random_device randomDevice;
+    m_randomGenerator.Seed((static_cast<uint64_t>(randomDevice()) << 32) | randomDevice());
+
     // Check OpenGL first before allocating any additional memory.
     CheckGLSLVersion();
+    m_startupTimes.glCheck = phaseTime();
+
+    // Create the factories first, so the idle preset is precompiled in the background while the renderer is set up.
+    m_presetFactoryManager->initialize();
+    m_startupTimes.presetFactories = phaseTime();
 
     m_timeKeeper = std::make_unique<TimeKeeper>(m_presetDuration,
                                                 m_softCutDuration,
@@ -230,19 +380,27 @@ void ProjectM::Initialize()
                                                 m_easterEgg);
 
     m_textureManager = std::make_unique<Renderer::TextureManager>(m_textureSearchPaths);
+    m_startupTimes.textureManager = phaseTime();
+
     m_shaderCache = std::make_unique<Renderer::ShaderCache>();
 
     m_transitionShaderManager = std::make_unique<Renderer::TransitionShaderManager>();
 
     m_textureCopier = std::make_unique<Renderer::CopyTexture>();
 
-    m_spriteManager = std::make_unique<UserSprites::SpriteManager>();
+    m_outputTargets = std::make_unique<Renderer::OutputTargets>();
 
-    m_presetFactoryManager->initialize();
+    m_spriteManager = std::make_unique<UserSprites::SpriteManager>();
+    m_startupTimes.renderer = phaseTime();
 
     LoadIdlePreset();
+    m_startupTimes.idlePreset = phaseTime();
 
     m_timeKeeper->StartPreset();
+
+    m_startupTimes.total = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    LOG_DEBUG("[ProjectM] Initialized in " + std::to_string(m_startupTimes.total * 1000.0) + " ms.");
 }
 
 void ProjectM::CheckGLSLVersion()
@@ -283,9 +441,12 @@ void ProjectM::SetWindowSize(uint32_t width, uint32_t height)
     /** Stash the new dimensions */
     m_windowWidth = width;
     m_windowHeight = height;
+
+    // Resize the preset framebuffers in the next frame.
+    m_simulationStepRequired = true;
 }
 
-void ProjectM::StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hardCut)
+void ProjectM::StartPresetTransition(std::unique_ptr<Preset>&& preset, const std::string& filename, bool hardCut, bool reused)
 {
     m_presetChangeNotified = m_presetLocked;
 
@@ -294,12 +455,21 @@ void ProjectM::StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hard
         return;
     }
 
-    preset->Initialize(GetRenderContext());
+    if (!reused)
+    {
+        preset->Initialize(GetRenderContext());
+    }
+
+    m_presetFrameCount = 0;
+    m_presetRenderTime = 0.0;
 
     // If already in a transition, force immediate completion.
     if (m_transitioningPreset != nullptr)
     {
+        RetireActivePreset();
         m_activePreset = std::move(m_transitioningPreset);
+        m_activePresetFilename = std::move(m_transitioningPresetFilename);
+        m_transitioningPresetFilename.clear();
         m_transition.reset();
     }
 
@@ -310,17 +480,100 @@ void ProjectM::StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hard
 
     if (hardCut)
     {
+        RetireActivePreset();
         m_activePreset = std::move(preset);
+        m_activePresetFilename = filename;
         m_timeKeeper->StartPreset();
     }
     else
     {
         m_transitioningPreset = std::move(preset);
+        m_transitioningPresetFilename = filename;
         m_timeKeeper->StartSmoothing();
-        m_transition = std::make_unique<Renderer::PresetTransition>(m_transitionShaderManager->RandomTransition(), m_softCutDuration, m_timeKeeper->GetFrameTime());
+        m_transition = std::make_unique<Renderer::PresetTransition>(m_transitionShaderManager->RandomTransition(m_randomGenerator), m_softCutDuration, m_timeKeeper->GetFrameTime(), m_randomGenerator);
+    }
+
+    // The new preset has no output yet.
+    m_simulationStepRequired = true;
+
+    // Don't count preset loading and shader compilation as rendering time.
+    m_frameStartTime = std::chrono::steady_clock::now();
+}
+
+void ProjectM::RetireActivePreset()
+{
+    m_presetCache->Store(m_activePresetFilename, std::move(m_activePreset));
+    m_activePresetFilename.clear();
+}
+
+auto ProjectM::PresetFrameCount() const -> uint32_t
+{
+    return m_presetFrameCount;
+}
+
+auto ProjectM::PresetAverageFrameTime() const -> double
+{
+    if (m_presetFrameCount == 0)
+    {
+        return 0.0;
+    }
+
+    return m_presetRenderTime / static_cast<double>(m_presetFrameCount);
+}
+
+auto ProjectM::PooledPresetMemoryBuffers() const -> uint32_t
+{
+    return m_presetFactoryManager->PooledMemoryBuffers();
+}
+
+void ProjectM::SetPresetCacheLimits(uint32_t maxPresets, size_t maxBytes)
+{
+    m_presetCache->SetLimits(maxPresets, maxBytes);
+}
+
+void ProjectM::PresetCacheStatistics(uint64_t& hits, uint64_t& misses, uint64_t& evictions,
+                                     uint32_t& cachedPresets, size_t& cachedBytes) const
+{
+    auto statistics = m_presetCache->GetStatistics();
+    hits = statistics.hits;
+    misses = statistics.misses;
+    evictions = statistics.evictions;
+    cachedPresets = statistics.cachedPresets;
+    cachedBytes = statistics.cachedBytes;
+}
+
+auto ProjectM::GetStartupTimes() const -> const StartupTimes&
+{
+    return m_startupTimes;
+}
+
+void ProjectM::LastFrameBandwidth(size_t& bytesRead, size_t& bytesWritten, size_t& renderTargetBytes) const
+{
+    bytesRead = 0;
+    bytesWritten = 0;
+    renderTargetBytes = 0;
+
+    for (const auto* preset : {m_activePreset.get(), m_transitioningPreset.get()})
+    {
+        if (preset == nullptr)
+        {
+            continue;
+        }
+
+        auto const bandwidth = preset->LastFrameBandwidth();
+        bytesRead += bandwidth.bytesRead;
+        bytesWritten += bandwidth.bytesWritten;
+        renderTargetBytes += preset->TextureMemory();
     }
 }
 
+void ProjectM::SimulationStatistics(uint64_t& displayedFrames, uint64_t& simulatedFrames, double& simulatedSeconds) const
+{
+    displayedFrames = m_displayFrameCount;
+    simulatedFrames = static_cast<uint64_t>(m_frameCount);
+    simulatedSeconds = m_simulatedSeconds;
+}
+
 auto ProjectM::WindowWidth() -> int
 {
     return m_windowWidth;
@@ -383,6 +636,16 @@ void ProjectM::BurnInTexture(uint32_t openGlTextureId, int left, int top, int wi
     Renderer::Framebuffer::Unbind();
 }
 
+auto ProjectM::AddOutputTarget(uint32_t framebufferObject, int width, int height) -> uint32_t
+{
+    return m_outputTargets->Add(framebufferObject, width, height);
+}
+
+void ProjectM::RemoveOutputTarget(uint32_t targetId)
+{
+    m_outputTargets->Remove(targetId);
+}
+
 void ProjectM::SetPresetLocked(bool locked)
 {
     // ToDo: Add a preset switch timer separate from the display timer and reset to 0 when
@@ -548,6 +811,44 @@ void ProjectM::SetTexelOffsets(float texelOffsetX, float texelOffsetY)
     m_texelOffsetY = texelOffsetY;
 }
 
+auto ProjectM::FastBlur() const -> bool
+{
+    return m_fastBlur;
+}
+
+void ProjectM::SetFastBlur(bool enabled)
+{
+    m_fastBlur = enabled;
+}
+
+auto ProjectM::GetRenderTargetQuality() const -> Renderer::RenderTargetQuality
+{
+    return m_renderTargetQuality;
+}
+
+void ProjectM::SetRenderTargetQuality(Renderer::RenderTargetQuality quality)
+{
+    m_renderTargetQuality = quality;
+    m_simulationStepRequired = true;
+}
+
+auto ProjectM::SimulationRate() const -> uint32_t
+{
+    return m_simulationRate;
+}
+
+void ProjectM::SetSimulationRate(uint32_t stepsPerSecond)
+{
+    m_simulationRate = stepsPerSecond;
+    m_secondsSinceLastSimulation = 0.0;
+    m_simulationStepRequired = true;
+}
+
+void ProjectM::SetRandomSeed(uint64_t seed)
+{
+    m_randomGenerator.Seed(seed);
+}
+
 auto ProjectM::PCM() -> libprojectM::Audio::PCM&
 {
     return m_audioStorage;
@@ -580,7 +881,7 @@ auto ProjectM::GetRenderContext() -> Renderer::RenderContext
     ctx.viewportSizeY = m_windowHeight;
     ctx.time = static_cast<float>(m_timeKeeper->GetRunningTime());
     ctx.progress = static_cast<float>(m_timeKeeper->PresetProgressA());
-    ctx.fps = static_cast<float>(m_targetFps);
+    ctx.fps = static_cast<float>(m_simulationRate > 0 ? m_simulationRate : m_targetFps);
     ctx.frame = m_frameCount;
     ctx.aspectX = (m_windowHeight > m_windowWidth) ? static_cast<float>(m_windowWidth) / static_cast<float>(m_windowHeight) : 1.0f;
     ctx.aspectY = (m_windowWidth > m_windowHeight) ? static_cast<float>(m_windowHeight) / static_cast<float>(m_windowWidth) : 1.0f;
@@ -593,8 +894,12 @@ auto ProjectM::GetRenderContext() -> Renderer::RenderContext
     ctx.texelOffsetX = m_texelOffsetX;
     ctx.texelOffsetY = m_texelOffsetY;
 
+    ctx.fastBlur = m_fastBlur;
+    ctx.renderTargetQuality = m_renderTargetQuality;
+
     ctx.textureManager = m_textureManager.get();
     ctx.shaderCache = m_shaderCache.get();
+    ctx.randomGenerator = &m_randomGenerator;
 
     if (m_transition)
     {
@@ -22,11 +22,13 @@
 
 #include <projectM-4/projectM_cxx_export.h>
 
+#include <Renderer/RandomNumberGenerator.hpp>
 #include <Renderer/RenderContext.hpp>
 #include <Renderer/TextureTypes.hpp>
 
 #include <Audio/PCM.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <istream>
 #include <memory>
@@ -37,6 +39,7 @@ namespace libprojectM {
 
 namespace Renderer {
 class CopyTexture;
+class OutputTargets;
 class PresetTransition;
 class Renderer;
 class TextureManager;
@@ -49,12 +52,30 @@ class SpriteManager;
 } // namespace UserSprites
 
 class Preset;
+class PresetCache;
 class PresetFactoryManager;
 class TimeKeeper;
+struct PresetMetadata;
 
 class PROJECTM_CXX_EXPORT ProjectM
 {
 public:
+    /**
+     * @brief Wall-clock durations of the startup phases, in seconds.
+     *
+     * CPU-only work like noise generation, decoding the built-in textures and precompiling the idle
+     * preset runs on worker threads in the background. The time spent waiting for these results is
+     * included in the phase which first needs them.
+     */
+    struct StartupTimes {
+        double glCheck{};         //!< Checking the OpenGL shader language version.
+        double presetFactories{}; //!< Registering the preset factories, starting to precompile the idle preset.
+        double textureManager{};  //!< Creating the samplers, starting to generate the built-in textures.
+        double renderer{};        //!< Creating the shader cache, transition shader manager, texture copier and sprite manager.
+        double idlePreset{};      //!< Loading the idle preset, including uploading the built-in textures and compiling shaders.
+        double total{};           //!< The whole initialization.
+    };
+
     ProjectM();
 
     ProjectM(const ProjectM& other) = delete;
@@ -100,6 +121,59 @@ public:
      */
     void LoadPresetData(std::istream& presetData, bool smoothTransition);
 
+    /**
+     * @brief Checks if the given preset file can be loaded without switching to it.
+     *
+     * Doesn't use any OpenGL functions and can safely be called from any thread.
+     *
+     * @param presetFilename The preset filename to check.
+     * @param errorMessage [out] Receives the reason if the preset can't be loaded.
+     * @return true if the preset file can be loaded, false if not.
+     */
+    auto ValidatePresetFile(const std::string& presetFilename, std::string& errorMessage) const -> bool;
+
+    /**
+     * @brief Adds a bundle of precompiled presets.
+     *
+     * Presets in the bundle are loaded from the precompiled data if LoadPresetFile() is called
+     * with the same filename as used when writing the bundle.
+     *
+     * @param bundleFilename The bundle file to add.
+     * @return true if the bundle was added, false if it can't be read.
+     */
+    auto AddPresetBundle(const std::string& bundleFilename) -> bool;
+
+    /**
+     * @brief Removes all preset bundles.
+     */
+    void ClearPresetBundles();
+
+    /**
+     * @brief Precompiles the given presets and writes them into a bundle file.
+     *
+     * Doesn't use any OpenGL functions and can safely be called from any thread.
+     *
+     * @param presetFilenames The preset files to add.
+     * @param bundleFilename The bundle file to write.
+     * @param errorMessage [out] Receives the reason if the bundle can't be written.
+     * @return true if the bundle was written, false if an error occurred.
+     */
+    auto WritePresetBundle(const std::vector<std::string>& presetFilenames, const std::string& bundleFilename,
+                           std::string& errorMessage) const -> bool;
+
+    /**
+     * @brief Reads the properties of a preset file without loading it.
+     *
+     * Doesn't use any OpenGL functions and can safely be called from any thread.
+     *
+     * @param presetFilename The preset filename to read.
+     * @param metadata [out] Receives the preset properties.
+     * @param errorMessage [out] Receives the reason if the preset can't be read.
+     * @return true if the metadata was read, false if an error occurred.
+     */
+    auto ReadPresetMetadata(const std::string& presetFilename, PresetMetadata& metadata,
+                            std::string& errorMessage) const -> bool;
+
     void SetWindowSize(uint32_t width, uint32_t height);
 
     /**
@@ -194,6 +268,20 @@ public:
 
     void SetTexelOffsets(float texelOffsetX, float texelOffsetY);
 
+    auto FastBlur() const -> bool;
+
+    void SetFastBlur(bool enabled);
+
+    auto GetRenderTargetQuality() const -> Renderer::RenderTargetQuality;
+
+    void SetRenderTargetQuality(Renderer::RenderTargetQuality quality);
+
+    auto SimulationRate() const -> uint32_t;
+
+    void SetSimulationRate(uint32_t stepsPerSecond);
+
+    void SetRandomSeed(uint64_t seed);
+
     void Touch(float touchX, float touchY, int pressure, int touchType);
 
     void TouchDrag(float touchX, float touchY, int pressure);
@@ -281,15 +369,120 @@ public:
      */
     void BurnInTexture(uint32_t openGlTextureId, int left, int top, int width, int height);
 
+    /**
+     * @brief Adds a framebuffer which receives a scaled copy of each rendered frame.
+     * @param framebufferObject The OpenGL framebuffer object to draw into.
+     * @param width The width of the framebuffer in pixels.
+     * @param height The height of the framebuffer in pixels.
+     * @return The identifier of the output target, or 0 if the size is invalid.
+     */
+    auto AddOutputTarget(uint32_t framebufferObject, int width, int height) -> uint32_t;
+
+    /**
+     * @brief Stops drawing into the given output target.
+     * @param targetId The identifier returned by AddOutputTarget().
+     */
+    void RemoveOutputTarget(uint32_t targetId);
+
+    /**
+     * @brief Returns the number of frames rendered since the current preset was started.
+     * @return The number of frames rendered with the most recently loaded preset.
+     */
+    auto PresetFrameCount() const -> uint32_t;
+
+    /**
+     * @brief Returns the average time spent in RenderFrame() since the current preset was started.
+     *
+     * While a soft transition is running, the time for rendering both presets is attributed to the
+     * newly loaded preset.
+     *
+     * @return The average frame render time in seconds, or 0.0 if no frame was rendered yet.
+     */
+    auto PresetAverageFrameTime() const -> double;
+
+    /**
+     * @brief Returns the number of expression memory buffers kept for reuse by future presets.
+     * The buffer pool is shared by all instances.
+     * @return The number of pooled buffers.
+     */
+    auto PooledPresetMemoryBuffers() const -> uint32_t;
+
+    /**
+     * @brief Sets the limits of the cache for recently used presets.
+     * @param maxPresets Max number of inactive presets kept for fast re-activation. 0 disables the cache.
+     * @param maxBytes Max estimated texture memory held by all cached presets.
+     */
+    void SetPresetCacheLimits(uint32_t maxPresets, size_t maxBytes);
+
+    /**
+     * @brief Returns the hit/miss counters and memory usage of the preset cache.
+     * @param hits [out] Number of preset loads served from the cache.
+     * @param misses [out] Number of preset file loads which had to create a new preset.
+     * @param evictions [out] Number of presets removed from the cache to stay within the limits.
+     * @param cachedPresets [out] Number of presets currently in the cache.
+     * @param cachedBytes [out] Estimated memory held by all cached presets.
+     */
+    void PresetCacheStatistics(uint64_t& hits, uint64_t& misses, uint64_t& evictions,
+                               uint32_t& cachedPresets, size_t& cachedBytes) const;
+
+    /**
+     * @brief Returns how long the phases of the projectM initialization took.
+     * @return The durations of the startup phases.
+     */
+    auto GetStartupTimes() const -> const StartupTimes&;
+
+    /**
+     * @brief Returns the estimated render target traffic of the last frame.
+     * @param bytesRead [out] Bytes read from the render targets of the displayed presets.
+     * @param bytesWritten [out] Bytes written to the render targets of the displayed presets.
+     * @param renderTargetBytes [out] Video memory allocated for the render targets of the displayed presets.
+     */
+    void LastFrameBandwidth(size_t& bytesRead, size_t& bytesWritten, size_t& renderTargetBytes) const;
+
+    /**
+     * @brief Returns how many frames were displayed and how many preset simulation steps were run.
+     * @param displayedFrames [out] Number of RenderFrame() calls since start.
+     * @param simulatedFrames [out] Number of frames in which the presets were rendered since start.
+     * @param simulatedSeconds [out] Sum of the time steps passed to the presets since start.
+     */
+    void SimulationStatistics(uint64_t& displayedFrames, uint64_t& simulatedFrames, double& simulatedSeconds) const;
+
 private:
     void Initialize();
 
     void CheckGLSLVersion();
 
-    void StartPresetTransition(std::unique_ptr<Preset>&& preset, bool hardCut);
+    /**
+     * @brief Starts displaying a new preset.
+     * @param preset The preset to display.
+     * @param filename The filename or URL the preset was loaded from, empty if loaded from a stream.
+     * @param hardCut True to switch immediately, false to blend over.
+     * @param reused True if the preset was taken from the cache and doesn't need to be initialized.
+     */
+    void StartPresetTransition(std::unique_ptr<Preset>&& preset, const std::string& filename, bool hardCut, bool reused);
+
+    /**
+     * @brief Moves the active preset into the preset cache.
+     */
+    void RetireActivePreset();
 
     void LoadIdlePreset();
 
+    /**
+     * @brief Adds the last frame time to the simulation clock and decides whether presets are rendered in this frame.
+     * @param secondsSinceLastSimulation [out] Time elapsed since the last simulation step, if one is due.
+     * @return True if the presets have to be rendered, false if the last output can be redrawn.
+     */
+    auto AdvanceSimulationTime(double& secondsSinceLastSimulation) -> bool;
+
+    /**
+     * @brief Draws the preset output or transition and the user sprites into the target framebuffer.
+     * @param targetFramebufferObject The framebuffer to draw into.
+     * @param renderContext The render context of the current frame.
+     * @param audioData The audio data of the last simulation step.
+     */
+    void DrawOutput(uint32_t targetFramebufferObject, const Renderer::RenderContext& renderContext, const Audio::FrameAudioData& audioData);
+
     auto GetRenderContext() -> Renderer::RenderContext;
 
     uint32_t m_meshX{32};            //!< Per-point mesh horizontal resolution.
@@ -308,12 +501,29 @@ private:
     float m_previousFrameVolume{};   //!< Volume in previous frame, used for hard cuts.
     float m_texelOffsetX{0.0};       //!< Horizontal warp shader texel offset
     float m_texelOffsetY{0.0};       //!< Vertical warp shader texel offset
+    bool m_fastBlur{false};          //!< If true, presets use the faster, approximated blur algorithm.
+    uint32_t m_simulationRate{0};    //!< Fixed preset simulation steps per second, or 0 to render presets in every frame.
+
+    Renderer::RenderTargetQuality m_renderTargetQuality{Renderer::RenderTargetQuality::Default}; //!< Texture formats of the preset render targets.
+
+    Renderer::RandomNumberGenerator m_randomGenerator; //!< Random number generator for presets and transitions, passed on via the render context.
 
     std::vector<std::string> m_textureSearchPaths;     ///!< List of paths to search for texture files
     Renderer::TextureLoadCallback m_textureLoadCallback; //!< Optional callback for loading textures from non-filesystem sources.
 
     /** Timing information */
-    int m_frameCount{0}; //!< Rendered frame count since start
+    int m_frameCount{0};                   //!< Simulated frame count since start
+    uint64_t m_displayFrameCount{0};       //!< Displayed frame count since start, including frames only redrawing the last output.
+    double m_secondsSinceLastSimulation{}; //!< Time accumulated since the last preset simulation step.
+    double m_simulatedSeconds{};           //!< Sum of all time steps passed to the presets.
+    bool m_simulationStepRequired{true};   //!< Forces a simulation step in the next frame, e.g. after a preset switch.
+
+    uint32_t m_presetFrameCount{0}; //!< Frames rendered since the current preset was started.
+    double m_presetRenderTime{0.0}; //!< Accumulated RenderFrame() time in seconds since the current preset was started.
+
+    std::chrono::steady_clock::time_point m_frameStartTime; //!< Start of the current frame's time measurement. Reset after loading a preset to exclude the load time.
+
+    StartupTimes m_startupTimes; //!< Durations of the initialization phases.
 
     bool m_presetLocked{false};         //!< If true, the preset change event will not be sent.
     bool m_presetChangeNotified{false}; //!< Stores whether the user has been notified that projectM wants to switch the preset.
@@ -326,8 +536,12 @@ private:
     std::unique_ptr<Renderer::ShaderCache> m_shaderCache;                         //!< The global shader cache.
     std::unique_ptr<Renderer::TransitionShaderManager> m_transitionShaderManager; //!< The transition shader manager.
     std::unique_ptr<Renderer::CopyTexture> m_textureCopier;                       //!< Class that copies textures 1:1 to another texture or framebuffer.
+    std::unique_ptr<Renderer::OutputTargets> m_outputTargets;                     //!< Additional framebuffers receiving scaled copies of the output.
     std::unique_ptr<Preset> m_activePreset;                                       //!< Currently loaded preset.
     std::unique_ptr<Preset> m_transitioningPreset;                                //!< Destination preset when smooth preset switching.
+    std::string m_activePresetFilename;                                           //!< Filename or URL of the active preset, used as the cache key.
+    std::string m_transitioningPresetFilename;                                    //!< Filename or URL of the transitioning preset, used as the cache key.
+    std::unique_ptr<PresetCache> m_presetCache;                                   //!< Recently used presets, kept for fast re-activation.
     std::unique_ptr<Renderer::PresetTransition> m_transition;                     //!< Transition effect used for blending.
     std::unique_ptr<TimeKeeper> m_timeKeeper;                                     //!< Keeps the different timers used to render and switch presets.
     std::unique_ptr<UserSprites::SpriteManager> m_spriteManager;                  //!< Manages all types of user sprites.
@@ -5,6 +5,7 @@
 #include <projectM-4/projectM.h>
 
 #include <Logging.hpp>
+#include <PresetFactory.hpp>
 
 #include <Audio/AudioConstants.hpp>
 #include <Renderer/Platform/GLResolver.hpp>
@@ -105,6 +106,9 @@ void projectm_destroy(projectm_handle instance)
 {
     auto projectMInstance = handle_to_instance(instance);
     delete projectMInstance;
+
+    // Deliver queued messages of the instance now, while the application's callback data is still valid.
+    libprojectM::Logging::Flush();
 }
 
 void projectm_load_preset_file(projectm_handle instance, const char* filename,
@@ -122,6 +126,104 @@ void projectm_load_preset_data(projectm_handle instance, const char* data,
     projectMInstance->LoadPresetData(presetDataStream, smooth_transition);
 }
 
+bool projectm_validate_preset_file(projectm_handle instance, const char* filename,
+                                   char** error_message)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    std::string errorMessage;
+    bool valid = projectMInstance->ValidatePresetFile(filename, errorMessage);
+
+    if (error_message != nullptr)
+    {
+        *error_message = valid ? nullptr : projectm_alloc_string_from_std_string(errorMessage);
+    }
+
+    return valid;
+}
+
+bool projectm_write_preset_bundle(projectm_handle instance, const char** preset_filenames,
+                                  size_t count, const char* bundle_filename,
+                                  char** error_message)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    std::vector<std::string> presetFilenames;
+    for (size_t index = 0; index < count; index++)
+    {
+        if (preset_filenames[index] != nullptr)
+        {
+            presetFilenames.emplace_back(preset_filenames[index]);
+        }
+    }
+
+    std::string errorMessage;
+    bool success = projectMInstance->WritePresetBundle(presetFilenames, bundle_filename, errorMessage);
+
+    if (error_message != nullptr)
+    {
+        *error_message = success ? nullptr : projectm_alloc_string_from_std_string(errorMessage);
+    }
+
+    return success;
+}
+
+bool projectm_add_preset_bundle(projectm_handle instance, const char* bundle_filename)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->AddPresetBundle(bundle_filename);
+}
+
+void projectm_clear_preset_bundles(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->ClearPresetBundles();
+}
+
+bool projectm_get_preset_metadata(projectm_handle instance, const char* filename,
+                                  projectm_preset_metadata* metadata, char** error_message)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    std::string errorMessage;
+    libprojectM::PresetMetadata presetMetadata;
+    bool success = projectMInstance->ReadPresetMetadata(filename, presetMetadata, errorMessage);
+
+    if (error_message != nullptr)
+    {
+        *error_message = success ? nullptr : projectm_alloc_string_from_std_string(errorMessage);
+    }
+
+    if (!success || metadata == nullptr)
+    {
+        return success;
+    }
+
+    std::string textures;
+    for (const auto& texture : presetMetadata.textures)
+    {
+        if (!textures.empty())
+        {
+            textures.push_back(' ');
+        }
+        textures.append(texture);
+    }
+
+    metadata->has_warp_shader = presetMetadata.hasWarpShader;
+    metadata->has_composite_shader = presetMetadata.hasCompositeShader;
+    metadata->has_per_pixel_code = presetMetadata.hasPerPixelCode;
+    metadata->custom_wave_count = presetMetadata.customWaveCount;
+    metadata->custom_shape_count = presetMetadata.customShapeCount;
+    metadata->max_wave_samples = presetMetadata.maxWaveSamples;
+    metadata->max_shape_instances = presetMetadata.maxShapeInstances;
+    metadata->blur_level = presetMetadata.blurLevel;
+    metadata->parse_time = presetMetadata.parseTime;
+    metadata->shader_translation_time = presetMetadata.shaderTranslationTime;
+    metadata->textures = textures.empty() ? nullptr : projectm_alloc_string_from_std_string(textures);
+
+    return true;
+}
+
 void projectm_set_preset_switch_requested_event_callback(projectm_handle instance,
                                                          projectm_preset_switch_requested_event callback, void* user_data)
 {
@@ -243,6 +345,18 @@ void projectm_opengl_burn_texture(projectm_handle instance, uint32_t texture, in
     projectMInstance->BurnInTexture(texture, left, top, width, height);
 }
 
+uint32_t projectm_opengl_add_output_target(projectm_handle instance, uint32_t framebuffer_object_id, int width, int height)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->AddOutputTarget(framebuffer_object_id, width, height);
+}
+
+void projectm_opengl_remove_output_target(projectm_handle instance, uint32_t output_target_id)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->RemoveOutputTarget(output_target_id);
+}
+
 void projectm_set_frame_time(projectm_handle instance, double seconds_since_first_frame)
 {
     auto projectMInstance = handle_to_instance(instance);
@@ -378,6 +492,69 @@ bool projectm_get_aspect_correction(projectm_handle instance)
     return projectMInstance->AspectCorrection();
 }
 
+void projectm_set_fast_blur(projectm_handle instance, bool enabled)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetFastBlur(enabled);
+}
+
+bool projectm_get_fast_blur(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->FastBlur();
+}
+
+void projectm_set_render_target_quality(projectm_handle instance, projectm_render_target_quality quality)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    switch (quality)
+    {
+        case PROJECTM_RENDER_TARGET_QUALITY_LOW:
+            projectMInstance->SetRenderTargetQuality(libprojectM::Renderer::RenderTargetQuality::Low);
+            break;
+        case PROJECTM_RENDER_TARGET_QUALITY_HIGH:
+            projectMInstance->SetRenderTargetQuality(libprojectM::Renderer::RenderTargetQuality::High);
+            break;
+        default:
+            projectMInstance->SetRenderTargetQuality(libprojectM::Renderer::RenderTargetQuality::Default);
+            break;
+    }
+}
+
+projectm_render_target_quality projectm_get_render_target_quality(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+
+    switch (projectMInstance->GetRenderTargetQuality())
+    {
+        case libprojectM::Renderer::RenderTargetQuality::Low:
+            return PROJECTM_RENDER_TARGET_QUALITY_LOW;
+        case libprojectM::Renderer::RenderTargetQuality::High:
+            return PROJECTM_RENDER_TARGET_QUALITY_HIGH;
+        default:
+            return PROJECTM_RENDER_TARGET_QUALITY_DEFAULT;
+    }
+}
+
+void projectm_set_simulation_rate(projectm_handle instance, uint32_t steps_per_second)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetSimulationRate(steps_per_second);
+}
+
+uint32_t projectm_get_simulation_rate(projectm_handle instance)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    return projectMInstance->SimulationRate();
+}
+
+void projectm_set_random_seed(projectm_handle instance, uint64_t seed)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetRandomSeed(seed);
+}
+
 void projectm_set_easter_egg(projectm_handle instance, float value)
 {
     auto projectMInstance = handle_to_instance(instance);
@@ -451,6 +628,12 @@ bool projectm_get_preset_start_clean(projectm_handle instance)
     return projectMInstance->PresetStartClean();
 }
 
+void projectm_set_preset_cache_limits(projectm_handle instance, uint32_t max_presets, size_t max_bytes)
+{
+    auto projectMInstance = handle_to_instance(instance);
+    projectMInstance->SetPresetCacheLimits(max_presets, max_bytes);
+}
+
 unsigned int projectm_pcm_get_max_samples()
 {
     return libprojectM::Audio::WaveformSamples;
@@ -484,6 +667,90 @@ auto projectm_write_debug_image_on_next_frame(projectm_handle, const char*) -> v
     // UNIMPLEMENTED
 }
 
+uint32_t projectm_get_preset_frame_count(projectm_handle instance)
+{
+    auto* projectMInstance = handle_to_instance(instance);
+
+    return projectMInstance->PresetFrameCount();
+}
+
+double projectm_get_preset_average_frame_time(projectm_handle instance)
+{
+    auto* projectMInstance = handle_to_instance(instance);
+
+    return projectMInstance->PresetAverageFrameTime();
+}
+
+void projectm_get_preset_memory_stats(projectm_handle instance, projectm_preset_memory_stats* stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+
+    auto* projectMInstance = handle_to_instance(instance);
+
+    stats->pooled_buffers = projectMInstance->PooledPresetMemoryBuffers();
+}
+
+void projectm_get_preset_cache_stats(projectm_handle instance, projectm_preset_cache_stats* stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+
+    auto* projectMInstance = handle_to_instance(instance);
+
+    projectMInstance->PresetCacheStatistics(stats->hits, stats->misses, stats->evictions,
+                                            stats->cached_presets, stats->cached_bytes);
+}
+
+void projectm_get_startup_stats(projectm_handle instance, projectm_startup_stats* stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+
+    auto* projectMInstance = handle_to_instance(instance);
+
+    const auto& startupTimes = projectMInstance->GetStartupTimes();
+    stats->gl_check_time = startupTimes.glCheck;
+    stats->preset_factory_time = startupTimes.presetFactories;
+    stats->texture_manager_time = startupTimes.textureManager;
+    stats->renderer_time = startupTimes.renderer;
+    stats->idle_preset_time = startupTimes.idlePreset;
+    stats->total_time = startupTimes.total;
+}
+
+void projectm_get_frame_bandwidth_stats(projectm_handle instance, projectm_frame_bandwidth_stats* stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+
+    auto* projectMInstance = handle_to_instance(instance);
+
+    projectMInstance->LastFrameBandwidth(stats->bytes_read, stats->bytes_written, stats->render_target_bytes);
+}
+
+void projectm_get_simulation_stats(projectm_handle instance, projectm_simulation_stats* stats)
+{
+    if (stats == nullptr)
+    {
+        return;
+    }
+
+    auto* projectMInstance = handle_to_instance(instance);
+
+    projectMInstance->SimulationStatistics(stats->displayed_frames, stats->simulated_frames, stats->simulated_seconds);
+    stats->simulation_ratio = stats->displayed_frames > 0
+                                  ? static_cast<double>(stats->simulated_frames) / static_cast<double>(stats->displayed_frames)
+                                  : 0.0;
+}
+
 uint32_t projectm_sprite_create(projectm_handle instance, const char* type, const char* code)
 {
     auto* projectMInstance = handle_to_instance(instance);
@@ -560,4 +827,19 @@ void projectm_set_log_level(projectm_log_level log_level, bool current_thread_on
     {
         libprojectM::Logging::SetGlobalLogLevel(static_cast<libprojectM::Logging::LogLevel>(log_level));
     }
+}
+
+void projectm_set_log_mode(projectm_log_mode mode)
+{
+    libprojectM::Logging::SetMode(static_cast<libprojectM::Logging::Mode>(mode));
+}
+
+uint32_t projectm_flush_logs()
+{
+    return static_cast<uint32_t>(libprojectM::Logging::Flush());
+}
+
+uint64_t projectm_get_dropped_log_messages()
+{
+    return libprojectM::Logging::DroppedMessages();
 }
\ No newline at end of file
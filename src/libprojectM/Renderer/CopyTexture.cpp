@@ -238,6 +238,12 @@ auto CopyTexture::Texture() -> std::shared_ptr<class Texture>
     return m_framebuffer.GetColorAttachmentTexture(0, 0);
 }
 
+void CopyTexture::SetFormat(GLint internalFormat, GLenum format, GLenum type)
+{
+    m_framebuffer.RemoveColorAttachment(0, 0);
+    m_framebuffer.CreateColorAttachment(0, 0, internalFormat, format, type);
+}
+
 void CopyTexture::UpdateTextureSize(int width, int height)
 {
     if (m_width == width &&
@@ -97,6 +97,19 @@ public:
      */
     auto Texture() -> std::shared_ptr<Texture>;
 
+    /**
+     * @brief Sets the texture format of the internal framebuffer.
+     *
+     * When copying into another framebuffer, the color attachments are swapped, so the format
+     * should match the format of the target framebuffer's attachment. Recreates the texture,
+     * discarding its contents.
+     *
+     * @param internalFormat OpenGL internal format, e.g. GL_RGBA8
+     * @param format Texture format, e.g. GL_RGBA
+     * @param type Data type, e.g. GL_UNSIGNED_BYTE
+     */
+    void SetFormat(GLint internalFormat, GLenum format, GLenum type);
+
 private:
     /**
      * Updates the mesh
@@ -3,7 +3,6 @@
 #include "Renderer/OpenGL.h"
 #include "Renderer/Texture.hpp"
 
-#include <chrono>
 #include <memory>
 #include <random>
 
@@ -12,32 +11,64 @@ namespace Renderer {
 
 auto MilkdropNoise::LowQuality() -> std::shared_ptr<Texture>
 {
-    return std::make_shared<Texture>("noise_lq", generate2D(256, 1).data(), GL_TEXTURE_2D, 256, 256, 0, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
+    return CreateTexture(Generate(Type::LowQuality));
 }
 
 auto MilkdropNoise::LowQualityLite() -> std::shared_ptr<Texture>
 {
-    return std::make_shared<Texture>("noise_lq_lite", generate2D(32, 1).data(), GL_TEXTURE_2D, 32, 32, 0, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
+    return CreateTexture(Generate(Type::LowQualityLite));
 }
 
 auto MilkdropNoise::MediumQuality() -> std::shared_ptr<Texture>
 {
-    return std::make_shared<Texture>("noise_mq", generate2D(256, 4).data(), GL_TEXTURE_2D, 256, 256, 0, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
+    return CreateTexture(Generate(Type::MediumQuality));
 }
 
 auto MilkdropNoise::HighQuality() -> std::shared_ptr<Texture>
 {
-    return std::make_shared<Texture>("noise_hq", generate2D(256, 8).data(), GL_TEXTURE_2D, 256, 256, 0, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
+    return CreateTexture(Generate(Type::HighQuality));
 }
 
 auto MilkdropNoise::LowQualityVolume() -> std::shared_ptr<Texture>
 {
-    return std::make_shared<Texture>("noisevol_lq", generate3D(32, 1).data(), GL_TEXTURE_3D, 32, 32, 32, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
+    return CreateTexture(Generate(Type::LowQualityVolume));
 }
 
 auto MilkdropNoise::HighQualityVolume() -> std::shared_ptr<Texture>
 {
-    return std::make_shared<Texture>("noisevol_hq", generate3D(32, 4).data(), GL_TEXTURE_3D, 32, 32, 32, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
+    return CreateTexture(Generate(Type::HighQualityVolume));
+}
+
+auto MilkdropNoise::Generate(Type type) -> Data
+{
+    switch (type)
+    {
+        case Type::LowQuality:
+            return {"noise_lq", GL_TEXTURE_2D, 256, generate2D(256, 1)};
+
+        case Type::LowQualityLite:
+            return {"noise_lq_lite", GL_TEXTURE_2D, 32, generate2D(32, 1)};
+
+        case Type::MediumQuality:
+            return {"noise_mq", GL_TEXTURE_2D, 256, generate2D(256, 4)};
+
+        case Type::HighQuality:
+            return {"noise_hq", GL_TEXTURE_2D, 256, generate2D(256, 8)};
+
+        case Type::LowQualityVolume:
+            return {"noisevol_lq", GL_TEXTURE_3D, 32, generate3D(32, 1)};
+
+        case Type::HighQualityVolume:
+            return {"noisevol_hq", GL_TEXTURE_3D, 32, generate3D(32, 4)};
+    }
+
+    return {};
+}
+
+auto MilkdropNoise::CreateTexture(const Data& data) -> std::shared_ptr<Texture>
+{
+    auto depth = data.target == GL_TEXTURE_3D ? data.size : 0;
+    return std::make_shared<Texture>(data.name, data.pixels.data(), data.target, data.size, data.size, depth, GL_RGBA8, GetPreferredInternalFormat(), GL_UNSIGNED_BYTE, false);
 }
 
 auto MilkdropNoise::GetPreferredInternalFormat() -> int
@@ -53,8 +84,9 @@ auto MilkdropNoise::GetPreferredInternalFormat() -> int
 
 auto MilkdropNoise::generate2D(int size, int zoomFactor) -> std::vector<uint32_t>
 {
-    uint32_t randomSeed = static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count());
-    std::default_random_engine randomGenerator(randomSeed);
+    // Textures may be generated concurrently, so a time-based seed could give identical textures.
+    std::random_device randomDevice;
+    std::default_random_engine randomGenerator(randomDevice());
     std::uniform_int_distribution<int> randomDistribution(0, INT32_MAX);
 
     std::vector<uint32_t> textureData;
@@ -140,8 +172,9 @@ auto MilkdropNoise::generate2D(int size, int zoomFactor) -> std::vector<uint32_t
 
 auto MilkdropNoise::generate3D(int size, int zoomFactor) -> std::vector<uint32_t>
 {
-    uint32_t randomSeed = static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count());
-    std::default_random_engine randomGenerator(randomSeed);
+    // Textures may be generated concurrently, so a time-based seed could give identical textures.
+    std::random_device randomDevice;
+    std::default_random_engine randomGenerator(randomDevice());
     std::uniform_int_distribution<int> randomDistribution(0, INT32_MAX);
 
 
@@ -4,6 +4,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace libprojectM {
@@ -27,8 +28,47 @@ namespace Renderer {
 class MilkdropNoise
 {
 public:
+    /**
+     * The available noise textures.
+     */
+    enum class Type
+    {
+        LowQuality,       //!< noise_lq
+        LowQualityLite,   //!< noise_lq_lite
+        MediumQuality,    //!< noise_mq
+        HighQuality,      //!< noise_hq
+        LowQualityVolume, //!< noisevol_lq
+        HighQualityVolume //!< noisevol_hq
+    };
+
+    /**
+     * Generated noise texture pixels which have not yet been uploaded to a texture.
+     */
+    struct Data {
+        std::string name;             //!< The texture name as used in presets, e.g. "noise_lq".
+        GLenum target{GL_TEXTURE_2D}; //!< The texture target, either GL_TEXTURE_2D or GL_TEXTURE_3D.
+        int size{};                   //!< Width, height and, for 3D textures, depth in pixels.
+        std::vector<uint32_t> pixels; //!< The RGBA pixel data.
+    };
+
     MilkdropNoise() = delete;
 
+    /**
+     * @brief Generates the pixel data of a noise texture.
+     * Doesn't call any OpenGL functions, so it can be used on any thread.
+     * @param type The noise texture to generate.
+     * @return The texture name, dimensions and pixel data.
+     */
+    static auto Generate(Type type) -> Data;
+
+    /**
+     * @brief Creates a texture from previously generated noise data.
+     * Requires a current OpenGL context.
+     * @param data The generated noise data.
+     * @return A new noise texture ready for use in rendering.
+     */
+    static auto CreateTexture(const Data& data) -> std::shared_ptr<Texture>;
+
     /**
      * Low-quality (high frequency) 2D noise texture, 256x256 with zoom level 1
      * @return A new noise texture ready for use in rendering.
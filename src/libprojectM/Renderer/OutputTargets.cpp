@@ -0,0 +1,156 @@
+#include "Renderer/OutputTargets.hpp"
+
+#include <algorithm>
+
+namespace libprojectM {
+namespace Renderer {
+
+auto OutputTargets::Add(uint32_t framebufferObject, int width, int height) -> uint32_t
+{
+    if (width <= 0 || height <= 0)
+    {
+        return 0;
+    }
+
+    Target target;
+    target.id = m_nextTargetId++;
+    target.framebufferObject = framebufferObject;
+    target.width = width;
+    target.height = height;
+
+    // Keep the targets sorted from largest to smallest, so the downsample chain only grows while drawing.
+    auto position = std::find_if(m_targets.begin(), m_targets.end(), [&target](const Target& other) {
+        return other.width * other.height < target.width * target.height;
+    });
+    m_targets.insert(position, target);
+
+    return target.id;
+}
+
+void OutputTargets::Remove(uint32_t targetId)
+{
+    m_targets.erase(std::remove_if(m_targets.begin(), m_targets.end(), [targetId](const Target& target) {
+                        return target.id == targetId;
+                    }),
+                    m_targets.end());
+
+    if (m_targets.empty())
+    {
+        m_downsampleChain.clear();
+    }
+}
+
+auto OutputTargets::Count() const -> size_t
+{
+    return m_targets.size();
+}
+
+void OutputTargets::Draw(uint32_t sourceFramebufferObject, int sourceWidth, int sourceHeight)
+{
+    m_lastDownsampleCount = 0;
+
+    if (m_targets.empty() || sourceWidth <= 0 || sourceHeight <= 0)
+    {
+        return;
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, sourceFramebufferObject);
+    GLint sampleBuffers{};
+    glGetIntegerv(GL_SAMPLE_BUFFERS, &sampleBuffers);
+
+    size_t nextLevel{};
+    Framebuffer* currentLevel{nullptr};
+    int currentWidth{sourceWidth};
+    int currentHeight{sourceHeight};
+
+    auto bindCurrentLevelRead = [&currentLevel, sourceFramebufferObject]() {
+        if (currentLevel != nullptr)
+        {
+            currentLevel->BindRead(0);
+        }
+        else
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFramebufferObject);
+        }
+    };
+
+    // Scaled blits from multisampled framebuffers aren't allowed, so resolve the image first.
+    if (sampleBuffers > 0)
+    {
+        auto& resolvedImage = ChainLevel(nextLevel++, sourceWidth, sourceHeight);
+        bindCurrentLevelRead();
+        resolvedImage.BindDraw(0);
+        Blit(sourceWidth, sourceHeight, sourceWidth, sourceHeight);
+        currentLevel = &resolvedImage;
+    }
+
+    // The image all targets start from, either the source or its resolved copy.
+    Framebuffer* const baseLevel{currentLevel};
+
+    auto halveIfLarger = [](int size, int targetSize) {
+        return size / 2 >= targetSize ? size / 2 : size;
+    };
+
+    for (const auto& target : m_targets)
+    {
+        // Targets are only sorted by area, so a previous target may have reduced one axis too far.
+        if (currentWidth < target.width || currentHeight < target.height)
+        {
+            currentLevel = baseLevel;
+            currentWidth = sourceWidth;
+            currentHeight = sourceHeight;
+        }
+
+        // Halve each axis independently until the target is at most a factor of two smaller.
+        while (currentWidth / 2 >= target.width || currentHeight / 2 >= target.height)
+        {
+            int const halfWidth = halveIfLarger(currentWidth, target.width);
+            int const halfHeight = halveIfLarger(currentHeight, target.height);
+
+            auto& halfSizeImage = ChainLevel(nextLevel++, halfWidth, halfHeight);
+            bindCurrentLevelRead();
+            halfSizeImage.BindDraw(0);
+            Blit(currentWidth, currentHeight, halfWidth, halfHeight);
+
+            currentLevel = &halfSizeImage;
+            currentWidth = halfWidth;
+            currentHeight = halfHeight;
+            m_lastDownsampleCount++;
+        }
+
+        bindCurrentLevelRead();
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target.framebufferObject);
+        Blit(currentWidth, currentHeight, target.width, target.height);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, sourceFramebufferObject);
+}
+
+auto OutputTargets::LastDownsampleCount() const -> int
+{
+    return m_lastDownsampleCount;
+}
+
+auto OutputTargets::ChainLevel(size_t level, int width, int height) -> Framebuffer&
+{
+    while (m_downsampleChain.size() <= level)
+    {
+        m_downsampleChain.push_back(std::make_unique<Framebuffer>());
+        m_downsampleChain.back()->CreateColorAttachment(0, 0);
+    }
+
+    auto& framebuffer = *m_downsampleChain.at(level);
+    framebuffer.SetSize(width, height);
+
+    return framebuffer;
+}
+
+void OutputTargets::Blit(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight)
+{
+    // At exactly half size, linear filtering averages each 2x2 pixel block.
+    GLenum const filter = (sourceWidth == targetWidth && sourceHeight == targetHeight) ? GL_NEAREST : GL_LINEAR;
+    glBlitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, targetWidth, targetHeight, GL_COLOR_BUFFER_BIT, filter);
+}
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Renderer/Framebuffer.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief Copies the final rendered image into additional framebuffers with their own sizes.
+ *
+ * Used to feed e.g. a low-resolution preview from the same simulation step as the main output.
+ * The targets are not rendered separately. Instead, the main output is scaled down with
+ * framebuffer blits. Targets smaller than half the size of the source are fed from a chain of
+ * intermediate images, each halving the width, the height or both, so each blit only has to
+ * reduce the size by up to a factor of two per axis, which keeps the linear filtering free of
+ * aliasing. The chain is shared between targets as long as each target fits into the current
+ * level. A target that is larger than the current level on either axis restarts the chain from
+ * the source image.
+ */
+class OutputTargets
+{
+public:
+    /**
+     * @brief Adds a new output target.
+     * @param framebufferObject The OpenGL framebuffer object to draw into.
+     * @param width The width of the target in pixels.
+     * @param height The height of the target in pixels.
+     * @return The identifier of the new target, or 0 if the size is invalid.
+     */
+    auto Add(uint32_t framebufferObject, int width, int height) -> uint32_t;
+
+    /**
+     * @brief Removes an output target.
+     * @param targetId The identifier returned by Add(). Unknown identifiers are ignored.
+     */
+    void Remove(uint32_t targetId);
+
+    /**
+     * @brief Returns the number of registered output targets.
+     * @return The number of output targets.
+     */
+    auto Count() const -> size_t;
+
+    /**
+     * @brief Copies the contents of the source framebuffer into all output targets.
+     * Binds the source framebuffer again when done.
+     * @param sourceFramebufferObject The framebuffer holding the final rendered image.
+     * @param sourceWidth The width of the rendered image in pixels.
+     * @param sourceHeight The height of the rendered image in pixels.
+     */
+    void Draw(uint32_t sourceFramebufferObject, int sourceWidth, int sourceHeight);
+
+    /**
+     * @brief Returns the number of intermediate downsampled images created during the last Draw() call.
+     * @return The number of downsample steps in the last frame.
+     */
+    auto LastDownsampleCount() const -> int;
+
+private:
+    /**
+     * @brief An external framebuffer receiving a scaled copy of the output.
+     */
+    struct Target {
+        uint32_t id{};                //!< Identifier of the target.
+        uint32_t framebufferObject{}; //!< OpenGL framebuffer object to draw into.
+        int width{};                  //!< Width of the target in pixels.
+        int height{};                 //!< Height of the target in pixels.
+    };
+
+    /**
+     * @brief Returns the given level of the downsample chain, resized to the given size if needed.
+     * @param level The chain level.
+     * @param width The required width of the level.
+     * @param height The required height of the level.
+     * @return The framebuffer of the requested level.
+     */
+    auto ChainLevel(size_t level, int width, int height) -> Framebuffer&;
+
+    /**
+     * @brief Copies the currently bound read framebuffer into the currently bound draw framebuffer.
+     * @param sourceWidth The width of the read framebuffer.
+     * @param sourceHeight The height of the read framebuffer.
+     * @param targetWidth The width of the draw framebuffer.
+     * @param targetHeight The height of the draw framebuffer.
+     */
+    static void Blit(int sourceWidth, int sourceHeight, int targetWidth, int targetHeight);
+
+    std::vector<Target> m_targets;                              //!< Registered targets, largest first.
+    std::vector<std::unique_ptr<Framebuffer>> m_downsampleChain; //!< Intermediate images, each halving one or both axes of the previous level.
+    uint32_t m_nextTargetId{1};                                 //!< Identifier for the next added target.
+    int m_lastDownsampleCount{};                                //!< Downsample steps in the last frame.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
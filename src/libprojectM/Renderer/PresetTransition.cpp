@@ -10,11 +10,13 @@ namespace Renderer {
 
 constexpr double PI = 3.14159265358979323846;
 
-PresetTransition::PresetTransition(const std::shared_ptr<Shader>& transitionShader, double durationSeconds, double transitionStartTime)
+PresetTransition::PresetTransition(const std::shared_ptr<Shader>& transitionShader, double durationSeconds, double transitionStartTime,
+                                   RandomNumberGenerator& randomGenerator)
     : m_mesh(VertexBufferUsage::StaticDraw)
     , m_transitionShader(transitionShader)
     , m_durationSeconds(durationSeconds)
     , m_transitionStartTime(transitionStartTime)
+    , m_randomGenerator(randomGenerator.NextSeed())
 {
     m_mesh.SetRenderPrimitiveType(Mesh::PrimitiveType::TriangleStrip);
 
@@ -27,8 +29,7 @@ PresetTransition::PresetTransition(const std::shared_ptr<Shader>& transitionShad
 
     m_mesh.Update();
 
-    std::mt19937 rand32(m_randomDevice());
-    m_staticRandomValues = {rand32(), rand32(), rand32(), rand32()};
+    m_staticRandomValues = {m_randomGenerator(), m_randomGenerator(), m_randomGenerator(), m_randomGenerator()};
 }
 
 auto PresetTransition::IsDone(double currentFrameTime) const -> bool
@@ -53,8 +54,6 @@ void PresetTransition::Draw(const Preset& oldPreset,
         return;
     }
 
-    std::mt19937 rand32(m_randomDevice());
-
     // Calculate progress values
     const auto secondsSinceStart = currentFrameTime - m_transitionStartTime;
 
@@ -87,10 +86,10 @@ void PresetTransition::Draw(const Preset& oldPreset,
 
     m_transitionShader->SetUniformInt4("iRandStatic", m_staticRandomValues);
 
-    m_transitionShader->SetUniformInt4("iRandFrame", {rand32(),
-                                                      rand32(),
-                                                      rand32(),
-                                                      rand32()});
+    m_transitionShader->SetUniformInt4("iRandFrame", {m_randomGenerator(),
+                                                      m_randomGenerator(),
+                                                      m_randomGenerator(),
+                                                      m_randomGenerator()});
 
     m_transitionShader->SetUniformFloat3("iBeatValues", {audioData.bass,
                                                          audioData.mid,
@@ -1,14 +1,13 @@
 #pragma once
 
 #include "Renderer/Mesh.hpp"
+#include "Renderer/RandomNumberGenerator.hpp"
 #include "Renderer/Shader.hpp"
 
 #include <Preset.hpp>
 
 #include <glm/glm.hpp>
 
-#include <random>
-
 namespace libprojectM {
 namespace Renderer {
 
@@ -25,10 +24,12 @@ public:
      * @param transitionShader The transition shader program.
      * @param durationSeconds Transition duration in seconds.
      * @param transitionStartTime The time in seconds since start of projectM.
+     * @param randomGenerator The projectM instance's random number generator, used to seed the transition's own generator.
      */
     explicit PresetTransition(const std::shared_ptr<Shader>& transitionShader,
                               double durationSeconds,
-                              double transitionStartTime);
+                              double transitionStartTime,
+                              RandomNumberGenerator& randomGenerator);
 
     /**
      * @brief Returns true if the transition is done.
@@ -80,7 +81,7 @@ private:
 
     glm::ivec4 m_staticRandomValues{}; //!< Four random integers, remaining static during the whole transition.
 
-    std::random_device m_randomDevice; //!< Seed for the random number generator
+    RandomNumberGenerator m_randomGenerator; //!< Generator for the per-frame random values.
 };
 
 } // namespace Renderer
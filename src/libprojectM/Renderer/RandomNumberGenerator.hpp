@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace libprojectM {
+namespace Renderer {
+
+/**
+ * @brief A small and fast pseudo-random number generator, using the xoshiro128** algorithm.
+ *
+ * Each projectM instance owns one generator, which is made available to presets and transitions
+ * via the render context. Drawing a value only takes a few integer operations, so it can be used
+ * every frame without the cost of constructing a std::random_device or std::mt19937.
+ *
+ * Meets the UniformRandomBitGenerator requirements, so it can also be used with the standard
+ * library distributions. The generator is not thread-safe.
+ */
+class RandomNumberGenerator
+{
+public:
+    using result_type = uint32_t;
+
+    RandomNumberGenerator() = default;
+
+    /**
+     * @brief Constructor. Seeds the generator with the given value.
+     * @param seed The seed value.
+     */
+    explicit RandomNumberGenerator(uint64_t seed)
+    {
+        Seed(seed);
+    }
+
+    /**
+     * @brief Resets the generator state, deriving it from the given seed.
+     * The same seed always produces the same sequence of numbers.
+     * @param seed The seed value.
+     */
+    void Seed(uint64_t seed)
+    {
+        // Expand the seed with splitmix64, as recommended for the xoshiro generators.
+        for (std::size_t index = 0; index < m_state.size(); index += 2)
+        {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t value = seed;
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+            value ^= value >> 31;
+
+            m_state[index] = static_cast<uint32_t>(value);
+            m_state[index + 1] = static_cast<uint32_t>(value >> 32);
+        }
+    }
+
+    static constexpr auto min() -> result_type
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr auto max() -> result_type
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    /**
+     * @brief Returns the next 32-bit random value.
+     * @return A random value in the full 32-bit range.
+     */
+    auto operator()() -> result_type
+    {
+        const uint32_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+        const uint32_t shifted = m_state[1] << 9;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+
+        m_state[2] ^= shifted;
+        m_state[3] = RotateLeft(m_state[3], 11);
+
+        return result;
+    }
+
+    /**
+     * @brief Returns a random float value between 0.0 (inclusive) and 1.0 (exclusive).
+     * @return The random value.
+     */
+    auto NextFloat() -> float
+    {
+        // Use the upper 24 bits, which exactly fit into the float mantissa.
+        return static_cast<float>((*this)() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    /**
+     * @brief Returns a random index between 0 (inclusive) and the given count (exclusive).
+     * @param count The number of possible values. Must be greater than zero.
+     * @return The random index.
+     */
+    auto NextIndex(uint32_t count) -> uint32_t
+    {
+        // Multiply-shift range reduction, avoids the division of a modulo operation.
+        return static_cast<uint32_t>((static_cast<uint64_t>((*this)()) * count) >> 32);
+    }
+
+    /**
+     * @brief Returns a new seed value, e.g. to initialize another generator from this one.
+     * @return A random 64-bit seed value.
+     */
+    auto NextSeed() -> uint64_t
+    {
+        const uint64_t high = (*this)();
+        return (high << 32) | (*this)();
+    }
+
+private:
+    static auto RotateLeft(uint32_t value, int bits) -> uint32_t
+    {
+        return (value << bits) | (value >> (32 - bits));
+    }
+
+    std::array<uint32_t, 4> m_state{0x9E3779B9U, 0x243F6A88U, 0xB7E15162U, 0x85A308D3U}; //!< Generator state. Must never be all zeros.
+};
+
+} // namespace Renderer
+} // namespace libprojectM
@@ -9,9 +9,23 @@
 namespace libprojectM {
 namespace Renderer {
 
+class RandomNumberGenerator;
 class ShaderCache;
 class TextureManager;
 
+/**
+ * @brief Selects the texture formats of the preset render targets.
+ *
+ * Lower quality settings reduce the memory bandwidth needed per frame, which is often the
+ * limiting factor on integrated GPUs.
+ */
+enum class RenderTargetQuality : int
+{
+    Low,     //!< 8 bits per channel main images and motion vector u/v map.
+    Default, //!< 8 bits per channel main images, 16-bit float motion vector u/v map.
+    High     //!< 10 bits per color channel main images, 16-bit float motion vector u/v map.
+};
+
 /**
  * @brief Holds all global data of the current rendering context, which can change from frame to frame.
  */
@@ -36,8 +50,13 @@ public:
     float texelOffsetX{0.0f}; //!< Horizontal texel offset in the warp shader.
     float texelOffsetY{0.0f}; //!< Vertical texel offset in the warp shader.
 
+    bool fastBlur{false}; //!< Use the faster, approximated blur algorithm for preset blur textures.
+
+    RenderTargetQuality renderTargetQuality{RenderTargetQuality::Default}; //!< Texture formats of the preset render targets.
+
     TextureManager* textureManager{nullptr}; //!< Holds all loaded textures for shader access.
     ShaderCache* shaderCache{nullptr}; //!< The shader chace of this projectM instance.
+    RandomNumberGenerator* randomGenerator{nullptr}; //!< The random number generator of this projectM instance. Only use it on the render thread.
 };
 
 } // namespace Renderer
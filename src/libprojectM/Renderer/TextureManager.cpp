@@ -12,8 +12,8 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <future>
 #include <memory>
-#include <random>
 #include <vector>
 
 // Missing in macOS SDK. Query will most certainly fail, but then use the default format.
@@ -37,6 +37,8 @@ void TextureManager::SetCurrentPresetPath(const std::string&)
 
 TextureSamplerDescriptor TextureManager::GetTexture(const std::string& fullName)
 {
+    CreatePreloadedTextures();
+
     std::string unqualifiedName;
     GLint wrapMode;
     GLint filterMode;
@@ -69,41 +71,55 @@ void TextureManager::Preload()
     m_samplers.emplace(std::make_pair(GL_REPEAT, GL_LINEAR), std::make_shared<Sampler>(GL_REPEAT, GL_LINEAR));
     m_samplers.emplace(std::make_pair(GL_REPEAT, GL_NEAREST), std::make_shared<Sampler>(GL_REPEAT, GL_NEAREST));
 
-    int width{};
-    int height{};
-    int channels{};
+    // Decoding the images and generating noise doesn't need OpenGL, so it can run in the background.
+    m_pendingImages.push_back(std::async(std::launch::async, &TextureManager::DecodeImage, "idlem", M_data, M_bytes));
+    m_pendingImages.push_back(std::async(std::launch::async, &TextureManager::DecodeImage, "idleheadphones", headphones_data, headphones_bytes));
 
+    for (auto type : {MilkdropNoise::Type::LowQualityLite,
+                      MilkdropNoise::Type::LowQuality,
+                      MilkdropNoise::Type::MediumQuality,
+                      MilkdropNoise::Type::HighQuality,
+                      MilkdropNoise::Type::LowQualityVolume,
+                      MilkdropNoise::Type::HighQualityVolume})
     {
-        std::unique_ptr<stbi_uc, decltype(&free)> const imageData(stbi_load_from_memory(M_data, M_bytes, &width, &height, &channels, 0), free);
+        m_pendingNoiseTextures.push_back(std::async(std::launch::async, &MilkdropNoise::Generate, type));
+    }
+}
 
-        if (imageData.get() != nullptr)
+void TextureManager::CreatePreloadedTextures()
+{
+    for (auto& pendingImage : m_pendingImages)
+    {
+        auto image = pendingImage.get();
+        if (image.pixels)
         {
-            auto format = TextureFormatFromChannels(channels);
-            m_textures["idlem"] = std::make_shared<Texture>("idlem", reinterpret_cast<const void*>(imageData.get()), GL_TEXTURE_2D, width, height, 0, format, format, GL_UNSIGNED_BYTE, false);
+            auto format = TextureFormatFromChannels(image.channels);
+            m_textures[image.name] = std::make_shared<Texture>(image.name, reinterpret_cast<const void*>(image.pixels.get()), GL_TEXTURE_2D, image.width, image.height, 0, format, format, GL_UNSIGNED_BYTE, false);
         }
     }
+    m_pendingImages.clear();
 
+    for (auto& pendingNoiseTexture : m_pendingNoiseTextures)
     {
-        std::unique_ptr<stbi_uc, decltype(&free)> const imageData(stbi_load_from_memory(headphones_data, headphones_bytes, &width, &height, &channels, 0), free);
-
-        if (imageData.get() != nullptr)
-        {
-            auto format = TextureFormatFromChannels(channels);
-            m_textures["idleheadphones"] = std::make_shared<Texture>("idleheadphones", reinterpret_cast<const void*>(imageData.get()), GL_TEXTURE_2D, width, height, 0, format, format, GL_UNSIGNED_BYTE, false);
-        }
+        auto noise = pendingNoiseTexture.get();
+        m_textures[noise.name] = MilkdropNoise::CreateTexture(noise);
     }
+    m_pendingNoiseTextures.clear();
+}
 
-    // Noise textures
-    m_textures["noise_lq_lite"] = MilkdropNoise::LowQualityLite();
-    m_textures["noise_lq"] = MilkdropNoise::LowQuality();
-    m_textures["noise_mq"] = MilkdropNoise::MediumQuality();
-    m_textures["noise_hq"] = MilkdropNoise::HighQuality();
-    m_textures["noisevol_lq"] = MilkdropNoise::LowQualityVolume();
-    m_textures["noisevol_hq"] = MilkdropNoise::HighQualityVolume();
+auto TextureManager::DecodeImage(const std::string& name, const unsigned char* data, int size) -> DecodedImage
+{
+    DecodedImage image;
+    image.name = name;
+    image.pixels.reset(stbi_load_from_memory(data, size, &image.width, &image.height, &image.channels, 0));
+
+    return image;
 }
 
 void TextureManager::PurgeTextures()
 {
+    CreatePreloadedTextures();
+
     // Increment age of all textures
     for (auto& texture : m_textures)
     {
@@ -280,13 +296,10 @@ auto TextureManager::LoadTexture(const ScannedFile& file) -> std::shared_ptr<Tex
     return newTexture;
 }
 
-auto TextureManager::GetRandomTexture(const std::string& randomName) -> TextureSamplerDescriptor
+auto TextureManager::GetRandomTexture(const std::string& randomName, RandomNumberGenerator& randomGenerator) -> TextureSamplerDescriptor
 {
     std::string selectedFilename;
 
-    std::random_device rndDevice;
-    std::default_random_engine rndEngine(rndDevice());
-
     ScanTextures();
 
     std::string lowerCaseName = Utils::ToLower(randomName);
@@ -306,8 +319,8 @@ auto TextureManager::GetRandomTexture(const std::string& randomName) -> TextureS
     if (prefix.empty())
     {
         // Just pick a random index.
-        std::uniform_int_distribution<size_t> distribution(0, m_scannedTextureFiles.size() - 1);
-        selectedFilename = m_scannedTextureFiles.at(distribution(rndEngine)).lowerCaseBaseName;
+        auto index = randomGenerator.NextIndex(static_cast<uint32_t>(m_scannedTextureFiles.size()));
+        selectedFilename = m_scannedTextureFiles.at(index).lowerCaseBaseName;
     }
     else
     {
@@ -322,8 +335,8 @@ auto TextureManager::GetRandomTexture(const std::string& randomName) -> TextureS
 
         if (!filteredFiles.empty())
         {
-            std::uniform_int_distribution<size_t> distribution(0, filteredFiles.size() - 1);
-            selectedFilename = filteredFiles.at(distribution(rndEngine)).lowerCaseBaseName;
+            auto index = randomGenerator.NextIndex(static_cast<uint32_t>(filteredFiles.size()));
+            selectedFilename = filteredFiles.at(index).lowerCaseBaseName;
         }
     }
 
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "Renderer/MilkdropNoise.hpp"
+#include "Renderer/RandomNumberGenerator.hpp"
 #include "Renderer/TextureSamplerDescriptor.hpp"
 #include "Renderer/TextureTypes.hpp"
 
+#include <cstdlib>
+#include <future>
 #include <map>
 #include <string>
 #include <vector>
@@ -17,6 +21,10 @@ public:
 
     /**
      * Constructor.
+     *
+     * Starts generating the noise textures and decoding the built-in idle textures on worker threads.
+     * The results are uploaded to OpenGL textures when a texture is first requested.
+     *
      * @param textureSearchPaths List of paths to search for textures. These paths are searched in the given order.
      */
     TextureManager(const std::vector<std::string>& textureSearchPaths);
@@ -41,9 +49,10 @@ public:
      * @brief Returns a random texture descriptor, optionally using a prefix (after the `randXX_` name).
      * Will use the default texture loading logic by calling GetTexture() if a texture was selected.
      * @param randomName The filename prefix to filter. If empty, all available textures are matches. Case-insensitive.
+     * @param randomGenerator The random number generator used to select the texture.
      * @return A texture descriptor with the random texture and a default sampler, or an empty sampler if no texture could be matched.
      */
-    auto GetRandomTexture(const std::string& randomName) -> TextureSamplerDescriptor;
+    auto GetRandomTexture(const std::string& randomName, RandomNumberGenerator& randomGenerator) -> TextureSamplerDescriptor;
 
     /**
      * @brief Returns a sampler for the given name.
@@ -77,6 +86,17 @@ private:
         uint32_t sizeBytes{}; //!< The texture in-memory size in bytes.
     };
 
+    /**
+     * A built-in image, decoded on a worker thread.
+     */
+    struct DecodedImage {
+        std::string name;                                                      //!< The texture name.
+        int width{};                                                           //!< Image width in pixels.
+        int height{};                                                          //!< Image height in pixels.
+        int channels{};                                                        //!< Number of color channels.
+        std::unique_ptr<unsigned char, decltype(&free)> pixels{nullptr, free}; //!< The decoded pixel data, nullptr if decoding failed.
+    };
+
     /**
      * A scanned texture file on the disk.
      */
@@ -89,6 +109,14 @@ private:
 
     void Preload();
 
+    /**
+     * @brief Waits for the preload workers and creates the built-in textures.
+     * Only does work on the first call after construction. Must be called on the OpenGL thread.
+     */
+    void CreatePreloadedTextures();
+
+    static auto DecodeImage(const std::string& name, const unsigned char* data, int size) -> DecodedImage;
+
     auto LoadTexture(const ScannedFile& file) -> std::shared_ptr<Texture>;
 
     void AddTextureFile(const std::string& fileName, const std::string& baseName);
@@ -111,6 +139,9 @@ private:
     std::vector<std::string> m_randomTextures;
     std::vector<std::string> m_extensions{".jpg", ".jpeg", ".dds", ".png", ".tga", ".bmp", ".dib"};
 
+    std::vector<std::future<DecodedImage>> m_pendingImages;               //!< Built-in images being decoded on worker threads.
+    std::vector<std::future<MilkdropNoise::Data>> m_pendingNoiseTextures; //!< Noise textures being generated on worker threads.
+
     TextureLoadCallback m_textureLoadCallback; //!< Optional callback for loading textures from non-filesystem sources.
 };
 
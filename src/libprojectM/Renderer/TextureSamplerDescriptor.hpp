@@ -99,6 +99,21 @@ public:
      */
     auto TexSizeDeclaration() const -> std::string;
 
+    /**
+     * @brief Returns the shader sampler HLSL declaration for a sampler name.
+     * @param samplerName The sampler name, without the "sampler_" prefix.
+     * @param volumeTexture True if the sampler is used with a 3D texture.
+     * @return The sampler declaration for use in the preset HLSL shaders.
+     */
+    static auto SamplerDeclaration(const std::string& samplerName, bool volumeTexture) -> std::string;
+
+    /**
+     * @brief Returns the shader texsize HLSL declaration for a texture size name.
+     * @param sizeName The texture size name, without the "texsize_" prefix.
+     * @return The texsize declaration for use in the preset HLSL shaders.
+     */
+    static auto TexSizeDeclaration(const std::string& sizeName) -> std::string;
+
     /**
      * @brief Tries to update the texture and sampler from the given texture manager if invalid.
      * @param textureManager The texture manager to retrieve the new data from.
@@ -6,24 +6,32 @@ namespace libprojectM {
 namespace Renderer {
 
 TransitionShaderManager::TransitionShaderManager()
-    : m_transitionShaders({CompileTransitionShader(kTransitionShaderBuiltInCircleGlsl330),
-                           CompileTransitionShader(kTransitionShaderBuiltInPlasmaGlsl330),
-                           CompileTransitionShader(kTransitionShaderBuiltInSimpleBlendGlsl330),
-                           CompileTransitionShader(kTransitionShaderBuiltInSweepGlsl330),
-                           CompileTransitionShader(kTransitionShaderBuiltInWarpGlsl330),
-                           CompileTransitionShader(kTransitionShaderBuiltInZoomBlurGlsl330)})
-    , m_mersenneTwister(m_randomDevice())
+    : m_transitionShaderSources({kTransitionShaderBuiltInCircleGlsl330,
+                                 kTransitionShaderBuiltInPlasmaGlsl330,
+                                 kTransitionShaderBuiltInSimpleBlendGlsl330,
+                                 kTransitionShaderBuiltInSweepGlsl330,
+                                 kTransitionShaderBuiltInWarpGlsl330,
+                                 kTransitionShaderBuiltInZoomBlurGlsl330})
+    , m_transitionShaders(m_transitionShaderSources.size())
+    , m_transitionShadersCompiled(m_transitionShaderSources.size(), false)
 {
 }
 
-auto TransitionShaderManager::RandomTransition() -> std::shared_ptr<Shader>
+auto TransitionShaderManager::RandomTransition(RandomNumberGenerator& randomGenerator) -> std::shared_ptr<Shader>
 {
-    if (m_transitionShaders.empty())
+    if (m_transitionShaderSources.empty())
     {
         return {};
     }
 
-    return m_transitionShaders.at(m_mersenneTwister() % m_transitionShaders.size());
+    auto index = randomGenerator.NextIndex(static_cast<uint32_t>(m_transitionShaderSources.size()));
+    if (!m_transitionShadersCompiled.at(index))
+    {
+        m_transitionShaders.at(index) = CompileTransitionShader(m_transitionShaderSources.at(index));
+        m_transitionShadersCompiled.at(index) = true;
+    }
+
+    return m_transitionShaders.at(index);
 }
 
 auto TransitionShaderManager::CompileTransitionShader(const std::string& shaderBodyCode) -> std::shared_ptr<Shader>
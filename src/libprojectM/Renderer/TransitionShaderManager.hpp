@@ -1,14 +1,19 @@
 #pragma once
 
+#include "Renderer/RandomNumberGenerator.hpp"
 #include "Renderer/Shader.hpp"
 
-#include <random>
+#include <string>
+#include <vector>
 
 namespace libprojectM {
 namespace Renderer {
 
 /**
  * @brief Manages all available transition shaders.
+ *
+ * Shaders are compiled on first use, so creating the manager doesn't add the compile time of all
+ * built-in transitions to the projectM startup time.
  */
 class TransitionShaderManager
 {
@@ -17,9 +22,10 @@ public:
 
     /**
      * @brief Selects a random transition shader from the list.
+     * @param randomGenerator The random number generator used to pick the shader.
      * @return A shared pointer to a transition shader.
      */
-    auto RandomTransition() -> std::shared_ptr<Shader>;
+    auto RandomTransition(RandomNumberGenerator& randomGenerator) -> std::shared_ptr<Shader>;
 
 private:
     /**
@@ -28,10 +34,9 @@ private:
      */
     static auto CompileTransitionShader(const std::string& shaderBodyCode) -> std::shared_ptr<Shader>;
 
-    std::vector<std::shared_ptr<Shader>> m_transitionShaders; //!< Currently loaded and compiled transition shaders.
-
-    std::random_device m_randomDevice; //!< Seed for the random number generator
-    std::mt19937 m_mersenneTwister; //!< Random engine to select shader
+    std::vector<std::string> m_transitionShaderSources;       //!< Body code of all available transition shaders.
+    std::vector<std::shared_ptr<Shader>> m_transitionShaders; //!< Compiled transition shaders, same order as the sources.
+    std::vector<bool> m_transitionShadersCompiled;            //!< Whether a compile was attempted for the shader at the same index.
 };
 
 } // namespace Renderer
@@ -2,19 +2,13 @@
 
 #include "UserSprites/SpriteException.hpp"
 
-#include "SpriteShaders.hpp"
-
 #include <MilkdropPreset/PresetFileParser.hpp>
 
-#include <Preset.hpp>
-
-#include <Renderer/BlendMode.hpp>
-#include <Renderer/ShaderCache.hpp>
 #include <Renderer/TextureManager.hpp>
 
 #include <Utils.hpp>
 
-#include <cassert>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <locale>
@@ -27,14 +21,7 @@
 namespace libprojectM {
 namespace UserSprites {
 
-MilkdropSprite::MilkdropSprite()
-    : m_mesh(Renderer::VertexBufferUsage::DynamicDraw, false, true)
-{
-    m_mesh.SetRenderPrimitiveType(Renderer::Mesh::PrimitiveType::TriangleStrip);
-    m_mesh.SetVertexCount(4);
-}
-
-void MilkdropSprite::Init(const std::string& spriteData, const Renderer::RenderContext& renderContext)
+auto MilkdropSprite::Parse(const std::string& spriteData) const -> std::shared_ptr<const SpriteDefinition>
 {
     MilkdropPreset::PresetFileParser parser;
     std::stringstream spriteDataStream(spriteData);
@@ -43,57 +30,57 @@ void MilkdropSprite::Init(const std::string& spriteData, const Renderer::RenderC
         throw SpriteException("Error reading sprite data.");
     }
 
-    // Load/compile shader
-    auto spriteShader = renderContext.shaderCache->Get("milkdrop_user_sprite");
-    if (!spriteShader)
-    {
-        // ToDo: Better handle this in the shader class to reduce duplicate code.
-#ifdef USE_GLES
-        // GLES also requires a precision specifier for variables and 3D samplers
-        constexpr char versionHeader[] = "#version 300 es\n\nprecision mediump float;\nprecision mediump sampler3D;\n";
-#else
-        constexpr char versionHeader[] = "#version 330\n\n";
-#endif
-
-        spriteShader = std::make_shared<Renderer::Shader>();
-        spriteShader->CompileProgram(static_cast<const char*>(versionHeader) + kMilkdropSpriteVertexGlsl330,
-                                     static_cast<const char*>(versionHeader) + kMilkdropSpriteFragmentGlsl330);
-        renderContext.shaderCache->Insert("milkdrop_user_sprite", spriteShader);
-    }
-
-    m_spriteShader = spriteShader;
-
     // We ignore the color key value here because OpenGL doesn't support those (DirectX has a specific texture
     // render state for this, which replaces the given color value with transparent texels).
     // Since sprites are user-supplied, we can just make blend mode 4 based on the texture's alpha channel,
     // which gives way better results and users can easily convert any image to PNG.
 
-    // Load and compile code
-    auto initCode = parser.GetCode("init_");
-    m_codeContext.RunInitCode(initCode, renderContext);
+    auto definition = std::make_shared<Definition>();
+    definition->initCode = parser.GetCode("init_");
+    definition->perFrameCode = parser.GetCode("code_");
+    definition->imageName = Utils::ToLower(parser.GetString("img", ""));
 
-    auto perFrameCode = parser.GetCode("code_");
-    if (!perFrameCode.empty())
+    return definition;
+}
+
+MilkdropSprite::~MilkdropSprite()
+{
+    if (m_definition && m_codeContext)
     {
-        m_codeContext.perFrameCodeHandle = projectm_eval_code_compile(m_codeContext.spriteCodeContext, perFrameCode.c_str());
-        if (!m_codeContext.perFrameCodeHandle)
-        {
-            int errorLine{};
-            int errorColumn{};
-            auto* errorMessage = projectm_eval_get_error(m_codeContext.spriteCodeContext, &errorLine, &errorColumn);
+        m_definition->codeContextPool.push_back(std::move(m_codeContext));
+    }
+}
 
-            throw SpriteException("Error compiling sprite per-frame code:" + std::string(errorMessage) + " (Line " + std::to_string(errorLine) + ", column " + std::to_string(errorColumn) + ")");
-        }
+void MilkdropSprite::Init(const std::shared_ptr<const SpriteDefinition>& definition, const Renderer::RenderContext& renderContext)
+{
+    auto spriteDefinition = std::static_pointer_cast<const Definition>(definition);
+
+    // Take compiled code from a previously destroyed sprite if possible.
+    std::unique_ptr<CodeContext> codeContext;
+    if (!spriteDefinition->codeContextPool.empty())
+    {
+        codeContext = std::move(spriteDefinition->codeContextPool.back());
+        spriteDefinition->codeContextPool.pop_back();
+    }
+    else
+    {
+        codeContext = std::make_unique<CodeContext>();
+        codeContext->Compile(spriteDefinition->initCode, spriteDefinition->perFrameCode);
     }
 
-    auto imageName = Utils::ToLower(parser.GetString("img", ""));
+    codeContext->RunInitCode(renderContext);
+
+    m_definition = std::move(spriteDefinition);
+    m_codeContext = std::move(codeContext);
+
+    const auto& imageName = m_definition->imageName;
 
     // Store texture as a shared_ptr to make sure TextureManager doesn't delete it.
     std::locale const loc;
     if (imageName.length() >= 6 &&
         imageName.substr(0, 4) == "rand" && std::isdigit(imageName.at(4), loc) && std::isdigit(imageName.at(5), loc))
     {
-        m_texture = renderContext.textureManager->GetRandomTexture(imageName).Texture();
+        m_texture = renderContext.textureManager->GetRandomTexture(imageName, *renderContext.randomGenerator).Texture();
     }
     else
     {
@@ -101,47 +88,39 @@ void MilkdropSprite::Init(const std::string& spriteData, const Renderer::RenderC
     }
 }
 
-void MilkdropSprite::Draw(const Audio::FrameAudioData& audioData,
-                          const Renderer::RenderContext& renderContext,
-                          uint32_t outputFramebufferObject,
-                          PresetList presets)
+void MilkdropSprite::Update(const Audio::FrameAudioData& audioData,
+                            const Renderer::RenderContext& renderContext,
+                            SpriteInstance& instance)
 {
-    auto spriteShader = m_spriteShader.lock();
-    assert(spriteShader.get());
-
-    m_codeContext.RunPerFrameCode(audioData, renderContext);
+    m_codeContext->RunPerFrameCode(audioData, renderContext);
 
-    m_spriteDone = *m_codeContext.done != 0.0;
-    bool burnIn = *m_codeContext.burn != 0.0;
-
-    auto& vertices = m_mesh.Vertices().Get();
+    m_spriteDone = *m_codeContext->done != 0.0;
 
     // Get values from expression code and clamp them where necessary.
-    float x = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext.x) * 2.0f - 1.0f));
-    float y = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext.y) * 2.0f - 1.0f));
-    float sx = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext.sx)));
-    float sy = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext.sy)));
-    float rot = static_cast<float>(*m_codeContext.rot);
-    int flipx = (*m_codeContext.flipx == 0.0) ? 0 : 1; // Comparing float to 0.0 isn't actually a good idea...
-    int flipy = (*m_codeContext.flipy == 0.0) ? 0 : 1;
-    float repeatx = std::min(100.0f, std::max(0.01f, static_cast<float>(*m_codeContext.repeatx)));
-    float repeaty = std::min(100.0f, std::max(0.01f, static_cast<float>(*m_codeContext.repeaty)));
-
-    int blendMode = std::min(4, std::max(0, (static_cast<int>(*m_codeContext.blendmode))));
-    float r = std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext.r))));
-    float g = std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext.g))));
-    float b = std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext.b))));
-    float a = std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext.a))));
-
-    // ToDo: Move all translations to vertex shader
-    vertices[0 + flipx].SetX(-sx);
-    vertices[1 - flipx].SetX(sx);
-    vertices[2 + flipx].SetX(-sx);
-    vertices[3 - flipx].SetX(sx);
-    vertices[0 + flipy * 2].SetY(-sy);
-    vertices[1 + flipy * 2].SetY(-sy);
-    vertices[2 - flipy * 2].SetY(sy);
-    vertices[3 - flipy * 2].SetY(sy);
+    float x = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext->x) * 2.0f - 1.0f));
+    float y = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext->y) * 2.0f - 1.0f));
+    float sx = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext->sx)));
+    float sy = std::min(1000.0f, std::max(-1000.0f, static_cast<float>(*m_codeContext->sy)));
+    float rot = static_cast<float>(*m_codeContext->rot);
+    bool flipx = *m_codeContext->flipx != 0.0; // Comparing float to 0.0 isn't actually a good idea...
+    bool flipy = *m_codeContext->flipy != 0.0;
+    float repeatx = std::min(100.0f, std::max(0.01f, static_cast<float>(*m_codeContext->repeatx)));
+    float repeaty = std::min(100.0f, std::max(0.01f, static_cast<float>(*m_codeContext->repeaty)));
+
+    instance.texture = m_texture.get();
+    instance.burnIn = *m_codeContext->burn != 0.0;
+    instance.blendMode = std::min(4, std::max(0, (static_cast<int>(*m_codeContext->blendmode))));
+    instance.color = {std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext->r)))),
+                      std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext->g)))),
+                      std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext->b)))),
+                      std::min(1.0f, std::max(0.0f, (static_cast<float>(*m_codeContext->a))))};
+
+    // The quad is described by its center and two half-axes, which are transformed the same way
+    // Milkdrop transforms the four corner vertices. The vertex shader then places the corners.
+    float axisXX = flipx ? -sx : sx;
+    float axisXY = 0.0f;
+    float axisYX = 0.0f;
+    float axisYY = flipy ? -sy : sy;
 
     // First aspect ratio: adjust for non-1:1 images
     {
@@ -150,18 +129,12 @@ void MilkdropSprite::Draw(const Audio::FrameAudioData& audioData,
         if (aspect < 1.0f)
         {
             // Landscape image
-            for (auto& vertex : vertices)
-            {
-                vertex.SetY(vertex.Y() * aspect);
-            }
+            axisYY *= aspect;
         }
         else
         {
             // Portrait image
-            for (auto& vertex : vertices)
-            {
-                vertex.SetX(vertex.X() / aspect);
-            }
+            axisXX /= aspect;
         }
     }
 
@@ -170,119 +143,39 @@ void MilkdropSprite::Draw(const Audio::FrameAudioData& audioData,
         auto cos_rot = std::cos(rot);
         auto sin_rot = std::sin(rot);
 
-        for (auto& vertex : vertices)
-        {
-            float rotX = vertex.X() * cos_rot - vertex.Y() * sin_rot;
-            float rotY = vertex.X() * sin_rot + vertex.Y() * cos_rot;
-            vertex = {rotX, rotY};
-        }
-    }
-
-    // Translation
-    for (auto& vertex : vertices)
-    {
-        vertex.SetX(vertex.X() + x);
-        vertex.SetY(vertex.Y() + y);
+        float rotXX = axisXX * cos_rot - axisXY * sin_rot;
+        float rotXY = axisXX * sin_rot + axisXY * cos_rot;
+        float rotYX = axisYX * cos_rot - axisYY * sin_rot;
+        float rotYY = axisYX * sin_rot + axisYY * cos_rot;
+        axisXX = rotXX;
+        axisXY = rotXY;
+        axisYX = rotYX;
+        axisYY = rotYY;
     }
 
-    // Second aspect ratio: normalize to width of screen
+    // Second aspect ratio: normalize to width of screen. Applies to the translation as well.
     {
         float aspect = renderContext.viewportSizeX / static_cast<float>(renderContext.viewportSizeY);
 
         if (aspect > 1.0)
         {
-            for (auto& vertex : vertices)
-            {
-                vertex.SetY(vertex.Y() * aspect);
-            }
+            axisXY *= aspect;
+            axisYY *= aspect;
+            y *= aspect;
         }
         else
         {
-            for (auto& vertex : vertices)
-            {
-                vertex.SetX(vertex.X() / aspect);
-            }
+            axisXX /= aspect;
+            axisYX /= aspect;
+            x /= aspect;
         }
     }
 
     // Third aspect ratio: adjust for burn-in
     // -> Not required in projectM, as we always render at viewport size, not a fixed 4:3 ratio
 
-    // Set u,v coords
-    {
-        float dtu = 0.5f;
-        float dtv = 0.5f;
-
-        m_mesh.UVs().Set({{-dtu, dtv},
-                          {dtu, dtv},
-                          {-dtu, -dtv},
-                          {dtu, -dtv}});
-
-        for (auto& uv : m_mesh.UVs().Get())
-        {
-            uv = {(uv.U() - 0.0f) * repeatx + 0.5f,
-                  (uv.V() - 0.0f) * repeaty + 0.5f};
-        }
-    }
-
-    spriteShader->Bind();
-
-    spriteShader->SetUniformInt("blend_mode", blendMode);
-    spriteShader->SetUniformInt("texture_sampler", 0);
-
-    m_texture->Bind(0);
-    m_sampler.Bind(0);
-
-    m_mesh.Update();
-
-    glVertexAttrib4f(1, r, g, b, a);
-
-    switch (blendMode)
-    {
-        case 0:
-        default:
-            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
-            break;
-        case 1:
-            Renderer::BlendMode::SetBlendActive(false);
-            break;
-        case 2:
-            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::One, Renderer::BlendMode::Function::One);
-            break;
-        case 3:
-            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceColor, Renderer::BlendMode::Function::OneMinusSourceColor);
-            break;
-        case 4:
-            // Milkdrop actually changed color keying to using texture alpha. The color key is ignored.
-            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
-            break;
-    }
-
-    // Draw to current output buffer
-    m_mesh.Draw();
-
-    if (burnIn)
-    {
-        // Also draw into all active preset main textures for next-frame burn-in effect
-        for (const auto preset : presets)
-        {
-            if (!preset.get())
-            {
-                continue;
-            }
-
-            preset.get()->BindFramebuffer();
-            m_mesh.Draw();
-        }
-
-        // Reset to original FBO
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(outputFramebufferObject));
-    }
-
-    m_texture->Unbind(0);
-    Renderer::Mesh::Unbind();
-    Renderer::Shader::Unbind();
-    Renderer::BlendMode::SetBlendActive(false);
+    instance.axes = {axisXX, axisXY, axisYX, axisYY};
+    instance.offsetAndRepeat = {x, y, repeatx, repeaty};
 }
 
 auto MilkdropSprite::Done() const -> bool
@@ -297,9 +190,20 @@ MilkdropSprite::CodeContext::CodeContext()
 
 MilkdropSprite::CodeContext::~CodeContext()
 {
+    if (initCodeHandle != nullptr)
+    {
+        projectm_eval_code_destroy(initCodeHandle);
+    }
+
+    if (perFrameCodeHandle != nullptr)
+    {
+        projectm_eval_code_destroy(perFrameCodeHandle);
+    }
+
     projectm_eval_context_destroy(spriteCodeContext);
 
     spriteCodeContext = nullptr;
+    initCodeHandle = nullptr;
     perFrameCodeHandle = nullptr;
 }
 
@@ -338,10 +242,43 @@ void MilkdropSprite::CodeContext::RegisterBuiltinVariables()
     REG_VAR(a);
 }
 
-void MilkdropSprite::CodeContext::RunInitCode(const std::string& initCode, const Renderer::RenderContext& renderContext)
+void MilkdropSprite::CodeContext::Compile(const std::string& initCode, const std::string& perFrameCode)
 {
     RegisterBuiltinVariables();
 
+    if (!initCode.empty())
+    {
+        initCodeHandle = projectm_eval_code_compile(spriteCodeContext, initCode.c_str());
+        if (initCodeHandle == nullptr)
+        {
+            int errorLine{};
+            int errorColumn{};
+            const auto* errorMessage = projectm_eval_get_error(spriteCodeContext, &errorLine, &errorColumn);
+
+            throw SpriteException("Error compiling sprite init code:" + std::string(errorMessage) + " (Line " + std::to_string(errorLine) + ", column " + std::to_string(errorColumn) + ")");
+        }
+    }
+
+    if (!perFrameCode.empty())
+    {
+        perFrameCodeHandle = projectm_eval_code_compile(spriteCodeContext, perFrameCode.c_str());
+        if (perFrameCodeHandle == nullptr)
+        {
+            int errorLine{};
+            int errorColumn{};
+            const auto* errorMessage = projectm_eval_get_error(spriteCodeContext, &errorLine, &errorColumn);
+
+            throw SpriteException("Error compiling sprite per-frame code:" + std::string(errorMessage) + " (Line " + std::to_string(errorLine) + ", column " + std::to_string(errorColumn) + ")");
+        }
+    }
+}
+
+void MilkdropSprite::CodeContext::RunInitCode(const Renderer::RenderContext& renderContext)
+{
+    // A reused context must not keep any state of the previous sprite.
+    projectm_eval_context_reset_variables(spriteCodeContext);
+    projectm_eval_context_free_memory(spriteCodeContext);
+
     // Set default values of output variables:
     // (by not setting these every frame, we allow the values to persist from frame-to-frame.)
     *x = 0.5;
@@ -361,7 +298,7 @@ void MilkdropSprite::CodeContext::RunInitCode(const std::string& initCode, const
     *done = 0.0;
     *burn = 1.0;
 
-    if (initCode.empty())
+    if (initCodeHandle == nullptr)
     {
         return;
     }
@@ -370,18 +307,7 @@ void MilkdropSprite::CodeContext::RunInitCode(const std::string& initCode, const
     *time = renderContext.time;
     *frame = renderContext.frame;
 
-    auto* initCodeHandle = projectm_eval_code_compile(spriteCodeContext, initCode.c_str());
-    if (initCodeHandle == nullptr)
-    {
-        int errorLine{};
-        int errorColumn{};
-        const auto* errorMessage = projectm_eval_get_error(spriteCodeContext, &errorLine, &errorColumn);
-
-        throw SpriteException("Error compiling sprite init code:" + std::string(errorMessage) + " (Line " + std::to_string(errorLine) + ", column " + std::to_string(errorColumn) + ")");
-    }
-
     projectm_eval_code_execute(initCodeHandle);
-    projectm_eval_code_destroy(initCodeHandle);
 }
 
 void MilkdropSprite::CodeContext::RunPerFrameCode(const Audio::FrameAudioData& audioData, const Renderer::RenderContext& renderContext)
@@ -2,34 +2,42 @@
 
 #include "UserSprites/Sprite.hpp"
 
-#include <Renderer/Mesh.hpp>
 #include <Renderer/Texture.hpp>
-#include <Renderer/TextureSamplerDescriptor.hpp>
 
 #include <projectm-eval.h>
 
+#include <memory>
+#include <vector>
+
 namespace libprojectM {
 namespace UserSprites {
 
 class MilkdropSprite : public Sprite
 {
 public:
-    MilkdropSprite();
+    MilkdropSprite() = default;
+
+    /**
+     * @brief Returns the sprite's code context to its definition for reuse.
+     */
+    ~MilkdropSprite() override;
 
-    ~MilkdropSprite() override = default;
+    auto Parse(const std::string& spriteData) const -> std::shared_ptr<const SpriteDefinition> override;
 
-    void Init(const std::string& spriteData, const Renderer::RenderContext& renderContext) override;
+    void Init(const std::shared_ptr<const SpriteDefinition>& definition, const Renderer::RenderContext& renderContext) override;
 
-    void Draw(const Audio::FrameAudioData& audioData,
-              const Renderer::RenderContext& renderContext,
-              uint32_t outputFramebufferObject,
-              PresetList presets) override;
+    void Update(const Audio::FrameAudioData& audioData,
+                const Renderer::RenderContext& renderContext,
+                SpriteInstance& instance) override;
 
     auto Done() const -> bool override;
 
 private:
     /**
      * @brief Context for the init and per-frame code.
+     *
+     * The code is compiled once. When the sprite is destroyed, the context is kept in the sprite
+     * definition and used again for the next sprite spawned from the same data.
      */
     struct CodeContext {
         CodeContext();
@@ -42,11 +50,19 @@ private:
         void RegisterBuiltinVariables();
 
         /**
-         * @brief Compiles and runs the init code of the sprite once, if any.
-         * Also sets up a the default values of the output variables.
+         * @brief Compiles the init and per-frame code of the sprite.
+         * @throws SpriteException Thrown if the code can't be compiled.
          * @param initCode The initialization code.
+         * @param perFrameCode The per-frame code.
+         */
+        void Compile(const std::string& initCode, const std::string& perFrameCode);
+
+        /**
+         * @brief Resets all variables and memory, then runs the init code of the sprite once, if any.
+         * Also sets up a the default values of the output variables.
+         * @param renderContext The frame rendering context data.
          */
-        void RunInitCode(const std::string& initCode, const Renderer::RenderContext& renderContext);
+        void RunInitCode(const Renderer::RenderContext& renderContext);
 
         /**
          * @brief Runs the per-frame update code for the sprite.
@@ -57,6 +73,7 @@ private:
                              const Renderer::RenderContext& renderContext);
 
         projectm_eval_context* spriteCodeContext{nullptr}; //!< The code runtime context, holds memory buffers and variables.
+        projectm_eval_code* initCodeHandle{nullptr};       //!< The compiled init code handle.
         projectm_eval_code* perFrameCodeHandle{nullptr};   //!< The compiled per-frame code handle.
 
         // Input variables
@@ -90,12 +107,23 @@ private:
         PRJM_EVAL_F* a{};         //!< Modulation color used in some blending modes. Default: 1.0
     };
 
-    CodeContext m_codeContext;                         //!< Sprite init and per-frame code.
-    std::shared_ptr<Renderer::Texture> m_texture;      //!< The sprite image, loaded via a name like other textures in Milkdrop presets.
-    Renderer::Sampler m_sampler{GL_REPEAT, GL_LINEAR}; //!< Texture sampler settings
-    std::weak_ptr<Renderer::Shader> m_spriteShader;    //!< The shader used to draw the user sprite.
-    Renderer::Mesh m_mesh;                             //!< A simple quad.
-    bool m_spriteDone{false};                          //!< If true, the sprite will be removed from the list.
+    /**
+     * @brief The code and image name from a Milkdrop sprite section.
+     */
+    class Definition : public SpriteDefinition
+    {
+    public:
+        std::string initCode;     //!< Code run once when the sprite is spawned.
+        std::string perFrameCode; //!< Code run each frame.
+        std::string imageName;    //!< Lower-case name of the sprite image.
+
+        mutable std::vector<std::unique_ptr<CodeContext>> codeContextPool; //!< Compiled code contexts of destroyed sprites, ready for reuse.
+    };
+
+    std::shared_ptr<const Definition> m_definition; //!< The definition this sprite was spawned from.
+    std::unique_ptr<CodeContext> m_codeContext;     //!< Sprite init and per-frame code.
+    std::shared_ptr<Renderer::Texture> m_texture;   //!< The sprite image, loaded via a name like other textures in Milkdrop presets.
+    bool m_spriteDone{false};                       //!< If true, the sprite will be removed from the list.
 };
 
 } // namespace UserSprites
@@ -1,14 +1,18 @@
 precision mediump float;
 
 layout(location = 0) in vec2 vertex_position;
-layout(location = 1) in vec4 vertex_color;
-layout(location = 2) in vec2 vertex_texture;
+layout(location = 1) in vec4 instance_color;
+layout(location = 2) in vec4 instance_axes;
+layout(location = 3) in vec4 instance_offset_repeat;
 
 out vec4 fragment_color;
 out vec2 fragment_texture;
 
 void main(){
-    gl_Position = vec4(vertex_position, 0.0, 1.0);
-    fragment_color = vertex_color;
-    fragment_texture = vertex_texture;
+    // The vertex position is the quad corner in the range -1 to 1, which is placed along the
+    // sprite's half-axes around its center. Texture coordinates are repeated around the quad center.
+    vec2 position = instance_offset_repeat.xy + vertex_position.x * instance_axes.xy + vertex_position.y * instance_axes.zw;
+    gl_Position = vec4(position, 0.0, 1.0);
+    fragment_color = instance_color;
+    fragment_texture = vec2(vertex_position.x, -vertex_position.y) * 0.5 * instance_offset_repeat.zw + 0.5;
 }
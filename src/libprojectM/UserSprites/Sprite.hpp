@@ -5,6 +5,9 @@
 #include <Audio/FrameAudioData.hpp>
 
 #include <Renderer/RenderContext.hpp>
+#include <Renderer/Texture.hpp>
+
+#include <glm/vec4.hpp>
 
 #include <cstdint>
 #include <functional>
@@ -15,6 +18,31 @@
 namespace libprojectM {
 namespace UserSprites {
 
+/**
+ * @brief Placement and appearance of a sprite in the current frame.
+ *
+ * Filled by each sprite and drawn by the sprite manager together with all other sprites.
+ */
+struct SpriteInstance {
+    const Renderer::Texture* texture{}; //!< The sprite image.
+    int blendMode{};                    //!< Image blending mode, 0 to 4. See MilkdropSprite for details.
+    bool burnIn{};                      //!< If true, the sprite is also drawn into the preset framebuffers.
+    glm::vec4 color{1.0f};              //!< Modulation color used in some blending modes.
+    glm::vec4 axes{};                   //!< Quad X (xy) and Y (zw) half-axes in clip space.
+    glm::vec4 offsetAndRepeat{};        //!< Quad center in clip space (xy) and texture repeat counts (zw).
+};
+
+/**
+ * @brief Parsed, immutable sprite data, shared by all sprites spawned from the same data.
+ *
+ * Sprite types may also keep reusable per-sprite state in their definition, e.g. compiled code.
+ */
+class SpriteDefinition
+{
+public:
+    virtual ~SpriteDefinition() = default;
+};
+
 class Sprite
 {
 public:
@@ -24,23 +52,30 @@ public:
     virtual ~Sprite() = default;
 
     /**
-     * @brief Initializes the sprite instance for rendering.
+     * @brief Parses the sprite data into a definition which can be used to initialize any number of sprites.
+     * @throws SpriteException Thrown if the sprite data is invalid.
      * @param spriteData The data for the sprite type.
+     * @return The parsed sprite definition.
+     */
+    virtual auto Parse(const std::string& spriteData) const -> std::shared_ptr<const SpriteDefinition> = 0;
+
+    /**
+     * @brief Initializes the sprite instance for rendering.
+     * @throws SpriteException Thrown if the sprite code can't be compiled.
+     * @param definition The parsed sprite definition, as returned by Parse() of the same sprite type.
      * @param renderContext The current frame's rendering context.
      */
-    virtual void Init(const std::string& spriteData, const Renderer::RenderContext& renderContext) = 0;
+    virtual void Init(const std::shared_ptr<const SpriteDefinition>& definition, const Renderer::RenderContext& renderContext) = 0;
 
     /**
-     * @brief Draws the sprite onto the current framebuffer.
+     * @brief Updates the sprite for the current frame.
      * @param audioData The frame audio data structure.
      * @param renderContext The current frame's rendering context.
-     * @param outputFramebufferObject Framebuffer object the sprite will be rendered to.
-     * @param presets The active preset, plus eventually the transitioning one. Used for the burn-in effect.
+     * @param instance [out] Receives the placement and appearance of the sprite in this frame.
      */
-    virtual void Draw(const Audio::FrameAudioData& audioData,
-                      const Renderer::RenderContext& renderContext,
-                      uint32_t outputFramebufferObject,
-                      PresetList presets) = 0;
+    virtual void Update(const Audio::FrameAudioData& audioData,
+                        const Renderer::RenderContext& renderContext,
+                        SpriteInstance& instance) = 0;
 
     /**
      * @brief Returns if the sprite has finished rendering and should be deleted.
@@ -0,0 +1,198 @@
+#include "UserSprites/SpriteBatch.hpp"
+
+#include "SpriteShaders.hpp"
+
+#include <Renderer/BlendMode.hpp>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/Texture.hpp>
+
+#include <cstddef>
+
+namespace libprojectM {
+namespace UserSprites {
+
+SpriteBatch::SpriteBatch()
+    : m_quadCorners(Renderer::VertexBufferUsage::StaticDraw)
+{
+    glGenBuffers(1, &m_instanceBuffer);
+
+    m_vertexArray.Bind();
+
+    m_quadCorners.Set({{-1.0f, -1.0f},
+                       {1.0f, -1.0f},
+                       {-1.0f, 1.0f},
+                       {1.0f, 1.0f}});
+    m_quadCorners.Update();
+    m_quadCorners.InitializeAttributePointer(0);
+    Renderer::VertexBuffer<Renderer::Point>::SetEnableAttributeArray(0, true);
+
+    // Color, axes and offset/repeat advance once per instance.
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    for (GLuint attributeIndex = 1; attributeIndex <= 3; attributeIndex++)
+    {
+        glEnableVertexAttribArray(attributeIndex);
+        glVertexAttribDivisor(attributeIndex, 1);
+    }
+
+    Renderer::VertexArray::Unbind();
+    Renderer::VertexBuffer<Renderer::Point>::Unbind();
+}
+
+SpriteBatch::~SpriteBatch()
+{
+    glDeleteBuffers(1, &m_instanceBuffer);
+}
+
+void SpriteBatch::Draw(const std::vector<SpriteInstance>& instances,
+                       const Renderer::RenderContext& renderContext,
+                       uint32_t outputFramebufferObject,
+                       const Sprite::PresetList& presets)
+{
+    m_drawCallCount = 0;
+
+    if (instances.empty())
+    {
+        return;
+    }
+
+    // Upload all instances of this frame at once.
+    m_instanceData.resize(instances.size());
+    for (size_t index = 0; index < instances.size(); index++)
+    {
+        m_instanceData[index] = {instances[index].color, instances[index].axes, instances[index].offsetAndRepeat};
+    }
+
+    // Always reallocate the storage, so the driver doesn't have to wait for draws still using the previous frame's data.
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(sizeof(InstanceData) * m_instanceData.size()), m_instanceData.data(), GL_STREAM_DRAW);
+
+    auto spriteShader = GetShader(renderContext);
+    spriteShader->Bind();
+    spriteShader->SetUniformInt("texture_sampler", 0);
+
+    m_vertexArray.Bind();
+    m_sampler.Bind(0);
+
+    size_t firstInstance{0};
+    while (firstInstance < instances.size())
+    {
+        const auto& first = instances[firstInstance];
+
+        // Collect all following instances which can be drawn with the same state.
+        size_t instanceCount{1};
+        while (firstInstance + instanceCount < instances.size())
+        {
+            const auto& next = instances[firstInstance + instanceCount];
+            if (next.texture != first.texture || next.blendMode != first.blendMode || next.burnIn != first.burnIn)
+            {
+                break;
+            }
+            instanceCount++;
+        }
+
+        spriteShader->SetUniformInt("blend_mode", first.blendMode);
+        first.texture->Bind(0);
+        SetBlendMode(first.blendMode);
+
+        // Draw to current output buffer
+        DrawInstances(firstInstance, instanceCount);
+
+        if (first.burnIn)
+        {
+            // Also draw into all active preset main textures for next-frame burn-in effect
+            for (const auto preset : presets)
+            {
+                if (!preset.get())
+                {
+                    continue;
+                }
+
+                preset.get()->BindFramebuffer();
+                DrawInstances(firstInstance, instanceCount);
+            }
+
+            // Reset to original FBO
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(outputFramebufferObject));
+        }
+
+        first.texture->Unbind(0);
+
+        firstInstance += instanceCount;
+    }
+
+    Renderer::VertexArray::Unbind();
+    Renderer::VertexBuffer<Renderer::Point>::Unbind();
+    Renderer::Shader::Unbind();
+    Renderer::BlendMode::SetBlendActive(false);
+}
+
+auto SpriteBatch::LastDrawCallCount() const -> uint32_t
+{
+    return m_drawCallCount;
+}
+
+auto SpriteBatch::GetShader(const Renderer::RenderContext& renderContext) -> std::shared_ptr<Renderer::Shader>
+{
+    auto spriteShader = renderContext.shaderCache->Get("milkdrop_user_sprite");
+    if (!spriteShader)
+    {
+        // ToDo: Better handle this in the shader class to reduce duplicate code.
+#ifdef USE_GLES
+        // GLES also requires a precision specifier for variables and 3D samplers
+        constexpr char versionHeader[] = "#version 300 es\n\nprecision mediump float;\nprecision mediump sampler3D;\n";
+#else
+        constexpr char versionHeader[] = "#version 330\n\n";
+#endif
+
+        spriteShader = std::make_shared<Renderer::Shader>();
+        spriteShader->CompileProgram(static_cast<const char*>(versionHeader) + kMilkdropSpriteVertexGlsl330,
+                                     static_cast<const char*>(versionHeader) + kMilkdropSpriteFragmentGlsl330);
+        renderContext.shaderCache->Insert("milkdrop_user_sprite", spriteShader);
+    }
+
+    return spriteShader;
+}
+
+void SpriteBatch::SetBlendMode(int blendMode)
+{
+    switch (blendMode)
+    {
+        case 0:
+        default:
+            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
+            break;
+        case 1:
+            Renderer::BlendMode::SetBlendActive(false);
+            break;
+        case 2:
+            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::One, Renderer::BlendMode::Function::One);
+            break;
+        case 3:
+            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceColor, Renderer::BlendMode::Function::OneMinusSourceColor);
+            break;
+        case 4:
+            // Milkdrop actually changed color keying to using texture alpha. The color key is ignored.
+            Renderer::BlendMode::Set(true, Renderer::BlendMode::Function::SourceAlpha, Renderer::BlendMode::Function::OneMinusSourceAlpha);
+            break;
+    }
+}
+
+void SpriteBatch::DrawInstances(size_t firstInstance, size_t instanceCount)
+{
+    // GL 3.3 and GLES 3 have no base instance parameter, so the attribute pointers start at the first instance.
+    auto const baseOffset = firstInstance * sizeof(InstanceData);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceBuffer);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          reinterpret_cast<void*>(baseOffset + offsetof(InstanceData, color)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          reinterpret_cast<void*>(baseOffset + offsetof(InstanceData, axes)));
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          reinterpret_cast<void*>(baseOffset + offsetof(InstanceData, offsetAndRepeat)));
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instanceCount));
+    m_drawCallCount++;
+}
+
+} // namespace UserSprites
+} // namespace libprojectM
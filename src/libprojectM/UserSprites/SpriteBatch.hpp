@@ -0,0 +1,95 @@
+#pragma once
+
+#include "UserSprites/Sprite.hpp"
+
+#include <Renderer/Point.hpp>
+#include <Renderer/RenderContext.hpp>
+#include <Renderer/Sampler.hpp>
+#include <Renderer/Shader.hpp>
+#include <Renderer/VertexArray.hpp>
+#include <Renderer/VertexBuffer.hpp>
+
+#include <glm/vec4.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace libprojectM {
+namespace UserSprites {
+
+/**
+ * @brief Draws sprite instances with as few draw calls as possible.
+ *
+ * All instances of a frame are uploaded into a single instance buffer. Consecutive instances
+ * using the same texture, blend mode and burn-in flag are drawn with a single instanced draw call.
+ * Sprites are not reordered, so overlapping sprites are blended in the same order as before.
+ */
+class SpriteBatch
+{
+public:
+    SpriteBatch();
+
+    ~SpriteBatch();
+
+    SpriteBatch(const SpriteBatch&) = delete;
+    auto operator=(const SpriteBatch&) -> SpriteBatch& = delete;
+
+    /**
+     * @brief Draws the given sprite instances.
+     * @param instances The sprite instances to draw, in drawing order.
+     * @param renderContext The current frame's rendering context.
+     * @param outputFramebufferObject Framebuffer object the sprites will be rendered to.
+     * @param presets The active preset, plus eventually the transitioning one. Used for the burn-in effect.
+     */
+    void Draw(const std::vector<SpriteInstance>& instances,
+              const Renderer::RenderContext& renderContext,
+              uint32_t outputFramebufferObject,
+              const Sprite::PresetList& presets);
+
+    /**
+     * @brief Returns the number of draw calls issued by the last Draw() call.
+     * @return The number of draw calls, including burn-in draws into the preset framebuffers.
+     */
+    auto LastDrawCallCount() const -> uint32_t;
+
+private:
+    /**
+     * @brief Per-instance vertex attributes, stored in the instance buffer.
+     */
+    struct InstanceData {
+        glm::vec4 color;           //!< Modulation color.
+        glm::vec4 axes;            //!< Quad X (xy) and Y (zw) half-axes in clip space.
+        glm::vec4 offsetAndRepeat; //!< Quad center in clip space (xy) and texture repeat counts (zw).
+    };
+
+    /**
+     * @brief Returns the sprite shader, compiling it on first use.
+     * @param renderContext The rendering context holding the shader cache.
+     * @return The sprite shader.
+     */
+    static auto GetShader(const Renderer::RenderContext& renderContext) -> std::shared_ptr<Renderer::Shader>;
+
+    /**
+     * @brief Sets the GL blend function for the given Milkdrop sprite blend mode.
+     * @param blendMode The sprite blend mode, 0 to 4.
+     */
+    static void SetBlendMode(int blendMode);
+
+    /**
+     * @brief Points the instance attributes at the given range and draws it.
+     * @param firstInstance Index of the first instance in the instance buffer.
+     * @param instanceCount Number of instances to draw.
+     */
+    void DrawInstances(size_t firstInstance, size_t instanceCount);
+
+    Renderer::VertexArray m_vertexArray;                  //!< VAO with the quad corners and instance attributes.
+    Renderer::VertexBuffer<Renderer::Point> m_quadCorners; //!< The four quad corners, drawn as a triangle strip.
+    GLuint m_instanceBuffer{};                            //!< Buffer object holding the instance data of the current frame.
+    std::vector<InstanceData> m_instanceData;             //!< CPU copy of the instance data.
+    Renderer::Sampler m_sampler{GL_REPEAT, GL_LINEAR};    //!< Texture sampler settings
+    uint32_t m_drawCallCount{};                           //!< Draw calls issued in the last frame.
+};
+
+} // namespace UserSprites
+} // namespace libprojectM
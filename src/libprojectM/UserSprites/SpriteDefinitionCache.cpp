@@ -0,0 +1,95 @@
+#include "UserSprites/SpriteDefinitionCache.hpp"
+
+#include <functional>
+#include <iterator>
+
+namespace libprojectM {
+namespace UserSprites {
+
+auto SpriteDefinitionCache::Find(const std::string& type, const std::string& spriteData) -> std::shared_ptr<const SpriteDefinition>
+{
+    auto entry = FindEntry(Hash(type, spriteData), type, spriteData);
+    if (entry == m_entries.end())
+    {
+        m_misses++;
+        return {};
+    }
+
+    m_hits++;
+    return entry->definition;
+}
+
+void SpriteDefinitionCache::Insert(const std::string& type, const std::string& spriteData, std::shared_ptr<const SpriteDefinition> definition)
+{
+    auto const hash = Hash(type, spriteData);
+    auto entry = FindEntry(hash, type, spriteData);
+    if (entry != m_entries.end())
+    {
+        entry->definition = std::move(definition);
+        return;
+    }
+
+    if (m_entries.size() >= MaxEntries)
+    {
+        auto range = m_entriesByHash.equal_range(m_entries.front().hash);
+        for (auto mapEntry = range.first; mapEntry != range.second; ++mapEntry)
+        {
+            if (mapEntry->second == m_entries.begin())
+            {
+                m_entriesByHash.erase(mapEntry);
+                break;
+            }
+        }
+        m_entries.pop_front();
+    }
+
+    m_entries.push_back({hash, type, spriteData, std::move(definition)});
+    m_entriesByHash.emplace(hash, std::prev(m_entries.end()));
+}
+
+void SpriteDefinitionCache::Clear()
+{
+    m_entriesByHash.clear();
+    m_entries.clear();
+}
+
+auto SpriteDefinitionCache::Size() const -> size_t
+{
+    return m_entries.size();
+}
+
+auto SpriteDefinitionCache::Hits() const -> uint64_t
+{
+    return m_hits;
+}
+
+auto SpriteDefinitionCache::Misses() const -> uint64_t
+{
+    return m_misses;
+}
+
+auto SpriteDefinitionCache::Hash(const std::string& type, const std::string& spriteData) -> size_t
+{
+    auto const typeHash = std::hash<std::string>()(type);
+    auto const dataHash = std::hash<std::string>()(spriteData);
+
+    return typeHash ^ (dataHash + 0x9e3779b9 + (typeHash << 6) + (typeHash >> 2));
+}
+
+auto SpriteDefinitionCache::FindEntry(size_t hash, const std::string& type, const std::string& spriteData) -> EntryList::iterator
+{
+    auto range = m_entriesByHash.equal_range(hash);
+    for (auto mapEntry = range.first; mapEntry != range.second; ++mapEntry)
+    {
+        const auto& entry = *mapEntry->second;
+        if (entry.type == type && entry.spriteData == spriteData)
+        {
+            return mapEntry->second;
+        }
+    }
+
+    return m_entries.end();
+}
+
+} // namespace UserSprites
+} // namespace libprojectM
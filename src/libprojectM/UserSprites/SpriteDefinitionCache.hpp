@@ -0,0 +1,101 @@
+#pragma once
+
+#include "UserSprites/Sprite.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace libprojectM {
+namespace UserSprites {
+
+/**
+ * @brief Keeps parsed sprite definitions, keyed by sprite type and data.
+ *
+ * Hosts often spawn the same sprite over and over, e.g. on every beat. With the cache, only the
+ * first spawn parses the sprite data, later spawns reuse the definition and whatever the sprite
+ * type keeps in it, e.g. compiled code. Data which failed to load is not cached, so it's parsed
+ * again on the next spawn.
+ *
+ * The cache holds a limited number of definitions and drops the oldest one when full. Lookups
+ * use a hash of the type and data, so they don't copy the sprite data.
+ */
+class SpriteDefinitionCache
+{
+public:
+    static constexpr size_t MaxEntries{64}; //!< Maximum number of cached definitions.
+
+    /**
+     * @brief Looks up the definition for the given sprite type and data.
+     * @param type The lower-case sprite type name.
+     * @param spriteData The sprite code/data.
+     * @return The cached definition, or nullptr if the data has to be parsed.
+     */
+    auto Find(const std::string& type, const std::string& spriteData) -> std::shared_ptr<const SpriteDefinition>;
+
+    /**
+     * @brief Stores a successfully parsed and initialized definition.
+     * @param type The lower-case sprite type name.
+     * @param spriteData The sprite code/data.
+     * @param definition The parsed definition.
+     */
+    void Insert(const std::string& type, const std::string& spriteData, std::shared_ptr<const SpriteDefinition> definition);
+
+    /**
+     * @brief Removes all cached definitions.
+     */
+    void Clear();
+
+    /**
+     * @brief Returns the number of cached definitions.
+     * @return The number of cache entries.
+     */
+    auto Size() const -> size_t;
+
+    /**
+     * @brief Returns the number of lookups which found a cached definition.
+     * @return The cache hit count.
+     */
+    auto Hits() const -> uint64_t;
+
+    /**
+     * @brief Returns the number of lookups which had to parse the sprite data.
+     * @return The cache miss count.
+     */
+    auto Misses() const -> uint64_t;
+
+private:
+    /**
+     * @brief A cached definition with the type and data it was parsed from.
+     */
+    struct Entry {
+        size_t hash{};                                       //!< Hash of type and data.
+        std::string type;                                    //!< The lower-case sprite type name.
+        std::string spriteData;                              //!< The sprite code/data.
+        std::shared_ptr<const SpriteDefinition> definition; //!< The parsed definition.
+    };
+
+    using EntryList = std::list<Entry>;
+
+    /**
+     * @brief Returns the hash of the given sprite type and data.
+     */
+    static auto Hash(const std::string& type, const std::string& spriteData) -> size_t;
+
+    /**
+     * @brief Finds the entry for the given type and data.
+     * @return An iterator to the entry, or m_entries.end() if there is none.
+     */
+    auto FindEntry(size_t hash, const std::string& type, const std::string& spriteData) -> EntryList::iterator;
+
+    EntryList m_entries;                                                  //!< Cached definitions, oldest first.
+    std::unordered_multimap<size_t, EntryList::iterator> m_entriesByHash; //!< Entries by hash of type and data.
+    uint64_t m_hits{};                                                    //!< Number of cache hits.
+    uint64_t m_misses{};                                                  //!< Number of cache misses.
+};
+
+} // namespace UserSprites
+} // namespace libprojectM
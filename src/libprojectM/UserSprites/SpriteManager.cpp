@@ -5,6 +5,8 @@
 
 #include <Renderer/Shader.hpp>
 
+#include <Utils.hpp>
+
 #include <algorithm>
 
 namespace libprojectM {
@@ -20,16 +22,25 @@ auto SpriteManager::Spawn(const std::string& type,
         return 0;
     }
 
-    auto sprite = Factory::CreateSprite(type);
+    auto const lowerCaseType = Utils::ToLower(type);
+    auto sprite = Factory::CreateSprite(lowerCaseType);
 
     if (!sprite)
     {
         return 0;
     }
 
+    auto definition = m_definitionCache.Find(lowerCaseType, spriteData);
+    bool const cached = definition != nullptr;
+
+    // Data which fails to load isn't cached, so it's parsed again on the next attempt.
     try
     {
-        sprite->Init(spriteData, renderContext);
+        if (!cached)
+        {
+            definition = sprite->Parse(spriteData);
+        }
+        sprite->Init(definition, renderContext);
     }
     catch (SpriteException& ex)
     {
@@ -44,18 +55,46 @@ auto SpriteManager::Spawn(const std::string& type,
         return 0;
     }
 
-    auto spriteIdentifier = GetLowestFreeIdentifier();
+    if (!cached)
+    {
+        m_definitionCache.Insert(lowerCaseType, spriteData, std::move(definition));
+    }
 
     // Already at max sprites, destroy the oldest sprite to make room.
-    if (m_sprites.size() == m_spriteSlots)
+    if (m_spriteCount >= std::min(m_spriteSlots, SlotIndexMask))
     {
-        Destroy(m_sprites.front().first);
+        FreeSlot(m_oldestSlot);
     }
 
-    m_sprites.emplace_back(spriteIdentifier, std::move(sprite));
-    m_spriteIdentifiers.insert(spriteIdentifier);
+    uint32_t slotIndex{};
+    if (!m_freeSlots.empty())
+    {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    auto& slot = m_slots[slotIndex];
+    slot.sprite = std::move(sprite);
+    slot.older = m_newestSlot;
+    slot.younger = InvalidSlot;
+
+    if (m_newestSlot != InvalidSlot)
+    {
+        m_slots[m_newestSlot].younger = slotIndex;
+    }
+    else
+    {
+        m_oldestSlot = slotIndex;
+    }
+    m_newestSlot = slotIndex;
+    m_spriteCount++;
 
-    return spriteIdentifier;
+    return MakeIdentifier(slotIndex);
 }
 
 void SpriteManager::Draw(const Audio::FrameAudioData& audioData,
@@ -63,53 +102,63 @@ void SpriteManager::Draw(const Audio::FrameAudioData& audioData,
                          uint32_t outputFramebufferObject,
                          Sprite::PresetList presets)
 {
-    std::vector<SpriteIdentifier> toDestroy;
+    std::vector<uint32_t> toDestroy;
 
-    for (auto& idAndSprite : m_sprites) {
-        idAndSprite.second->Draw(audioData, renderContext, outputFramebufferObject, presets);
+    // Run the sprite code first, then draw all sprites in as few batches as possible.
+    m_instances.resize(m_spriteCount);
+    size_t instanceIndex{0};
+    for (auto slotIndex = m_oldestSlot; slotIndex != InvalidSlot; slotIndex = m_slots[slotIndex].younger)
+    {
+        auto& sprite = m_slots[slotIndex].sprite;
+        sprite->Update(audioData, renderContext, m_instances[instanceIndex++]);
 
-        if (idAndSprite.second->Done())
+        if (sprite->Done())
         {
-            toDestroy.push_back(idAndSprite.first);
+            toDestroy.push_back(slotIndex);
         }
     }
 
-    for (auto id : toDestroy)
+    m_batch.Draw(m_instances, renderContext, outputFramebufferObject, presets);
+
+    for (auto slotIndex : toDestroy)
     {
-        Destroy(id);
+        FreeSlot(slotIndex);
     }
 }
 
 void SpriteManager::Destroy(SpriteIdentifier spriteIdentifier)
 {
-    if (m_spriteIdentifiers.find(spriteIdentifier) == m_spriteIdentifiers.end())
+    auto slotIndex = FindSlot(spriteIdentifier);
+    if (slotIndex == InvalidSlot)
     {
         return;
     }
 
-    m_spriteIdentifiers.erase(spriteIdentifier);
-    m_sprites.remove_if([spriteIdentifier](const auto& idAndSprite) {
-        return idAndSprite.first == spriteIdentifier;
-    });
+    FreeSlot(slotIndex);
 }
 
 void SpriteManager::DestroyAll()
 {
-    m_spriteIdentifiers.clear();
-    m_sprites.clear();
+    while (m_oldestSlot != InvalidSlot)
+    {
+        FreeSlot(m_oldestSlot);
+    }
+
+    m_definitionCache.Clear();
 }
 
 auto SpriteManager::ActiveSpriteCount() const -> uint32_t
 {
-    return m_sprites.size();
+    return m_spriteCount;
 }
 
 auto SpriteManager::ActiveSpriteIdentifiers() const -> std::vector<SpriteIdentifier>
 {
     std::vector<SpriteIdentifier> identifierList;
-    for (auto& idAndSprite : m_sprites)
+    identifierList.reserve(m_spriteCount);
+    for (auto slotIndex = m_oldestSlot; slotIndex != InvalidSlot; slotIndex = m_slots[slotIndex].younger)
     {
-        identifierList.emplace_back(idAndSprite.first);
+        identifierList.emplace_back(MakeIdentifier(slotIndex));
     }
 
     return identifierList;
@@ -120,10 +169,14 @@ void SpriteManager::SpriteSlots(uint32_t slots)
     m_spriteSlots = slots;
 
     // Remove excess sprites if limit was lowered
-    while (m_sprites.size() > slots)
+    while (m_spriteCount > slots)
+    {
+        FreeSlot(m_oldestSlot);
+    }
+
+    if (slots == 0)
     {
-        m_spriteIdentifiers.erase(m_sprites.front().first);
-        m_sprites.pop_front();
+        m_definitionCache.Clear();
     }
 }
 
@@ -132,21 +185,68 @@ auto SpriteManager::SpriteSlots() const -> uint32_t
     return m_spriteSlots;
 }
 
-auto SpriteManager::GetLowestFreeIdentifier() -> SpriteIdentifier
+auto SpriteManager::DefinitionCache() const -> const SpriteDefinitionCache&
 {
-    SpriteIdentifier lowestId = 0;
+    return m_definitionCache;
+}
 
-    for (const auto& spriteId : m_spriteIdentifiers)
+auto SpriteManager::LastDrawCallCount() const -> uint32_t
+{
+    return m_batch.LastDrawCallCount();
+}
+
+auto SpriteManager::MakeIdentifier(uint32_t slotIndex) const -> SpriteIdentifier
+{
+    // Slot index 0 is stored as 1, so identifiers are never zero.
+    return (m_slots[slotIndex].generation << SlotIndexBits) | (slotIndex + 1);
+}
+
+auto SpriteManager::FindSlot(SpriteIdentifier spriteIdentifier) const -> uint32_t
+{
+    auto const slotNumber = spriteIdentifier & SlotIndexMask;
+    if (slotNumber == 0 || slotNumber > m_slots.size())
     {
-        if (spriteId > lowestId + 1)
-        {
-            return lowestId + 1;
-        }
+        return InvalidSlot;
+    }
 
-        lowestId = spriteId;
+    auto const slotIndex = slotNumber - 1;
+    if (!m_slots[slotIndex].sprite || MakeIdentifier(slotIndex) != spriteIdentifier)
+    {
+        return InvalidSlot;
     }
 
-    return lowestId + 1;
+    return slotIndex;
+}
+
+void SpriteManager::FreeSlot(uint32_t slotIndex)
+{
+    auto& slot = m_slots[slotIndex];
+
+    if (slot.older != InvalidSlot)
+    {
+        m_slots[slot.older].younger = slot.younger;
+    }
+    else
+    {
+        m_oldestSlot = slot.younger;
+    }
+
+    if (slot.younger != InvalidSlot)
+    {
+        m_slots[slot.younger].older = slot.older;
+    }
+    else
+    {
+        m_newestSlot = slot.older;
+    }
+
+    slot.sprite.reset();
+    slot.older = InvalidSlot;
+    slot.younger = InvalidSlot;
+    slot.generation = (slot.generation + 1) & (std::numeric_limits<uint32_t>::max() >> SlotIndexBits);
+
+    m_freeSlots.push_back(slotIndex);
+    m_spriteCount--;
 }
 
 } // namespace UserSprites
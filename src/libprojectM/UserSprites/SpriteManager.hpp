@@ -1,13 +1,13 @@
 #pragma once
 
 #include "UserSprites/Sprite.hpp"
+#include "UserSprites/SpriteBatch.hpp"
+#include "UserSprites/SpriteDefinitionCache.hpp"
 
 #include <Renderer/RenderContext.hpp>
 
 #include <cstdint>
-#include <list>
-#include <set>
-#include <utility>
+#include <limits>
 #include <vector>
 
 namespace libprojectM {
@@ -52,7 +52,7 @@ public:
     /**
      * @brief Destroys all active sprites.
      *
-     * Sprites will be removed when drawing the next frame.
+     * Also drops all cached sprite definitions.
      */
     void DestroyAll();
 
@@ -64,7 +64,7 @@ public:
 
     /**
      * @brief Returns a set of identifiers for all active sprites.
-     * @return A vector with the identifiers of all active sprites.
+     * @return A vector with the identifiers of all active sprites, oldest first.
      */
     auto ActiveSpriteIdentifiers() const -> std::vector<SpriteIdentifier>;
 
@@ -72,7 +72,8 @@ public:
      * @brief Sets the number of available sprite slots, e.g. the number of concurrently active sprites.
      * If there are more active sprites than the newly set limit, the oldest sprites will be destroyed
      * in order until the new limit is matched.
-     * @param slots The maximum number of active sprites. 0 disables user sprites. Default is 16.
+     * @param slots The maximum number of active sprites. 0 disables user sprites and drops all cached
+     *              sprite definitions. Default is 16.
      */
     void SpriteSlots(uint32_t slots);
 
@@ -82,18 +83,67 @@ public:
      */
     auto SpriteSlots() const -> uint32_t;
 
+    /**
+     * @brief Returns the number of draw calls issued for the sprites in the last frame.
+     * @return The number of draw calls, including burn-in draws into the preset framebuffers.
+     */
+    auto LastDrawCallCount() const -> uint32_t;
+
+    /**
+     * @brief Returns the cache of parsed sprite definitions.
+     * @return The sprite definition cache.
+     */
+    auto DefinitionCache() const -> const SpriteDefinitionCache&;
+
 private:
-    using SpriteIdPair = std::pair<SpriteIdentifier, Sprite::Ptr>;
+    static constexpr uint32_t InvalidSlot{std::numeric_limits<uint32_t>::max()}; //!< Marks the end of the age list.
+    static constexpr uint32_t SlotIndexBits{20};                                 //!< Identifier bits used for the slot index, the rest holds the generation.
+    static constexpr uint32_t SlotIndexMask{(1U << SlotIndexBits) - 1};          //!< Mask for the slot index part of an identifier.
+
+    /**
+     * @brief Storage for a single sprite.
+     *
+     * Active slots are linked in order of their age, so the oldest sprite can be found and
+     * any sprite can be removed in constant time.
+     */
+    struct Slot {
+        Sprite::Ptr sprite;            //!< The sprite, or nullptr if the slot is free.
+        uint32_t generation{};         //!< Incremented each time the slot is freed, invalidating old identifiers.
+        uint32_t older{InvalidSlot};   //!< Index of the next older active sprite.
+        uint32_t younger{InvalidSlot}; //!< Index of the next younger active sprite.
+    };
 
     /**
-     * Returns the lowest free ID, starting at 1.
-     * @return The lowest available/unused sprite ID.
+     * @brief Returns the identifier of the sprite in the given slot.
+     * @param slotIndex The slot index.
+     * @return The identifier, combining the slot index and generation.
      */
-    SpriteIdentifier GetLowestFreeIdentifier();
+    auto MakeIdentifier(uint32_t slotIndex) const -> SpriteIdentifier;
+
+    /**
+     * @brief Returns the slot of an active sprite.
+     * @param spriteIdentifier The sprite identifier.
+     * @return The slot index, or InvalidSlot if the identifier doesn't belong to an active sprite.
+     */
+    auto FindSlot(SpriteIdentifier spriteIdentifier) const -> uint32_t;
+
+    /**
+     * @brief Destroys the sprite in the given slot and puts the slot on the free list.
+     * @param slotIndex The index of an active slot.
+     */
+    void FreeSlot(uint32_t slotIndex);
+
+    uint32_t m_spriteSlots{16}; //!< Max number of active sprites.
+
+    std::vector<Slot> m_slots;          //!< Sprite storage, indexed by the lower identifier bits.
+    std::vector<uint32_t> m_freeSlots;  //!< Indices of unused slots.
+    uint32_t m_oldestSlot{InvalidSlot}; //!< The first sprite to draw and to be evicted.
+    uint32_t m_newestSlot{InvalidSlot}; //!< The most recently spawned sprite.
+    uint32_t m_spriteCount{};           //!< Number of active sprites.
 
-    uint32_t m_spriteSlots{16};                     //!< Max number of active sprites.
-    std::set<SpriteIdentifier> m_spriteIdentifiers; //!< Set to keep track of ordered sprite IDs.
-    std::list<SpriteIdPair> m_sprites;              //!< Active sprites with their identifier.
+    SpriteDefinitionCache m_definitionCache; //!< Parsed sprite data, reused when the same sprite is spawned again.
+    std::vector<SpriteInstance> m_instances; //!< Instance data of all sprites in the current frame, in drawing order.
+    SpriteBatch m_batch;                     //!< Draws the sprite instances.
 };
 
 } // namespace UserSprites
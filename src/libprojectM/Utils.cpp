@@ -1,10 +1,35 @@
 #include "Utils.hpp"
 
 #include <algorithm>
+#include <ctime>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
 
 namespace libprojectM {
 namespace Utils {
 
+namespace {
+
+/**
+ * @brief Converts a std::filesystem file time into an integer tick count.
+ */
+template<typename TimeType>
+auto TimeToTicks(TimeType time) -> int64_t
+{
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+/**
+ * @brief Boost.Filesystem returns the modification time as time_t.
+ */
+inline auto TimeToTicks(std::time_t time) -> int64_t
+{
+    return static_cast<int64_t>(time);
+}
+
+} // namespace
+
 auto ToLower(const std::string& str) -> std::string
 {
     std::string lowerStr(str);
@@ -77,5 +102,24 @@ auto StripComments(const std::string& source) -> std::string
     return result;
 }
 
+auto GetFileInfo(const std::string& filename, uint64_t& size, int64_t& modificationTime) -> bool
+{
+    try
+    {
+        if (!is_regular_file(filename))
+        {
+            return false;
+        }
+
+        size = static_cast<uint64_t>(file_size(filename));
+        modificationTime = TimeToTicks(last_write_time(filename));
+        return true;
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+}
+
 } // namespace Utils
 } // namespace libprojectM
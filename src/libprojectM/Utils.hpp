@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace libprojectM {
@@ -22,5 +23,15 @@ void ToUpperInPlace(std::string& str);
  */
 auto StripComments(const std::string& source) -> std::string;
 
+/**
+ * @brief Retrieves the size and modification time of a regular file.
+ * @param filename The file to check.
+ * @param size [out] The file size in bytes.
+ * @param modificationTime [out] The modification time in filesystem-specific ticks. Only comparable
+ *                         with other values returned by this function.
+ * @return True if the file exists and could be checked, false otherwise.
+ */
+auto GetFileInfo(const std::string& filename, uint64_t& size, int64_t& modificationTime) -> bool;
+
 } // namespace Utils
 } // namespace libprojectM
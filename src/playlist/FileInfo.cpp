@@ -0,0 +1,80 @@
+#include "FileInfo.hpp"
+
+#include <ctime>
+#include <fstream>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace libprojectM {
+namespace Playlist {
+
+namespace {
+
+constexpr uint64_t FnvOffsetBasis = 14695981039346656037ULL;
+constexpr uint64_t FnvPrime = 1099511628211ULL;
+
+/**
+ * @brief Converts a std::filesystem file time into an integer tick count.
+ */
+template<typename TimeType>
+auto TimeToTicks(TimeType time) -> int64_t
+{
+    return static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+/**
+ * @brief Boost.Filesystem returns the modification time as time_t.
+ */
+inline auto TimeToTicks(std::time_t time) -> int64_t
+{
+    return static_cast<int64_t>(time);
+}
+
+} // namespace
+
+auto GetFileInfo(const std::string& filename, uint64_t& size, int64_t& modificationTime) -> bool
+{
+    try
+    {
+        if (!is_regular_file(filename))
+        {
+            return false;
+        }
+
+        size = static_cast<uint64_t>(file_size(filename));
+        modificationTime = TimeToTicks(last_write_time(filename));
+        return true;
+    }
+    catch (std::exception&)
+    {
+        return false;
+    }
+}
+
+auto HashFileContents(const std::string& filename, uint64_t& hash) -> bool
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    hash = FnvOffsetBasis;
+
+    char buffer[16384];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+    {
+        auto bytesRead = static_cast<size_t>(file.gcount());
+        for (size_t index = 0; index < bytesRead; index++)
+        {
+            hash ^= static_cast<unsigned char>(buffer[index]);
+            hash *= FnvPrime;
+        }
+    }
+
+    return file.eof();
+}
+
+} // namespace Playlist
+} // namespace libprojectM
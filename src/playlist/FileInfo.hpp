@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace libprojectM {
+namespace Playlist {
+
+/**
+ * @brief Retrieves the size and modification time of a regular file.
+ *
+ * The modification time is an opaque tick count, only meant to be compared with other values
+ * returned by this function.
+ *
+ * @param filename The file to check.
+ * @param size [out] Receives the file size in bytes.
+ * @param modificationTime [out] Receives the modification time.
+ * @return True if the file is a regular file and could be checked, false otherwise.
+ */
+auto GetFileInfo(const std::string& filename, uint64_t& size, int64_t& modificationTime) -> bool;
+
+/**
+ * @brief Calculates the FNV-1a hash of a file's contents.
+ * @param filename The file to hash.
+ * @param hash [out] Receives the hash value.
+ * @return True if the file could be read, false if not.
+ */
+auto HashFileContents(const std::string& filename, uint64_t& hash) -> bool;
+
+} // namespace Playlist
+} // namespace libprojectM
@@ -1,10 +1,25 @@
 #include "Filter.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 namespace libprojectM {
 namespace Playlist {
 
+namespace {
+
+auto IsPathSep(const char* character) -> bool
+{
+    return *character == '/' || *character == '\\';
+}
+
+auto IsSameCharacter(const char* left, const char* right) -> bool
+{
+    return *left == *right || (IsPathSep(left) && IsPathSep(right));
+}
+
+} // namespace
+
 auto Filter::List() const -> const std::vector<std::string>&
 {
     return m_filters;
@@ -13,81 +28,280 @@ auto Filter::List() const -> const std::vector<std::string>&
 void Filter::SetList(std::vector<std::string> filterList)
 {
     m_filters = std::move(filterList);
-}
 
+    m_compiledFilters.clear();
+    m_patternFilters.clear();
+    for (auto& literalFilters : m_literalFilters)
+    {
+        literalFilters.clear();
+    }
 
-auto Filter::Passes(const std::string& filename) -> bool
-{
     for (const auto& filterExpression : m_filters)
     {
-        if (!filterExpression.empty() && ApplyExpression(filename, filterExpression))
+        if (filterExpression.empty())
         {
-            // Default action is "remove if filename matches".
-            return filterExpression.at(0) == '+';
+            continue;
         }
-    }
 
-    return true;
+        auto compiledIndex = m_compiledFilters.size();
+        m_compiledFilters.push_back(Compile(filterExpression));
+
+        const auto& compiledExpression = m_compiledFilters.back();
+        if (compiledExpression.matchType == MatchType::Literal)
+        {
+            // Only the first occurrence of a literal is relevant, as the first matching rule wins.
+            m_literalFilters[static_cast<int>(compiledExpression.anchor)].emplace(NormalizeSeparators(compiledExpression.pattern.c_str()), compiledIndex);
+        }
+        else
+        {
+            m_patternFilters.push_back(compiledIndex);
+        }
+    }
 }
 
 
-auto Filter::ApplyExpression(const std::string& filename, const std::string& filterExpression) -> bool
+auto Filter::Passes(const std::string& filename) const -> bool
 {
-    // Implementation idea thanks to Robert van Engelen
-    // https://www.codeproject.com/Articles/5163931/Fast-String-Matching-with-Wildcards-Globs-and-Giti
-
-    if (filename.empty() || filterExpression.empty())
+    const auto* expression = FirstMatch(filename);
+    if (expression == nullptr)
     {
-        return false;
+        return true;
     }
 
-    const auto* currentFilenameChar{filename.c_str()};
-    const auto* currentFilterChar{filterExpression.c_str()};
+    // Default action is "remove if filename matches".
+    return expression->include;
+}
 
-    const char* previousFilenameChar{nullptr};
-    const char* previousFilterChar{nullptr};
 
-    bool inPathglob{false}; //!< True if the glob has a '**' pattern
+auto Filter::Matches(const std::string& filename) const -> bool
+{
+    return FirstMatch(filename) != nullptr;
+}
 
-    auto isPathSep = [](const char* character) {
-        return *character == '/' || *character == '\\';
-    };
 
-    if (*currentFilterChar == '+' || *currentFilterChar == '-')
+auto Filter::FirstMatch(const std::string& filename) const -> const CompiledExpression*
+{
+    if (filename.empty() || m_compiledFilters.empty())
     {
-        currentFilterChar++;
+        return nullptr;
     }
 
-    if (isPathSep(currentFilterChar))
+    // Find the first literal rule matching the filename. Pattern rules only need to be checked up to this index.
+    auto firstLiteralMatch = m_compiledFilters.size();
+    for (int anchor = 0; anchor < static_cast<int>(Anchor::Count); anchor++)
     {
-        while (*currentFilenameChar == '.' && isPathSep(&currentFilenameChar[1]))
+        const auto& literalFilters = m_literalFilters[anchor];
+        if (literalFilters.empty())
         {
-            currentFilenameChar += 2;
+            continue;
         }
-        while (isPathSep(currentFilenameChar))
+
+        auto match = literalFilters.find(NormalizeSeparators(MatchStart(filename, static_cast<Anchor>(anchor))));
+        if (match != literalFilters.end())
         {
-            currentFilenameChar++;
+            firstLiteralMatch = std::min(firstLiteralMatch, match->second);
         }
-        currentFilterChar++;
     }
-    else if (strchr(currentFilterChar, '/') == nullptr && strchr(currentFilterChar, '\\') == nullptr)
+
+    for (auto patternIndex : m_patternFilters)
     {
-        const auto *separatorUnix = strrchr(currentFilenameChar, '/');
-        const auto *separatorwindows = strrchr(currentFilenameChar, '\\');
-        if (separatorUnix != nullptr && separatorwindows != nullptr)
+        if (patternIndex > firstLiteralMatch)
         {
-            currentFilenameChar = std::min(separatorUnix, separatorwindows) + 1;
+            break;
         }
-        else if (separatorUnix != nullptr)
+
+        const auto& expression = m_compiledFilters[patternIndex];
+        if (ApplyExpression(filename, expression))
         {
-            currentFilenameChar = separatorUnix + 1;
+            return &expression;
         }
-        else if (separatorwindows != nullptr)
-        {
-            currentFilenameChar = separatorwindows + 1;
+    }
+
+    if (firstLiteralMatch < m_compiledFilters.size())
+    {
+        return &m_compiledFilters[firstLiteralMatch];
+    }
+
+    return nullptr;
+}
+
+
+auto Filter::Compile(const std::string& filterExpression) -> CompiledExpression
+{
+    CompiledExpression compiledExpression;
+
+    const auto* currentFilterChar{filterExpression.c_str()};
+
+    compiledExpression.include = *currentFilterChar == '+';
+    if (*currentFilterChar == '+' || *currentFilterChar == '-')
+    {
+        currentFilterChar++;
+    }
+
+    if (IsPathSep(currentFilterChar))
+    {
+        compiledExpression.anchor = Anchor::Root;
+        currentFilterChar++;
+    }
+    else if (strchr(currentFilterChar, '/') == nullptr && strchr(currentFilterChar, '\\') == nullptr)
+    {
+        compiledExpression.anchor = Anchor::Filename;
+    }
+    else
+    {
+        compiledExpression.anchor = Anchor::Path;
+    }
+
+    compiledExpression.pattern = currentFilterChar;
+    auto& pattern = compiledExpression.pattern;
+
+    auto starCount = std::count(pattern.begin(), pattern.end(), '*');
+    auto hasQuestionMark = pattern.find('?') != std::string::npos;
+
+    if (hasQuestionMark || starCount > 1)
+    {
+        compiledExpression.matchType = MatchType::Glob;
+    }
+    else if (starCount == 0)
+    {
+        compiledExpression.matchType = MatchType::Literal;
+    }
+    else if (pattern.back() == '*')
+    {
+        compiledExpression.matchType = MatchType::Prefix;
+        pattern.pop_back();
+    }
+    else if (pattern.front() == '*')
+    {
+        compiledExpression.matchType = MatchType::Suffix;
+        pattern.erase(0, 1);
+    }
+    else
+    {
+        compiledExpression.matchType = MatchType::Glob;
+    }
+
+    return compiledExpression;
+}
+
+
+auto Filter::MatchStart(const std::string& filename, Anchor anchor) -> const char*
+{
+    const auto* currentFilenameChar{filename.c_str()};
+
+    switch (anchor)
+    {
+        case Anchor::Root:
+            while (*currentFilenameChar == '.' && IsPathSep(&currentFilenameChar[1]))
+            {
+                currentFilenameChar += 2;
+            }
+            while (IsPathSep(currentFilenameChar))
+            {
+                currentFilenameChar++;
+            }
+            break;
+
+        case Anchor::Filename: {
+            const auto* separatorUnix = strrchr(currentFilenameChar, '/');
+            const auto* separatorwindows = strrchr(currentFilenameChar, '\\');
+            if (separatorUnix != nullptr && separatorwindows != nullptr)
+            {
+                currentFilenameChar = std::min(separatorUnix, separatorwindows) + 1;
+            }
+            else if (separatorUnix != nullptr)
+            {
+                currentFilenameChar = separatorUnix + 1;
+            }
+            else if (separatorwindows != nullptr)
+            {
+                currentFilenameChar = separatorwindows + 1;
+            }
+            break;
+        }
+
+        case Anchor::Path:
+        case Anchor::Count:
+            break;
+    }
+
+    return currentFilenameChar;
+}
+
+
+auto Filter::ApplyExpression(const std::string& filename, const CompiledExpression& expression) -> bool
+{
+    const auto* currentFilenameChar = MatchStart(filename, expression.anchor);
+    const auto& pattern = expression.pattern;
+
+    switch (expression.matchType)
+    {
+        case MatchType::Literal:
+            return NormalizeSeparators(currentFilenameChar) == NormalizeSeparators(pattern.c_str());
+
+        case MatchType::Prefix: {
+            // A single "*" doesn't match path separators.
+            for (const auto& patternChar : pattern)
+            {
+                if (*currentFilenameChar == '\0' || !IsSameCharacter(&patternChar, currentFilenameChar))
+                {
+                    return false;
+                }
+                currentFilenameChar++;
+            }
+
+            return strchr(currentFilenameChar, '/') == nullptr && strchr(currentFilenameChar, '\\') == nullptr;
         }
+
+        case MatchType::Suffix: {
+            auto remainingLength = strlen(currentFilenameChar);
+            if (remainingLength < pattern.length())
+            {
+                return false;
+            }
+
+            const auto* suffixStart = currentFilenameChar + remainingLength - pattern.length();
+            for (const auto* character = currentFilenameChar; character != suffixStart; character++)
+            {
+                if (IsPathSep(character))
+                {
+                    return false;
+                }
+            }
+
+            for (const auto& patternChar : pattern)
+            {
+                if (!IsSameCharacter(&patternChar, suffixStart))
+                {
+                    return false;
+                }
+                suffixStart++;
+            }
+
+            return true;
+        }
+
+        case MatchType::Glob:
+            return MatchGlob(currentFilenameChar, pattern.c_str());
     }
 
+    return false;
+}
+
+
+auto Filter::MatchGlob(const char* filename, const char* filter) -> bool
+{
+    // Implementation idea thanks to Robert van Engelen
+    // https://www.codeproject.com/Articles/5163931/Fast-String-Matching-with-Wildcards-Globs-and-Giti
+
+    const auto* currentFilenameChar{filename};
+    const auto* currentFilterChar{filter};
+
+    const char* previousFilenameChar{nullptr};
+    const char* previousFilterChar{nullptr};
+
+    bool inPathglob{false}; //!< True if the glob has a '**' pattern
+
     while (*currentFilenameChar != '\0')
     {
         switch (*currentFilterChar)
@@ -105,7 +319,7 @@ auto Filter::ApplyExpression(const std::string& filename, const std::string& fil
                     {
                         return true;
                     }
-                    if (!isPathSep(currentFilterChar))
+                    if (!IsPathSep(currentFilterChar))
                     {
                         return false;
                     }
@@ -117,7 +331,7 @@ auto Filter::ApplyExpression(const std::string& filename, const std::string& fil
                 continue;
 
             case '?':
-                if (isPathSep(currentFilenameChar))
+                if (IsPathSep(currentFilenameChar))
                 {
                     break;
                 }
@@ -127,8 +341,7 @@ auto Filter::ApplyExpression(const std::string& filename, const std::string& fil
                 continue;
 
             default:
-                if (*currentFilterChar != *currentFilenameChar &&
-                    !(isPathSep(currentFilterChar) && isPathSep(currentFilenameChar)))
+                if (!IsSameCharacter(currentFilterChar, currentFilenameChar))
                 {
                     break;
                 }
@@ -137,7 +350,7 @@ auto Filter::ApplyExpression(const std::string& filename, const std::string& fil
                 continue;
         }
 
-        if (previousFilterChar != nullptr && (inPathglob || !isPathSep(previousFilenameChar)))
+        if (previousFilterChar != nullptr && (inPathglob || !IsPathSep(previousFilenameChar)))
         {
             currentFilenameChar = ++previousFilenameChar;
             currentFilterChar = previousFilterChar;
@@ -156,5 +369,13 @@ auto Filter::ApplyExpression(const std::string& filename, const std::string& fil
 }
 
 
+auto Filter::NormalizeSeparators(const char* text) -> std::string
+{
+    std::string normalized(text);
+    std::replace(normalized.begin(), normalized.end(), '\\', '/');
+    return normalized;
+}
+
+
 } // namespace Playlist
 } // namespace libprojectM
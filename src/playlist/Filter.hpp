@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace libprojectM {
@@ -10,6 +12,11 @@ namespace Playlist {
  * @brief Implements a simple filename globbing filter.
  *
  * See API docs of projectm_playlist_set_filter() in playlist.h for syntax details.
+ *
+ * Filter expressions are compiled once when the list is set. Expressions without wildcards are
+ * looked up in a hash table, expressions with a single leading or trailing "*" use a simple
+ * suffix or prefix comparison, and only the remaining expressions run the full glob matcher.
+ * Passes() doesn't modify the filter and can be called from multiple threads concurrently.
  */
 class Filter
 {
@@ -35,18 +42,103 @@ public:
      * @param filename The filename to check.
      * @return True if the filename passes the filter, false if it should b skipped.
      */
-    auto Passes(const std::string& filename) ->bool;
+    auto Passes(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Checks if any expression in the filter list matches the filename.
+     *
+     * Unlike Passes(), the include/exclude action of the expressions is ignored.
+     *
+     * @param filename The filename to check.
+     * @return True if at least one expression matches the filename, false if none does.
+     */
+    auto Matches(const std::string& filename) const -> bool;
 
 private:
     /**
-     * @brief Applies a single filter to the given filename.
-     * @param character The filename to check.
-     * @param filterExpression The filter expression. A leading + or - is ignored.
-     * @return True if the filter matches the filename, false otherwise.
+     * Determines which part of the filename an expression is matched against.
+     */
+    enum class Anchor : int
+    {
+        Root,     //!< Expression starts with a path separator, match against the whole path.
+        Filename, //!< Expression contains no path separator, match against the filename only.
+        Path,     //!< Expression contains a path separator, match against the whole path.
+        Count     //!< Number of anchor types.
+    };
+
+    /**
+     * Matching strategy selected by the expression compiler.
      */
-    static auto ApplyExpression(const std::string& character, const std::string& filterExpression) -> bool;
+    enum class MatchType
+    {
+        Literal, //!< No wildcards, the remaining filename must be equal to the pattern.
+        Prefix,  //!< Pattern followed by a single "*".
+        Suffix,  //!< A single "*" followed by the pattern.
+        Glob     //!< Anything else, uses the backtracking glob matcher.
+    };
+
+    /**
+     * A pre-processed filter expression.
+     */
+    struct CompiledExpression {
+        bool include{false};                 //!< True if a match includes the file, false if it's removed.
+        Anchor anchor{Anchor::Filename};     //!< Part of the filename to match against.
+        MatchType matchType{MatchType::Glob}; //!< Matching strategy.
+        std::string pattern;                 //!< Pattern without action prefix, anchoring separator and fast-path wildcard.
+    };
+
+    /**
+     * @brief Returns the first expression in the list which matches the filename.
+     * @param filename The filename to check.
+     * @return A pointer to the first matching compiled expression, or nullptr if none matches.
+     */
+    auto FirstMatch(const std::string& filename) const -> const CompiledExpression*;
+
+    /**
+     * @brief Compiles a single non-empty filter expression.
+     * @param filterExpression The filter expression, including the optional + or - prefix.
+     * @return The compiled expression.
+     */
+    static auto Compile(const std::string& filterExpression) -> CompiledExpression;
+
+    /**
+     * @brief Returns the part of the filename an expression with the given anchor is matched against.
+     * @param filename The full filename.
+     * @param anchor The expression anchor type.
+     * @return A pointer into the filename where matching starts.
+     */
+    static auto MatchStart(const std::string& filename, Anchor anchor) -> const char*;
+
+    /**
+     * @brief Applies a single compiled expression to the given filename.
+     * @param filename The filename to check.
+     * @param expression The compiled expression.
+     * @return True if the expression matches the filename, false otherwise.
+     */
+    static auto ApplyExpression(const std::string& filename, const CompiledExpression& expression) -> bool;
+
+    /**
+     * @brief Matches a glob pattern against the given string.
+     * @param filename Start of the (partial) filename to match.
+     * @param filter Start of the glob pattern.
+     * @return True if the pattern matches the whole string, false otherwise.
+     */
+    static auto MatchGlob(const char* filename, const char* filter) -> bool;
+
+    /**
+     * @brief Creates a lookup key for literal expressions.
+     * Both path separator types are considered equal by the matcher, so they're unified in the key.
+     * @param text The text to normalize.
+     * @return The text with all backslashes replaced by forward slashes.
+     */
+    static auto NormalizeSeparators(const char* text) -> std::string;
 
     std::vector<std::string> m_filters; //!< List of filters to apply.
+
+    std::vector<CompiledExpression> m_compiledFilters; //!< Compiled non-empty expressions, in the same order as in m_filters.
+    std::vector<size_t> m_patternFilters;              //!< Indices of all non-literal expressions in m_compiledFilters.
+
+    std::unordered_map<std::string, size_t> m_literalFilters[static_cast<int>(Anchor::Count)]; //!< First literal expression index per normalized pattern and anchor.
 };
 
 } // namespace Playlist
@@ -0,0 +1,66 @@
+#include "History.hpp"
+
+namespace libprojectM {
+namespace Playlist {
+
+History::History(size_t capacity)
+    : m_entries(capacity > 0 ? capacity : 1)
+{
+}
+
+
+auto History::Empty() const -> bool
+{
+    return m_size == 0;
+}
+
+
+auto History::Size() const -> size_t
+{
+    return m_size;
+}
+
+
+void History::Clear()
+{
+    m_start = 0;
+    m_size = 0;
+}
+
+
+void History::Push(uint64_t itemId)
+{
+    if (m_size == m_entries.size())
+    {
+        m_entries[m_start] = itemId;
+        m_start = (m_start + 1) % m_entries.size();
+        return;
+    }
+
+    m_entries[(m_start + m_size) % m_entries.size()] = itemId;
+    m_size++;
+}
+
+
+void History::Pop()
+{
+    if (m_size > 0)
+    {
+        m_size--;
+    }
+}
+
+
+auto History::Back() const -> uint64_t
+{
+    return m_entries[(m_start + m_size - 1) % m_entries.size()];
+}
+
+
+auto History::At(size_t index) const -> uint64_t
+{
+    return m_entries[(m_start + index) % m_entries.size()];
+}
+
+} // namespace Playlist
+} // namespace libprojectM
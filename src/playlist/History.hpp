@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace libprojectM {
+namespace Playlist {
+
+/**
+ * @brief Bounded playback history of item IDs.
+ *
+ * Implemented as a ring buffer with a fixed capacity. If the history is full, adding a new
+ * entry overwrites the oldest one.
+ */
+class History
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param capacity The maximum number of entries kept in the history.
+     */
+    explicit History(size_t capacity);
+
+    /**
+     * @brief Returns if the history is empty.
+     * @return True if the history contains no entries.
+     */
+    auto Empty() const -> bool;
+
+    /**
+     * @brief Returns the number of entries in the history.
+     * @return The number of entries.
+     */
+    auto Size() const -> size_t;
+
+    /**
+     * @brief Removes all entries.
+     */
+    void Clear();
+
+    /**
+     * @brief Adds a new entry, removing the oldest one if the history is full.
+     * @param itemId The item ID to add.
+     */
+    void Push(uint64_t itemId);
+
+    /**
+     * @brief Removes the newest entry. Does nothing if the history is empty.
+     */
+    void Pop();
+
+    /**
+     * @brief Returns the newest entry.
+     * @note Must not be called on an empty history.
+     * @return The newest item ID.
+     */
+    auto Back() const -> uint64_t;
+
+    /**
+     * @brief Returns the entry at the given position, with 0 being the oldest entry.
+     * @param index The entry index, must be smaller than Size().
+     * @return The item ID at the given position.
+     */
+    auto At(size_t index) const -> uint64_t;
+
+private:
+    std::vector<uint64_t> m_entries; //!< Ring buffer storage, sized to the capacity.
+    size_t m_start{0};               //!< Buffer index of the oldest entry.
+    size_t m_size{0};                //!< Number of valid entries.
+};
+
+} // namespace Playlist
+} // namespace libprojectM
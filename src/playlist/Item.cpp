@@ -3,18 +3,25 @@
 namespace libprojectM {
 namespace Playlist {
 
-Item::Item(std::string filename)
+Item::Item(std::string filename, uint64_t id)
     : m_filename(std::move(filename))
+    , m_id(id)
 {
 }
 
 
-auto Item::Filename() const -> std::string
+auto Item::Filename() const -> const std::string&
 {
     return m_filename;
 }
 
 
+auto Item::Id() const -> uint64_t
+{
+    return m_id;
+}
+
+
 auto Item::operator==(const std::string& other) const -> bool
 {
     return m_filename == other;
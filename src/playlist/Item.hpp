@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 namespace libprojectM {
@@ -10,13 +11,24 @@ class Item
 public:
     Item() = delete;
 
-    explicit Item(std::string filename);
+    /**
+     * @brief Constructor.
+     * @param filename The full path and filename of the preset.
+     * @param id A playlist-unique ID which identifies the item even if its position changes.
+     */
+    explicit Item(std::string filename, uint64_t id = 0);
 
     /**
      * @brief Returns the filename of the playlist item.
      * @return The full path and filename of the playlist item.
      */
-    auto Filename() const -> std::string;
+    auto Filename() const -> const std::string&;
+
+    /**
+     * @brief Returns the stable item ID.
+     * @return The ID assigned by the playlist when the item was added.
+     */
+    auto Id() const -> uint64_t;
 
     /**
      * @brief Filename comparator.
@@ -27,6 +39,7 @@ public:
 
 private:
     std::string m_filename;
+    uint64_t m_id{};
 };
 
 } // namespace Playlist
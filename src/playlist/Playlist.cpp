@@ -1,7 +1,11 @@
 #include "Playlist.hpp"
 
+#include "PlaylistSnapshot.hpp"
+
 #include <algorithm>
 #include <chrono>
+#include <system_error>
+#include <thread>
 
 // Fall back to boost if compiler doesn't support C++17
 #include PROJECTM_FILESYSTEM_INCLUDE
@@ -35,8 +39,13 @@ bool Playlist::Empty() const
 
 void Playlist::Clear()
 {
-    m_presetHistory.clear();
+    m_presetHistory.Clear();
+    m_shuffleBag.clear();
+    m_shuffleBagNext = 0;
     m_items.clear();
+    m_itemPositions.clear();
+    m_validItemPositions = 0;
+    m_itemsGeneration++;
 }
 
 
@@ -46,6 +55,31 @@ const std::vector<Item>& Playlist::Items() const
 }
 
 
+auto Playlist::ItemsGeneration() const -> uint64_t
+{
+    return m_itemsGeneration;
+}
+
+
+auto Playlist::Find(const std::string& pattern, uint32_t startIndex, uint32_t maxResults) const -> std::vector<uint32_t>
+{
+    std::vector<uint32_t> matches;
+
+    class Filter patternFilter;
+    patternFilter.SetList({pattern});
+
+    for (size_t index = startIndex; index < m_items.size() && matches.size() < maxResults; index++)
+    {
+        if (patternFilter.Matches(m_items[index].Filename()))
+        {
+            matches.push_back(static_cast<uint32_t>(index));
+        }
+    }
+
+    return matches;
+}
+
+
 bool Playlist::AddItem(const std::string& filename, uint32_t index, bool allowDuplicates)
 {
     if (filename.empty())
@@ -66,23 +100,34 @@ bool Playlist::AddItem(const std::string& filename, uint32_t index, bool allowDu
         }
     }
 
+    auto itemId = m_nextItemId++;
+    m_itemsGeneration++;
+
     if (index >= m_items.size())
     {
-        m_items.emplace_back(filename);
+        index = static_cast<uint32_t>(m_items.size());
+        m_items.emplace_back(filename, itemId);
+
+        m_itemPositions[itemId] = index;
+        if (m_validItemPositions == index)
+        {
+            // No other items have moved, so the map stays up to date.
+            m_validItemPositions++;
+        }
     }
     else
     {
-        // Increment indices of items equal or grater than the newly added index.
-        for (auto& historyItem : m_presetHistory)
-        {
-            if (historyItem >= index)
-            {
-                historyItem++;
-            }
-        }
-
+        InvalidateItemPositions(index);
+        m_items.emplace(m_items.cbegin() + index, filename, itemId);
+        m_itemPositions[itemId] = index;
+    }
 
-        m_items.emplace(m_items.cbegin() + index, filename);
+    // Add new items to a random spot in the remaining part of the current shuffle cycle.
+    if (!m_shuffleBag.empty())
+    {
+        m_shuffleBag.push_back(itemId);
+        std::uniform_int_distribution<size_t> bagDistribution(m_shuffleBagNext, m_shuffleBag.size() - 1);
+        std::swap(m_shuffleBag.back(), m_shuffleBag[bagDistribution(m_randomGenerator)]);
     }
 
     return true;
@@ -138,15 +183,6 @@ auto Playlist::AddPath(const std::string& path, uint32_t index, bool recursive,
         }
     }
 
-    // Increment indices of items in playback history equal or grater than the newly added index.
-    for (auto& historyItem : m_presetHistory)
-    {
-        if (historyItem >= index)
-        {
-            historyItem += presetsAdded;
-        }
-    }
-
     return presetsAdded;
 }
 
@@ -158,24 +194,12 @@ auto Playlist::RemoveItem(uint32_t index) -> bool
         return false;
     }
 
-    // Remove item from history and decrement indices of items after the removed index.
-    for (auto it = begin(m_presetHistory); it != end(m_presetHistory);)
-    {
-        if (*it == index)
-        {
-            it = m_presetHistory.erase(it);
-            continue;
-        }
-
-        if (*it > index)
-        {
-            (*it)--;
-        }
-
-        ++it;
-    }
+    // History entries of the removed item are skipped when the history is read.
+    m_itemPositions.erase(m_items[index].Id());
+    InvalidateItemPositions(index);
 
     m_items.erase(m_items.cbegin() + index);
+    m_itemsGeneration++;
 
     return true;
 }
@@ -193,6 +217,20 @@ auto Playlist::Shuffle() const -> bool
 }
 
 
+void Playlist::SetShuffleMode(ShuffleMode mode)
+{
+    m_shuffleMode = mode;
+    m_shuffleBag.clear();
+    m_shuffleBagNext = 0;
+}
+
+
+auto Playlist::GetShuffleMode() const -> ShuffleMode
+{
+    return m_shuffleMode;
+}
+
+
 void Playlist::Sort(uint32_t startIndex, uint32_t count,
                     Playlist::SortPredicate predicate, Playlist::SortOrder order)
 {
@@ -206,7 +244,8 @@ void Playlist::Sort(uint32_t startIndex, uint32_t count,
         count = static_cast<uint32_t>(m_items.size() - startIndex);
     }
 
-    m_presetHistory.clear();
+    InvalidateItemPositions(startIndex);
+    m_itemsGeneration++;
 
     std::sort(m_items.begin() + startIndex,
               m_items.begin() + startIndex + count,
@@ -243,6 +282,36 @@ void Playlist::Sort(uint32_t startIndex, uint32_t count,
 }
 
 
+void Playlist::SetFrameBudget(double seconds)
+{
+    m_frameBudget = seconds;
+}
+
+
+auto Playlist::FrameBudget() const -> double
+{
+    return m_frameBudget;
+}
+
+
+void Playlist::SetCostMode(CostMode mode)
+{
+    m_costMode = mode;
+}
+
+
+auto Playlist::GetCostMode() const -> CostMode
+{
+    return m_costMode;
+}
+
+
+auto Playlist::Stats() -> PresetStats&
+{
+    return m_stats;
+}
+
+
 auto Playlist::NextPresetIndex() -> uint32_t
 {
     if (m_items.empty())
@@ -252,19 +321,7 @@ auto Playlist::NextPresetIndex() -> uint32_t
 
     AddCurrentPresetIndexToHistory();
 
-    if (m_shuffle)
-    {
-        std::uniform_int_distribution<uint32_t> randomDistribution(0, static_cast<uint32_t>(m_items.size() - 1));
-        m_currentPosition = randomDistribution(m_randomGenerator);
-    }
-    else
-    {
-        m_currentPosition++;
-        if (m_currentPosition >= m_items.size())
-        {
-            m_currentPosition = 0;
-        }
-    }
+    m_currentPosition = SelectPosition(true);
 
     return m_currentPosition;
 }
@@ -279,26 +336,43 @@ auto Playlist::PreviousPresetIndex() -> uint32_t
 
     AddCurrentPresetIndexToHistory();
 
-    if (m_shuffle)
+    if (m_shuffle && m_shuffleMode == ShuffleMode::Bag)
     {
-        std::uniform_int_distribution<uint32_t> randomDistribution(0, static_cast<uint32_t>(m_items.size() - 1));
-        m_currentPosition = randomDistribution(m_randomGenerator);
+        m_currentPosition = StepBackShuffleBag();
+        return m_currentPosition;
     }
-    else
+
+    m_currentPosition = SelectPosition(false);
+
+    return m_currentPosition;
+}
+
+
+auto Playlist::PeekNextPresetIndex(uint32_t& index) -> bool
+{
+    if (m_items.empty())
     {
-        if (m_currentPosition == 0)
-        {
-            m_currentPosition = static_cast<uint32_t>(m_items.size() - 1);
-        }
-        else
-        {
-            m_currentPosition--;
-        }
+        return false;
     }
 
-    return m_currentPosition;
+    if (!m_shuffle)
+    {
+        index = m_currentPosition + 1 >= m_items.size() ? 0 : m_currentPosition + 1;
+        return true;
+    }
+
+    if (m_shuffleMode == ShuffleMode::Random)
+    {
+        return false;
+    }
+
+    PrepareShuffleBag();
+    index = ItemPosition(m_shuffleBag[m_shuffleBagNext]);
+
+    return true;
 }
 
+
 auto Playlist::LastPresetIndex() -> uint32_t
 {
     if (m_items.empty())
@@ -306,18 +380,22 @@ auto Playlist::LastPresetIndex() -> uint32_t
         throw PlaylistEmptyException();
     }
 
-    if (!m_presetHistory.empty())
+    while (!m_presetHistory.Empty())
     {
-        m_currentPosition = m_presetHistory.back();
-        m_presetHistory.pop_back();
-    }
-    else
-    {
-        m_currentPosition = PreviousPresetIndex();
-        // Remove added history item again to prevent ping-pong behavior
-        m_presetHistory.pop_back();
+        auto position = ItemPosition(m_presetHistory.Back());
+        m_presetHistory.Pop();
+
+        if (position != InvalidPosition)
+        {
+            m_currentPosition = position;
+            return m_currentPosition;
+        }
     }
 
+    m_currentPosition = PreviousPresetIndex();
+    // Remove added history item again to prevent ping-pong behavior
+    m_presetHistory.Pop();
+
     return m_currentPosition;
 }
 
@@ -360,17 +438,24 @@ auto Playlist::SetPresetIndex(uint32_t presetIndex) -> uint32_t
 
 void Playlist::RemoveLastHistoryEntry()
 {
-    if (!m_presetHistory.empty())
-    {
-        m_presetHistory.pop_back();
-    }
+    PruneHistory();
+    m_presetHistory.Pop();
 }
 
 
 auto Playlist::HistoryItems() const -> std::vector<uint32_t>
 {
     std::vector<uint32_t> items;
-    std::copy(begin(m_presetHistory), end(m_presetHistory), std::back_inserter(items));
+    items.reserve(m_presetHistory.Size());
+
+    for (size_t index = 0; index < m_presetHistory.Size(); index++)
+    {
+        auto position = ItemPosition(m_presetHistory.At(index));
+        if (position != InvalidPosition)
+        {
+            items.push_back(position);
+        }
+    }
 
     return items;
 }
@@ -384,42 +469,411 @@ auto Playlist::Filter() -> class Filter&
 
 auto Playlist::ApplyFilter() -> uint32_t
 {
-    uint32_t itemsRemoved{};
+    // Evaluate all items first, possibly in parallel, then compact the item list in a single pass.
+    std::vector<char> itemPasses(m_items.size(), 1);
+
+    auto evaluateRange = [this, &itemPasses](size_t startIndex, size_t endIndex) {
+        for (size_t index = startIndex; index < endIndex; index++)
+        {
+            itemPasses[index] = m_filter.Passes(m_items[index].Filename()) ? 1 : 0;
+        }
+    };
+
+    size_t threadCount = std::min(static_cast<size_t>(std::thread::hardware_concurrency()),
+                                  m_items.size() / MinItemsPerFilterThread);
+
+    if (threadCount > 1)
+    {
+        std::vector<std::thread> workers;
+        size_t itemsPerThread = (m_items.size() + threadCount - 1) / threadCount;
+
+        try
+        {
+            for (size_t startIndex = itemsPerThread; startIndex < m_items.size(); startIndex += itemsPerThread)
+            {
+                workers.emplace_back(evaluateRange, startIndex, std::min(startIndex + itemsPerThread, m_items.size()));
+            }
+        }
+        catch (std::system_error&)
+        {
+            // Threads not available, the calling thread will evaluate the remaining items.
+        }
+
+        size_t evaluatedEnd = itemsPerThread * (workers.size() + 1);
+        evaluateRange(0, itemsPerThread);
+        if (evaluatedEnd < m_items.size())
+        {
+            evaluateRange(evaluatedEnd, m_items.size());
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    else
+    {
+        evaluateRange(0, m_items.size());
+    }
+
+    return RemoveMarkedItems(itemPasses);
+}
+
+
+auto Playlist::RemoveItems(const std::unordered_set<std::string>& filenames) -> uint32_t
+{
+    if (filenames.empty())
+    {
+        return 0;
+    }
+
+    std::vector<char> keepItems(m_items.size(), 1);
+    for (size_t index = 0; index < m_items.size(); index++)
+    {
+        if (filenames.find(m_items[index].Filename()) != filenames.end())
+        {
+            keepItems[index] = 0;
+        }
+    }
+
+    return RemoveMarkedItems(keepItems);
+}
+
 
-    for (auto it = begin(m_items); it != end(m_items);)
+auto Playlist::RemoveMarkedItems(const std::vector<char>& keepItems) -> uint32_t
+{
+    size_t writeIndex{0};
+    for (size_t readIndex = 0; readIndex < m_items.size(); readIndex++)
     {
-        if (!m_filter.Passes(it->Filename()))
+        if (keepItems[readIndex] == 0)
         {
-            it = m_items.erase(it);
-            itemsRemoved++;
+            m_itemPositions.erase(m_items[readIndex].Id());
+            InvalidateItemPositions(readIndex);
+            continue;
         }
-        else
+
+        if (writeIndex != readIndex)
         {
-            ++it;
+            m_items[writeIndex] = std::move(m_items[readIndex]);
         }
+        writeIndex++;
     }
 
+    auto itemsRemoved = static_cast<uint32_t>(m_items.size() - writeIndex);
+    m_items.erase(m_items.begin() + static_cast<std::ptrdiff_t>(writeIndex), m_items.end());
+
     if (itemsRemoved != 0)
     {
-        m_presetHistory.clear();
+        m_itemsGeneration++;
     }
 
     return itemsRemoved;
 }
 
 
+auto Playlist::SaveSnapshot(const std::string& filename) const -> bool
+{
+    PlaylistSnapshot snapshot;
+
+    snapshot.items.reserve(m_items.size());
+    for (const auto& item : m_items)
+    {
+        snapshot.items.push_back(item.Filename());
+    }
+
+    snapshot.filters = m_filter.List();
+    snapshot.history = HistoryItems();
+    snapshot.shuffle = m_shuffle;
+    snapshot.currentPosition = m_currentPosition;
+
+    return snapshot.Save(filename);
+}
+
+
+auto Playlist::LoadSnapshot(const std::string& filename) -> bool
+{
+    PlaylistSnapshot snapshot;
+    if (!snapshot.Load(filename))
+    {
+        return false;
+    }
+
+    Clear();
+
+    m_items.reserve(snapshot.items.size());
+    m_itemPositions.reserve(snapshot.items.size());
+    for (auto& itemFilename : snapshot.items)
+    {
+        auto itemId = m_nextItemId++;
+        m_itemPositions.emplace(itemId, static_cast<uint32_t>(m_items.size()));
+        m_items.emplace_back(std::move(itemFilename), itemId);
+    }
+    m_validItemPositions = m_items.size();
+
+    for (auto historyIndex : snapshot.history)
+    {
+        m_presetHistory.Push(m_items[historyIndex].Id());
+    }
+
+    m_filter.SetList(std::move(snapshot.filters));
+    m_shuffle = snapshot.shuffle;
+    m_currentPosition = snapshot.currentPosition;
+
+    return true;
+}
+
+
 void Playlist::AddCurrentPresetIndexToHistory()
 {
+    if (m_currentPosition >= m_items.size())
+    {
+        return;
+    }
+
+    auto currentItemId = m_items[m_currentPosition].Id();
+
     // No duplicate entries.
-    if (!m_presetHistory.empty() && m_currentPosition == m_presetHistory.back())
+    PruneHistory();
+    if (!m_presetHistory.Empty() && currentItemId == m_presetHistory.Back())
     {
         return;
     }
 
-    m_presetHistory.push_back(m_currentPosition);
-    if (m_presetHistory.size() > MaxHistoryItems)
+    // The ring buffer drops the oldest entry if full.
+    m_presetHistory.Push(currentItemId);
+}
+
+
+auto Playlist::SelectPosition(bool forward) -> uint32_t
+{
+    auto itemCount = static_cast<uint32_t>(m_items.size());
+
+    if (m_shuffle && m_shuffleMode == ShuffleMode::Bag)
+    {
+        return SelectShuffleBagPosition();
+    }
+
+    if (m_shuffle)
+    {
+        std::uniform_int_distribution<uint32_t> randomDistribution(0, itemCount - 1);
+
+        uint32_t position{};
+        for (uint32_t attempt = 0; attempt < MaxCostSelectionAttempts; attempt++)
+        {
+            position = randomDistribution(m_randomGenerator);
+            if (AcceptByCost(position))
+            {
+                return position;
+            }
+        }
+
+        // Unlucky draws: scan once around the playlist from the last draw for an item within the budget.
+        for (uint32_t checked = 0; checked < itemCount; checked++)
+        {
+            auto candidate = (position + checked) % itemCount;
+            if (IsWithinBudget(candidate))
+            {
+                return candidate;
+            }
+        }
+
+        return position;
+    }
+
+    auto step = [itemCount, forward](uint32_t position) -> uint32_t {
+        if (forward)
+        {
+            return position + 1 >= itemCount ? 0 : position + 1;
+        }
+        return position == 0 ? itemCount - 1 : position - 1;
+    };
+
+    // Walk at most once around the playlist. If no item fits the budget, play the adjacent one.
+    auto adjacentPosition = step(m_currentPosition);
+    auto position = adjacentPosition;
+    for (uint32_t checked = 0; checked < itemCount; checked++)
+    {
+        if (AcceptByCost(position))
+        {
+            return position;
+        }
+        position = step(position);
+    }
+
+    return adjacentPosition;
+}
+
+
+auto Playlist::IsWithinBudget(uint32_t position) const -> bool
+{
+    if (m_costMode == CostMode::Ignore || m_frameBudget <= 0.0)
+    {
+        return true;
+    }
+
+    const auto* stats = m_stats.Get(m_items[position].Filename());
+    return stats == nullptr ||
+           stats->frameCount < MinCostEstimateFrames ||
+           stats->averageFrameTime <= m_frameBudget;
+}
+
+
+auto Playlist::AcceptByCost(uint32_t position) -> bool
+{
+    if (IsWithinBudget(position))
+    {
+        return true;
+    }
+
+    if (m_costMode == CostMode::Skip)
+    {
+        return false;
+    }
+
+    const auto* stats = m_stats.Get(m_items[position].Filename());
+    std::uniform_real_distribution<double> acceptDistribution(0.0, 1.0);
+    return acceptDistribution(m_randomGenerator) < m_frameBudget / stats->averageFrameTime;
+}
+
+
+auto Playlist::SelectShuffleBagPosition() -> uint32_t
+{
+    PrepareShuffleBag();
+
+    // Look at a few upcoming items and move the first one within the budget to the front.
+    size_t selected = m_shuffleBagNext;
+    uint32_t attempts{0};
+    bool accepted{false};
+    for (size_t candidate = m_shuffleBagNext; candidate < m_shuffleBag.size() && attempts < MaxCostSelectionAttempts; candidate++)
+    {
+        auto position = ItemPosition(m_shuffleBag[candidate]);
+        if (position == InvalidPosition)
+        {
+            continue;
+        }
+
+        attempts++;
+        if (AcceptByCost(position))
+        {
+            selected = candidate;
+            accepted = true;
+            break;
+        }
+    }
+
+    if (!accepted)
+    {
+        // Nothing accepted yet: take the next item within the budget from the rest of the cycle, if any.
+        for (size_t candidate = m_shuffleBagNext; candidate < m_shuffleBag.size(); candidate++)
+        {
+            auto position = ItemPosition(m_shuffleBag[candidate]);
+            if (position != InvalidPosition && IsWithinBudget(position))
+            {
+                selected = candidate;
+                break;
+            }
+        }
+    }
+
+    std::swap(m_shuffleBag[m_shuffleBagNext], m_shuffleBag[selected]);
+
+    return ItemPosition(m_shuffleBag[m_shuffleBagNext++]);
+}
+
+
+auto Playlist::StepBackShuffleBag() -> uint32_t
+{
+    // The current item is the last one taken from the bag, unless it was selected by other means.
+    auto end = m_shuffleBagNext;
+    if (end > 0 && m_currentPosition < m_items.size() &&
+        m_shuffleBag[end - 1] == m_items[m_currentPosition].Id())
+    {
+        end--;
+    }
+
+    for (auto candidate = end; candidate > 0; candidate--)
+    {
+        auto position = ItemPosition(m_shuffleBag[candidate - 1]);
+        if (position != InvalidPosition)
+        {
+            // Items stepped back over are played again by the following NextPresetIndex() calls.
+            m_shuffleBagNext = candidate;
+            return position;
+        }
+    }
+
+    // Already at the start of the cycle, nothing to step back to.
+    return SelectShuffleBagPosition();
+}
+
+
+void Playlist::PrepareShuffleBag()
+{
+    while (m_shuffleBagNext < m_shuffleBag.size() &&
+           ItemPosition(m_shuffleBag[m_shuffleBagNext]) == InvalidPosition)
+    {
+        m_shuffleBagNext++;
+    }
+
+    if (m_shuffleBagNext < m_shuffleBag.size())
+    {
+        return;
+    }
+
+    m_shuffleBag.clear();
+    m_shuffleBag.reserve(m_items.size());
+    for (const auto& item : m_items)
+    {
+        m_shuffleBag.push_back(item.Id());
+    }
+
+    std::shuffle(m_shuffleBag.begin(), m_shuffleBag.end(), m_randomGenerator);
+    m_shuffleBagNext = 0;
+
+    // Don't repeat the current item across the cycle boundary.
+    if (m_shuffleBag.size() > 1 && m_currentPosition < m_items.size() &&
+        m_shuffleBag.front() == m_items[m_currentPosition].Id())
+    {
+        std::swap(m_shuffleBag.front(), m_shuffleBag.back());
+    }
+}
+
+
+auto Playlist::ItemPosition(uint64_t itemId) const -> uint32_t
+{
+    auto position = m_itemPositions.find(itemId);
+    if (position == m_itemPositions.end())
+    {
+        return InvalidPosition;
+    }
+
+    if (position->second < m_validItemPositions)
+    {
+        return position->second;
+    }
+
+    // Update the outdated tail of the map in one go.
+    for (size_t index = m_validItemPositions; index < m_items.size(); index++)
+    {
+        m_itemPositions[m_items[index].Id()] = static_cast<uint32_t>(index);
+    }
+    m_validItemPositions = m_items.size();
+
+    return m_itemPositions.at(itemId);
+}
+
+
+void Playlist::InvalidateItemPositions(size_t firstChangedIndex)
+{
+    m_validItemPositions = std::min(m_validItemPositions, firstChangedIndex);
+}
+
+
+void Playlist::PruneHistory()
+{
+    while (!m_presetHistory.Empty() && ItemPosition(m_presetHistory.Back()) == InvalidPosition)
     {
-        m_presetHistory.pop_front();
+        m_presetHistory.Pop();
     }
 }
 
@@ -1,13 +1,16 @@
 #pragma once
 
 #include "Filter.hpp"
+#include "History.hpp"
 #include "Item.hpp"
+#include "PresetStats.hpp"
 
 #include <cstdint>
 #include <limits>
-#include <list>
 #include <random>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace libprojectM {
@@ -32,6 +35,10 @@ public:
  *
  * This class contains a list of the presets (called playlist "Items" here) and additional settings
  * required for playback control.
+ *
+ * Each item is assigned a playlist-unique ID when added. The playback history stores these IDs,
+ * so it stays valid when items are added, removed or reordered. Positions of history items are
+ * resolved through an ID-to-position map which is only updated lazily after the item list changed.
  */
 class Playlist
 {
@@ -46,6 +53,24 @@ public:
      */
     static constexpr size_t MaxHistoryItems = 1000;
 
+    /**
+     * Minimum number of items each worker thread evaluates in ApplyFilter(). Smaller playlists
+     * are filtered on the calling thread only.
+     */
+    static constexpr size_t MinItemsPerFilterThread = 10000;
+
+    /**
+     * Minimum number of recorded frames before a preset's measured cost is used for scheduling.
+     */
+    static constexpr uint64_t MinCostEstimateFrames = 30;
+
+    /**
+     * Maximum number of random draws when looking for a preset within the frame budget in
+     * shuffle mode. If no draw is accepted, the playlist is scanned for a preset within the
+     * budget, and the last draw is only used if there is none.
+     */
+    static constexpr uint32_t MaxCostSelectionAttempts = 16;
+
     /**
      * Sort predicate.
      */
@@ -64,6 +89,25 @@ public:
         Descending //!< Sort in descending order.
     };
 
+    /**
+     * Scheduling behavior for presets exceeding the frame budget.
+     */
+    enum class CostMode
+    {
+        Ignore,    //!< Ignore measured preset costs.
+        Skip,      //!< Skip presets exceeding the frame budget.
+        DownWeight //!< Select presets exceeding the frame budget with a probability of budget / cost.
+    };
+
+    /**
+     * Preset selection behavior if shuffle is enabled.
+     */
+    enum class ShuffleMode
+    {
+        Random, //!< Select a uniformly random item on each switch. Items may repeat at any time.
+        Bag     //!< Play all items once in a random order, then start over with a new order.
+    };
+
     /**
      * Constructor.
      */
@@ -99,12 +143,36 @@ public:
      */
     virtual auto Items() const -> const std::vector<Item>&;
 
+    /**
+     * @brief Returns the current item list generation.
+     *
+     * The generation is incremented by every call which adds, removes or reorders items. References
+     * or pointers into the item list, including item filename strings, stay valid as long as the
+     * generation doesn't change.
+     *
+     * @return The current item list generation.
+     */
+    virtual auto ItemsGeneration() const -> uint64_t;
+
+    /**
+     * @brief Searches the playlist for items matching a glob pattern.
+     *
+     * The pattern uses the same syntax as the filter list, see projectm_playlist_set_filter().
+     * A leading + or - is ignored.
+     *
+     * @param pattern The glob pattern to match.
+     * @param startIndex The playlist index to start searching at.
+     * @param maxResults The maximum number of indices to return.
+     * @return The playlist indices of matching items, in ascending order.
+     */
+    virtual auto Find(const std::string& pattern, uint32_t startIndex, uint32_t maxResults) const -> std::vector<uint32_t>;
+
     /**
      * @brief Adds a preset file to the playlist.
      *
      * Use Playlist::InsertAtEnd as index to always insert an item at the end of the playlist.
      *
-     * The playback history will be kept, and indices are updated accordingly.
+     * The playback history will be kept.
      *
      * @param filename The file path and name to add.
      * @param index The index to insert the preset at. If larger than the playlist size, it's added
@@ -121,7 +189,7 @@ public:
      * The function will scan the given path (and possible subdirs) for files with a .milk extension
      * and add them to the playlist, starting at the given index.
      *
-     * The playback history will be kept, and indices are updated accordingly.
+     * The playback history will be kept.
      *
      * The order of the added files is unspecified. Use the Sort() method to sort the playlist or
      * the newly added range.
@@ -140,7 +208,7 @@ public:
 
     /**
      * @brief Removes a playlist item at the given playlist index.
-     * The playback history will be kept, and indices are updated accordingly.
+     * The playback history will be kept, except for entries referring to the removed item.
      * @param index The index to remove.
      * @return True if an item was removed, false if the index was out of bounds and no item was
      *         removed..
@@ -159,12 +227,27 @@ public:
      */
     virtual auto Shuffle() const -> bool;
 
+    /**
+     * @brief Sets how items are selected if shuffle is enabled.
+     *
+     * Changing the mode starts a new shuffle cycle.
+     *
+     * @param mode The new shuffle mode.
+     */
+    virtual void SetShuffleMode(ShuffleMode mode);
+
+    /**
+     * @brief Returns how items are selected if shuffle is enabled.
+     * @return The current shuffle mode.
+     */
+    virtual auto GetShuffleMode() const -> ShuffleMode;
+
     /**
      * @brief Sorts the whole or a part of the playlist according to the options.
      *
      * Sorting is case-sensitive.
      *
-     * The playback history is cleared when calling this function.
+     * The playback history is kept and will refer to the same items after sorting.
      *
      * @param startIndex The index to start sorting at. If the index is larger than the last
      *                   item index, the playlist will remain unchanged.
@@ -175,11 +258,43 @@ public:
      */
     virtual void Sort(uint32_t startIndex, uint32_t count, SortPredicate predicate, SortOrder order);
 
+    /**
+     * @brief Sets the frame budget used by the cost mode.
+     * @param seconds The maximum average frame time a preset should need. 0 or less disables the budget.
+     */
+    virtual void SetFrameBudget(double seconds);
+
+    /**
+     * @brief Returns the current frame budget.
+     * @return The frame budget in seconds, 0 if disabled.
+     */
+    virtual auto FrameBudget() const -> double;
+
+    /**
+     * @brief Sets how presets exceeding the frame budget are scheduled.
+     * @param mode The new cost mode.
+     */
+    virtual void SetCostMode(CostMode mode);
+
+    /**
+     * @brief Returns how presets exceeding the frame budget are scheduled.
+     * @return The current cost mode.
+     */
+    virtual auto GetCostMode() const -> CostMode;
+
+    /**
+     * @brief Returns the render cost statistics used for scheduling.
+     * @return The preset statistics store.
+     */
+    virtual auto Stats() -> PresetStats&;
+
     /**
      * @brief Returns the next preset index that should be played.
      *
      * Each call will either increment the current index, or select a random preset, depending on
-     * the shuffle setting.
+     * the shuffle setting. In the bag shuffle mode, each item is returned once per cycle. If a
+     * frame budget and cost mode are set, presets measured to exceed the budget are skipped or
+     * selected less often.
      *
      * @throws PlaylistEmptyException Thrown if the playlist is currently empty.
      * @return The index of the next playlist item to be played.
@@ -190,13 +305,28 @@ public:
      * @brief Returns the previous preset index in the playlist.
      *
      * Each call will either decrement the current index, or select a random preset, depending on
-     * the shuffle setting.
+     * the shuffle setting. The frame budget is applied the same way as in NextPresetIndex().
+     *
+     * In the bag shuffle mode, this steps back through the items already played in the current
+     * cycle, without applying the frame budget again. Subsequent calls to NextPresetIndex() then
+     * replay the items stepped over. At the start of a cycle, the next bag item is returned.
      *
      * @throws PlaylistEmptyException Thrown if the playlist is currently empty.
      * @return The index of the previous playlist item.
      */
     virtual auto PreviousPresetIndex() -> uint32_t;
 
+    /**
+     * @brief Predicts the index NextPresetIndex() will return, without changing the position.
+     *
+     * The prediction is exact for sequential playback and the bag shuffle mode, unless the cost
+     * mode skips the predicted item. In random shuffle mode, the next item can't be predicted.
+     *
+     * @param index [out] Receives the predicted index.
+     * @return True if a prediction was made, false if the playlist is empty or in random shuffle mode.
+     */
+    virtual auto PeekNextPresetIndex(uint32_t& index) -> bool;
+
     /**
      * @brief Returns the last preset index that has been played.
      *
@@ -249,22 +379,137 @@ public:
      * @brief Applies the current filter list to the existing playlist.
      *
      * Note this function only removes items. Previously filtered items are not added again.
+     * The order of the remaining items is preserved. Large playlists are evaluated on multiple
+     * threads. History entries of removed items are dropped, all others are kept.
      *
      * @return The number of filtered (removed) items.
      */
     virtual auto ApplyFilter() -> uint32_t;
 
+    /**
+     * @brief Removes all items with one of the given filenames.
+     *
+     * The order of the remaining items is preserved. History entries of removed items are
+     * dropped, all others are kept.
+     *
+     * @param filenames The filenames of the items to remove.
+     * @return The number of removed items.
+     */
+    virtual auto RemoveItems(const std::unordered_set<std::string>& filenames) -> uint32_t;
+
+    /**
+     * @brief Saves the playlist items, filter list, shuffle state, position and history to a file.
+     * @param filename The snapshot file to write.
+     * @return True if the snapshot was written, false if an error occurred.
+     */
+    virtual auto SaveSnapshot(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Replaces the playlist contents with those of a previously saved snapshot.
+     *
+     * Preset files are neither filtered nor checked for existence. If the snapshot can't be
+     * loaded, the playlist remains unchanged.
+     *
+     * @param filename The snapshot file to read.
+     * @return True if the snapshot was loaded, false if the file is missing, unsupported or corrupted.
+     */
+    virtual auto LoadSnapshot(const std::string& filename) -> bool;
+
 private:
+    /**
+     * Position value returned by ItemPosition() if an item ID isn't part of the playlist.
+     */
+    static constexpr auto InvalidPosition = std::numeric_limits<uint32_t>::max();
+
     /**
      * @brief Adds a preset to the history and trims the list if it gets too long.
      */
     void AddCurrentPresetIndexToHistory();
 
-    std::vector<Item> m_items;         //!< All items in the current playlist.
-    class Filter m_filter;             //!< Item filter.
-    bool m_shuffle{false};             //!< True if shuffle mode is enabled, false to play presets in order.
-    uint32_t m_currentPosition{0};       //!< Current playlist position.
-    std::list<uint32_t> m_presetHistory; //!< The playback history.
+    /**
+     * @brief Selects the next or previous preset position, honoring the shuffle and cost settings.
+     * @param forward True to move forward in sequential mode, false to move backward.
+     * @return The selected playlist position.
+     */
+    auto SelectPosition(bool forward) -> uint32_t;
+
+    /**
+     * @brief Checks whether the item at the given position is known to fit into the frame budget.
+     * Items without enough recorded frames and all items without a budget or cost mode fit.
+     * @param position The playlist position to check.
+     * @return True if the item fits into the budget, false if it was measured to exceed it.
+     */
+    auto IsWithinBudget(uint32_t position) const -> bool;
+
+    /**
+     * @brief Decides whether the item at the given position may be played with the current frame budget.
+     * @param position The playlist position to check.
+     * @return True if the item should be played, false if it should be skipped.
+     */
+    auto AcceptByCost(uint32_t position) -> bool;
+
+    /**
+     * @brief Takes the next item from the shuffle bag, preferring items within the frame budget.
+     *
+     * Items skipped due to the budget stay in the bag for the current cycle.
+     *
+     * @return The selected playlist position.
+     */
+    auto SelectShuffleBagPosition() -> uint32_t;
+
+    /**
+     * @brief Moves the shuffle bag cursor back to the item played before the current one.
+     * @return The playlist position of the previous bag item.
+     */
+    auto StepBackShuffleBag() -> uint32_t;
+
+    /**
+     * @brief Skips removed items in the shuffle bag and starts a new cycle if the bag is empty.
+     */
+    void PrepareShuffleBag();
+
+    /**
+     * @brief Returns the current playlist position of the item with the given ID.
+     * @param itemId The item ID to look up.
+     * @return The item's playlist index or InvalidPosition if the item was removed.
+     */
+    auto ItemPosition(uint64_t itemId) const -> uint32_t;
+
+    /**
+     * @brief Marks the positions of all items starting at the given index as outdated.
+     * @param firstChangedIndex The first playlist index which was changed.
+     */
+    void InvalidateItemPositions(size_t firstChangedIndex);
+
+    /**
+     * @brief Removes newest history entries which refer to items no longer in the playlist.
+     */
+    void PruneHistory();
+
+    /**
+     * @brief Removes all items not marked to be kept in a single pass.
+     * @param keepItems One flag per item, 0 if the item at this index should be removed.
+     * @return The number of removed items.
+     */
+    auto RemoveMarkedItems(const std::vector<char>& keepItems) -> uint32_t;
+
+    std::vector<Item> m_items;                //!< All items in the current playlist.
+    class Filter m_filter;                    //!< Item filter.
+    bool m_shuffle{false};                    //!< True if shuffle mode is enabled, false to play presets in order.
+    uint32_t m_currentPosition{0};            //!< Current playlist position.
+    History m_presetHistory{MaxHistoryItems}; //!< The playback history, stores item IDs.
+    uint64_t m_nextItemId{1};                 //!< ID assigned to the next item added to the playlist.
+    uint64_t m_itemsGeneration{0};            //!< Incremented on every change to the item list.
+    PresetStats m_stats;                      //!< Measured render costs per preset.
+    double m_frameBudget{0.0};                //!< Frame budget in seconds, 0 if disabled.
+    CostMode m_costMode{CostMode::Ignore};    //!< How presets exceeding the frame budget are handled.
+
+    ShuffleMode m_shuffleMode{ShuffleMode::Random}; //!< How items are selected in shuffle mode.
+    std::vector<uint64_t> m_shuffleBag;             //!< Item IDs of the current shuffle cycle in play order. May contain removed items.
+    size_t m_shuffleBagNext{0};                     //!< Index of the next item to play in m_shuffleBag.
+
+    mutable std::unordered_map<uint64_t, uint32_t> m_itemPositions; //!< Item ID to playlist index map.
+    mutable size_t m_validItemPositions{0};                         //!< Number of leading items whose entries in m_itemPositions are up to date.
 
     std::default_random_engine m_randomGenerator;
 };
@@ -2,12 +2,64 @@
 
 #include "projectM-4/callbacks.h"
 #include "projectM-4/core.h"
+#include "projectM-4/instrumentation.h"
+#include "projectM-4/memory.h"
+
+#include <algorithm>
+#include <sstream>
 
 namespace libprojectM {
 namespace Playlist {
 
 PlaylistCWrapper::PlaylistCWrapper(projectm_handle projectMInstance)
     : m_projectMInstance(projectMInstance)
+    , m_presetValidator(std::make_unique<PresetValidator>([this](const std::string& filename, std::string& errorMessage) {
+        char* error{nullptr};
+        bool valid = projectm_validate_preset_file(m_projectMInstance, filename.c_str(), &error);
+        if (error != nullptr)
+        {
+            errorMessage = error;
+            projectm_free_string(error);
+        }
+        return valid;
+    }))
+    , m_presetIndex(std::make_unique<PresetMetadataIndex>([this](const std::string& filename, PresetMetadataIndex::Entry& entry) {
+        if (m_projectMInstance == nullptr)
+        {
+            return false;
+        }
+
+        projectm_preset_metadata metadata{};
+        if (!projectm_get_preset_metadata(m_projectMInstance, filename.c_str(), &metadata, nullptr))
+        {
+            return false;
+        }
+
+        entry.hasWarpShader = metadata.has_warp_shader;
+        entry.hasCompositeShader = metadata.has_composite_shader;
+        entry.hasPerPixelCode = metadata.has_per_pixel_code;
+        entry.customWaveCount = metadata.custom_wave_count;
+        entry.customShapeCount = metadata.custom_shape_count;
+        entry.maxWaveSamples = metadata.max_wave_samples;
+        entry.maxShapeInstances = metadata.max_shape_instances;
+        entry.blurLevel = metadata.blur_level;
+        entry.parseTime = metadata.parse_time;
+        entry.shaderTranslationTime = metadata.shader_translation_time;
+
+        entry.textures.clear();
+        if (metadata.textures != nullptr)
+        {
+            std::istringstream textureStream(metadata.textures);
+            std::string texture;
+            while (textureStream >> texture)
+            {
+                entry.textures.push_back(texture);
+            }
+            projectm_free_string(metadata.textures);
+        }
+
+        return true;
+    }))
 {
     if (m_projectMInstance != nullptr)
     {
@@ -19,6 +71,9 @@ PlaylistCWrapper::PlaylistCWrapper(projectm_handle projectMInstance)
 
 void PlaylistCWrapper::Connect(projectm_handle projectMInstance)
 {
+    // The validator uses the current projectM instance.
+    m_presetValidator->Stop();
+
     if (m_projectMInstance != nullptr)
     {
         projectm_set_preset_switch_requested_event_callback(m_projectMInstance, nullptr, nullptr);
@@ -26,6 +81,7 @@ void PlaylistCWrapper::Connect(projectm_handle projectMInstance)
     }
 
     m_projectMInstance = projectMInstance;
+    m_playingPresetFilename.clear();
 
     if (m_projectMInstance != nullptr)
     {
@@ -44,6 +100,8 @@ void PlaylistCWrapper::OnPresetSwitchRequested(bool isHardCut, void* userData)
 
     auto* playlist = reinterpret_cast<PlaylistCWrapper*>(userData);
 
+    playlist->ApplyValidationResults();
+
     try
     {
         playlist->PlayPresetIndex(playlist->NextPresetIndex(), isHardCut, true);
@@ -114,6 +172,8 @@ void PlaylistCWrapper::PlayPresetIndex(uint32_t index, bool hardCut, bool resetF
 {
     m_hardCutRequested = hardCut;
 
+    RecordPlayingPresetCost();
+
     auto& playlistItems = Items();
 
     uint32_t failedCount = 0;
@@ -131,6 +191,8 @@ void PlaylistCWrapper::PlayPresetIndex(uint32_t index, bool hardCut, bool resetF
         {
             if (m_presetLoadEventCallback(index, filename.c_str(), hardCut, m_presetLoadEventUserData))
             {
+                m_playingPresetFilename = filename;
+
                 // Application handled the load - return without further action.
                 // The app is responsible for calling projectm_load_preset_file/data,
                 // handling errors, and firing the switched event when ready.
@@ -143,6 +205,7 @@ void PlaylistCWrapper::PlayPresetIndex(uint32_t index, bool hardCut, bool resetF
 
         if (!m_lastPresetSwitchFailed)
         {
+            m_playingPresetFilename = filename;
             break;
         }
 
@@ -203,6 +266,91 @@ auto PlaylistCWrapper::GetLastNavigationDirection() const -> NavigationDirection
     return m_lastNavigationDirection;
 }
 
+
+auto PlaylistCWrapper::StartValidation() -> bool
+{
+    if (m_projectMInstance == nullptr)
+    {
+        return false;
+    }
+
+    const auto& items = Items();
+
+    std::vector<std::string> filenames;
+    filenames.reserve(items.size());
+    for (const auto& item : items)
+    {
+        filenames.push_back(item.Filename());
+    }
+
+    return m_presetValidator->Start(std::move(filenames));
+}
+
+
+auto PlaylistCWrapper::Validator() -> PresetValidator&
+{
+    return *m_presetValidator;
+}
+
+
+auto PlaylistCWrapper::ApplyValidationResults() -> uint32_t
+{
+    auto invalidFilenames = m_presetValidator->TakeInvalidFilenames();
+    if (invalidFilenames.empty())
+    {
+        return 0;
+    }
+
+    return RemoveItems({invalidFilenames.begin(), invalidFilenames.end()});
+}
+
+
+auto PlaylistCWrapper::MetadataIndex() -> PresetMetadataIndex&
+{
+    return *m_presetIndex;
+}
+
+
+auto PlaylistCWrapper::AddIndexedItems(const std::vector<std::string>& conditions, uint32_t index, bool allowDuplicates) -> uint32_t
+{
+    std::vector<std::string> filenames;
+    if (!m_presetIndex->Find(conditions, filenames))
+    {
+        return 0;
+    }
+
+    uint32_t presetsAdded{0};
+    for (const auto& filename : filenames)
+    {
+        uint32_t currentIndex{InsertAtEnd};
+        if (index < InsertAtEnd)
+        {
+            currentIndex = index + presetsAdded;
+        }
+        if (AddItem(filename, currentIndex, allowDuplicates))
+        {
+            presetsAdded++;
+        }
+    }
+
+    return presetsAdded;
+}
+
+
+void PlaylistCWrapper::RecordPlayingPresetCost()
+{
+    if (m_projectMInstance == nullptr || m_playingPresetFilename.empty())
+    {
+        return;
+    }
+
+    Stats().Record(m_playingPresetFilename,
+                   projectm_get_preset_frame_count(m_projectMInstance),
+                   projectm_get_preset_average_frame_time(m_projectMInstance));
+
+    m_playingPresetFilename.clear();
+}
+
 } // namespace Playlist
 } // namespace libprojectM
 
@@ -343,6 +491,58 @@ char* projectm_playlist_item(projectm_playlist_handle instance, uint32_t index)
 }
 
 
+auto projectm_playlist_items_generation(projectm_playlist_handle instance) -> uint64_t
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->ItemsGeneration();
+}
+
+
+auto projectm_playlist_items_view(projectm_playlist_handle instance, uint32_t start, uint32_t count,
+                                  const char** filenames, uint64_t* generation) -> uint32_t
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    if (generation != nullptr)
+    {
+        *generation = playlist->ItemsGeneration();
+    }
+
+    const auto& items = playlist->Items();
+
+    if (filenames == nullptr || start >= items.size())
+    {
+        return 0;
+    }
+
+    size_t endPos = std::min(static_cast<size_t>(start) + count, items.size());
+
+    for (size_t index{start}; index < endPos; index++)
+    {
+        filenames[index - start] = items[index].Filename().c_str();
+    }
+
+    return static_cast<uint32_t>(endPos - start);
+}
+
+
+auto projectm_playlist_find(projectm_playlist_handle instance, const char* pattern,
+                            uint32_t start, uint32_t max_results, uint32_t* indices) -> uint32_t
+{
+    if (pattern == nullptr || indices == nullptr)
+    {
+        return 0;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    auto matches = playlist->Find(pattern, start, max_results);
+    std::copy(matches.begin(), matches.end(), indices);
+
+    return static_cast<uint32_t>(matches.size());
+}
+
+
 auto projectm_playlist_add_path(projectm_playlist_handle instance, const char* path,
                                 bool recurse_subdirs, bool allow_duplicates) -> uint32_t
 {
@@ -481,6 +681,55 @@ void projectm_playlist_set_shuffle(projectm_playlist_handle instance, bool shuff
 }
 
 
+void projectm_playlist_set_shuffle_mode(projectm_playlist_handle instance, projectm_playlist_shuffle_mode mode)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    switch (mode)
+    {
+        case SHUFFLE_MODE_BAG:
+            playlist->SetShuffleMode(libprojectM::Playlist::Playlist::ShuffleMode::Bag);
+            break;
+        default:
+            playlist->SetShuffleMode(libprojectM::Playlist::Playlist::ShuffleMode::Random);
+            break;
+    }
+}
+
+
+auto projectm_playlist_get_shuffle_mode(projectm_playlist_handle instance) -> projectm_playlist_shuffle_mode
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    switch (playlist->GetShuffleMode())
+    {
+        case libprojectM::Playlist::Playlist::ShuffleMode::Bag:
+            return SHUFFLE_MODE_BAG;
+        default:
+            return SHUFFLE_MODE_RANDOM;
+    }
+}
+
+
+auto projectm_playlist_peek_next_position(projectm_playlist_handle instance, uint32_t* position) -> bool
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    uint32_t index{};
+    if (!playlist->PeekNextPresetIndex(index))
+    {
+        return false;
+    }
+
+    if (position != nullptr)
+    {
+        *position = index;
+    }
+
+    return true;
+}
+
+
 void projectm_playlist_sort(projectm_playlist_handle instance, uint32_t start_index, uint32_t count,
                             projectm_playlist_sort_predicate predicate, projectm_playlist_sort_order order)
 {
@@ -552,6 +801,7 @@ auto projectm_playlist_set_position(projectm_playlist_handle instance, uint32_t
 uint32_t projectm_playlist_play_next(projectm_playlist_handle instance, bool hard_cut)
 {
     auto* playlist = playlist_handle_to_instance(instance);
+    playlist->ApplyValidationResults();
     playlist->SetLastNavigationDirection(libprojectM::Playlist::PlaylistCWrapper::NavigationDirection::Next);
     try
     {
@@ -569,6 +819,7 @@ uint32_t projectm_playlist_play_next(projectm_playlist_handle instance, bool har
 uint32_t projectm_playlist_play_previous(projectm_playlist_handle instance, bool hard_cut)
 {
     auto* playlist = playlist_handle_to_instance(instance);
+    playlist->ApplyValidationResults();
     playlist->SetLastNavigationDirection(libprojectM::Playlist::PlaylistCWrapper::NavigationDirection::Previous);
     try
     {
@@ -586,6 +837,7 @@ uint32_t projectm_playlist_play_previous(projectm_playlist_handle instance, bool
 uint32_t projectm_playlist_play_last(projectm_playlist_handle instance, bool hard_cut)
 {
     auto* playlist = playlist_handle_to_instance(instance);
+    playlist->ApplyValidationResults();
 
     playlist->SetLastNavigationDirection(libprojectM::Playlist::PlaylistCWrapper::NavigationDirection::Last);
     try
@@ -645,4 +897,285 @@ auto projectm_playlist_apply_filter(projectm_playlist_handle instance) -> size_t
 {
     auto* playlist = playlist_handle_to_instance(instance);
     return playlist->ApplyFilter();
-}
\ No newline at end of file
+}
+
+auto projectm_playlist_save(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->SaveSnapshot(filename);
+}
+
+
+auto projectm_playlist_load(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->LoadSnapshot(filename);
+}
+
+
+void projectm_playlist_set_frame_budget(projectm_playlist_handle instance, double seconds)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    playlist->SetFrameBudget(seconds);
+}
+
+
+auto projectm_playlist_get_frame_budget(projectm_playlist_handle instance) -> double
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->FrameBudget();
+}
+
+
+void projectm_playlist_set_cost_mode(projectm_playlist_handle instance, projectm_playlist_cost_mode mode)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    switch (mode)
+    {
+        case COST_MODE_SKIP:
+            playlist->SetCostMode(libprojectM::Playlist::Playlist::CostMode::Skip);
+            break;
+        case COST_MODE_DOWN_WEIGHT:
+            playlist->SetCostMode(libprojectM::Playlist::Playlist::CostMode::DownWeight);
+            break;
+        default:
+            playlist->SetCostMode(libprojectM::Playlist::Playlist::CostMode::Ignore);
+            break;
+    }
+}
+
+
+auto projectm_playlist_get_cost_mode(projectm_playlist_handle instance) -> projectm_playlist_cost_mode
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    switch (playlist->GetCostMode())
+    {
+        case libprojectM::Playlist::Playlist::CostMode::Skip:
+            return COST_MODE_SKIP;
+        case libprojectM::Playlist::Playlist::CostMode::DownWeight:
+            return COST_MODE_DOWN_WEIGHT;
+        default:
+            return COST_MODE_IGNORE;
+    }
+}
+
+
+auto projectm_playlist_get_preset_stats(projectm_playlist_handle instance, uint32_t index,
+                                        uint32_t* play_count, uint64_t* frame_count,
+                                        double* average_frame_time) -> bool
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    const auto& items = playlist->Items();
+    if (index >= items.size())
+    {
+        return false;
+    }
+
+    const auto* stats = playlist->Stats().Get(items[index].Filename());
+    if (stats == nullptr)
+    {
+        return false;
+    }
+
+    if (play_count != nullptr)
+    {
+        *play_count = stats->playCount;
+    }
+    if (frame_count != nullptr)
+    {
+        *frame_count = stats->frameCount;
+    }
+    if (average_frame_time != nullptr)
+    {
+        *average_frame_time = stats->averageFrameTime;
+    }
+
+    return true;
+}
+
+
+void projectm_playlist_clear_stats(projectm_playlist_handle instance)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    playlist->Stats().Clear();
+}
+
+
+auto projectm_playlist_save_stats(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->Stats().Save(filename);
+}
+
+
+auto projectm_playlist_load_stats(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->Stats().Load(filename);
+}
+
+
+auto projectm_playlist_start_validation(projectm_playlist_handle instance) -> bool
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->StartValidation();
+}
+
+
+void projectm_playlist_stop_validation(projectm_playlist_handle instance)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    playlist->Validator().Stop();
+}
+
+
+auto projectm_playlist_get_validation_progress(projectm_playlist_handle instance, uint32_t* checked,
+                                               uint32_t* total) -> bool
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    auto& validator = playlist->Validator();
+
+    bool running = validator.Running();
+
+    if (checked != nullptr)
+    {
+        *checked = validator.Progress();
+    }
+    if (total != nullptr)
+    {
+        *total = validator.Total();
+    }
+
+    return running;
+}
+
+
+auto projectm_playlist_apply_validation_results(projectm_playlist_handle instance) -> uint32_t
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->ApplyValidationResults();
+}
+
+
+auto projectm_playlist_save_validation_cache(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->Validator().SaveCache(filename);
+}
+
+
+auto projectm_playlist_load_validation_cache(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->Validator().LoadCache(filename);
+}
+
+
+auto projectm_playlist_build_index(projectm_playlist_handle instance, const char* path, bool recurse_subdirs,
+                                   uint32_t thread_count) -> uint32_t
+{
+    if (path == nullptr)
+    {
+        return 0;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->MetadataIndex().Build(path, recurse_subdirs, thread_count);
+}
+
+
+auto projectm_playlist_get_index_size(projectm_playlist_handle instance) -> uint32_t
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    return static_cast<uint32_t>(playlist->MetadataIndex().Entries().size());
+}
+
+
+void projectm_playlist_clear_index(projectm_playlist_handle instance)
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+    playlist->MetadataIndex().Clear();
+}
+
+
+auto projectm_playlist_save_index(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->MetadataIndex().Save(filename);
+}
+
+
+auto projectm_playlist_load_index(projectm_playlist_handle instance, const char* filename) -> bool
+{
+    if (filename == nullptr)
+    {
+        return false;
+    }
+
+    auto* playlist = playlist_handle_to_instance(instance);
+    return playlist->MetadataIndex().Load(filename);
+}
+
+
+auto projectm_playlist_add_indexed_presets(projectm_playlist_handle instance, const char** conditions,
+                                           uint32_t count, bool allow_duplicates) -> uint32_t
+{
+    return projectm_playlist_insert_indexed_presets(instance, conditions, count,
+                                                    libprojectM::Playlist::Playlist::InsertAtEnd, allow_duplicates);
+}
+
+
+auto projectm_playlist_insert_indexed_presets(projectm_playlist_handle instance, const char** conditions,
+                                              uint32_t count, uint32_t index, bool allow_duplicates) -> uint32_t
+{
+    auto* playlist = playlist_handle_to_instance(instance);
+
+    std::vector<std::string> conditionList;
+    for (uint32_t conditionIndex = 0; conditions != nullptr && conditionIndex < count; conditionIndex++)
+    {
+        if (conditions[conditionIndex] != nullptr)
+        {
+            conditionList.emplace_back(conditions[conditionIndex]);
+        }
+    }
+
+    return playlist->AddIndexedItems(conditionList, index, allow_duplicates);
+}
@@ -3,8 +3,11 @@
 #include "projectM-4/playlist.h"
 
 #include "Playlist.hpp"
+#include "PresetMetadataIndex.hpp"
+#include "PresetValidator.hpp"
 
 #include <cstdint>
+#include <memory>
 
 namespace libprojectM {
 namespace Playlist {
@@ -103,7 +106,62 @@ public:
      */
     auto GetLastNavigationDirection() const -> NavigationDirection;
 
+    /**
+     * @brief Starts checking all current playlist items on a background thread.
+     *
+     * Uses projectm_validate_preset_file() on the connected projectM instance. Items found to be
+     * invalid are removed from the playlist by ApplyValidationResults().
+     *
+     * @return True if the validation was started, false if no projectM instance is connected or
+     *         the worker thread couldn't be started.
+     */
+    virtual auto StartValidation() -> bool;
+
+    /**
+     * @brief Returns the background preset validator.
+     * @return A reference to the preset validator of this playlist.
+     */
+    virtual auto Validator() -> PresetValidator&;
+
+    /**
+     * @brief Removes all items found to be invalid by the background validation from the playlist.
+     *
+     * Must be called from the thread owning the playlist. Automatically called before each
+     * preset switch.
+     *
+     * @return The number of removed items.
+     */
+    auto ApplyValidationResults() -> uint32_t;
+
+    /**
+     * @brief Returns the preset metadata index.
+     *
+     * The index reads preset metadata with projectm_get_preset_metadata() on the connected
+     * projectM instance. If no instance is connected, only file information is indexed.
+     *
+     * @return A reference to the preset index of this playlist.
+     */
+    virtual auto MetadataIndex() -> PresetMetadataIndex&;
+
+    /**
+     * @brief Adds all indexed presets matching the given conditions to the playlist.
+     *
+     * Doesn't access the preset files. Presets are added in filename order.
+     *
+     * @param conditions The conditions, as described in PresetMetadataIndex.
+     * @param index The index to insert the presets at. If larger than the playlist size, they're
+     *              added to the end of the playlist.
+     * @param allowDuplicates If true, duplicate files are allowed.
+     * @return The number of presets added. 0 if any condition is invalid.
+     */
+    virtual auto AddIndexedItems(const std::vector<std::string>& conditions, uint32_t index, bool allowDuplicates) -> uint32_t;
+
 private:
+    /**
+     * @brief Stores the render cost of the currently playing preset in the preset statistics.
+     */
+    void RecordPlayingPresetCost();
+
     projectm_handle m_projectMInstance{nullptr}; //!< The projectM instance handle this instance is connected to.
 
     uint32_t m_presetSwitchRetryCount{500}; //!< Number of switch retries before sending the failure event to the application.
@@ -113,6 +171,8 @@ private:
 
     bool m_hardCutRequested{false}; //!< Stores the type of the last requested switch attempt.
 
+    std::string m_playingPresetFilename; //!< Filename of the preset currently playing, used to record its render cost.
+
     projectm_playlist_preset_switched_event m_presetSwitchedEventCallback{nullptr}; //!< Preset switched callback pointer set by the application.
     void* m_presetSwitchedEventUserData{nullptr};                                   //!< Context data pointer set by the application.
 
@@ -123,6 +183,9 @@ private:
     void* m_presetLoadEventUserData{nullptr};                               //!< Context data pointer set by the application.
 
     NavigationDirection m_lastNavigationDirection{NavigationDirection::Next}; //!< Last direction used to switch a preset.
+
+    std::unique_ptr<PresetValidator> m_presetValidator; //!< Background validator for the playlist items.
+    std::unique_ptr<PresetMetadataIndex> m_presetIndex; //!< Preset metadata index.
 };
 
 } // namespace Playlist
@@ -0,0 +1,246 @@
+#include "PlaylistSnapshot.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace libprojectM {
+namespace Playlist {
+
+namespace {
+
+constexpr char SnapshotMagic[4] = {'P', 'M', 'P', 'L'};
+constexpr uint32_t ShuffleFlag = 1;
+
+auto Checksum(const std::vector<char>& data, size_t length) -> uint32_t
+{
+    uint32_t hash{2166136261U};
+    for (size_t index = 0; index < length; index++)
+    {
+        hash ^= static_cast<uint8_t>(data[index]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+auto DecodeUInt32(const char* data) -> uint32_t
+{
+    uint32_t value{};
+    for (int byte = 0; byte < 4; byte++)
+    {
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(data[byte])) << (byte * 8);
+    }
+    return value;
+}
+
+void WriteUInt32(std::vector<char>& data, uint32_t value)
+{
+    for (int byte = 0; byte < 4; byte++)
+    {
+        data.push_back(static_cast<char>((value >> (byte * 8)) & 0xFF));
+    }
+}
+
+void WriteString(std::vector<char>& data, const std::string& value)
+{
+    WriteUInt32(data, static_cast<uint32_t>(value.size()));
+    data.insert(data.end(), value.begin(), value.end());
+}
+
+/**
+ * Bounds-checked sequential reader over the snapshot data.
+ */
+class SnapshotReader
+{
+public:
+    SnapshotReader(const std::vector<char>& data, size_t length)
+        : m_data(data)
+        , m_length(length)
+    {
+    }
+
+    auto ReadUInt32(uint32_t& value) -> bool
+    {
+        if (m_length - m_offset < 4)
+        {
+            return false;
+        }
+
+        value = DecodeUInt32(m_data.data() + m_offset);
+        m_offset += 4;
+        return true;
+    }
+
+    auto ReadString(std::string& value) -> bool
+    {
+        uint32_t stringLength{};
+        if (!ReadUInt32(stringLength) || m_length - m_offset < stringLength)
+        {
+            return false;
+        }
+
+        value.assign(m_data.data() + m_offset, stringLength);
+        m_offset += stringLength;
+        return true;
+    }
+
+    void Skip(size_t byteCount)
+    {
+        m_offset += byteCount;
+    }
+
+    auto AtEnd() const -> bool
+    {
+        return m_offset == m_length;
+    }
+
+private:
+    const std::vector<char>& m_data;
+    size_t m_length{};
+    size_t m_offset{};
+};
+
+} // namespace
+
+auto PlaylistSnapshot::Save(const std::string& filename) const -> bool
+{
+    std::vector<char> data;
+    data.insert(data.end(), std::begin(SnapshotMagic), std::end(SnapshotMagic));
+    WriteUInt32(data, FormatVersion);
+    WriteUInt32(data, shuffle ? ShuffleFlag : 0);
+    WriteUInt32(data, currentPosition);
+    WriteUInt32(data, static_cast<uint32_t>(items.size()));
+    WriteUInt32(data, static_cast<uint32_t>(filters.size()));
+    WriteUInt32(data, static_cast<uint32_t>(history.size()));
+
+    for (const auto& item : items)
+    {
+        WriteString(data, item);
+    }
+    for (const auto& filter : filters)
+    {
+        WriteString(data, filter);
+    }
+    for (auto historyIndex : history)
+    {
+        WriteUInt32(data, historyIndex);
+    }
+
+    WriteUInt32(data, Checksum(data, data.size()));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return file.good();
+}
+
+
+auto PlaylistSnapshot::Load(const std::string& filename) -> bool
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    auto fileSize = static_cast<size_t>(file.tellg());
+    // Magic, header fields and checksum.
+    if (fileSize < sizeof(SnapshotMagic) + 7 * 4)
+    {
+        return false;
+    }
+
+    std::vector<char> data(fileSize);
+    file.seekg(0);
+    file.read(data.data(), static_cast<std::streamsize>(fileSize));
+    if (!file.good())
+    {
+        return false;
+    }
+
+    if (!std::equal(std::begin(SnapshotMagic), std::end(SnapshotMagic), data.begin()))
+    {
+        return false;
+    }
+
+    // Verify the checksum first, so we don't have to deal with garbage data while parsing.
+    auto payloadLength = fileSize - 4;
+    if (DecodeUInt32(data.data() + payloadLength) != Checksum(data, payloadLength))
+    {
+        return false;
+    }
+
+    SnapshotReader reader(data, payloadLength);
+    reader.Skip(sizeof(SnapshotMagic));
+
+    uint32_t version{};
+    uint32_t flags{};
+    uint32_t position{};
+    uint32_t itemCount{};
+    uint32_t filterCount{};
+    uint32_t historyCount{};
+
+    if (!reader.ReadUInt32(version) ||
+        version != FormatVersion ||
+        !reader.ReadUInt32(flags) ||
+        !reader.ReadUInt32(position) ||
+        !reader.ReadUInt32(itemCount) ||
+        !reader.ReadUInt32(filterCount) ||
+        !reader.ReadUInt32(historyCount))
+    {
+        return false;
+    }
+
+    // Each string needs at least its length field, each history entry four bytes.
+    if ((static_cast<uint64_t>(itemCount) + filterCount + historyCount) * 4 > payloadLength)
+    {
+        return false;
+    }
+
+    std::vector<std::string> newItems(itemCount);
+    for (auto& item : newItems)
+    {
+        if (!reader.ReadString(item))
+        {
+            return false;
+        }
+    }
+
+    std::vector<std::string> newFilters(filterCount);
+    for (auto& filter : newFilters)
+    {
+        if (!reader.ReadString(filter))
+        {
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> newHistory(historyCount);
+    for (auto& historyIndex : newHistory)
+    {
+        if (!reader.ReadUInt32(historyIndex) || historyIndex >= itemCount)
+        {
+            return false;
+        }
+    }
+
+    if (!reader.AtEnd())
+    {
+        return false;
+    }
+
+    items = std::move(newItems);
+    filters = std::move(newFilters);
+    history = std::move(newHistory);
+    shuffle = (flags & ShuffleFlag) != 0;
+    currentPosition = position < itemCount ? position : 0;
+
+    return true;
+}
+
+} // namespace Playlist
+} // namespace libprojectM
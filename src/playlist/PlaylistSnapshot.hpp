@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace Playlist {
+
+/**
+ * @brief Binary snapshot of a playlist's state.
+ *
+ * Used to save a playlist to disk and restore it on the next start without scanning the
+ * filesystem again. The file is read in a single pass, and the contained preset files are not
+ * checked for existence when loading. Missing files are handled like any other preset load
+ * failure when they're about to be played.
+ *
+ * File layout (all integers are unsigned 32 bit, little endian):
+ * - Header: magic "PMPL", format version, flags, current position, item count, filter count,
+ *   history count.
+ * - Item filenames and filter expressions, each stored as a length followed by the characters.
+ * - History entries as playlist indices, oldest first.
+ * - FNV-1a checksum of all preceding bytes.
+ */
+struct PlaylistSnapshot {
+    static constexpr uint32_t FormatVersion = 1; //!< Current snapshot format version.
+
+    std::vector<std::string> items;   //!< Preset filenames, in playlist order.
+    std::vector<std::string> filters; //!< Filter expressions.
+    std::vector<uint32_t> history;    //!< Playback history as playlist indices, oldest first.
+    bool shuffle{false};              //!< Shuffle mode state.
+    uint32_t currentPosition{0};      //!< Current playlist position.
+
+    /**
+     * @brief Writes the snapshot to a file.
+     * @param filename The file to write. Will be overwritten if it exists.
+     * @return True if the file was written successfully, false if an error occurred.
+     */
+    auto Save(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Reads a snapshot from a file.
+     *
+     * If the file can't be read, has an unsupported version or is corrupted, false is returned
+     * and the snapshot contents are left unchanged.
+     *
+     * @param filename The file to read.
+     * @return True if the snapshot was read successfully, false if not.
+     */
+    auto Load(const std::string& filename) -> bool;
+};
+
+} // namespace Playlist
+} // namespace libprojectM
@@ -0,0 +1,534 @@
+#include "PresetMetadataIndex.hpp"
+
+#include "FileInfo.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+using namespace PROJECTM_FILESYSTEM_NAMESPACE::filesystem;
+
+namespace libprojectM {
+namespace Playlist {
+
+namespace {
+
+constexpr char IndexHeader[] = "projectM-preset-index";
+
+/**
+ * @brief Returns the value of a numeric condition field.
+ * @param entry The entry to read the value from.
+ * @param field The field name.
+ * @param value [out] Receives the field value.
+ * @return True if the field exists, false if not.
+ */
+auto NumericField(const PresetMetadataIndex::Entry& entry, const std::string& field, double& value) -> bool
+{
+    if (field == "size")
+    {
+        value = static_cast<double>(entry.fileSize);
+    }
+    else if (field == "metadata")
+    {
+        value = entry.hasMetadata ? 1.0 : 0.0;
+    }
+    else if (field == "warp_shader")
+    {
+        value = entry.hasWarpShader ? 1.0 : 0.0;
+    }
+    else if (field == "composite_shader")
+    {
+        value = entry.hasCompositeShader ? 1.0 : 0.0;
+    }
+    else if (field == "per_pixel_code")
+    {
+        value = entry.hasPerPixelCode ? 1.0 : 0.0;
+    }
+    else if (field == "custom_waves")
+    {
+        value = entry.customWaveCount;
+    }
+    else if (field == "custom_shapes")
+    {
+        value = entry.customShapeCount;
+    }
+    else if (field == "max_wave_samples")
+    {
+        value = entry.maxWaveSamples;
+    }
+    else if (field == "max_shape_instances")
+    {
+        value = entry.maxShapeInstances;
+    }
+    else if (field == "blur_level")
+    {
+        value = entry.blurLevel;
+    }
+    else if (field == "parse_time")
+    {
+        value = entry.parseTime;
+    }
+    else if (field == "shader_translation_time")
+    {
+        value = entry.shaderTranslationTime;
+    }
+    else if (field == "load_time")
+    {
+        value = entry.parseTime + entry.shaderTranslationTime;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Removes leading and trailing whitespace.
+ */
+auto Trim(const std::string& text) -> std::string
+{
+    auto first = text.find_first_not_of(" \t");
+    if (first == std::string::npos)
+    {
+        return {};
+    }
+
+    auto last = text.find_last_not_of(" \t");
+    return text.substr(first, last - first + 1);
+}
+
+} // namespace
+
+
+PresetMetadataIndex::PresetMetadataIndex(MetadataFunction metadataFunction)
+    : m_metadataFunction(std::move(metadataFunction))
+{
+}
+
+
+auto PresetMetadataIndex::Build(const std::string& path, bool recursive, uint32_t threadCount) -> uint32_t
+{
+    std::vector<std::string> filenames;
+
+    try
+    {
+        if (recursive)
+        {
+            for (const auto& entry : recursive_directory_iterator(path))
+            {
+                if (is_regular_file(entry) && entry.path().extension() == ".milk")
+                {
+                    filenames.push_back(entry.path().string());
+                }
+            }
+        }
+        else
+        {
+            for (const auto& entry : directory_iterator(path))
+            {
+                if (is_regular_file(entry) && entry.path().extension() == ".milk")
+                {
+                    filenames.push_back(entry.path().string());
+                }
+            }
+        }
+    }
+    catch (std::exception&)
+    {
+        return 0;
+    }
+
+    std::sort(filenames.begin(), filenames.end());
+
+    // Workers only read m_entries and write into their own result slots.
+    std::vector<Entry> results(filenames.size());
+    std::vector<char> indexed(filenames.size(), 0);
+    std::atomic<size_t> nextFile{0};
+
+    auto worker = [&]() {
+        for (size_t fileIndex = nextFile++; fileIndex < filenames.size(); fileIndex = nextFile++)
+        {
+            indexed[fileIndex] = IndexFile(filenames[fileIndex], results[fileIndex]) ? 1 : 0;
+        }
+    };
+
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<uint32_t>(std::min<size_t>(threadCount, std::max<size_t>(filenames.size(), 1)));
+
+    // The calling thread does its share of the work, so a failure to start threads isn't fatal.
+    std::vector<std::thread> threads;
+    for (uint32_t thread = 1; thread < threadCount; thread++)
+    {
+        try
+        {
+            threads.emplace_back(worker);
+        }
+        catch (std::system_error&)
+        {
+            break;
+        }
+    }
+
+    worker();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Remove entries of files which were deleted from the scanned directory.
+    const std::string separators{'/', static_cast<char>(PROJECTM_FILESYSTEM_NAMESPACE::filesystem::path::preferred_separator)};
+    std::string directoryPrefix = path;
+    if (!directoryPrefix.empty() && separators.find(directoryPrefix.back()) == std::string::npos)
+    {
+        directoryPrefix.push_back(separators.back());
+    }
+
+    for (auto entry = m_entries.begin(); entry != m_entries.end();)
+    {
+        const auto& filename = entry->first;
+        bool inScannedDirectory = filename.compare(0, directoryPrefix.length(), directoryPrefix) == 0 &&
+                                  (recursive || filename.find_first_of(separators, directoryPrefix.length()) == std::string::npos);
+
+        if (inScannedDirectory && !std::binary_search(filenames.begin(), filenames.end(), filename))
+        {
+            entry = m_entries.erase(entry);
+        }
+        else
+        {
+            ++entry;
+        }
+    }
+
+    uint32_t indexedCount{0};
+    for (size_t fileIndex = 0; fileIndex < filenames.size(); fileIndex++)
+    {
+        if (indexed[fileIndex] != 0)
+        {
+            m_entries[filenames[fileIndex]] = std::move(results[fileIndex]);
+            indexedCount++;
+        }
+        else
+        {
+            m_entries.erase(filenames[fileIndex]);
+        }
+    }
+
+    return indexedCount;
+}
+
+
+auto PresetMetadataIndex::Entries() const -> const std::map<std::string, Entry>&
+{
+    return m_entries;
+}
+
+
+void PresetMetadataIndex::Clear()
+{
+    m_entries.clear();
+}
+
+
+auto PresetMetadataIndex::Find(const std::vector<std::string>& conditions, std::vector<std::string>& filenames) const -> bool
+{
+    std::vector<Condition> parsedConditions(conditions.size());
+    for (size_t index = 0; index < conditions.size(); index++)
+    {
+        if (!ParseCondition(conditions[index], parsedConditions[index]))
+        {
+            return false;
+        }
+    }
+
+    for (const auto& entry : m_entries)
+    {
+        bool matches = std::all_of(parsedConditions.begin(), parsedConditions.end(), [&entry](const Condition& condition) {
+            return Matches(entry.second, condition);
+        });
+
+        if (matches)
+        {
+            filenames.push_back(entry.first);
+        }
+    }
+
+    return true;
+}
+
+
+auto PresetMetadataIndex::Save(const std::string& filename) const -> bool
+{
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.imbue(std::locale::classic());
+
+    file << IndexHeader << ' ' << FormatVersion << '\n';
+
+    for (const auto& entry : m_entries)
+    {
+        const auto& preset = entry.second;
+
+        std::string textures;
+        for (const auto& texture : preset.textures)
+        {
+            if (!textures.empty())
+            {
+                textures.push_back(' ');
+            }
+            textures.append(texture);
+        }
+
+        file << preset.modificationTime << '\t'
+             << preset.fileSize << '\t'
+             << preset.contentHash << '\t'
+             << (preset.hasMetadata ? 1 : 0) << '\t'
+             << (preset.hasWarpShader ? 1 : 0) << '\t'
+             << (preset.hasCompositeShader ? 1 : 0) << '\t'
+             << (preset.hasPerPixelCode ? 1 : 0) << '\t'
+             << preset.customWaveCount << '\t'
+             << preset.customShapeCount << '\t'
+             << preset.maxWaveSamples << '\t'
+             << preset.maxShapeInstances << '\t'
+             << preset.blurLevel << '\t'
+             << preset.parseTime << '\t'
+             << preset.shaderTranslationTime << '\t'
+             << textures << '\t'
+             << entry.first << '\n';
+    }
+
+    return file.good();
+}
+
+
+auto PresetMetadataIndex::Load(const std::string& filename) -> bool
+{
+    std::ifstream file(filename);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.imbue(std::locale::classic());
+
+    std::string header;
+    uint32_t version{};
+    if (!(file >> header >> version) || header != IndexHeader || version != FormatVersion)
+    {
+        return false;
+    }
+
+    std::map<std::string, Entry> entries;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream(line);
+        lineStream.imbue(std::locale::classic());
+
+        Entry entry;
+        int hasMetadata{};
+        int hasWarpShader{};
+        int hasCompositeShader{};
+        int hasPerPixelCode{};
+        std::string textures;
+        std::string presetFilename;
+        if (!(lineStream >> entry.modificationTime >> entry.fileSize >> entry.contentHash
+                         >> hasMetadata >> hasWarpShader >> hasCompositeShader >> hasPerPixelCode
+                         >> entry.customWaveCount >> entry.customShapeCount
+                         >> entry.maxWaveSamples >> entry.maxShapeInstances >> entry.blurLevel
+                         >> entry.parseTime >> entry.shaderTranslationTime) ||
+            lineStream.get() != '\t' ||
+            !std::getline(lineStream, textures, '\t') ||
+            !std::getline(lineStream, presetFilename) ||
+            presetFilename.empty())
+        {
+            continue;
+        }
+
+        entry.hasMetadata = hasMetadata != 0;
+        entry.hasWarpShader = hasWarpShader != 0;
+        entry.hasCompositeShader = hasCompositeShader != 0;
+        entry.hasPerPixelCode = hasPerPixelCode != 0;
+
+        std::istringstream textureStream(textures);
+        std::string texture;
+        while (textureStream >> texture)
+        {
+            entry.textures.push_back(texture);
+        }
+
+        entries[presetFilename] = std::move(entry);
+    }
+
+    m_entries = std::move(entries);
+
+    return true;
+}
+
+
+auto PresetMetadataIndex::ParseCondition(const std::string& conditionText, Condition& condition) -> bool
+{
+    auto operatorPos = conditionText.find_first_of("=!<>");
+    if (operatorPos == std::string::npos)
+    {
+        return false;
+    }
+
+    auto operatorLength = (operatorPos + 1 < conditionText.length() && conditionText[operatorPos + 1] == '=') ? 2 : 1;
+    auto operatorText = conditionText.substr(operatorPos, operatorLength);
+
+    if (operatorText == "=" || operatorText == "==")
+    {
+        condition.comparison = Condition::Operator::Equal;
+    }
+    else if (operatorText == "!=")
+    {
+        condition.comparison = Condition::Operator::NotEqual;
+    }
+    else if (operatorText == "<")
+    {
+        condition.comparison = Condition::Operator::Less;
+    }
+    else if (operatorText == "<=")
+    {
+        condition.comparison = Condition::Operator::LessEqual;
+    }
+    else if (operatorText == ">")
+    {
+        condition.comparison = Condition::Operator::Greater;
+    }
+    else if (operatorText == ">=")
+    {
+        condition.comparison = Condition::Operator::GreaterEqual;
+    }
+    else
+    {
+        return false;
+    }
+
+    condition.field = Trim(conditionText.substr(0, operatorPos));
+    condition.text = Trim(conditionText.substr(operatorPos + operatorLength));
+    std::transform(condition.text.begin(), condition.text.end(), condition.text.begin(), [](char character) {
+        return (character >= 'A' && character <= 'Z') ? static_cast<char>(character - 'A' + 'a') : character;
+    });
+
+    if (condition.text.empty())
+    {
+        return false;
+    }
+
+    if (condition.field == "texture")
+    {
+        return condition.comparison == Condition::Operator::Equal ||
+               condition.comparison == Condition::Operator::NotEqual;
+    }
+
+    double unused{};
+    if (!NumericField(Entry(), condition.field, unused))
+    {
+        return false;
+    }
+
+    std::istringstream valueStream(condition.text);
+    valueStream.imbue(std::locale::classic());
+    return (valueStream >> condition.number) && (valueStream >> std::ws).eof();
+}
+
+
+auto PresetMetadataIndex::Matches(const Entry& entry, const Condition& condition) -> bool
+{
+    if (!entry.hasMetadata && condition.field != "size" && condition.field != "metadata")
+    {
+        return false;
+    }
+
+    if (condition.field == "texture")
+    {
+        bool referenced = std::find(entry.textures.begin(), entry.textures.end(), condition.text) != entry.textures.end();
+        return referenced == (condition.comparison == Condition::Operator::Equal);
+    }
+
+    double value{};
+    NumericField(entry, condition.field, value);
+
+    switch (condition.comparison)
+    {
+        case Condition::Operator::Equal:
+            return value == condition.number;
+        case Condition::Operator::NotEqual:
+            return value != condition.number;
+        case Condition::Operator::Less:
+            return value < condition.number;
+        case Condition::Operator::LessEqual:
+            return value <= condition.number;
+        case Condition::Operator::Greater:
+            return value > condition.number;
+        case Condition::Operator::GreaterEqual:
+            return value >= condition.number;
+    }
+
+    return false;
+}
+
+
+auto PresetMetadataIndex::IndexFile(const std::string& filename, Entry& entry) const -> bool
+{
+    if (!GetFileInfo(filename, entry.fileSize, entry.modificationTime))
+    {
+        return false;
+    }
+
+    auto existingEntry = m_entries.find(filename);
+    bool found = existingEntry != m_entries.end();
+
+    if (found && existingEntry->second.modificationTime == entry.modificationTime && existingEntry->second.fileSize == entry.fileSize)
+    {
+        entry = existingEntry->second;
+        return true;
+    }
+
+    if (!HashFileContents(filename, entry.contentHash))
+    {
+        return false;
+    }
+
+    if (found && existingEntry->second.fileSize == entry.fileSize && existingEntry->second.contentHash == entry.contentHash)
+    {
+        // Same contents, only the timestamp changed.
+        auto modificationTime = entry.modificationTime;
+        entry = existingEntry->second;
+        entry.modificationTime = modificationTime;
+        return true;
+    }
+
+    entry.hasMetadata = m_metadataFunction(filename, entry);
+    if (!entry.hasMetadata)
+    {
+        // Don't keep partially filled metadata.
+        Entry fileInfo;
+        fileInfo.modificationTime = entry.modificationTime;
+        fileInfo.fileSize = entry.fileSize;
+        fileInfo.contentHash = entry.contentHash;
+        entry = std::move(fileInfo);
+    }
+
+    return true;
+}
+
+} // namespace Playlist
+} // namespace libprojectM
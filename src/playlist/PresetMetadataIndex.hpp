@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace libprojectM {
+namespace Playlist {
+
+/**
+ * @brief Persistent index of preset metadata, used to select presets without opening the files.
+ *
+ * Build() scans a directory for preset files and reads the metadata of each file on multiple
+ * threads, using a user-supplied function which must be safe to call concurrently. Like in the
+ * PresetValidator, files whose modification time and size didn't change, or whose contents hash
+ * is unchanged, reuse the existing entry instead of being read again.
+ *
+ * Find() returns all indexed presets matching a list of conditions. Each condition has the form
+ * "field op value", with op being one of =, !=, <, <=, > or >=. Numeric fields are:
+ * - size: the file size in bytes.
+ * - metadata: 1 if the metadata could be read, 0 if not.
+ * - warp_shader, composite_shader, per_pixel_code: 1 if present, 0 if not.
+ * - custom_waves, custom_shapes: the number of enabled custom waveforms and shapes.
+ * - max_wave_samples, max_shape_instances: the highest sample and instance counts.
+ * - blur_level: the highest blur level used by the shaders, 0 to 3.
+ * - parse_time, shader_translation_time, load_time: measured times in seconds. load_time is
+ *   the sum of the other two.
+ *
+ * The "texture" field only supports = and != to select presets which do or don't reference the
+ * given texture name. Except for size and metadata, conditions never match presets without
+ * metadata.
+ *
+ * The index can be saved to and loaded from a text file. Layout: a header line
+ * "projectM-preset-index 1", followed by one line per preset with the modification time, file
+ * size, content hash, metadata flag, the three shader/code flags, the four custom wave and shape
+ * counts, the blur level, both times, the space-separated texture names and the preset filename,
+ * all separated by tabs.
+ */
+class PresetMetadataIndex
+{
+public:
+    static constexpr uint32_t FormatVersion = 1; //!< Current index file format version.
+
+    /**
+     * Indexed properties of a single preset file.
+     */
+    struct Entry {
+        int64_t modificationTime{0};       //!< File modification time, in file system clock ticks.
+        uint64_t fileSize{0};              //!< File size in bytes.
+        uint64_t contentHash{0};           //!< FNV-1a hash of the file contents.
+        bool hasMetadata{false};           //!< True if the metadata below could be read.
+        bool hasWarpShader{false};         //!< True if the preset uses a warp shader.
+        bool hasCompositeShader{false};    //!< True if the preset uses a composite shader.
+        bool hasPerPixelCode{false};       //!< True if the preset has per-pixel code.
+        uint32_t customWaveCount{0};       //!< Number of enabled custom waveforms.
+        uint32_t customShapeCount{0};      //!< Number of enabled custom shapes.
+        uint32_t maxWaveSamples{0};        //!< Highest sample count of the enabled custom waveforms.
+        uint32_t maxShapeInstances{0};     //!< Highest instance count of the enabled custom shapes.
+        uint32_t blurLevel{0};             //!< Highest blur level used by the preset shaders.
+        double parseTime{0.0};             //!< Measured parse time in seconds.
+        double shaderTranslationTime{0.0}; //!< Measured shader translation time in seconds.
+        std::vector<std::string> textures; //!< Lower-case names of the referenced textures.
+    };
+
+    /**
+     * @brief Function reading the metadata of a single preset file.
+     * Receives the filename and fills in all metadata fields of the entry. Returns false if the
+     * metadata can't be read. File information and hasMetadata are set by the index.
+     */
+    using MetadataFunction = std::function<bool(const std::string& filename, Entry& entry)>;
+
+    PresetMetadataIndex() = delete;
+
+    /**
+     * @brief Constructor.
+     * @param metadataFunction The function used to read the metadata of each preset file.
+     */
+    explicit PresetMetadataIndex(MetadataFunction metadataFunction);
+
+    /**
+     * @brief Scans a directory for .milk files and adds or updates their entries.
+     *
+     * Entries of files in the scanned directory which no longer exist are removed. Blocks until
+     * all files are indexed.
+     *
+     * @param path The directory to scan.
+     * @param recursive True to also scan all subdirectories.
+     * @param threadCount The number of threads used to read the files. 0 uses one thread per CPU core.
+     * @return The number of indexed preset files found in the directory.
+     */
+    auto Build(const std::string& path, bool recursive, uint32_t threadCount) -> uint32_t;
+
+    /**
+     * @brief Returns all index entries, sorted by filename.
+     * @return A reference to the index entries, keyed by filename.
+     */
+    auto Entries() const -> const std::map<std::string, Entry>&;
+
+    /**
+     * @brief Removes all entries.
+     */
+    void Clear();
+
+    /**
+     * @brief Returns the filenames of all presets matching the given conditions.
+     * @param conditions The conditions, all of which must match. See the class description for the syntax.
+     * @param filenames [out] Receives the matching filenames, sorted by name.
+     * @return True if all conditions could be parsed, false if not. No filenames are returned in this case.
+     */
+    auto Find(const std::vector<std::string>& conditions, std::vector<std::string>& filenames) const -> bool;
+
+    /**
+     * @brief Writes the index to a file.
+     * @param filename The file to write. Will be overwritten if it exists.
+     * @return True if the file was written successfully, false if an error occurred.
+     */
+    auto Save(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Replaces the index with the contents of a file.
+     *
+     * If the file can't be read or has an unsupported format, false is returned and the current
+     * index is left unchanged. Malformed lines are skipped.
+     *
+     * @param filename The file to read.
+     * @return True if the file was read successfully, false if not.
+     */
+    auto Load(const std::string& filename) -> bool;
+
+private:
+    /**
+     * A parsed Find() condition.
+     */
+    struct Condition {
+        /**
+         * Comparison operators.
+         */
+        enum class Operator : uint8_t
+        {
+            Equal,
+            NotEqual,
+            Less,
+            LessEqual,
+            Greater,
+            GreaterEqual
+        };
+
+        std::string field;                    //!< The field name.
+        Operator comparison{Operator::Equal}; //!< The comparison operator.
+        std::string text;                     //!< The value as text, used for the texture field.
+        double number{0.0};                   //!< The value as number, used for all other fields.
+    };
+
+    /**
+     * @brief Parses a single condition string.
+     * @param conditionText The condition to parse.
+     * @param condition [out] Receives the parsed condition.
+     * @return True if the condition is valid, false if not.
+     */
+    static auto ParseCondition(const std::string& conditionText, Condition& condition) -> bool;
+
+    /**
+     * @brief Checks if an entry matches a condition.
+     * @param entry The entry to check.
+     * @param condition The condition to check against.
+     * @return True if the entry matches, false if not.
+     */
+    static auto Matches(const Entry& entry, const Condition& condition) -> bool;
+
+    /**
+     * @brief Indexes a single file, reusing the existing entry where possible.
+     *
+     * Only reads from m_entries, so it can be called from multiple threads while no entries are
+     * modified.
+     *
+     * @param filename The preset file to index.
+     * @param entry [out] Receives the index entry.
+     * @return True if the file could be indexed, false if it isn't accessible.
+     */
+    auto IndexFile(const std::string& filename, Entry& entry) const -> bool;
+
+    MetadataFunction m_metadataFunction; //!< The function used to read preset metadata.
+
+    std::map<std::string, Entry> m_entries; //!< Index entries, keyed by filename.
+};
+
+} // namespace Playlist
+} // namespace libprojectM
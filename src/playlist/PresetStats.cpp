@@ -0,0 +1,129 @@
+#include "PresetStats.hpp"
+
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <utility>
+
+namespace libprojectM {
+namespace Playlist {
+
+namespace {
+
+constexpr char StatsHeader[] = "projectM-preset-stats";
+
+} // namespace
+
+
+void PresetStats::Record(const std::string& filename, uint32_t frameCount, double averageFrameTime)
+{
+    if (frameCount == 0 || averageFrameTime < 0.0)
+    {
+        return;
+    }
+
+    auto& entry = m_entries[filename];
+
+    auto totalFrames = entry.frameCount + frameCount;
+    entry.averageFrameTime = (entry.averageFrameTime * static_cast<double>(entry.frameCount) +
+                              averageFrameTime * static_cast<double>(frameCount)) /
+                             static_cast<double>(totalFrames);
+    entry.frameCount = totalFrames;
+    entry.playCount++;
+}
+
+
+auto PresetStats::Get(const std::string& filename) const -> const Entry*
+{
+    auto entry = m_entries.find(filename);
+    if (entry == m_entries.end())
+    {
+        return nullptr;
+    }
+
+    return &entry->second;
+}
+
+
+auto PresetStats::Size() const -> size_t
+{
+    return m_entries.size();
+}
+
+
+void PresetStats::Clear()
+{
+    m_entries.clear();
+}
+
+
+auto PresetStats::Save(const std::string& filename) const -> bool
+{
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.imbue(std::locale::classic());
+    file.precision(std::numeric_limits<double>::max_digits10);
+
+    file << StatsHeader << ' ' << FormatVersion << '\n';
+    for (const auto& entry : m_entries)
+    {
+        file << entry.second.playCount << '\t'
+             << entry.second.frameCount << '\t'
+             << entry.second.averageFrameTime << '\t'
+             << entry.first << '\n';
+    }
+
+    return file.good();
+}
+
+
+auto PresetStats::Load(const std::string& filename) -> bool
+{
+    std::ifstream file(filename);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.imbue(std::locale::classic());
+
+    std::string header;
+    uint32_t version{};
+    if (!(file >> header >> version) || header != StatsHeader || version != FormatVersion)
+    {
+        return false;
+    }
+
+    std::unordered_map<std::string, Entry> entries;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream(line);
+        lineStream.imbue(std::locale::classic());
+
+        Entry entry;
+        std::string presetFilename;
+        if (!(lineStream >> entry.playCount >> entry.frameCount >> entry.averageFrameTime) ||
+            lineStream.get() != '\t' ||
+            !std::getline(lineStream, presetFilename) ||
+            presetFilename.empty() ||
+            entry.frameCount == 0)
+        {
+            continue;
+        }
+
+        entries[presetFilename] = entry;
+    }
+
+    m_entries = std::move(entries);
+
+    return true;
+}
+
+} // namespace Playlist
+} // namespace libprojectM
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace libprojectM {
+namespace Playlist {
+
+/**
+ * @brief Stores measured render costs of presets, keyed by the preset filename.
+ *
+ * Each time a preset stops playing, the number of frames rendered and the average frame time
+ * reported by projectM are merged into the preset's entry. The store can be saved to and loaded
+ * from a text file, so measurements are kept across application runs.
+ *
+ * File layout: a header line "projectM-preset-stats 1", followed by one line per preset with the
+ * play count, total frame count and average frame time in seconds, separated by tabs and followed
+ * by the preset filename.
+ */
+class PresetStats
+{
+public:
+    static constexpr uint32_t FormatVersion = 1; //!< Current stats file format version.
+
+    /**
+     * Render statistics of a single preset.
+     */
+    struct Entry {
+        uint32_t playCount{0};         //!< Number of recorded plays.
+        uint64_t frameCount{0};        //!< Total number of frames rendered over all plays.
+        double averageFrameTime{0.0};  //!< Average frame time over all frames in seconds.
+    };
+
+    /**
+     * @brief Merges a single play of a preset into its statistics.
+     * @param filename The preset filename.
+     * @param frameCount The number of frames rendered. Plays without any frames are ignored.
+     * @param averageFrameTime The average frame time of this play in seconds.
+     */
+    void Record(const std::string& filename, uint32_t frameCount, double averageFrameTime);
+
+    /**
+     * @brief Returns the statistics for the given preset.
+     * @param filename The preset filename.
+     * @return A pointer to the preset's statistics, or nullptr if no data was recorded for it.
+     */
+    auto Get(const std::string& filename) const -> const Entry*;
+
+    /**
+     * @brief Returns the number of presets with recorded statistics.
+     * @return The number of presets in the store.
+     */
+    auto Size() const -> size_t;
+
+    /**
+     * @brief Removes all recorded statistics.
+     */
+    void Clear();
+
+    /**
+     * @brief Writes all statistics to a file.
+     * @param filename The file to write. Will be overwritten if it exists.
+     * @return True if the file was written successfully, false if an error occurred.
+     */
+    auto Save(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Replaces the current statistics with the contents of a file.
+     *
+     * If the file can't be read or has an unsupported format, false is returned and the current
+     * statistics are left unchanged. Malformed lines are skipped.
+     *
+     * @param filename The file to read.
+     * @return True if the file was read successfully, false if not.
+     */
+    auto Load(const std::string& filename) -> bool;
+
+private:
+    std::unordered_map<std::string, Entry> m_entries; //!< Statistics per preset filename.
+};
+
+} // namespace Playlist
+} // namespace libprojectM
@@ -0,0 +1,282 @@
+#include "PresetValidator.hpp"
+
+#include "FileInfo.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <locale>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+namespace libprojectM {
+namespace Playlist {
+
+namespace {
+
+constexpr char CacheHeader[] = "projectM-preset-validation";
+
+} // namespace
+
+
+PresetValidator::PresetValidator(ValidateFunction validateFunction)
+    : m_validateFunction(std::move(validateFunction))
+{
+}
+
+
+PresetValidator::~PresetValidator()
+{
+    Stop();
+}
+
+
+auto PresetValidator::Start(std::vector<std::string> filenames) -> bool
+{
+    Stop();
+
+    m_stopRequested = false;
+    m_progress = 0;
+    m_total = static_cast<uint32_t>(filenames.size());
+    m_running = true;
+
+    try
+    {
+        m_workerThread = std::thread(&PresetValidator::Run, this, std::move(filenames));
+    }
+    catch (std::system_error&)
+    {
+        m_running = false;
+        return false;
+    }
+
+    return true;
+}
+
+
+void PresetValidator::Stop()
+{
+    m_stopRequested = true;
+
+    if (m_workerThread.joinable())
+    {
+        m_workerThread.join();
+    }
+
+    m_running = false;
+}
+
+
+auto PresetValidator::Running() const -> bool
+{
+    return m_running;
+}
+
+
+auto PresetValidator::Progress() const -> uint32_t
+{
+    return m_progress;
+}
+
+
+auto PresetValidator::Total() const -> uint32_t
+{
+    return m_total;
+}
+
+
+auto PresetValidator::TakeInvalidFilenames() -> std::vector<std::string>
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<std::string> invalidFilenames;
+    std::swap(invalidFilenames, m_invalidFilenames);
+
+    return invalidFilenames;
+}
+
+
+auto PresetValidator::GetCacheEntry(const std::string& filename, CacheEntry& entry) const -> bool
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto cacheEntry = m_cache.find(filename);
+    if (cacheEntry == m_cache.end())
+    {
+        return false;
+    }
+
+    entry = cacheEntry->second;
+
+    return true;
+}
+
+
+void PresetValidator::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_cache.clear();
+}
+
+
+auto PresetValidator::SaveCache(const std::string& filename) const -> bool
+{
+    std::ofstream file(filename, std::ios::trunc);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.imbue(std::locale::classic());
+
+    file << CacheHeader << ' ' << FormatVersion << '\n';
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (const auto& entry : m_cache)
+    {
+        // Keep each entry on a single line with a fixed number of fields.
+        std::string errorMessage = entry.second.errorMessage;
+        std::replace_if(
+            errorMessage.begin(), errorMessage.end(), [](char character) {
+                return character == '\t' || character == '\n' || character == '\r';
+            },
+            ' ');
+
+        file << entry.second.modificationTime << '\t'
+             << entry.second.fileSize << '\t'
+             << entry.second.contentHash << '\t'
+             << (entry.second.valid ? 1 : 0) << '\t'
+             << errorMessage << '\t'
+             << entry.first << '\n';
+    }
+
+    return file.good();
+}
+
+
+auto PresetValidator::LoadCache(const std::string& filename) -> bool
+{
+    std::ifstream file(filename);
+    if (!file.good())
+    {
+        return false;
+    }
+
+    file.imbue(std::locale::classic());
+
+    std::string header;
+    uint32_t version{};
+    if (!(file >> header >> version) || header != CacheHeader || version != FormatVersion)
+    {
+        return false;
+    }
+
+    std::unordered_map<std::string, CacheEntry> cache;
+    std::string line;
+    while (std::getline(file, line))
+    {
+        std::istringstream lineStream(line);
+        lineStream.imbue(std::locale::classic());
+
+        CacheEntry entry;
+        int valid{};
+        std::string presetFilename;
+        if (!(lineStream >> entry.modificationTime >> entry.fileSize >> entry.contentHash >> valid) ||
+            lineStream.get() != '\t' ||
+            !std::getline(lineStream, entry.errorMessage, '\t') ||
+            !std::getline(lineStream, presetFilename) ||
+            presetFilename.empty())
+        {
+            continue;
+        }
+
+        entry.valid = valid != 0;
+        cache[presetFilename] = std::move(entry);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache = std::move(cache);
+
+    return true;
+}
+
+
+void PresetValidator::Run(std::vector<std::string> filenames)
+{
+    for (const auto& filename : filenames)
+    {
+        if (m_stopRequested)
+        {
+            break;
+        }
+
+        ValidateFile(filename);
+        m_progress++;
+    }
+
+    m_running = false;
+}
+
+
+void PresetValidator::ValidateFile(const std::string& filename)
+{
+    CacheEntry entry;
+    // Only local files can be cached.
+    bool cacheable = GetFileInfo(filename, entry.fileSize, entry.modificationTime);
+
+    if (cacheable)
+    {
+        CacheEntry cachedEntry;
+        bool found = GetCacheEntry(filename, cachedEntry);
+
+        if (found && cachedEntry.modificationTime == entry.modificationTime && cachedEntry.fileSize == entry.fileSize)
+        {
+            entry = cachedEntry;
+        }
+        else
+        {
+            cacheable = HashFileContents(filename, entry.contentHash);
+
+            if (cacheable && found && cachedEntry.fileSize == entry.fileSize && cachedEntry.contentHash == entry.contentHash)
+            {
+                // Same contents, only the timestamp changed.
+                entry.valid = cachedEntry.valid;
+                entry.errorMessage = cachedEntry.errorMessage;
+            }
+            else
+            {
+                entry.valid = m_validateFunction(filename, entry.errorMessage);
+            }
+        }
+    }
+    else
+    {
+        // Not a local file, e.g. a URL. Always check, but don't cache the result.
+        entry.valid = m_validateFunction(filename, entry.errorMessage);
+    }
+
+    if (entry.valid)
+    {
+        entry.errorMessage.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!entry.valid)
+    {
+        m_invalidFilenames.push_back(filename);
+    }
+
+    if (cacheable)
+    {
+        m_cache[filename] = std::move(entry);
+    }
+    else
+    {
+        m_cache.erase(filename);
+    }
+}
+
+} // namespace Playlist
+} // namespace libprojectM
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace libprojectM {
+namespace Playlist {
+
+/**
+ * @brief Checks preset files on a background thread, so broken presets can be removed before they're played.
+ *
+ * The actual check is done by a user-supplied function, which must be safe to call from another
+ * thread. Results are cached by filename together with the file's modification time, size and a
+ * content hash. Files whose modification time and size didn't change aren't read again. If only
+ * the modification time changed, e.g. after copying a preset collection, the content hash is used
+ * to reuse the previous result.
+ *
+ * The cache can be saved to and loaded from a text file. Layout: a header line
+ * "projectM-preset-validation 1", followed by one line per preset with the modification time,
+ * file size, content hash, a 1/0 valid flag and the error message, separated by tabs and followed
+ * by the preset filename.
+ */
+class PresetValidator
+{
+public:
+    static constexpr uint32_t FormatVersion = 1; //!< Current cache file format version.
+
+    /**
+     * @brief Function checking a single preset file.
+     * Receives the filename, returns true if valid. If not, the reason is stored in the second argument.
+     */
+    using ValidateFunction = std::function<bool(const std::string& filename, std::string& errorMessage)>;
+
+    /**
+     * Cached validation result of a single preset file.
+     */
+    struct CacheEntry {
+        int64_t modificationTime{0}; //!< File modification time, in file system clock ticks.
+        uint64_t fileSize{0};        //!< File size in bytes.
+        uint64_t contentHash{0};     //!< FNV-1a hash of the file contents.
+        bool valid{true};            //!< True if the preset passed validation.
+        std::string errorMessage;    //!< The validation error, if the preset is invalid.
+    };
+
+    PresetValidator() = delete;
+
+    /**
+     * @brief Constructor.
+     * @param validateFunction The function used to check each preset file.
+     */
+    explicit PresetValidator(ValidateFunction validateFunction);
+
+    /**
+     * @brief Destructor. Stops a running validation pass.
+     */
+    ~PresetValidator();
+
+    PresetValidator(const PresetValidator&) = delete;
+    auto operator=(const PresetValidator&) -> PresetValidator& = delete;
+
+    /**
+     * @brief Starts a new validation pass over the given files.
+     *
+     * A running pass is stopped first. Invalid files found by a previous pass and not yet retrieved
+     * with TakeInvalidFilenames() are kept.
+     *
+     * @param filenames The preset files to check.
+     * @return True if the worker thread was started, false if no thread could be created.
+     */
+    auto Start(std::vector<std::string> filenames) -> bool;
+
+    /**
+     * @brief Stops the current validation pass and waits for the worker thread to exit.
+     */
+    void Stop();
+
+    /**
+     * @brief Returns whether a validation pass is currently running.
+     * @return True if the worker thread is still checking files.
+     */
+    auto Running() const -> bool;
+
+    /**
+     * @brief Returns the number of files checked in the current or last pass.
+     * @return The number of checked files.
+     */
+    auto Progress() const -> uint32_t;
+
+    /**
+     * @brief Returns the number of files in the current or last pass.
+     * @return The total number of files to check.
+     */
+    auto Total() const -> uint32_t;
+
+    /**
+     * @brief Returns all files found to be invalid since the last call and clears the list.
+     * @return The filenames of the invalid presets.
+     */
+    auto TakeInvalidFilenames() -> std::vector<std::string>;
+
+    /**
+     * @brief Retrieves the cached validation result of a file.
+     * @param filename The preset filename.
+     * @param entry [out] Receives the cached result if found.
+     * @return True if a cached result was found, false if not.
+     */
+    auto GetCacheEntry(const std::string& filename, CacheEntry& entry) const -> bool;
+
+    /**
+     * @brief Removes all cached results.
+     */
+    void ClearCache();
+
+    /**
+     * @brief Writes all cached results to a file.
+     * @param filename The file to write. Will be overwritten if it exists.
+     * @return True if the file was written successfully, false if an error occurred.
+     */
+    auto SaveCache(const std::string& filename) const -> bool;
+
+    /**
+     * @brief Replaces the cached results with the contents of a file.
+     *
+     * If the file can't be read or has an unsupported format, false is returned and the current
+     * cache is left unchanged. Malformed lines are skipped.
+     *
+     * @param filename The file to read.
+     * @return True if the file was read successfully, false if not.
+     */
+    auto LoadCache(const std::string& filename) -> bool;
+
+private:
+    /**
+     * @brief Worker thread function, checks all files of the current pass.
+     * @param filenames The preset files to check.
+     */
+    void Run(std::vector<std::string> filenames);
+
+    /**
+     * @brief Checks a single file, using the cache where possible.
+     * @param filename The preset file to check.
+     */
+    void ValidateFile(const std::string& filename);
+
+    ValidateFunction m_validateFunction; //!< The function used to check each preset file.
+
+    std::thread m_workerThread;              //!< The validation worker thread.
+    std::atomic<bool> m_stopRequested{false}; //!< Set to stop the worker thread early.
+    std::atomic<bool> m_running{false};       //!< True while the worker thread is checking files.
+    std::atomic<uint32_t> m_progress{0};      //!< Number of files checked in the current pass.
+    std::atomic<uint32_t> m_total{0};         //!< Number of files in the current pass.
+
+    mutable std::mutex m_mutex;                            //!< Protects the cache and the invalid file list.
+    std::unordered_map<std::string, CacheEntry> m_cache;  //!< Cached results, keyed by filename.
+    std::vector<std::string> m_invalidFilenames;           //!< Invalid files not yet retrieved.
+};
+
+} // namespace Playlist
+} // namespace libprojectM
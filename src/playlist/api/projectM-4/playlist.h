@@ -29,7 +29,11 @@
 #include "projectM-4/playlist_callbacks.h"
 #include "projectM-4/playlist_core.h"
 #include "projectM-4/playlist_filter.h"
+#include "projectM-4/playlist_index.h"
 #include "projectM-4/playlist_items.h"
 #include "projectM-4/playlist_memory.h"
 #include "projectM-4/playlist_playback.h"
+#include "projectM-4/playlist_snapshot.h"
+#include "projectM-4/playlist_stats.h"
 #include "projectM-4/playlist_types.h"
+#include "projectM-4/playlist_validation.h"
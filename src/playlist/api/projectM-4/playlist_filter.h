@@ -91,8 +91,8 @@ PROJECTM_PLAYLIST_EXPORT char** projectm_playlist_get_filter(projectm_playlist_h
 /**
  * @brief Applies the current filter list to the existing playlist.
  *
- * Note this function only removes items. Previously filtered items are not added again. If items
- * were removed, the playback history is cleared.
+ * Note this function only removes items. Previously filtered items are not added again. History
+ * entries of removed items are dropped, the remaining history is kept.
  *
  * @param instance The playlist manager instance.
  * @return The number of removed items.
@@ -0,0 +1,155 @@
+/**
+ * @file playlist_index.h
+ * @copyright 2003-2025 projectM Team
+ * @brief Functions for indexing preset metadata and building playlists from the index.
+ * @since 4.2.0
+ *
+ * projectM -- Milkdrop-esque visualisation SDK
+ * Copyright (C)2003-2024 projectM Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * See 'LICENSE.txt' included within this release
+ *
+ */
+
+#pragma once
+
+#include "projectM-4/playlist_types.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Scans a directory for presets and adds their metadata to the playlist's preset index.
+ *
+ * <p>The metadata of each ".milk" file is read with projectm_get_preset_metadata() on the connected
+ * projectM instance, using multiple threads. It includes the content hash and size, used shaders,
+ * per-pixel code, enabled custom waves and shapes, referenced textures, the blur level and the
+ * measured parse and shader translation times. If the playlist isn't connected to a projectM
+ * instance, only the file information is indexed.</p>
+ *
+ * <p>Files already in the index are only read again if their size or contents changed. Entries of
+ * files removed from the directory are deleted. The call blocks until all files are indexed.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param path A local filesystem path to scan for presets.
+ * @param recurse_subdirs If true, subdirectories of the given path will also be scanned.
+ * @param thread_count The number of threads to use. 0 uses one thread per CPU core.
+ * @return The number of indexed presets found in the path. 0 may indicate issues scanning the path.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_build_index(projectm_playlist_handle instance, const char* path,
+                                                                bool recurse_subdirs, uint32_t thread_count);
+
+/**
+ * @brief Returns the number of presets in the preset index.
+ * @param instance The playlist manager instance.
+ * @return The number of indexed presets.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_get_index_size(projectm_playlist_handle instance);
+
+/**
+ * @brief Removes all presets from the preset index.
+ * @param instance The playlist manager instance.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_clear_index(projectm_playlist_handle instance);
+
+/**
+ * @brief Saves the preset index to a file.
+ *
+ * The file is a plain text file with one line per preset.
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to write. An existing file will be overwritten.
+ * @return True if the file was written successfully, false if an error occurred.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_save_index(projectm_playlist_handle instance,
+                                                           const char* filename);
+
+/**
+ * @brief Replaces the preset index with the contents of a file.
+ *
+ * If the file can't be read or has an unsupported format, the current index is kept.
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to read.
+ * @return True if the file was loaded successfully, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_load_index(projectm_playlist_handle instance,
+                                                           const char* filename);
+
+/**
+ * @brief Appends all indexed presets matching the given conditions to the end of the playlist.
+ *
+ * <p>The preset files are not accessed, so a playlist can be built from a loaded index without
+ * scanning the filesystem. Presets are added in filename order.</p>
+ *
+ * <p>Each condition has the form "field op value", where op is one of =, !=, <, <=, > or >=. All
+ * conditions must match. Available numeric fields:</p>
+ * <ul>
+ *   <li>size: the file size in bytes.</li>
+ *   <li>metadata: 1 if the preset metadata could be read, 0 if not.</li>
+ *   <li>warp_shader, composite_shader, per_pixel_code: 1 if used by the preset, 0 if not.</li>
+ *   <li>custom_waves, custom_shapes: number of enabled custom waves and shapes.</li>
+ *   <li>max_wave_samples, max_shape_instances: highest sample and instance counts.</li>
+ *   <li>blur_level: highest blur level used by the shaders, 0 to 3.</li>
+ *   <li>parse_time, shader_translation_time, load_time: measured times in seconds.</li>
+ * </ul>
+ * <p>The "texture" field only supports = and != and selects presets which do or don't reference
+ * the given texture, e.g. "texture != clouds". Except for size and metadata, conditions don't match
+ * presets without metadata.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param conditions A list of conditions. Can be NULL if count is 0.
+ * @param count The number of conditions in the list.
+ * @param allow_duplicates If true, matching presets will always be added. If false, a preset is
+ *                         only added if the exact filename doesn't exist in the current playlist.
+ * @return The number of presets added. 0 if any condition can't be parsed.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_add_indexed_presets(projectm_playlist_handle instance,
+                                                                        const char** conditions, uint32_t count,
+                                                                        bool allow_duplicates);
+
+/**
+ * @brief Inserts all indexed presets matching the given conditions at the given playlist position.
+ *
+ * See projectm_playlist_add_indexed_presets() for the condition syntax.
+ *
+ * @param instance The playlist manager instance.
+ * @param conditions A list of conditions. Can be NULL if count is 0.
+ * @param count The number of conditions in the list.
+ * @param index The index to insert the presets at. If larger than the playlist size, they're added
+ *              to the end of the playlist.
+ * @param allow_duplicates If true, matching presets will always be added. If false, a preset is
+ *                         only added if the exact filename doesn't exist in the current playlist.
+ * @return The number of presets added. 0 if any condition can't be parsed.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_insert_indexed_presets(projectm_playlist_handle instance,
+                                                                           const char** conditions, uint32_t count,
+                                                                           uint32_t index, bool allow_duplicates);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -83,6 +83,66 @@ PROJECTM_PLAYLIST_EXPORT char** projectm_playlist_items(projectm_playlist_handle
  */
 PROJECTM_PLAYLIST_EXPORT char* projectm_playlist_item(projectm_playlist_handle instance, uint32_t index);
 
+/**
+ * @brief Returns the current generation of the playlist item list.
+ *
+ * The generation changes whenever items are added, removed or reordered, e.g. by adding presets,
+ * sorting, applying a filter, loading a snapshot or removing a preset that failed to load. Use it
+ * to check if pointers returned by projectm_playlist_items_view() are still valid.
+ *
+ * @param instance The playlist manager instance.
+ * @return The current item list generation.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint64_t projectm_playlist_items_generation(projectm_playlist_handle instance);
+
+/**
+ * @brief Returns pointers to the filenames inside the given range of the current playlist, without copying.
+ *
+ * <p>Works like projectm_playlist_items(), but fills a caller-provided array with pointers into
+ * the playlist's own storage instead of allocating copies. This makes it cheap to call repeatedly,
+ * e.g. when rendering a scrolling list.</p>
+ *
+ * <p>The returned pointers are only valid until the next call which changes the playlist items.
+ * As preset switches may remove broken presets, compare the value of
+ * projectm_playlist_items_generation() with the one returned in @a generation before using the
+ * pointers again. Do not free or modify the returned strings.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param start The zero-based starting index of the range to return.
+ * @param count The maximum number of items to return. The @a filenames array must have room for
+ *              at least this number of pointers.
+ * @param[out] filenames Array receiving the filename pointers.
+ * @param[out] generation Optional. If not NULL, receives the item list generation the pointers
+ *                        belong to.
+ * @return The number of pointers written to @a filenames.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_items_view(projectm_playlist_handle instance, uint32_t start,
+                                                               uint32_t count, const char** filenames,
+                                                               uint64_t* generation);
+
+/**
+ * @brief Searches the playlist for presets matching a glob pattern.
+ *
+ * <p>The pattern uses the same syntax as filter expressions, see projectm_playlist_set_filter().
+ * A leading + or - is ignored. The search is done inside the library, no filenames are copied.</p>
+ *
+ * <p>To iterate over all matches, call this function again with @a start set to the last
+ * returned index plus one.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param pattern The glob pattern to search for.
+ * @param start The zero-based playlist index to start searching at.
+ * @param max_results The maximum number of indices to return. The @a indices array must have room
+ *                    for at least this number of values.
+ * @param[out] indices Array receiving the playlist indices of matching presets, in ascending order.
+ * @return The number of indices written to @a indices.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_find(projectm_playlist_handle instance, const char* pattern,
+                                                         uint32_t start, uint32_t max_results, uint32_t* indices);
+
 /**
  * @brief Appends presets from the given path to the end of the current playlist.
  *
@@ -51,6 +51,46 @@ PROJECTM_PLAYLIST_EXPORT void projectm_playlist_set_shuffle(projectm_playlist_ha
  */
 PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_get_shuffle(projectm_playlist_handle instance);
 
+/**
+ * @brief Sets how presets are selected if shuffle is enabled.
+ *
+ * <p>With SHUFFLE_MODE_RANDOM, each switch selects a uniformly random preset, so presets may
+ * repeat at any time. With SHUFFLE_MODE_BAG, all presets are played once in a random order before
+ * a new order is drawn. Presets added during a cycle are inserted at a random spot in the rest of
+ * the cycle. The default is SHUFFLE_MODE_RANDOM.</p>
+ *
+ * <p>Changing the mode starts a new cycle.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param mode The new shuffle mode.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_set_shuffle_mode(projectm_playlist_handle instance,
+                                                                 projectm_playlist_shuffle_mode mode);
+
+/**
+ * @brief Returns how presets are selected if shuffle is enabled.
+ * @param instance The playlist manager instance.
+ * @return The current shuffle mode.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT projectm_playlist_shuffle_mode projectm_playlist_get_shuffle_mode(projectm_playlist_handle instance);
+
+/**
+ * @brief Predicts the playlist position projectm_playlist_play_next() will switch to.
+ *
+ * Can be used to prefetch the next preset. The prediction is exact if shuffle is disabled or in
+ * SHUFFLE_MODE_BAG, unless the cost mode skips the predicted preset. In SHUFFLE_MODE_RANDOM, the
+ * next preset can't be predicted.
+ *
+ * @param instance The playlist manager instance.
+ * @param[out] position Receives the predicted playlist position.
+ * @return True if a prediction was made, false if the playlist is empty or in random shuffle mode.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_peek_next_position(projectm_playlist_handle instance,
+                                                                   uint32_t* position);
+
 /**
  * @brief Sets the number of retries after failed preset switches.
  * @note Retry behavior changed in v4.2, using a loop. Default retry count is now 500. Failed items
@@ -129,8 +169,9 @@ PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_play_previous(projectm_playl
 /**
  * @brief Plays the last preset played in the history and returns the index of the preset.
  *
- * The history keeps track of the last 1000 presets and will go back in the history. The
- * playback history will be cleared whenever the playlist items are changed.
+ * The history keeps track of the last 1000 presets and will go back in the history. History
+ * entries follow their items if the playlist is changed or sorted, entries of removed items are
+ * skipped.
  *
  * If the history is empty, this call behaves identical to projectm_playlist_play_previous(),
  * but the item is not added to the history.
@@ -0,0 +1,73 @@
+/**
+ * @file playlist_snapshot.h
+ * @copyright 2003-2025 projectM Team
+ * @brief Functions to save and restore the playlist state.
+ * @since 4.2.0
+ *
+ * projectM -- Milkdrop-esque visualisation SDK
+ * Copyright (C)2003-2024 projectM Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * See 'LICENSE.txt' included within this release
+ *
+ */
+
+#pragma once
+
+#include "projectM-4/playlist_types.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Saves the current playlist state to a binary snapshot file.
+ *
+ * <p>The snapshot contains the playlist items, the filter list, the shuffle setting, the current
+ * position and the playback history. It can be loaded with projectm_playlist_load() on the next
+ * start, which is a lot faster than scanning preset directories again.</p>
+ *
+ * <p>The snapshot format is versioned. Files written by a different version of the playlist
+ * library may not be loadable.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to write. An existing file will be overwritten.
+ * @return True if the snapshot was written successfully, false if an error occurred.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_save(projectm_playlist_handle instance, const char* filename);
+
+/**
+ * @brief Replaces the playlist with the contents of a previously saved snapshot file.
+ *
+ * <p>The items are restored as-is. The filter list is not applied, and preset files are not
+ * checked for existence. Presets which no longer exist will fail to load when switched to, and are
+ * then removed from the playlist like any other broken preset.</p>
+ *
+ * <p>If the file is missing, has an unsupported version or is corrupted, the playlist is not
+ * modified.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The snapshot file to load.
+ * @return True if the snapshot was loaded, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_load(projectm_playlist_handle instance, const char* filename);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
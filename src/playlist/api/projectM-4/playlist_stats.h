@@ -0,0 +1,148 @@
+/**
+ * @file playlist_stats.h
+ * @copyright 2003-2025 projectM Team
+ * @brief Functions for cost-aware preset scheduling based on measured render times.
+ * @since 4.2.0
+ *
+ * projectM -- Milkdrop-esque visualisation SDK
+ * Copyright (C)2003-2024 projectM Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * See 'LICENSE.txt' included within this release
+ *
+ */
+
+#pragma once
+
+#include "projectM-4/playlist_types.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Sets the frame budget used for cost-aware preset scheduling.
+ *
+ * <p>Each time the playlist switches away from a preset, the number of frames rendered and the
+ * average frame time reported by projectM are recorded for this preset. If the recorded average
+ * exceeds the frame budget, the preset is skipped or selected less often, depending on the cost
+ * mode set with projectm_playlist_set_cost_mode().</p>
+ *
+ * <p>Presets are only rated after at least 30 frames have been recorded for them. Presets without
+ * enough data are always eligible.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param seconds The frame budget in seconds, e.g. 1.0 / 30.0 to target 30 FPS. A value of 0 or
+ *                less disables the budget.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_set_frame_budget(projectm_playlist_handle instance,
+                                                                 double seconds);
+
+/**
+ * @brief Returns the frame budget used for cost-aware preset scheduling.
+ * @param instance The playlist manager instance.
+ * @return The frame budget in seconds, or 0 if disabled.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT double projectm_playlist_get_frame_budget(projectm_playlist_handle instance);
+
+/**
+ * @brief Sets how presets exceeding the frame budget are scheduled.
+ *
+ * <p>With COST_MODE_SKIP, presets over budget are skipped. A preset over budget is only played
+ * if no preset within the budget is left. With COST_MODE_DOWN_WEIGHT, presets over budget are
+ * selected with a probability of budget divided by their average frame time. The default is
+ * COST_MODE_IGNORE.</p>
+ *
+ * <p>The cost mode is only used for automatic switches and projectm_playlist_play_next() and
+ * projectm_playlist_play_previous(). Presets selected directly by index or from the history are
+ * always played.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @param mode The new cost mode.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_set_cost_mode(projectm_playlist_handle instance,
+                                                              projectm_playlist_cost_mode mode);
+
+/**
+ * @brief Returns how presets exceeding the frame budget are scheduled.
+ * @param instance The playlist manager instance.
+ * @return The current cost mode.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT projectm_playlist_cost_mode projectm_playlist_get_cost_mode(projectm_playlist_handle instance);
+
+/**
+ * @brief Returns the recorded render statistics of a playlist item.
+ *
+ * Statistics are stored by preset filename, so they're kept if the item is moved or removed and
+ * added again.
+ *
+ * @param instance The playlist manager instance.
+ * @param index The playlist index of the item.
+ * @param[out] play_count Receives the number of recorded plays. Can be NULL.
+ * @param[out] frame_count Receives the total number of frames recorded. Can be NULL.
+ * @param[out] average_frame_time Receives the average frame time in seconds. Can be NULL.
+ * @return True if statistics were recorded for the item, false if not or the index is out of
+ *         bounds. The output values are not modified if false is returned.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_get_preset_stats(projectm_playlist_handle instance,
+                                                                 uint32_t index,
+                                                                 uint32_t* play_count,
+                                                                 uint64_t* frame_count,
+                                                                 double* average_frame_time);
+
+/**
+ * @brief Removes all recorded preset render statistics.
+ * @param instance The playlist manager instance.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_clear_stats(projectm_playlist_handle instance);
+
+/**
+ * @brief Saves the recorded preset render statistics to a file.
+ *
+ * The file is a plain text file with one line per preset.
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to write. An existing file will be overwritten.
+ * @return True if the file was written successfully, false if an error occurred.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_save_stats(projectm_playlist_handle instance,
+                                                           const char* filename);
+
+/**
+ * @brief Replaces the recorded preset render statistics with the contents of a file.
+ *
+ * If the file can't be read or has an unsupported format, the current statistics are kept.
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to read.
+ * @return True if the file was loaded successfully, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_load_stats(projectm_playlist_handle instance,
+                                                           const char* filename);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
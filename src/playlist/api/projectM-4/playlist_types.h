@@ -65,6 +65,29 @@ typedef enum
     SORT_ORDER_DESCENDING //!< Sort in alphabetically descending order.
 } projectm_playlist_sort_order;
 
+
+/**
+ * Scheduling behavior for presets exceeding the playlist frame budget.
+ * @since 4.2.0
+ */
+typedef enum
+{
+    COST_MODE_IGNORE,     //!< Ignore measured preset costs.
+    COST_MODE_SKIP,       //!< Skip presets exceeding the frame budget.
+    COST_MODE_DOWN_WEIGHT //!< Select presets exceeding the frame budget less often.
+} projectm_playlist_cost_mode;
+
+
+/**
+ * Preset selection behavior if shuffle is enabled.
+ * @since 4.2.0
+ */
+typedef enum
+{
+    SHUFFLE_MODE_RANDOM, //!< Select a uniformly random preset on each switch.
+    SHUFFLE_MODE_BAG     //!< Play each preset once in a random order before repeating any.
+} projectm_playlist_shuffle_mode;
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
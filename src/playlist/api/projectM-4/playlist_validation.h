@@ -0,0 +1,125 @@
+/**
+ * @file playlist_validation.h
+ * @copyright 2003-2025 projectM Team
+ * @brief Functions for checking playlist items in the background and removing broken presets.
+ * @since 4.2.0
+ *
+ * projectM -- Milkdrop-esque visualisation SDK
+ * Copyright (C)2003-2024 projectM Team
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ * See 'LICENSE.txt' included within this release
+ *
+ */
+
+#pragma once
+
+#include "projectM-4/playlist_types.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Starts checking all playlist items on a background thread.
+ *
+ * <p>Each item is checked with projectm_validate_preset_file() on the connected projectM instance,
+ * which parses the preset, compiles its expressions and translates its shaders without using
+ * OpenGL. Items which fail the check are removed from the playlist before the next preset switch,
+ * or when calling projectm_playlist_apply_validation_results().</p>
+ *
+ * <p>Results are cached by filename, file size and modification time. Files with unchanged size
+ * and contents are not checked again, even if the modification time changed. Use
+ * projectm_playlist_save_validation_cache() and projectm_playlist_load_validation_cache() to keep
+ * the cache across application runs.</p>
+ *
+ * <p>Items added after starting the validation are not checked. A running validation is
+ * restarted. Connecting the playlist to another projectM instance stops the validation.</p>
+ *
+ * @param instance The playlist manager instance.
+ * @return True if the validation was started, false if the playlist isn't connected to a
+ *         projectM instance or no thread could be started.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_start_validation(projectm_playlist_handle instance);
+
+/**
+ * @brief Stops the background validation and waits for the worker thread to exit.
+ *
+ * Invalid items found so far are still removed.
+ *
+ * @param instance The playlist manager instance.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT void projectm_playlist_stop_validation(projectm_playlist_handle instance);
+
+/**
+ * @brief Returns the progress of the current or last background validation.
+ * @param instance The playlist manager instance.
+ * @param[out] checked Receives the number of items checked so far. Can be NULL.
+ * @param[out] total Receives the number of items to check. Can be NULL.
+ * @return True if the validation is still running, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_get_validation_progress(projectm_playlist_handle instance,
+                                                                        uint32_t* checked,
+                                                                        uint32_t* total);
+
+/**
+ * @brief Removes all items found to be invalid so far from the playlist.
+ *
+ * This is done automatically before each preset switch. Call this function to update the playlist
+ * earlier, e.g. before displaying it. Must be called from the same thread as all other playlist
+ * functions.
+ *
+ * @param instance The playlist manager instance.
+ * @return The number of removed items.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT uint32_t projectm_playlist_apply_validation_results(projectm_playlist_handle instance);
+
+/**
+ * @brief Saves the cached validation results to a file.
+ *
+ * The file is a plain text file with one line per preset.
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to write. An existing file will be overwritten.
+ * @return True if the file was written successfully, false if an error occurred.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_save_validation_cache(projectm_playlist_handle instance,
+                                                                      const char* filename);
+
+/**
+ * @brief Replaces the cached validation results with the contents of a file.
+ *
+ * If the file can't be read or has an unsupported format, the current cache is kept. Should not
+ * be called while a validation is running.
+ *
+ * @param instance The playlist manager instance.
+ * @param filename The file to read.
+ * @return True if the file was loaded successfully, false if not.
+ * @since 4.2.0
+ */
+PROJECTM_PLAYLIST_EXPORT bool projectm_playlist_load_validation_cache(projectm_playlist_handle instance,
+                                                                      const char* filename);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
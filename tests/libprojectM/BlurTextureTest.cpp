@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <MilkdropPreset/BlurTexture.hpp>
+#include <MilkdropPreset/PerFrameContext.hpp>
+#include <MilkdropPreset/PresetState.hpp>
+
+#include <Renderer/OpenGL.h>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/Texture.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using libprojectM::MilkdropPreset::BlurTexture;
+using libprojectM::MilkdropPreset::PerFrameContext;
+using libprojectM::MilkdropPreset::PresetState;
+
+namespace {
+
+constexpr int sourceWidth{256};
+constexpr int sourceHeight{192};
+
+/**
+ * Renders the blur textures of a test image into offscreen textures with a surfaceless EGL context.
+ */
+class BlurTextureRendering : public EGLTestFixture
+{
+protected:
+    void SetUp() override
+    {
+        EGLTestFixture::SetUp();
+        if (IsSkipped())
+        {
+            return;
+        }
+
+        if (!LoadGLFunctions())
+        {
+            GTEST_SKIP() << "Unable to load the OpenGL functions.";
+        }
+
+        // Bright rectangles on a dark gradient, so the blur spreads hard edges of varying contrast.
+        std::vector<unsigned char> pixels(sourceWidth * sourceHeight * 4);
+        for (int y = 0; y < sourceHeight; y++)
+        {
+            for (int x = 0; x < sourceWidth; x++)
+            {
+                auto* pixel = &pixels[(y * sourceWidth + x) * 4];
+                bool const inRectangle = (x / 32 + y / 32) % 3 == 0;
+                pixel[0] = static_cast<unsigned char>(inRectangle ? 240 : x / 4);
+                pixel[1] = static_cast<unsigned char>(inRectangle ? 200 : y / 4);
+                pixel[2] = static_cast<unsigned char>(inRectangle ? 40 : 100);
+                pixel[3] = 255;
+            }
+        }
+        m_sourceTexture = std::make_shared<libprojectM::Renderer::Texture>("source", pixels.data(), GL_TEXTURE_2D, sourceWidth, sourceHeight, 0,
+                                                                           GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, false);
+    }
+
+    void TearDown() override
+    {
+        m_sourceTexture.reset();
+
+        EGLTestFixture::TearDown();
+    }
+
+    /**
+     * Renders the blur textures up to the given level and returns the contents of each blur texture.
+     */
+    auto Render(BlurTexture::Mode mode, BlurTexture::BlurLevel level) -> std::vector<std::vector<unsigned char>>
+    {
+        PresetState state;
+        state.renderContext.shaderCache = &m_shaderCache;
+
+        PerFrameContext perFrameContext(state.globalMemory, &state.globalRegisters);
+        perFrameContext.RegisterBuiltinVariables();
+        *perFrameContext.blur1_min = 0.0;
+        *perFrameContext.blur1_max = 1.0;
+        *perFrameContext.blur2_min = 0.0;
+        *perFrameContext.blur2_max = 1.0;
+        *perFrameContext.blur3_min = 0.0;
+        *perFrameContext.blur3_max = 1.0;
+        *perFrameContext.blur1_edge_darken = 0.25;
+
+        BlurTexture blurTexture;
+        blurTexture.Initialize(state.renderContext);
+        blurTexture.SetRequiredBlurLevel(level);
+        blurTexture.SetMode(mode);
+        blurTexture.Update(*m_sourceTexture, perFrameContext, level);
+
+        std::vector<std::vector<unsigned char>> blurPixels;
+        for (const auto& descriptor : blurTexture.GetDescriptorsForBlurLevel(level))
+        {
+            blurPixels.push_back(ReadTexture(*descriptor.Texture()));
+        }
+        EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+        return blurPixels;
+    }
+
+    /**
+     * Reads back the contents of the given texture.
+     */
+    static auto ReadTexture(const libprojectM::Renderer::Texture& texture) -> std::vector<unsigned char>
+    {
+        std::vector<unsigned char> pixels(static_cast<size_t>(texture.Width()) * static_cast<size_t>(texture.Height()) * 4);
+        if (texture.TextureID() == 0)
+        {
+            return {};
+        }
+
+        GLuint framebuffer{};
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.TextureID(), 0);
+        glReadPixels(0, 0, texture.Width(), texture.Height(), GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &framebuffer);
+
+        return pixels;
+    }
+
+    libprojectM::Renderer::ShaderCache m_shaderCache;
+    std::shared_ptr<libprojectM::Renderer::Texture> m_sourceTexture;
+};
+
+} // namespace
+
+TEST_F(BlurTextureRendering, FastBlurResemblesClassicBlur)
+{
+    auto classic = Render(BlurTexture::Mode::Classic, BlurTexture::BlurLevel::Blur3);
+    auto fast = Render(BlurTexture::Mode::Fast, BlurTexture::BlurLevel::Blur3);
+
+    ASSERT_EQ(classic.size(), 3);
+    ASSERT_EQ(fast.size(), 3);
+
+    for (size_t level = 0; level < classic.size(); level++)
+    {
+        SCOPED_TRACE("blur" + std::to_string(level + 1));
+        ASSERT_FALSE(classic[level].empty());
+        ASSERT_EQ(classic[level].size(), fast[level].size());
+
+        // Both filters have a slightly different shape, but have to produce a similar overall result.
+        long totalDifference{};
+        for (size_t index = 0; index < classic[level].size(); index++)
+        {
+            totalDifference += std::abs(classic[level][index] - fast[level][index]);
+        }
+        EXPECT_LE(totalDifference / static_cast<long>(classic[level].size()), 5);
+    }
+}
+
+TEST_F(BlurTextureRendering, SkipsUpdateWithoutBlurLevel)
+{
+    PresetState state;
+    state.renderContext.shaderCache = &m_shaderCache;
+    PerFrameContext perFrameContext(state.globalMemory, &state.globalRegisters);
+    perFrameContext.RegisterBuiltinVariables();
+
+    // The preset requested a blur level before, but no shader using it is drawn.
+    BlurTexture blurTexture;
+    blurTexture.Initialize(state.renderContext);
+    blurTexture.SetRequiredBlurLevel(BlurTexture::BlurLevel::Blur2);
+    blurTexture.Update(*m_sourceTexture, perFrameContext, BlurTexture::BlurLevel::None);
+
+    size_t bytesRead{};
+    size_t bytesWritten{};
+    blurTexture.LastUpdateBandwidth(bytesRead, bytesWritten);
+    EXPECT_EQ(blurTexture.TextureMemory(), 0);
+    EXPECT_EQ(bytesRead, 0);
+    EXPECT_EQ(bytesWritten, 0);
+
+    // Once rendered, the blur textures must not be touched by a frame which doesn't read them.
+    blurTexture.Update(*m_sourceTexture, perFrameContext, BlurTexture::BlurLevel::Blur2);
+    blurTexture.LastUpdateBandwidth(bytesRead, bytesWritten);
+    ASSERT_GT(bytesWritten, 0);
+
+    auto const descriptors = blurTexture.GetDescriptorsForBlurLevel(BlurTexture::BlurLevel::Blur2);
+    ASSERT_EQ(descriptors.size(), 2);
+    auto const blur2Pixels = ReadTexture(*descriptors[1].Texture());
+    ASSERT_FALSE(blur2Pixels.empty());
+
+    std::vector<unsigned char> blackPixels(sourceWidth * sourceHeight * 4);
+    libprojectM::Renderer::Texture blackTexture("black", blackPixels.data(), GL_TEXTURE_2D, sourceWidth, sourceHeight, 0,
+                                                GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, false);
+    blurTexture.Update(blackTexture, perFrameContext, BlurTexture::BlurLevel::None);
+
+    blurTexture.LastUpdateBandwidth(bytesRead, bytesWritten);
+    EXPECT_EQ(bytesRead, 0);
+    EXPECT_EQ(bytesWritten, 0);
+    EXPECT_EQ(ReadTexture(*descriptors[1].Texture()), blur2Pixels);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+}
+
+TEST_F(BlurTextureRendering, FastModeOnlyAllocatesSampledTextures)
+{
+    PresetState state;
+    state.renderContext.shaderCache = &m_shaderCache;
+    PerFrameContext perFrameContext(state.globalMemory, &state.globalRegisters);
+    perFrameContext.RegisterBuiltinVariables();
+
+    BlurTexture blurTexture;
+    blurTexture.Initialize(state.renderContext);
+    blurTexture.SetRequiredBlurLevel(BlurTexture::BlurLevel::Blur3);
+
+    // For the 256x192 source: blur1 is 64x48, blur2 32x24 and blur3 16x16.
+    // The classic blur also needs a 128x96 texture plus one more of each blur2 and blur3 size.
+    constexpr size_t fastBytes{(64 * 48 + 32 * 24 + 16 * 16) * 4};
+    constexpr size_t classicBytes{fastBytes + (128 * 96 + 32 * 24 + 16 * 16) * 4};
+
+    blurTexture.SetMode(BlurTexture::Mode::Fast);
+    blurTexture.Update(*m_sourceTexture, perFrameContext, BlurTexture::BlurLevel::Blur3);
+    EXPECT_EQ(blurTexture.TextureMemory(), fastBytes);
+
+    // Switching modes reallocates the textures.
+    blurTexture.SetMode(BlurTexture::Mode::Classic);
+    blurTexture.Update(*m_sourceTexture, perFrameContext, BlurTexture::BlurLevel::Blur3);
+    EXPECT_EQ(blurTexture.TextureMemory(), classicBytes);
+
+    blurTexture.SetMode(BlurTexture::Mode::Fast);
+    blurTexture.Update(*m_sourceTexture, perFrameContext, BlurTexture::BlurLevel::Blur3);
+    EXPECT_EQ(blurTexture.TextureMemory(), fastBytes);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <Renderer/Platform/GLResolver.hpp>
+#include <Renderer/Platform/GladLoader.hpp>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <array>
+
+/**
+ * Creates a surfaceless EGL display, as provided by Mesa, e.g. with the llvmpipe driver.
+ */
+inline auto CreateSurfacelessDisplay() -> EGLDisplay
+{
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay == nullptr)
+    {
+        return EGL_NO_DISPLAY;
+    }
+
+    auto display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr))
+    {
+        return EGL_NO_DISPLAY;
+    }
+
+    return display;
+}
+
+/**
+ * Creates an OpenGL 3.3 core or OpenGL ES 3.0 context without a surface.
+ */
+inline auto CreateContext(EGLDisplay display) -> EGLContext
+{
+#ifdef USE_GLES
+    eglBindAPI(EGL_OPENGL_ES_API);
+    const std::array<EGLint, 5> attributes{EGL_CONTEXT_MAJOR_VERSION, 3,
+                                           EGL_CONTEXT_MINOR_VERSION, 0,
+                                           EGL_NONE};
+#else
+    eglBindAPI(EGL_OPENGL_API);
+    const std::array<EGLint, 7> attributes{EGL_CONTEXT_MAJOR_VERSION, 3,
+                                           EGL_CONTEXT_MINOR_VERSION, 3,
+                                           EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                           EGL_NONE};
+#endif
+
+    return eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes.data());
+}
+
+/**
+ * OpenGL function loader for projectm_create_with_opengl_load_proc() and the GLResolver.
+ */
+inline auto LoadGLProc(const char* name, void*) -> void*
+{
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+/**
+ * Test fixture providing a surfaceless OpenGL context, which is current while each test runs.
+ *
+ * Tests are skipped if no context can be created. Derived fixtures call EGLTestFixture::SetUp()
+ * first and return early if IsSkipped() is true, and call EGLTestFixture::TearDown() last.
+ */
+class EGLTestFixture : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_display = CreateSurfacelessDisplay();
+        if (m_display == EGL_NO_DISPLAY)
+        {
+            GTEST_SKIP() << "No surfaceless EGL display available.";
+        }
+
+        m_context = CreateContext(m_display);
+        if (m_context != EGL_NO_CONTEXT && !eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, m_context))
+        {
+            eglDestroyContext(m_display, m_context);
+            m_context = EGL_NO_CONTEXT;
+        }
+        if (m_context == EGL_NO_CONTEXT)
+        {
+            GTEST_SKIP() << "Unable to create an OpenGL context.";
+        }
+    }
+
+    void TearDown() override
+    {
+        if (m_context != EGL_NO_CONTEXT)
+        {
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(m_display, m_context);
+            m_context = EGL_NO_CONTEXT;
+        }
+        if (m_display != EGL_NO_DISPLAY)
+        {
+            eglTerminate(m_display);
+            m_display = EGL_NO_DISPLAY;
+        }
+    }
+
+    /**
+     * Loads the OpenGL functions for tests using the renderer classes directly.
+     * @return True if the functions were loaded.
+     */
+    static auto LoadGLFunctions() -> bool
+    {
+        return libprojectM::Renderer::Platform::GLResolver::Instance().Initialize(LoadGLProc, nullptr) &&
+               libprojectM::Renderer::Platform::GladLoader::Instance().Initialize();
+    }
+
+    EGLDisplay m_display{EGL_NO_DISPLAY};
+    EGLContext m_context{EGL_NO_CONTEXT};
+};
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/EvalMemoryPool.hpp>
+
+#include <memory>
+#include <vector>
+
+using libprojectM::MilkdropPreset::EvalMemoryPool;
+
+namespace {
+
+/**
+ * Compiles and runs a line of expression code using the given global memory buffer.
+ */
+auto Execute(projectm_eval_mem_buffer buffer, const char* code) -> PRJM_EVAL_F
+{
+    PRJM_EVAL_F registers[100]{};
+    std::unique_ptr<projectm_eval_context, decltype(&projectm_eval_context_destroy)> context(
+        projectm_eval_context_create(buffer, &registers), &projectm_eval_context_destroy);
+    std::unique_ptr<projectm_eval_code, decltype(&projectm_eval_code_destroy)> compiledCode(
+        projectm_eval_code_compile(context.get(), code), &projectm_eval_code_destroy);
+    EXPECT_NE(compiledCode, nullptr);
+
+    return compiledCode ? projectm_eval_code_execute(compiledCode.get()) : 0.0;
+}
+
+} // namespace
+
+TEST(EvalMemoryPool, ReleasedBufferIsClearedAndReused)
+{
+    auto& pool = EvalMemoryPool::Instance();
+    pool.Clear();
+
+    auto* buffer = pool.Acquire();
+    ASSERT_NE(buffer, nullptr);
+    Execute(buffer, "gmegabuf(5) = 1; gmegabuf(1000000) = 2;");
+    EXPECT_EQ(Execute(buffer, "gmegabuf(5) + gmegabuf(1000000)"), 3.0);
+
+    pool.Release(buffer);
+    EXPECT_EQ(pool.PooledBuffers(), 1);
+
+    auto* reusedBuffer = pool.Acquire();
+    ASSERT_EQ(reusedBuffer, buffer);
+    EXPECT_EQ(pool.PooledBuffers(), 0);
+    EXPECT_EQ(Execute(reusedBuffer, "gmegabuf(5) + gmegabuf(1000000)"), 0.0);
+
+    pool.Release(reusedBuffer);
+    pool.Clear();
+}
+
+TEST(EvalMemoryPool, NullBufferIsIgnored)
+{
+    auto& pool = EvalMemoryPool::Instance();
+    pool.Clear();
+
+    pool.Release(nullptr);
+    EXPECT_EQ(pool.PooledBuffers(), 0);
+}
+
+TEST(EvalMemoryPool, PoolSizeIsLimited)
+{
+    auto& pool = EvalMemoryPool::Instance();
+    pool.Clear();
+
+    std::vector<projectm_eval_mem_buffer> buffers;
+    for (size_t index = 0; index < EvalMemoryPool::MaxPooledBuffers + 2; index++)
+    {
+        buffers.push_back(pool.Acquire());
+    }
+
+    for (auto* buffer : buffers)
+    {
+        pool.Release(buffer);
+    }
+
+    EXPECT_EQ(pool.PooledBuffers(), EvalMemoryPool::MaxPooledBuffers);
+
+    pool.Clear();
+    EXPECT_EQ(pool.PooledBuffers(), 0);
+}
@@ -0,0 +1,393 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/ExpressionOptimizer.hpp>
+
+#include <projectm-eval.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <regex>
+#include <set>
+#include <string>
+#include <vector>
+
+using libprojectM::MilkdropPreset::ExpressionOptimizer;
+
+namespace {
+
+/**
+ * Compiles code with projectm-eval and runs it with a separate set of variable values per code.
+ *
+ * All code shares a single expression context. Each compiled code has its own state, which is
+ * copied into the context variables before running the code and read back afterwards, so the
+ * original and the optimized code can be run side by side.
+ */
+class EvalRunner
+{
+public:
+    using State = std::map<std::string, PRJM_EVAL_F>;
+
+    EvalRunner()
+        : m_context(projectm_eval_context_create(nullptr, nullptr), &projectm_eval_context_destroy)
+    {
+    }
+
+    ~EvalRunner()
+    {
+        for (auto* code : m_code)
+        {
+            projectm_eval_code_destroy(code);
+        }
+    }
+
+    /**
+     * Compiles the code and registers all variables it references.
+     */
+    auto Compile(const std::string& code) -> projectm_eval_code*
+    {
+        auto* compiledCode = projectm_eval_code_compile(m_context.get(), code.c_str());
+        if (compiledCode == nullptr)
+        {
+            int line{};
+            int column{};
+            ADD_FAILURE() << "projectm-eval failed to compile:\n"
+                          << code << "\nError: " << projectm_eval_get_error(m_context.get(), &line, &column);
+            return nullptr;
+        }
+        m_code.push_back(compiledCode);
+
+        auto functions = FunctionNames(code);
+        for (const auto& identifier : ExpressionOptimizer::ReferencedIdentifiers(code))
+        {
+            if (functions.find(identifier) == functions.end())
+            {
+                m_variables[identifier] = projectm_eval_context_register_variable(m_context.get(), identifier.c_str());
+            }
+        }
+
+        return compiledCode;
+    }
+
+    /**
+     * Runs compiled code with the given state, updating it with the resulting variable values.
+     */
+    void Run(projectm_eval_code* code, State& state)
+    {
+        for (const auto& variable : m_variables)
+        {
+            *variable.second = state[variable.first];
+        }
+
+        projectm_eval_code_execute(code);
+
+        for (const auto& variable : m_variables)
+        {
+            state[variable.first] = *variable.second;
+        }
+    }
+
+private:
+    /**
+     * Returns the lower-case names of all identifiers followed by an opening parenthesis.
+     */
+    static auto FunctionNames(const std::string& code) -> std::set<std::string>
+    {
+        std::set<std::string> functions;
+        std::regex const functionCall("([A-Za-z_][A-Za-z_0-9]*)\\s*\\(");
+        for (auto match = std::sregex_iterator(code.begin(), code.end(), functionCall); match != std::sregex_iterator(); ++match)
+        {
+            auto name = (*match)[1].str();
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char character) {
+                return static_cast<char>(std::tolower(character));
+            });
+            functions.insert(name);
+        }
+        return functions;
+    }
+
+    std::unique_ptr<projectm_eval_context, decltype(&projectm_eval_context_destroy)> m_context; //!< The shared expression context.
+    std::vector<projectm_eval_code*> m_code;                                                     //!< All compiled code.
+    std::map<std::string, PRJM_EVAL_F*> m_variables;                                             //!< Registered context variables.
+};
+
+/**
+ * Returns the identifiers referenced by both the original and the optimized code.
+ *
+ * Removed dead stores leave their variable unchanged and hoisted values use new variables, so
+ * only these variables are expected to have the same values after running either code.
+ */
+auto SharedIdentifiers(const std::string& originalCode, const std::string& optimizedCode) -> std::set<std::string>
+{
+    auto originalIdentifiers = ExpressionOptimizer::ReferencedIdentifiers(originalCode);
+    auto optimizedIdentifiers = ExpressionOptimizer::ReferencedIdentifiers(optimizedCode);
+
+    std::set<std::string> sharedIdentifiers;
+    std::set_intersection(originalIdentifiers.begin(), originalIdentifiers.end(),
+                          optimizedIdentifiers.begin(), optimizedIdentifiers.end(),
+                          std::inserter(sharedIdentifiers, sharedIdentifiers.begin()));
+    return sharedIdentifiers;
+}
+
+/**
+ * Expects the given variables to have the same value in both states, within a small tolerance.
+ */
+void ExpectSameValues(const EvalRunner::State& original, const EvalRunner::State& optimized,
+                      const std::set<std::string>& variables, const std::string& context)
+{
+    for (const auto& variable : variables)
+    {
+        auto originalValue = original.find(variable);
+        auto optimizedValue = optimized.find(variable);
+        if (originalValue == original.end() || optimizedValue == optimized.end())
+        {
+            continue;
+        }
+
+        EXPECT_NEAR(originalValue->second, optimizedValue->second, 1e-9 * std::max(1.0, std::abs(originalValue->second)))
+            << "Variable " << variable << " " << context;
+    }
+}
+
+auto ParseCode(const std::string& code) -> ExpressionOptimizer
+{
+    ExpressionOptimizer optimizer;
+    EXPECT_TRUE(optimizer.Parse(code)) << code;
+    return optimizer;
+}
+
+const std::set<std::string> perFrameExternalVariables{
+    "zoom", "zoomexp", "rot", "warp", "cx", "cy", "dx", "dy", "sx", "sy",
+    "wave_r", "wave_g", "wave_b", "monitor", "q1", "q3"};
+
+const std::set<std::string> perPixelExternalVariables{
+    "zoom", "zoomexp", "rot", "warp", "cx", "cy", "dx", "dy", "sx", "sy"};
+
+const std::set<std::string> perVertexVariables{"x", "y", "rad", "ang"};
+
+const std::vector<std::string> perFrameInputs{"time", "frame", "fps", "bass", "mid", "treb", "bass_att", "mid_att", "treb_att"};
+
+const std::vector<std::string> perFrameCodeSamples{
+    "zoom = zoom + 0.1*sin(time*1.3) + 2*3*0.001; rot = rot*(1 + bass*0.1);\n"
+    "unused = bass*2; q1 = time; q2 = 5; tmp = 1; tmp = mid; dx = tmp*0.01;",
+
+    "t = t + 0.01 * (1 + treb_att); wave_r = 0.5 + 0.5*sin(t);\n"
+    "q3 = if(above(bass, 1), 1, 0); megabuf(0); x1 = rand(10); monitor = x1*0 + $PI;",
+
+    "// Comments are skipped\n"
+    "vol = (bass + mid + treb) / 3; /* block comment */ beat = vol > 1.2 && bass_att > 1;\n"
+    "cx = 0.5 + 0.1*sin(time*0.7); cy = 0.5 + 0.1*cos(time*0.6);\n"
+    "zoom = beat ? 1.1 : (0.99 + 0.01*max(vol, 0.5)); warp = -sqr(sin(1)) + abs(-2) * 0.1;",
+
+    "a = 1; b = (a = a + 1; a*2); sx = 1 + b*0.01; c = 5; c = 6; c = c + 1; sy = c*0.1;\n"
+    "count = 0; loop(3, count = count + 1; dy = dy + 0.001*count);"};
+
+const std::vector<std::string> perPixelCodeSamples{
+    "zoom = zoom + 0.05*sin(rad*10 + time*2) * (1 + q1); rot = rot + 0.02*cos(ang*3 - time) * bass_att;\n"
+    "dx = dx + 0.01*sin(y*6.28 + time)*treb; dummy = q2*3; c = cos(time*0.3)*0.5; sx = sx + c*x*0.1;",
+
+    "r = rad; i = 0; loop(3, i = i + 1; r = r*0.9 + sin(time)); zoom = zoom + (bass > 1 ? r*0.01 : -r*0.01);\n"
+    "warp = warp * (1 + 0.1*sin(time*1.7 + q3)) + pow(rad, 2) * min(bass, 2) * 0.01;",
+
+    "d = sqrt(sqr(x - 0.5) + sqr(y - 0.5)); cx = 0.5 + 0.1*sin(time); cy = cx;\n"
+    "dy = dy + if(below(d, 0.3), 0.01*cos(time*3)*mid, 0); rot = rot + zoomexp*0.001*sin(frame*0.01);"};
+
+} // namespace
+
+TEST(ExpressionOptimizer, ConstantsAreFolded)
+{
+    auto optimizer = ParseCode("zoom = 2*3 + sin(0) + max(1, 2.5); rot = -(4 - 1)*$pi*0; warp = 1/0;");
+    optimizer.FoldConstants();
+
+    EXPECT_EQ(optimizer.Code(), "zoom=8.5;\nrot=(-0);\nwarp=(1/0);\n");
+}
+
+TEST(ExpressionOptimizer, UnreadAssignmentsAreRemoved)
+{
+    auto optimizer = ParseCode("a = 5; zoom = (b = 2) * 3; c = rand(2); q2 = 1;");
+    optimizer.RemoveDeadStores({"zoom", "q1"});
+
+    EXPECT_EQ(optimizer.Code(), "zoom=(2*3);\nrand(2);\n");
+}
+
+TEST(ExpressionOptimizer, OverwrittenAssignmentsAreRemoved)
+{
+    auto optimizer = ParseCode("b = 1; b = 2; zoom = b; rot = 1; rot = rot + 1; reg00 = 1; reg00 = 2;");
+    optimizer.RemoveDeadStores({"zoom", "rot"});
+
+    EXPECT_EQ(optimizer.Code(), "b=2;\nzoom=b;\nrot=1;\nrot=(rot+1);\nreg00=2;\n");
+}
+
+TEST(ExpressionOptimizer, UserVariablesReadInLaterFramesAreKept)
+{
+    auto optimizer = ParseCode("zoom = t; t = t + 1;");
+    optimizer.RemoveDeadStores({"zoom"});
+
+    EXPECT_EQ(optimizer.Code(), "zoom=t;\nt=(t+1);\n");
+}
+
+TEST(ExpressionOptimizer, InvariantsAreHoisted)
+{
+    auto optimizer = ParseCode("zoom = zoom + sin(time)*x; c = cos(time); rot = c*rad + cos(time);");
+    auto prologue = optimizer.HoistInvariants(perVertexVariables);
+
+    EXPECT_EQ(prologue, "_ppinv0=sin(time);\n_ppinv1=cos(time);\n");
+    EXPECT_EQ(optimizer.Code(), "zoom=(zoom+(_ppinv0*x));\nc=_ppinv1;\nrot=((c*rad)+_ppinv1);\n");
+}
+
+TEST(ExpressionOptimizer, HoistedVariablesDontCollide)
+{
+    auto optimizer = ParseCode("_ppinv0 = 1; zoom = zoom * sin(time) * _ppinv0;");
+    auto prologue = optimizer.HoistInvariants(perVertexVariables);
+
+    EXPECT_EQ(prologue, "__ppinv0=sin(time);\n");
+}
+
+TEST(ExpressionOptimizer, SideEffectsAreNotHoisted)
+{
+    auto optimizer = ParseCode("zoom = zoom + rand(10)*0.01 + megabuf(time)*x;");
+    auto prologue = optimizer.HoistInvariants(perVertexVariables);
+
+    EXPECT_EQ(prologue, "");
+}
+
+TEST(ExpressionOptimizer, UnsupportedCodeIsNotChanged)
+{
+    ExpressionOptimizer optimizer;
+    for (const auto* code : {"zoom = $x10;", "zoom = 1e3;", "a = -b^2;", "a = b | c + 1;", "a = !b + 1;",
+                             "a = unknown(1);", "a = sin(1, 2);", "megabuf(1) = 2;", "a = b ? c = 1 : 2;",
+                             "a = b[1];", "a = \"text\";", "a = (1 + 2;"})
+    {
+        EXPECT_FALSE(optimizer.Parse(code)) << code;
+        EXPECT_EQ(ExpressionOptimizer::OptimizePerFrameCode(code, perFrameExternalVariables), code);
+    }
+}
+
+TEST(ExpressionOptimizer, ReferencedIdentifiers)
+{
+    auto identifiers = ExpressionOptimizer::ReferencedIdentifiers("ret = tex2D(sampler_main, uv).xyz * Q1 + _qb.x * 2.0f;");
+
+    EXPECT_EQ(identifiers, (std::set<std::string>{"ret", "tex2d", "sampler_main", "uv", "xyz", "q1", "_qb", "x"}));
+}
+
+TEST(ExpressionOptimizer, PerFrameCodeDifferential)
+{
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<double> inputDistribution(-2.0, 2.0);
+
+    for (const auto& code : perFrameCodeSamples)
+    {
+        auto optimizedCode = ExpressionOptimizer::OptimizePerFrameCode(code, perFrameExternalVariables);
+        ASSERT_NE(optimizedCode, code);
+
+        EvalRunner runner;
+        auto* original = runner.Compile(code);
+        auto* optimized = runner.Compile(optimizedCode);
+        ASSERT_NE(original, nullptr);
+        ASSERT_NE(optimized, nullptr);
+
+        auto sharedVariables = SharedIdentifiers(code, optimizedCode);
+        EvalRunner::State originalState;
+        EvalRunner::State optimizedState;
+
+        for (int frame = 0; frame < 50; frame++)
+        {
+            for (const auto& input : perFrameInputs)
+            {
+                auto value = inputDistribution(random);
+                originalState[input] = value;
+                optimizedState[input] = value;
+            }
+
+            runner.Run(original, originalState);
+            runner.Run(optimized, optimizedState);
+
+            ExpectSameValues(originalState, optimizedState, sharedVariables,
+                             "in frame " + std::to_string(frame) + " of code:\n" + code + "\nOptimized:\n" + optimizedCode);
+        }
+    }
+}
+
+TEST(ExpressionOptimizer, PerPixelCodeDifferential)
+{
+    std::mt19937 random(5678);
+    std::uniform_real_distribution<double> inputDistribution(-2.0, 2.0);
+    std::uniform_real_distribution<double> coordinateDistribution(0.0, 1.0);
+
+    for (const auto& code : perPixelCodeSamples)
+    {
+        std::string prologueCode;
+        auto optimizedCode = ExpressionOptimizer::OptimizePerPixelCode(code, perPixelExternalVariables, perVertexVariables, prologueCode);
+        ASSERT_FALSE(prologueCode.empty());
+
+        EvalRunner runner;
+        auto* original = runner.Compile(code);
+        auto* optimized = runner.Compile(optimizedCode);
+        auto* prologue = runner.Compile(prologueCode);
+        ASSERT_NE(original, nullptr);
+        ASSERT_NE(optimized, nullptr);
+        ASSERT_NE(prologue, nullptr);
+
+        auto sharedVariables = SharedIdentifiers(code, optimizedCode);
+        EvalRunner::State originalState;
+        EvalRunner::State optimizedState;
+
+        for (int frame = 0; frame < 10; frame++)
+        {
+            std::map<std::string, double> frameValues;
+            for (const auto& input : perFrameInputs)
+            {
+                frameValues[input] = inputDistribution(random);
+            }
+            for (const auto& input : perPixelExternalVariables)
+            {
+                frameValues[input] = inputDistribution(random);
+            }
+            for (const auto* input : {"q1", "q2", "q3"})
+            {
+                frameValues[input] = inputDistribution(random);
+            }
+
+            // Per-frame values stay set when the prologue runs, same as in PerPixelMesh.
+            for (const auto& value : frameValues)
+            {
+                originalState[value.first] = value.second;
+                optimizedState[value.first] = value.second;
+            }
+
+            runner.Run(prologue, optimizedState);
+
+            for (int vertex = 0; vertex < 20; vertex++)
+            {
+                std::map<std::string, double> vertexValues{
+                    {"x", coordinateDistribution(random)},
+                    {"y", coordinateDistribution(random)},
+                    {"rad", coordinateDistribution(random)},
+                    {"ang", inputDistribution(random)}};
+
+                for (auto* state : {&originalState, &optimizedState})
+                {
+                    for (const auto& value : vertexValues)
+                    {
+                        (*state)[value.first] = value.second;
+                    }
+                    for (const auto& variable : perPixelExternalVariables)
+                    {
+                        (*state)[variable] = frameValues[variable];
+                    }
+                }
+
+                runner.Run(original, originalState);
+                runner.Run(optimized, optimizedState);
+
+                ExpectSameValues(originalState, optimizedState, sharedVariables,
+                                 "in frame " + std::to_string(frame) + ", vertex " + std::to_string(vertex) + " of code:\n" +
+                                     code + "\nOptimized:\n" + prologueCode + optimizedCode);
+            }
+        }
+    }
+}
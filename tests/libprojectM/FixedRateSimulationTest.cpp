@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <Renderer/OpenGL.h>
+
+#include <projectM-4/audio.h>
+#include <projectM-4/core.h>
+#include <projectM-4/instrumentation.h>
+#include <projectM-4/parameters.h>
+#include <projectM-4/render_opengl.h>
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <vector>
+
+static constexpr auto fixedRateSimulationTestDataPath{PROJECTM_TEST_DATA_DIR "/MilkdropPresetValidation/"};
+
+namespace {
+
+constexpr int viewportSize{64};
+constexpr int displayRate{240};
+
+/**
+ * Renders display frames at the given frame times with a given simulation rate.
+ * @return The simulation statistics after the last frame.
+ */
+auto Render(uint32_t simulationRate, const std::vector<double>& frameTimes) -> projectm_simulation_stats
+{
+    projectm_simulation_stats stats{};
+
+    auto* projectM = projectm_create_with_opengl_load_proc(LoadGLProc, nullptr);
+    if (projectM == nullptr)
+    {
+        return stats;
+    }
+
+    GLuint texture{};
+    GLuint framebuffer{};
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, viewportSize, viewportSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+    projectm_set_simulation_rate(projectM, simulationRate);
+    projectm_set_window_size(projectM, viewportSize, viewportSize);
+    projectm_load_preset_file(projectM, (std::string(fixedRateSimulationTestDataPath) + "valid-v1.milk").c_str(), false);
+
+    std::array<float, 256> samples{};
+    for (size_t frame = 0; frame < frameTimes.size(); frame++)
+    {
+        for (size_t sample = 0; sample < samples.size(); sample++)
+        {
+            samples[sample] = std::sin(static_cast<float>(sample + frame) * 0.1f);
+        }
+        projectm_pcm_add_float(projectM, samples.data(), static_cast<unsigned int>(samples.size()), PROJECTM_MONO);
+        projectm_set_frame_time(projectM, frameTimes[frame]);
+        projectm_opengl_render_frame_fbo(projectM, framebuffer);
+    }
+
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+    projectm_get_simulation_stats(projectM, &stats);
+
+    projectm_destroy(projectM);
+
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &texture);
+
+    return stats;
+}
+
+/**
+ * Renders one second of 240 Hz display frames with a given simulation rate.
+ * @return The simulation statistics after the last frame.
+ */
+auto RenderSecond(uint32_t simulationRate) -> projectm_simulation_stats
+{
+    std::vector<double> frameTimes;
+    for (int frame = 1; frame <= displayRate; frame++)
+    {
+        frameTimes.push_back(static_cast<double>(frame) / static_cast<double>(displayRate));
+    }
+
+    return Render(simulationRate, frameTimes);
+}
+
+/**
+ * Provides a surfaceless OpenGL context for the projectM instances.
+ */
+class FixedRateSimulation : public EGLTestFixture
+{
+};
+
+} // namespace
+
+TEST_F(FixedRateSimulation, SimulatesEveryFrameByDefault)
+{
+    auto stats = RenderSecond(0);
+
+    EXPECT_EQ(stats.displayed_frames, displayRate);
+    EXPECT_EQ(stats.simulated_frames, displayRate);
+    EXPECT_DOUBLE_EQ(stats.simulation_ratio, 1.0);
+}
+
+TEST_F(FixedRateSimulation, SimulatesAtFixedRate)
+{
+    auto stats = RenderSecond(60);
+
+    EXPECT_EQ(stats.displayed_frames, displayRate);
+
+    // Rounding of the frame times may delay single steps by one display frame.
+    EXPECT_GE(stats.simulated_frames, 48);
+    EXPECT_LE(stats.simulated_frames, 61);
+    EXPECT_NEAR(stats.simulation_ratio, 0.25, 0.05);
+}
+
+TEST_F(FixedRateSimulation, SimulatedTimeFollowsUnevenFrameTimes)
+{
+    // Frame times both shorter and longer than the simulation interval.
+    const std::array<double, 4> frameDurations{1.0 / 240.0, 1.0 / 25.0, 1.0 / 144.0, 1.0 / 50.0};
+
+    std::vector<double> frameTimes;
+    double wallTime{};
+    for (int frame = 0; frame < 200; frame++)
+    {
+        wallTime += frameDurations[frame % frameDurations.size()];
+        frameTimes.push_back(wallTime);
+    }
+
+    auto stats = Render(60, frameTimes);
+
+    EXPECT_EQ(stats.displayed_frames, frameTimes.size());
+    EXPECT_LT(stats.simulated_frames, stats.displayed_frames);
+
+    // Only the time accumulated for the next step is missing, at most one simulation interval.
+    // The small tolerance covers the clock reading taken when the instance was created.
+    EXPECT_LE(stats.simulated_seconds, wallTime + 0.001);
+    EXPECT_GE(stats.simulated_seconds, wallTime - 1.0 / 60.0 - 0.001);
+}
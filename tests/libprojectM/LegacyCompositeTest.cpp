@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <MilkdropPreset/Filters.hpp>
+#include <MilkdropPreset/PresetState.hpp>
+#include <MilkdropPreset/VideoEcho.hpp>
+
+#include <Renderer/Framebuffer.hpp>
+#include <Renderer/OpenGL.h>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/Texture.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+using libprojectM::MilkdropPreset::Filters;
+using libprojectM::MilkdropPreset::PresetState;
+using libprojectM::MilkdropPreset::VideoEcho;
+
+namespace {
+
+constexpr int viewportSize{64};
+
+/**
+ * Video echo, gamma and filter settings of a preset without a composite shader.
+ */
+struct LegacyCompositeSettings {
+    std::string name;
+    float videoEchoAlpha{};
+    float videoEchoZoom{1.0f};
+    int videoEchoOrientation{};
+    float gammaAdj{1.0f};
+    bool brighten{};
+    bool darken{};
+    bool solarize{};
+    bool invert{};
+};
+
+/**
+ * Renders the video echo and filters into an offscreen framebuffer with a surfaceless EGL context.
+ */
+class LegacyComposite : public EGLTestFixture
+{
+protected:
+    void SetUp() override
+    {
+        EGLTestFixture::SetUp();
+        if (IsSkipped())
+        {
+            return;
+        }
+
+        if (!LoadGLFunctions())
+        {
+            GTEST_SKIP() << "Unable to load the OpenGL functions.";
+        }
+
+        // A gradient in each color channel, so both the echo sampling and the color math are tested.
+        std::vector<unsigned char> pixels(viewportSize * viewportSize * 4);
+        for (int y = 0; y < viewportSize; y++)
+        {
+            for (int x = 0; x < viewportSize; x++)
+            {
+                auto* pixel = &pixels[(y * viewportSize + x) * 4];
+                pixel[0] = static_cast<unsigned char>(x * 4);
+                pixel[1] = static_cast<unsigned char>(y * 4);
+                pixel[2] = static_cast<unsigned char>((x + y) * 2);
+                pixel[3] = 255;
+            }
+        }
+        m_inputTexture = std::make_shared<libprojectM::Renderer::Texture>("input", pixels.data(), GL_TEXTURE_2D, viewportSize, viewportSize, 0,
+                                                                          GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, false);
+    }
+
+    void TearDown() override
+    {
+        m_inputTexture.reset();
+
+        EGLTestFixture::TearDown();
+    }
+
+    /**
+     * Renders the effects either with the single-pass shader or the original blending passes.
+     */
+    auto Render(const LegacyCompositeSettings& settings, bool singlePass) -> std::vector<unsigned char>
+    {
+        PresetState state;
+        state.renderContext.viewportSizeX = viewportSize;
+        state.renderContext.viewportSizeY = viewportSize;
+        state.renderContext.time = 12.5f;
+        state.renderContext.shaderCache = &m_shaderCache;
+        state.LoadShaders();
+        state.mainTexture = m_inputTexture;
+
+        // Use the same hue animation in both renders.
+        state.hueRandomOffsets = {1.0f, 2.0f, 3.0f, 4.0f};
+
+        state.videoEchoAlpha = settings.videoEchoAlpha;
+        state.videoEchoZoom = settings.videoEchoZoom;
+        state.videoEchoOrientation = settings.videoEchoOrientation;
+        state.gammaAdj = settings.gammaAdj;
+        state.brighten = settings.brighten;
+        state.darken = settings.darken;
+        state.solarize = settings.solarize;
+        state.invert = settings.invert;
+
+        libprojectM::Renderer::Framebuffer framebuffer(1);
+        framebuffer.CreateColorAttachment(0, 0);
+        framebuffer.SetSize(viewportSize, viewportSize);
+        framebuffer.Bind(0);
+        glViewport(0, 0, viewportSize, viewportSize);
+
+        VideoEcho videoEcho(state);
+        Filters filters(state);
+        if (singlePass)
+        {
+            videoEcho.CompileShader();
+        }
+
+        bool const filtersApplied = videoEcho.Draw();
+        EXPECT_EQ(filtersApplied, singlePass);
+        if (!filtersApplied)
+        {
+            filters.Draw();
+        }
+
+        std::vector<unsigned char> pixels(viewportSize * viewportSize * 4);
+        glReadPixels(0, 0, viewportSize, viewportSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+        return pixels;
+    }
+
+    libprojectM::Renderer::ShaderCache m_shaderCache;
+    std::shared_ptr<libprojectM::Renderer::Texture> m_inputTexture;
+};
+
+} // namespace
+
+TEST_F(LegacyComposite, SinglePassMatchesBlendingPasses)
+{
+    const std::vector<LegacyCompositeSettings> settingsList{
+        {"gamma", 0.0f, 1.0f, 0, 1.7f},
+        {"high gamma", 0.0f, 1.0f, 0, 2.6f},
+        {"echo", 0.4f, 1.3f, 0, 1.0f},
+        {"echo flipped", 0.5f, 0.8f, 3, 1.0f},
+        {"echo with gamma", 0.3f, 2.0f, 1, 2.4f},
+        {"brighten", 0.0f, 1.0f, 0, 1.0f, true},
+        {"darken", 0.0f, 1.0f, 0, 1.0f, false, true},
+        {"solarize", 0.0f, 1.0f, 0, 1.0f, false, false, true},
+        {"invert", 0.0f, 1.0f, 0, 1.0f, false, false, false, true},
+        {"all effects", 0.5f, 1.5f, 2, 1.5f, true, true, true, true},
+    };
+
+    for (const auto& settings : settingsList)
+    {
+        SCOPED_TRACE(settings.name);
+
+        auto blended = Render(settings, false);
+        auto singlePass = Render(settings, true);
+
+        // The blending passes round to 8 bits after each pass, the single pass only once.
+        int maxDifference{};
+        for (size_t index = 0; index < blended.size(); index++)
+        {
+            maxDifference = std::max(maxDifference, std::abs(blended[index] - singlePass[index]));
+        }
+        EXPECT_LE(maxDifference, 6);
+    }
+}
+
+TEST_F(LegacyComposite, ShaderIsSharedPerEffectCombination)
+{
+    LegacyCompositeSettings settings{"echo brighten", 0.5f, 1.5f, 0, 1.0f, true};
+    Render(settings, true);
+    EXPECT_NE(m_shaderCache.Get("milkdrop_legacy_composite_VIDEO_ECHO_BRIGHTEN"), nullptr);
+    EXPECT_EQ(m_shaderCache.Get("milkdrop_legacy_composite_INVERT"), nullptr);
+}
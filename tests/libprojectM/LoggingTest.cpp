@@ -4,6 +4,9 @@
 #include <Logging.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
 #include <thread>
 
 using libprojectM::Logging;
@@ -13,6 +16,7 @@ class LoggingTest : public ::testing::Test
 protected:
     void SetUp() override
     {
+        Logging::SetMode(Logging::Mode::Synchronous);
         Logging::SetThreadCallback({});
         Logging::SetGlobalCallback({});
         Logging::SetThreadLogLevel(Logging::LogLevel::NotSet);
@@ -20,6 +24,12 @@ protected:
 
         m_logFlag1 = false;
         m_logFlag2 = false;
+        m_logCount = 0;
+    }
+
+    void TearDown() override
+    {
+        Logging::SetMode(Logging::Mode::Synchronous);
     }
 
     static void loggingCallback1(const char*, int, void*)
@@ -32,8 +42,14 @@ protected:
         m_logFlag2 = true;
     }
 
+    static void countingCallback(const char*, int, void*)
+    {
+        m_logCount++;
+    }
+
     static std::atomic_bool m_logFlag1;
     static std::atomic_bool m_logFlag2;
+    static std::atomic_int m_logCount;
 
     static std::atomic_int m_logSeverity1;
     static std::atomic_int m_logSeverity2;
@@ -41,6 +57,7 @@ protected:
 
 std::atomic_bool LoggingTest::m_logFlag1{};
 std::atomic_bool LoggingTest::m_logFlag2{};
+std::atomic_int LoggingTest::m_logCount{};
 
 std::atomic_int LoggingTest::m_logSeverity1{};
 std::atomic_int LoggingTest::m_logSeverity2{};
@@ -283,4 +300,172 @@ TEST_P(LoggingTestWithLevels, LogLevelThreadAndGlobal)
     }
 }
 
+TEST_F(LoggingTest, QueuedModeDeliversOnFlush)
+{
+    Logging::SetGlobalCallback({&LoggingTest::countingCallback, nullptr});
+    Logging::SetMode(Logging::Mode::Queued);
+
+    Logging::Log("Test 1", Logging::LogLevel::Information);
+    Logging::Log("Test 2", Logging::LogLevel::Information);
+    Logging::Log("Test 3", Logging::LogLevel::Information);
+    EXPECT_EQ(m_logCount, 0);
+
+    EXPECT_EQ(Logging::Flush(), 3U);
+    EXPECT_EQ(m_logCount, 3);
+
+    EXPECT_EQ(Logging::Flush(), 0U);
+}
+
+TEST_F(LoggingTest, QueuedModeKeepsMessageAndSeverity)
+{
+    static std::string logMessage;
+    static Logging::LogLevel logLevel;
+
+    const Logging::CallbackFunction logCallback = [](const char* message, int level, void*) -> void {
+        logMessage = message;
+        logLevel = static_cast<Logging::LogLevel>(level);
+    };
+
+    Logging::SetGlobalCallback({logCallback, nullptr});
+    Logging::SetMode(Logging::Mode::Queued);
+    logMessage = {};
+
+    Logging::Log("This is a test message", Logging::LogLevel::Warning);
+    Logging::Flush();
+
+    EXPECT_EQ(logMessage, "This is a test message");
+    EXPECT_EQ(logLevel, Logging::LogLevel::Warning);
+}
+
+TEST_F(LoggingTest, QueuedModeUsesCallbackOfLoggingThread)
+{
+    Logging::SetGlobalCallback({&LoggingTest::loggingCallback1, nullptr});
+    Logging::SetMode(Logging::Mode::Queued);
+
+    {
+        auto loggingThreadFunc = [&]() -> void {
+            Logging::SetThreadCallback({&LoggingTest::loggingCallback2, nullptr});
+            Logging::Log("Test", Logging::LogLevel::Information);
+        };
+
+        std::thread loggingThread{loggingThreadFunc};
+        loggingThread.join();
+    }
+
+    EXPECT_FALSE(m_logFlag2);
+
+    // The thread callback registered by the logging thread is called on this thread.
+    Logging::Flush();
+    EXPECT_FALSE(m_logFlag1);
+    EXPECT_TRUE(m_logFlag2);
+}
+
+TEST_F(LoggingTest, QueueOverflowDropsMessages)
+{
+    Logging::SetGlobalCallback({&LoggingTest::countingCallback, nullptr});
+    Logging::SetMode(Logging::Mode::Queued);
+
+    auto droppedBefore = Logging::DroppedMessages();
+    for (int index = 0; index < 300; index++)
+    {
+        Logging::Log("Test", Logging::LogLevel::Information);
+    }
+
+    EXPECT_EQ(Logging::Flush(), 256U);
+    EXPECT_EQ(Logging::DroppedMessages() - droppedBefore, 44U);
+
+    // After flushing, the queue accepts messages again.
+    Logging::Log("Test", Logging::LogLevel::Information);
+    EXPECT_EQ(Logging::Flush(), 1U);
+    EXPECT_EQ(m_logCount, 257);
+}
+
+TEST_F(LoggingTest, QueuedModeTruncatesLongMessages)
+{
+    static std::string logMessage;
+
+    const Logging::CallbackFunction logCallback = [](const char* message, int, void*) -> void {
+        logMessage = message;
+    };
+
+    Logging::SetGlobalCallback({logCallback, nullptr});
+    Logging::SetMode(Logging::Mode::Queued);
+
+    Logging::Log(std::string(1000, 'x'), Logging::LogLevel::Information);
+    Logging::Flush();
+
+    EXPECT_EQ(logMessage, std::string(511, 'x'));
+}
+
+TEST_F(LoggingTest, SwitchingToSynchronousDeliversPendingMessages)
+{
+    Logging::SetGlobalCallback({&LoggingTest::countingCallback, nullptr});
+    Logging::SetMode(Logging::Mode::Queued);
+
+    Logging::Log("Test", Logging::LogLevel::Information);
+    Logging::Log("Test", Logging::LogLevel::Information);
+    EXPECT_EQ(m_logCount, 0);
+
+    Logging::SetMode(Logging::Mode::Synchronous);
+    EXPECT_EQ(m_logCount, 2);
+
+    Logging::Log("Test", Logging::LogLevel::Information);
+    EXPECT_EQ(m_logCount, 3);
+}
+
+TEST_F(LoggingTest, BackgroundModeDeliversMessages)
+{
+    Logging::SetGlobalCallback({&LoggingTest::countingCallback, nullptr});
+    Logging::SetMode(Logging::Mode::Background);
+    EXPECT_EQ(Logging::GetMode(), Logging::Mode::Background);
+
+    for (int index = 0; index < 10; index++)
+    {
+        Logging::Log("Test", Logging::LogLevel::Information);
+    }
+
+    auto waitStart = std::chrono::steady_clock::now();
+    while (m_logCount < 10 && std::chrono::steady_clock::now() - waitStart < std::chrono::seconds(5))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_EQ(m_logCount, 10);
+}
+
+/**
+ * Logging cost per message on the calling thread with a blocking callback, synchronous vs. queued.
+ * Only prints timings, so it isn't run by default. Run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(LoggingTest, DISABLED_QueuedLoggingBenchmark)
+{
+    constexpr int messageCount{200};
+
+    // Simulates a callback writing to a socket which occasionally blocks.
+    const Logging::CallbackFunction blockingCallback = [](const char*, int, void*) -> void {
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    };
+    Logging::SetGlobalCallback({blockingCallback, nullptr});
+
+    const std::string message{"[TextureManager] Loading texture file: /usr/share/projectM/textures/example.jpg"};
+
+    auto measure = [&message]() {
+        auto start = std::chrono::steady_clock::now();
+        for (int index = 0; index < messageCount; index++)
+        {
+            Logging::Log(message, Logging::LogLevel::Information);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / messageCount;
+    };
+
+    auto synchronousTime = measure();
+
+    Logging::SetMode(Logging::Mode::Queued);
+    auto queuedTime = measure();
+    EXPECT_EQ(Logging::Flush(), static_cast<size_t>(messageCount));
+
+    std::cout << "[ BENCHMARK ] Logging thread cost per message: synchronous " << synchronousTime
+              << " ns, queued " << queuedTime << " ns" << std::endl;
+}
+
 INSTANTIATE_TEST_SUITE_P(LogLevel, LoggingTestWithLevels, testing::Values(Logging::LogLevel::NotSet, Logging::LogLevel::Trace, Logging::LogLevel::Debug, Logging::LogLevel::Information, Logging::LogLevel::Warning, Logging::LogLevel::Error, Logging::LogLevel::Fatal));
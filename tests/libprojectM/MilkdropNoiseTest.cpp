@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <Renderer/MilkdropNoise.hpp>
+
+#include <future>
+#include <vector>
+
+using libprojectM::Renderer::MilkdropNoise;
+
+TEST(MilkdropNoise, GeneratesTextureDimensions)
+{
+    auto lowQuality = MilkdropNoise::Generate(MilkdropNoise::Type::LowQuality);
+    EXPECT_EQ(lowQuality.name, "noise_lq");
+    EXPECT_EQ(lowQuality.target, static_cast<GLenum>(GL_TEXTURE_2D));
+    EXPECT_EQ(lowQuality.size, 256);
+    EXPECT_EQ(lowQuality.pixels.size(), 256 * 256);
+
+    auto lowQualityLite = MilkdropNoise::Generate(MilkdropNoise::Type::LowQualityLite);
+    EXPECT_EQ(lowQualityLite.name, "noise_lq_lite");
+    EXPECT_EQ(lowQualityLite.size, 32);
+    EXPECT_EQ(lowQualityLite.pixels.size(), 32 * 32);
+
+    auto highQualityVolume = MilkdropNoise::Generate(MilkdropNoise::Type::HighQualityVolume);
+    EXPECT_EQ(highQualityVolume.name, "noisevol_hq");
+    EXPECT_EQ(highQualityVolume.target, static_cast<GLenum>(GL_TEXTURE_3D));
+    EXPECT_EQ(highQualityVolume.size, 32);
+    EXPECT_EQ(highQualityVolume.pixels.size(), 32 * 32 * 32);
+}
+
+TEST(MilkdropNoise, ConcurrentlyGeneratedTexturesDiffer)
+{
+    // The textures are generated on worker threads at the same time, so each needs its own seed.
+    std::vector<std::future<MilkdropNoise::Data>> pendingTextures;
+    for (int index = 0; index < 4; index++)
+    {
+        pendingTextures.push_back(std::async(std::launch::async, &MilkdropNoise::Generate, MilkdropNoise::Type::HighQuality));
+    }
+
+    std::vector<MilkdropNoise::Data> textures;
+    for (auto& pendingTexture : pendingTextures)
+    {
+        textures.push_back(pendingTexture.get());
+    }
+
+    for (size_t first = 0; first < textures.size(); first++)
+    {
+        for (size_t second = first + 1; second < textures.size(); second++)
+        {
+            EXPECT_NE(textures[first].pixels, textures[second].pixels);
+        }
+    }
+}
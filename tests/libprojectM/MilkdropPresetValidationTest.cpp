@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/Factory.hpp>
+#include <MilkdropPreset/MilkdropPreset.hpp>
+#include <MilkdropPreset/MilkdropPresetExceptions.hpp>
+#include <MilkdropPreset/MilkdropShader.hpp>
+
+#include <Renderer/Shader.hpp>
+
+static constexpr auto validationTestDataPath{PROJECTM_TEST_DATA_DIR "/MilkdropPresetValidation/"};
+
+using libprojectM::MilkdropPreset::Factory;
+using libprojectM::MilkdropPreset::MilkdropPreset;
+using libprojectM::MilkdropPreset::MilkdropPresetLoadException;
+using libprojectM::MilkdropPreset::MilkdropShader;
+using libprojectM::Renderer::ShaderException;
+
+TEST(MilkdropPresetValidation, MissingFile)
+{
+    EXPECT_THROW(MilkdropPreset::Validate(std::string(validationTestDataPath) + "does-not-exist.milk"), MilkdropPresetLoadException);
+}
+
+TEST(MilkdropPresetValidation, ValidPresetWithoutShaders)
+{
+    EXPECT_NO_THROW(MilkdropPreset::Validate(std::string(validationTestDataPath) + "valid-v1.milk"));
+}
+
+TEST(MilkdropPresetValidation, ValidPresetWithShaders)
+{
+    EXPECT_NO_THROW(MilkdropPreset::Validate(std::string(validationTestDataPath) + "valid-v2-shaders.milk"));
+}
+
+TEST(MilkdropPresetValidation, InvalidCompositeShader)
+{
+    EXPECT_THROW(MilkdropPreset::Validate(std::string(validationTestDataPath) + "invalid-comp-shader.milk"), ShaderException);
+}
+
+TEST(MilkdropPresetValidation, ShadersIgnoredInVersion1Presets)
+{
+    EXPECT_NO_THROW(MilkdropPreset::Validate(std::string(validationTestDataPath) + "invalid-shader-v1.milk"));
+}
+
+TEST(MilkdropPresetValidation, ShaderValidate)
+{
+    EXPECT_NO_THROW(MilkdropShader::Validate(MilkdropShader::ShaderType::WarpShader,
+                                             "shader_body\n{\n    ret = tex2D(sampler_fw_main, uv).xyz;\n}\n"));
+    EXPECT_THROW(MilkdropShader::Validate(MilkdropShader::ShaderType::WarpShader,
+                                          "shader_body\n{\n    ret = undeclared_function(uv);\n}\n"),
+                 ShaderException);
+}
+
+TEST(MilkdropPresetValidation, FactoryProtocols)
+{
+    Factory factory;
+
+    EXPECT_NO_THROW(factory.ValidatePresetFile("idle://Some Preset.milk"));
+    EXPECT_NO_THROW(factory.ValidatePresetFile("file://" + std::string(validationTestDataPath) + "valid-v1.milk"));
+    EXPECT_THROW(factory.ValidatePresetFile("http://example.com/preset.milk"), std::exception);
+}
+
+TEST(MilkdropPresetValidation, ReadMetadata)
+{
+    auto metadata = MilkdropPreset::ReadMetadata(std::string(validationTestDataPath) + "metadata-v2.milk");
+
+    EXPECT_TRUE(metadata.hasWarpShader);
+    EXPECT_TRUE(metadata.hasCompositeShader);
+    EXPECT_TRUE(metadata.hasPerPixelCode);
+    EXPECT_EQ(metadata.customWaveCount, 2);
+    EXPECT_EQ(metadata.maxWaveSamples, 512);
+    EXPECT_EQ(metadata.customShapeCount, 2);
+    EXPECT_EQ(metadata.maxShapeInstances, 16);
+    EXPECT_EQ(metadata.blurLevel, 2);
+    EXPECT_EQ(metadata.textures, std::vector<std::string>({"clouds", "noise_lq"}));
+    EXPECT_GT(metadata.parseTime, 0.0);
+    EXPECT_GT(metadata.shaderTranslationTime, 0.0);
+}
+
+TEST(MilkdropPresetValidation, ReadMetadataWithoutShaders)
+{
+    auto metadata = MilkdropPreset::ReadMetadata(std::string(validationTestDataPath) + "invalid-shader-v1.milk");
+
+    EXPECT_FALSE(metadata.hasWarpShader);
+    EXPECT_FALSE(metadata.hasCompositeShader);
+    EXPECT_EQ(metadata.blurLevel, 0);
+    EXPECT_TRUE(metadata.textures.empty());
+    EXPECT_EQ(metadata.shaderTranslationTime, 0.0);
+}
+
+TEST(MilkdropPresetValidation, ReadMetadataKeepsUntranslatableShaders)
+{
+    auto metadata = MilkdropPreset::ReadMetadata(std::string(validationTestDataPath) + "invalid-comp-shader.milk");
+
+    EXPECT_TRUE(metadata.hasCompositeShader);
+}
+
+TEST(MilkdropPresetValidation, ReadMetadataMissingFile)
+{
+    EXPECT_THROW(MilkdropPreset::ReadMetadata(std::string(validationTestDataPath) + "does-not-exist.milk"), MilkdropPresetLoadException);
+}
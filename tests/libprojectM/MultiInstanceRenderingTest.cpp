@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <Renderer/OpenGL.h>
+
+#include <projectM-4/audio.h>
+#include <projectM-4/core.h>
+#include <projectM-4/logging.h>
+#include <projectM-4/parameters.h>
+#include <projectM-4/render_opengl.h>
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+static constexpr auto multiInstanceTestDataPath{PROJECTM_TEST_DATA_DIR "/MilkdropPresetValidation/"};
+
+namespace {
+
+constexpr int instanceCount{8};
+constexpr int frameCount{30};
+constexpr int viewportSize{64};
+
+/**
+ * Renders a preset with its own GL context and projectM instance on the calling thread.
+ *
+ * Frame times, random seed and audio only depend on the instance index, so the image is the same
+ * no matter which other instances render at the same time.
+ *
+ * @return The framebuffer contents after the last frame, or an empty vector if rendering failed.
+ */
+auto RenderInstance(EGLDisplay display, int instanceIndex) -> std::vector<unsigned char>
+{
+    auto context = CreateContext(display);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+    {
+        return {};
+    }
+
+    std::vector<unsigned char> pixels;
+
+    auto* projectM = projectm_create_with_opengl_load_proc(LoadGLProc, nullptr);
+
+    if (projectM != nullptr)
+    {
+        GLuint texture{};
+        GLuint framebuffer{};
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, viewportSize, viewportSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+        projectm_set_random_seed(projectM, static_cast<uint64_t>(instanceIndex) + 1);
+        projectm_set_window_size(projectM, viewportSize, viewportSize);
+        projectm_load_preset_file(projectM, (std::string(multiInstanceTestDataPath) + "valid-v2-shaders.milk").c_str(), false);
+
+        std::array<float, 512> samples{};
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            for (size_t sample = 0; sample < samples.size(); sample++)
+            {
+                samples[sample] = std::sin(static_cast<float>(sample + frame * instanceIndex) * 0.1f);
+            }
+            projectm_pcm_add_float(projectM, samples.data(), static_cast<unsigned int>(samples.size()), PROJECTM_MONO);
+            projectm_set_frame_time(projectM, static_cast<double>(frame) / 60.0);
+            projectm_opengl_render_frame_fbo(projectM, framebuffer);
+        }
+
+        std::vector<unsigned char> framebufferPixels(viewportSize * viewportSize * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glReadPixels(0, 0, viewportSize, viewportSize, GL_RGBA, GL_UNSIGNED_BYTE, framebufferPixels.data());
+        if (glGetError() == GL_NO_ERROR)
+        {
+            pixels = std::move(framebufferPixels);
+        }
+
+        projectm_destroy(projectM);
+
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+    }
+
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, context);
+
+    return pixels;
+}
+
+/**
+ * Checks if any color channel of the image is not black.
+ */
+auto HasImageContent(const std::vector<unsigned char>& pixels) -> bool
+{
+    for (size_t index = 0; index < pixels.size(); index += 4)
+    {
+        if (pixels[index] != 0 || pixels[index + 1] != 0 || pixels[index + 2] != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Counts the log messages passed to it in the int pointed to by the user data.
+ */
+void CountLogMessages(const char*, projectm_log_level, void* userData)
+{
+    (*static_cast<int*>(userData))++;
+}
+
+/**
+ * Provides the EGL display the instance threads create their contexts on.
+ */
+class MultiInstanceRendering : public EGLTestFixture
+{
+};
+
+} // namespace
+
+TEST_F(MultiInstanceRendering, InstancesRenderConcurrently)
+{
+    std::vector<std::vector<unsigned char>> concurrentPixels(instanceCount);
+    std::vector<std::thread> threads;
+    for (int instance = 0; instance < instanceCount; instance++)
+    {
+        threads.emplace_back([this, instance, &concurrentPixels]() {
+            concurrentPixels[instance] = RenderInstance(m_display, instance);
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Each instance must render the same image as when rendering alone.
+    for (int instance = 0; instance < instanceCount; instance++)
+    {
+        SCOPED_TRACE("Instance " + std::to_string(instance));
+
+        ASSERT_EQ(concurrentPixels[instance].size(), viewportSize * viewportSize * 4);
+        EXPECT_TRUE(HasImageContent(concurrentPixels[instance]));
+
+        auto singlePixels = RenderInstance(m_display, instance);
+        ASSERT_EQ(singlePixels.size(), concurrentPixels[instance].size());
+        EXPECT_TRUE(singlePixels == concurrentPixels[instance]);
+    }
+}
+
+TEST_F(MultiInstanceRendering, DestroyDeliversQueuedLogMessages)
+{
+    int messageCount{};
+    projectm_set_log_callback(&CountLogMessages, false, &messageCount);
+    projectm_set_log_mode(PROJECTM_LOG_MODE_QUEUED);
+
+    auto* projectM = projectm_create_with_opengl_load_proc(LoadGLProc, nullptr);
+    ASSERT_NE(projectM, nullptr);
+
+    // Loading a missing file logs an error.
+    projectm_load_preset_file(projectM, "/nonexistent/preset.milk", false);
+    projectm_destroy(projectM);
+
+    // The callback data may be freed right after destroying the instance, so nothing may be left in the queue.
+    EXPECT_GT(messageCount, 0);
+    EXPECT_EQ(projectm_flush_logs(), 0U);
+
+    projectm_set_log_mode(PROJECTM_LOG_MODE_SYNCHRONOUS);
+    projectm_set_log_callback(nullptr, false, nullptr);
+}
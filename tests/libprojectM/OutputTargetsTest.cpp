@@ -0,0 +1,230 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <Renderer/OpenGL.h>
+
+#include <projectM-4/audio.h>
+#include <projectM-4/core.h>
+#include <projectM-4/parameters.h>
+#include <projectM-4/render_opengl.h>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static constexpr auto outputTargetsTestDataPath{PROJECTM_TEST_DATA_DIR "/RenderTargetQuality/"};
+
+namespace {
+
+constexpr int frameCount{10};
+constexpr int viewportSize{256};
+
+/**
+ * An offscreen framebuffer with an RGBA8 texture attached.
+ */
+struct OffscreenTarget {
+    explicit OffscreenTarget(int targetSize)
+        : OffscreenTarget(targetSize, targetSize)
+    {
+    }
+
+    OffscreenTarget(int targetWidth, int targetHeight)
+        : width(targetWidth)
+        , height(targetHeight)
+    {
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    }
+
+    ~OffscreenTarget()
+    {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+    }
+
+    auto ReadPixels() const -> std::vector<unsigned char>
+    {
+        std::vector<unsigned char> pixels(width * height * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        return pixels;
+    }
+
+    int width{};
+    int height{};
+    GLuint texture{};
+    GLuint framebuffer{};
+};
+
+/**
+ * Box-filters a square RGBA image down by the given integer factors per axis.
+ */
+auto Downsample(const std::vector<unsigned char>& pixels, int size, int factorX, int factorY) -> std::vector<unsigned char>
+{
+    int const targetWidth = size / factorX;
+    int const targetHeight = size / factorY;
+    std::vector<unsigned char> result(targetWidth * targetHeight * 4);
+    for (int y = 0; y < targetHeight; y++)
+    {
+        for (int x = 0; x < targetWidth; x++)
+        {
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int sum{};
+                for (int sampleY = 0; sampleY < factorY; sampleY++)
+                {
+                    for (int sampleX = 0; sampleX < factorX; sampleX++)
+                    {
+                        sum += pixels[((y * factorY + sampleY) * size + x * factorX + sampleX) * 4 + channel];
+                    }
+                }
+                result[(y * targetWidth + x) * 4 + channel] = static_cast<unsigned char>(sum / (factorX * factorY));
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * Returns the mean absolute difference per color channel of two images.
+ */
+auto MeanDifference(const std::vector<unsigned char>& first, const std::vector<unsigned char>& second) -> long
+{
+    long totalDifference{};
+    for (size_t index = 0; index < first.size(); index++)
+    {
+        totalDifference += std::abs(first[index] - second[index]);
+    }
+    return totalDifference / static_cast<long>(first.size());
+}
+
+/**
+ * Renders a preset into a main framebuffer and several smaller output targets.
+ */
+class OutputTargets : public EGLTestFixture
+{
+protected:
+    void SetUp() override
+    {
+        EGLTestFixture::SetUp();
+        if (IsSkipped())
+        {
+            return;
+        }
+
+        m_projectM = projectm_create_with_opengl_load_proc(LoadGLProc, nullptr);
+        ASSERT_NE(m_projectM, nullptr);
+
+        projectm_set_window_size(m_projectM, viewportSize, viewportSize);
+        projectm_load_preset_file(m_projectM, (std::string(outputTargetsTestDataPath) + "motion-vectors.milk").c_str(), false);
+    }
+
+    void TearDown() override
+    {
+        if (m_projectM != nullptr)
+        {
+            projectm_destroy(m_projectM);
+        }
+
+        EGLTestFixture::TearDown();
+    }
+
+    void RenderFrames(GLuint framebuffer)
+    {
+        std::array<float, 512> samples{};
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            for (size_t sample = 0; sample < samples.size(); sample++)
+            {
+                samples[sample] = 0.8f * std::sin(static_cast<float>(sample) * 0.05f + static_cast<float>(frame) * 0.3f);
+            }
+            projectm_pcm_add_float(m_projectM, samples.data(), static_cast<unsigned int>(samples.size()), PROJECTM_MONO);
+            projectm_opengl_render_frame_fbo(m_projectM, framebuffer);
+        }
+    }
+
+    projectm_handle m_projectM{nullptr};
+};
+
+} // namespace
+
+TEST_F(OutputTargets, RejectsInvalidSize)
+{
+    EXPECT_EQ(projectm_opengl_add_output_target(m_projectM, 0, 0, 64), 0U);
+    EXPECT_EQ(projectm_opengl_add_output_target(m_projectM, 0, 64, -1), 0U);
+}
+
+TEST_F(OutputTargets, ScaledOutputsMatchMainImage)
+{
+    OffscreenTarget mainTarget(viewportSize);
+    OffscreenTarget halfSizeTarget(viewportSize / 2);
+    OffscreenTarget thumbnailTarget(viewportSize / 8);
+
+    auto thumbnailId = projectm_opengl_add_output_target(m_projectM, thumbnailTarget.framebuffer, thumbnailTarget.width, thumbnailTarget.height);
+    auto halfSizeId = projectm_opengl_add_output_target(m_projectM, halfSizeTarget.framebuffer, halfSizeTarget.width, halfSizeTarget.height);
+    EXPECT_NE(thumbnailId, 0U);
+    EXPECT_NE(halfSizeId, 0U);
+    EXPECT_NE(thumbnailId, halfSizeId);
+
+    RenderFrames(mainTarget.framebuffer);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+    auto mainPixels = mainTarget.ReadPixels();
+
+    // Each halving step averages 2x2 pixels, so the result closely resembles a box filter.
+    EXPECT_LE(MeanDifference(halfSizeTarget.ReadPixels(), Downsample(mainPixels, viewportSize, 2, 2)), 1);
+    EXPECT_LE(MeanDifference(thumbnailTarget.ReadPixels(), Downsample(mainPixels, viewportSize, 8, 8)), 2);
+}
+
+TEST_F(OutputTargets, WideTargetIsHalvedPerAxis)
+{
+    OffscreenTarget mainTarget(viewportSize);
+    OffscreenTarget stripTarget(viewportSize, viewportSize / 8);
+    OffscreenTarget halfSizeTarget(viewportSize / 2);
+
+    // The strip has a smaller area than the half-size target, so it is drawn after it.
+    projectm_opengl_add_output_target(m_projectM, stripTarget.framebuffer, stripTarget.width, stripTarget.height);
+    projectm_opengl_add_output_target(m_projectM, halfSizeTarget.framebuffer, halfSizeTarget.width, halfSizeTarget.height);
+
+    RenderFrames(mainTarget.framebuffer);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+    auto mainPixels = mainTarget.ReadPixels();
+
+    EXPECT_LE(MeanDifference(halfSizeTarget.ReadPixels(), Downsample(mainPixels, viewportSize, 2, 2)), 1);
+    EXPECT_LE(MeanDifference(stripTarget.ReadPixels(), Downsample(mainPixels, viewportSize, 1, 8)), 2);
+}
+
+TEST_F(OutputTargets, RemovedTargetIsNotUpdated)
+{
+    OffscreenTarget mainTarget(viewportSize);
+    OffscreenTarget previewTarget(viewportSize / 4);
+
+    auto previewId = projectm_opengl_add_output_target(m_projectM, previewTarget.framebuffer, previewTarget.width, previewTarget.height);
+    projectm_opengl_remove_output_target(m_projectM, previewId);
+
+    // Unknown identifiers are ignored.
+    projectm_opengl_remove_output_target(m_projectM, previewId + 100);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, previewTarget.framebuffer);
+    glClearColor(1.0f, 0.0f, 1.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    RenderFrames(mainTarget.framebuffer);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+    auto previewPixels = previewTarget.ReadPixels();
+    for (size_t index = 0; index < previewPixels.size(); index += 4)
+    {
+        ASSERT_EQ(previewPixels[index], 255);
+        ASSERT_EQ(previewPixels[index + 1], 0);
+        ASSERT_EQ(previewPixels[index + 2], 255);
+    }
+}
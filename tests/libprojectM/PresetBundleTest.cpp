@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <MilkdropPreset/PresetBundle.hpp>
+#include <MilkdropPreset/PresetFileParser.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+static constexpr auto bundleTestDataPath{PROJECTM_TEST_DATA_DIR "/MilkdropPresetValidation/"};
+
+using libprojectM::MilkdropPreset::BlurTexture;
+using libprojectM::MilkdropPreset::PrecompiledPreset;
+using libprojectM::MilkdropPreset::PresetBundle;
+using libprojectM::MilkdropPreset::PresetFileParser;
+
+namespace {
+
+/**
+ * Copies a test preset into the output dir, so tests can modify or remove it.
+ */
+auto CopyTestPreset(const std::string& sourceName, const std::string& targetName) -> std::string
+{
+    std::ifstream source(std::string(bundleTestDataPath) + sourceName, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+
+    std::string filename = PROJECTM_TEST_OUTPUT_DIR "/" + targetName;
+    std::ofstream target(filename, std::ios::binary | std::ios::trunc);
+    target << contents;
+
+    return filename;
+}
+
+} // namespace
+
+TEST(PresetBundle, WriteAndLoad)
+{
+    auto presetFile = CopyTestPreset("valid-v2-shaders.milk", "BundleWriteAndLoad.milk");
+    const std::string bundleFile = PROJECTM_TEST_OUTPUT_DIR "/BundleWriteAndLoad.pmbundle";
+
+    ASSERT_EQ(PresetBundle::Write({presetFile}, bundleFile), 1);
+
+    PresetBundle bundle;
+    ASSERT_TRUE(bundle.Open(bundleFile));
+    EXPECT_TRUE(bundle.Contains(presetFile));
+    EXPECT_FALSE(bundle.Contains("other.milk"));
+
+    PrecompiledPreset preset;
+    ASSERT_TRUE(bundle.Load(presetFile, preset));
+
+    EXPECT_FALSE(preset.values.empty());
+    EXPECT_FALSE(preset.warpShader.preprocessedCode.empty());
+    EXPECT_FALSE(preset.warpShader.glslSource.empty());
+    EXPECT_FALSE(preset.compositeShader.glslSource.empty());
+    EXPECT_EQ(preset.compositeShader.maxBlurLevel, BlurTexture::BlurLevel::Blur1);
+    EXPECT_EQ(preset.compositeShader.samplerNames.count("main"), 1);
+    EXPECT_EQ(preset.compositeShader.samplerNames.count("blur1"), 1);
+    EXPECT_EQ(preset.compositeShader.samplerNames.count("rand00"), 1);
+}
+
+TEST(PresetBundle, LoadedPresetMatchesSourceFile)
+{
+    auto presetFile = CopyTestPreset("valid-v2-shaders.milk", "BundleMatchesSource.milk");
+    const std::string bundleFile = PROJECTM_TEST_OUTPUT_DIR "/BundleMatchesSource.pmbundle";
+
+    ASSERT_EQ(PresetBundle::Write({presetFile}, bundleFile), 1);
+
+    PresetBundle bundle;
+    ASSERT_TRUE(bundle.Open(bundleFile));
+
+    PrecompiledPreset preset;
+    ASSERT_TRUE(bundle.Load(presetFile, preset));
+
+    PresetFileParser bundledParser;
+    ASSERT_TRUE(bundledParser.ReadData(preset.values));
+    for (const auto& code : preset.code)
+    {
+        bundledParser.SetCode(code.first, code.second);
+    }
+
+    PresetFileParser sourceParser;
+    ASSERT_TRUE(sourceParser.Read(presetFile));
+
+    EXPECT_EQ(bundledParser.GetInt("MILKDROP_PRESET_VERSION", 0), sourceParser.GetInt("MILKDROP_PRESET_VERSION", 0));
+    EXPECT_EQ(bundledParser.GetCode("per_frame_"), sourceParser.GetCode("per_frame_"));
+    EXPECT_EQ(bundledParser.GetCode("warp_"), sourceParser.GetCode("warp_"));
+    EXPECT_EQ(bundledParser.GetCode("comp_"), sourceParser.GetCode("comp_"));
+    EXPECT_EQ(bundledParser.GetCode("per_pixel_"), "");
+
+    // Code lines are only stored as assembled blocks.
+    EXPECT_TRUE(bundledParser.PresetValues().find("per_frame_1") == bundledParser.PresetValues().end());
+}
+
+TEST(PresetBundle, ModifiedSourceFileIsNotLoaded)
+{
+    auto presetFile = CopyTestPreset("valid-v1.milk", "BundleModifiedSource.milk");
+    const std::string bundleFile = PROJECTM_TEST_OUTPUT_DIR "/BundleModifiedSource.pmbundle";
+
+    ASSERT_EQ(PresetBundle::Write({presetFile}, bundleFile), 1);
+
+    {
+        std::ofstream modifiedFile(presetFile, std::ios::app);
+        modifiedFile << "zoom=1.1\n";
+    }
+
+    PresetBundle bundle;
+    ASSERT_TRUE(bundle.Open(bundleFile));
+    EXPECT_TRUE(bundle.Contains(presetFile));
+
+    PrecompiledPreset preset;
+    EXPECT_FALSE(bundle.Load(presetFile, preset));
+}
+
+TEST(PresetBundle, MissingSourceFileIsLoadedFromBundle)
+{
+    auto presetFile = CopyTestPreset("valid-v1.milk", "BundleMissingSource.milk");
+    const std::string bundleFile = PROJECTM_TEST_OUTPUT_DIR "/BundleMissingSource.pmbundle";
+
+    ASSERT_EQ(PresetBundle::Write({presetFile}, bundleFile), 1);
+    ASSERT_EQ(std::remove(presetFile.c_str()), 0);
+
+    PresetBundle bundle;
+    ASSERT_TRUE(bundle.Open(bundleFile));
+
+    PrecompiledPreset preset;
+    EXPECT_TRUE(bundle.Load(presetFile, preset));
+}
+
+TEST(PresetBundle, UnparseablePresetsAreSkipped)
+{
+    auto presetFile = CopyTestPreset("valid-v1.milk", "BundleSkipValid.milk");
+    const std::string bundleFile = PROJECTM_TEST_OUTPUT_DIR "/BundleSkip.pmbundle";
+
+    ASSERT_EQ(PresetBundle::Write({presetFile, std::string(bundleTestDataPath) + "does-not-exist.milk"}, bundleFile), 1);
+
+    PresetBundle bundle;
+    ASSERT_TRUE(bundle.Open(bundleFile));
+    EXPECT_TRUE(bundle.Contains(presetFile));
+    EXPECT_FALSE(bundle.Contains(std::string(bundleTestDataPath) + "does-not-exist.milk"));
+}
+
+TEST(PresetBundle, UntranslatableShaderIsLeftEmpty)
+{
+    auto preset = PresetBundle::Precompile(std::string(bundleTestDataPath) + "invalid-comp-shader.milk");
+
+    EXPECT_TRUE(preset.compositeShader.preprocessedCode.empty());
+    EXPECT_TRUE(preset.compositeShader.glslSource.empty());
+}
+
+TEST(PresetBundle, OpenRejectsOtherFiles)
+{
+    PresetBundle bundle;
+    EXPECT_FALSE(bundle.Open(std::string(bundleTestDataPath) + "valid-v1.milk"));
+    EXPECT_FALSE(bundle.Open(std::string(bundleTestDataPath) + "does-not-exist.pmbundle"));
+}
@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+
+#include <Preset.hpp>
+#include <PresetCache.hpp>
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+using libprojectM::Preset;
+using libprojectM::PresetCache;
+
+namespace {
+
+/**
+ * Preset stub with a configurable memory size and reset result.
+ */
+class TestPreset : public Preset
+{
+public:
+    TestPreset(size_t textureMemory, bool resettable, int& destroyedCount)
+        : m_textureMemory(textureMemory)
+        , m_resettable(resettable)
+        , m_destroyedCount(destroyedCount)
+    {
+    }
+
+    ~TestPreset() override
+    {
+        m_destroyedCount++;
+    }
+
+    void Initialize(const libprojectM::Renderer::RenderContext&) override
+    {
+    }
+
+    void RenderFrame(const libprojectM::Audio::FrameAudioData&, const libprojectM::Renderer::RenderContext&) override
+    {
+    }
+
+    auto OutputTexture() const -> std::shared_ptr<libprojectM::Renderer::Texture> override
+    {
+        return {};
+    }
+
+    void DrawInitialImage(const std::shared_ptr<libprojectM::Renderer::Texture>&, const libprojectM::Renderer::RenderContext&) override
+    {
+    }
+
+    void BindFramebuffer() override
+    {
+    }
+
+    auto TextureMemory() const -> size_t override
+    {
+        return m_textureMemory;
+    }
+
+    auto Reset(const libprojectM::Renderer::RenderContext&) -> bool override
+    {
+        resetCount++;
+        return m_resettable;
+    }
+
+    int resetCount{0};
+
+private:
+    size_t m_textureMemory;
+    bool m_resettable;
+    int& m_destroyedCount;
+};
+
+/**
+ * Writes a preset file into the output dir, replacing any previous contents.
+ */
+void WritePresetFile(const std::string& filename, const std::string& contents)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file << contents;
+}
+
+} // namespace
+
+TEST(PresetCache, ReturnsStoredPreset)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    auto preset = std::make_unique<TestPreset>(100, true, destroyed);
+    auto* presetPointer = preset.get();
+    cache.Store("file:///presets/a.milk", std::move(preset));
+
+    auto cachedPreset = cache.Take("file:///presets/a.milk", {});
+    ASSERT_EQ(cachedPreset.get(), presetPointer);
+    EXPECT_EQ(presetPointer->resetCount, 1);
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits, 1);
+    EXPECT_EQ(statistics.misses, 0);
+    EXPECT_EQ(statistics.cachedPresets, 0);
+    EXPECT_EQ(statistics.cachedBytes, 0);
+    EXPECT_EQ(destroyed, 0);
+}
+
+TEST(PresetCache, ChangedPresetFileIsNotReused)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    const std::string presetFile = PROJECTM_TEST_OUTPUT_DIR "/PresetCacheChangedFile.milk";
+    WritePresetFile(presetFile, "[preset00]\nzoom=1.0\n");
+
+    // Unchanged files are reused, also when passed as a file URL.
+    cache.Store(presetFile, std::make_unique<TestPreset>(100, true, destroyed));
+    EXPECT_NE(cache.Take(presetFile, {}), nullptr);
+    cache.Store("file://" + presetFile, std::make_unique<TestPreset>(100, true, destroyed));
+    EXPECT_NE(cache.Take("file://" + presetFile, {}), nullptr);
+    EXPECT_EQ(destroyed, 2);
+
+    cache.Store(presetFile, std::make_unique<TestPreset>(100, true, destroyed));
+    WritePresetFile(presetFile, "[preset00]\nzoom=1.1\nrot=0.1\n");
+
+    EXPECT_EQ(cache.Take(presetFile, {}), nullptr);
+    EXPECT_EQ(destroyed, 3);
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits, 2);
+    EXPECT_EQ(statistics.misses, 1);
+    EXPECT_EQ(statistics.cachedPresets, 0);
+    EXPECT_EQ(statistics.cachedBytes, 0);
+}
+
+TEST(PresetCache, CountsMisses)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, true, destroyed));
+
+    EXPECT_EQ(cache.Take("b.milk", {}), nullptr);
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits, 0);
+    EXPECT_EQ(statistics.misses, 1);
+    EXPECT_EQ(statistics.cachedPresets, 1);
+    EXPECT_EQ(statistics.cachedBytes, 100);
+}
+
+TEST(PresetCache, PresetsWithoutFilenameAreNotCached)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    cache.Store("", std::make_unique<TestPreset>(100, true, destroyed));
+
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(cache.GetStatistics().cachedPresets, 0);
+}
+
+TEST(PresetCache, PresetsFailingToResetAreDestroyed)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, false, destroyed));
+
+    EXPECT_EQ(cache.Take("a.milk", {}), nullptr);
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(cache.GetStatistics().misses, 1);
+    EXPECT_EQ(cache.GetStatistics().cachedPresets, 0);
+}
+
+TEST(PresetCache, EvictsLeastRecentlyUsedByCount)
+{
+    int destroyed{};
+    PresetCache cache;
+    cache.SetLimits(2, 1000);
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.Store("b.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.Store("c.milk", std::make_unique<TestPreset>(100, true, destroyed));
+
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(cache.Take("a.milk", {}), nullptr);
+    EXPECT_NE(cache.Take("b.milk", {}), nullptr);
+    EXPECT_NE(cache.Take("c.milk", {}), nullptr);
+    EXPECT_EQ(cache.GetStatistics().evictions, 1);
+}
+
+TEST(PresetCache, EvictsLeastRecentlyUsedByMemory)
+{
+    int destroyed{};
+    PresetCache cache;
+    cache.SetLimits(10, 250);
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.Store("b.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.Store("c.milk", std::make_unique<TestPreset>(100, true, destroyed));
+
+    auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.cachedPresets, 2);
+    EXPECT_EQ(statistics.cachedBytes, 200);
+    EXPECT_EQ(statistics.evictions, 1);
+    EXPECT_EQ(cache.Take("a.milk", {}), nullptr);
+
+    // A single preset exceeding the limit isn't cached at all.
+    cache.Store("d.milk", std::make_unique<TestPreset>(300, true, destroyed));
+    EXPECT_EQ(cache.GetStatistics().cachedPresets, 2);
+    EXPECT_EQ(destroyed, 2);
+}
+
+TEST(PresetCache, KeepsOnlyLatestInstanceOfPreset)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    auto preset = std::make_unique<TestPreset>(100, true, destroyed);
+    auto* presetPointer = preset.get();
+    cache.Store("a.milk", std::move(preset));
+
+    EXPECT_EQ(destroyed, 1);
+    EXPECT_EQ(cache.GetStatistics().cachedPresets, 1);
+    EXPECT_EQ(cache.Take("a.milk", {}).get(), presetPointer);
+}
+
+TEST(PresetCache, ZeroLimitDisablesCache)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.SetLimits(0, 1000);
+
+    EXPECT_EQ(destroyed, 1);
+
+    cache.Store("b.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(cache.GetStatistics().cachedPresets, 0);
+}
+
+TEST(PresetCache, ClearDestroysPresets)
+{
+    int destroyed{};
+    PresetCache cache;
+
+    cache.Store("a.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.Store("b.milk", std::make_unique<TestPreset>(100, true, destroyed));
+    cache.Clear();
+
+    EXPECT_EQ(destroyed, 2);
+    EXPECT_EQ(cache.GetStatistics().cachedPresets, 0);
+    EXPECT_EQ(cache.GetStatistics().cachedBytes, 0);
+}
@@ -2,7 +2,18 @@
 
 #include <MilkdropPreset/PresetFileParser.hpp>
 
+#include <Renderer/FileScanner.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <set>
+#include <string>
+
 static constexpr auto fileParserTestDataPath{ PROJECTM_TEST_DATA_DIR "/PresetFileParser/" };
+static constexpr auto presetCorpusPath{ PROJECTM_TEST_PRESETS_DIR };
 
 using libprojectM::MilkdropPreset::PresetFileParser;
 
@@ -203,3 +214,145 @@ TEST(PresetFileParser, GetBooleanDefault)
 
     EXPECT_EQ(parser.GetBool("RandomKey", true), true);
 }
+
+TEST(PresetFileParser, ReadData)
+{
+    std::string data("[preset00]\r\nfRating=3.5\r\nper_frame_1=r=1.0;\r\nper_frame_2=g=1.0;");
+
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.ReadData(std::vector<char>(data.begin(), data.end())));
+
+    EXPECT_FLOAT_EQ(parser.GetFloat("fRating", 0.0f), 3.5f);
+    EXPECT_EQ(parser.GetCode("per_frame_"), "r=1.0;\ng=1.0;\n");
+}
+
+TEST(PresetFileParser, ReadDataWithNullByte)
+{
+    std::vector<char> data{'a', '=', '1', '\0', '\n'};
+
+    PresetFileParser parser;
+    EXPECT_FALSE(parser.ReadData(data));
+}
+
+TEST(PresetFileParser, CaseInsensitiveKeys)
+{
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.Read(std::string(fileParserTestDataPath) + "parser-valueconversion.milk"));
+
+    EXPECT_EQ(parser.GetBool("badditivewaves", false), true);
+    EXPECT_EQ(parser.GetBool("BADDITIVEWAVES", false), true);
+}
+
+TEST(PresetFileParser, GetCodeIgnoresLeadingZeros)
+{
+    std::string data("per_frame_1=r=1.0;\nper_frame_02=g=1.0;\nper_frame_2=b=1.0;\n");
+
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.ReadData(std::vector<char>(data.begin(), data.end())));
+
+    EXPECT_EQ(parser.GetCode("per_frame_"), "r=1.0;\nb=1.0;\n");
+    EXPECT_EQ(parser.GetString("per_frame_02", ""), "g=1.0;");
+}
+
+TEST(PresetFileParser, GetShaderVersions)
+{
+    std::string data("PSVERSION=3\nPSVERSION_WARP=4\nPSVERSION_COMP=1\n");
+
+    PresetFileParser parser;
+    ASSERT_TRUE(parser.ReadData(std::vector<char>(data.begin(), data.end())));
+
+    int warpShaderVersion{2};
+    int compositeShaderVersion{2};
+    parser.GetShaderVersions(100, warpShaderVersion, compositeShaderVersion);
+    EXPECT_EQ(warpShaderVersion, 0);
+    EXPECT_EQ(compositeShaderVersion, 0);
+
+    warpShaderVersion = 2;
+    compositeShaderVersion = 2;
+    parser.GetShaderVersions(200, warpShaderVersion, compositeShaderVersion);
+    EXPECT_EQ(warpShaderVersion, 3);
+    EXPECT_EQ(compositeShaderVersion, 3);
+
+    parser.GetShaderVersions(201, warpShaderVersion, compositeShaderVersion);
+    EXPECT_EQ(warpShaderVersion, 4);
+    EXPECT_EQ(compositeShaderVersion, 1);
+}
+
+TEST(PresetFileParser, CodeBlocks)
+{
+    const auto& codeBlocks = PresetFileParser::CodeBlocks();
+
+    // Three main expression blocks, three per custom wave, two per custom shape and two shaders.
+    ASSERT_EQ(codeBlocks.size(), 25);
+
+    std::set<std::string> keyPrefixes;
+    size_t shaderCount{};
+    for (const auto& codeBlock : codeBlocks)
+    {
+        EXPECT_TRUE(keyPrefixes.insert(codeBlock.keyPrefix).second) << codeBlock.keyPrefix;
+        EXPECT_FALSE(codeBlock.name.empty());
+        if (codeBlock.isShader)
+        {
+            shaderCount++;
+        }
+    }
+    EXPECT_EQ(shaderCount, 2);
+
+    EXPECT_EQ(keyPrefixes.count("per_frame_init_"), 1);
+    EXPECT_EQ(keyPrefixes.count("wave_3_per_point"), 1);
+    EXPECT_EQ(keyPrefixes.count("shape_0_per_frame"), 1);
+    EXPECT_EQ(keyPrefixes.count("comp_"), 1);
+}
+
+/**
+ * Parser throughput benchmark. Parses all presets in the source tree or the directory given in the
+ * PROJECTM_PRESET_CORPUS_DIR environment variable. Run with --gtest_also_run_disabled_tests.
+ */
+TEST(PresetFileParser, DISABLED_CorpusBenchmark)
+{
+    std::string corpusPath = presetCorpusPath;
+    const char* corpusPathOverride = std::getenv("PROJECTM_PRESET_CORPUS_DIR");
+    if (corpusPathOverride != nullptr)
+    {
+        corpusPath = corpusPathOverride;
+    }
+
+    std::vector<std::string> extensions{".milk"};
+    libprojectM::Renderer::FileScanner scanner({corpusPath}, extensions);
+
+    std::vector<std::vector<char>> presets;
+    scanner.Scan([&presets](const std::string& path, const std::string&) {
+        std::ifstream file(path, std::ios::binary);
+        presets.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    });
+    ASSERT_FALSE(presets.empty());
+
+    constexpr int iterations = 20;
+    size_t parsedCount{0};
+    size_t codeLength{0};
+
+    auto startTime = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++)
+    {
+        for (const auto& preset : presets)
+        {
+            PresetFileParser parser;
+            if (parser.ReadData(preset))
+            {
+                // Fetch a typical mix of values, as the preset loader would.
+                codeLength += static_cast<size_t>(parser.GetFloat("fDecay", 0.98f) > 0.0f);
+                codeLength += static_cast<size_t>(parser.GetInt("nWaveMode", 0));
+                codeLength += parser.GetCode("per_frame_").length();
+                codeLength += parser.GetCode("per_pixel_").length();
+                codeLength += parser.GetCode("warp_").length();
+                codeLength += parser.GetCode("comp_").length();
+                parsedCount++;
+            }
+        }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Parsed " << parsedCount << " presets in " << elapsed << " s, "
+              << static_cast<double>(parsedCount) / elapsed << " presets/second" << std::endl;
+    EXPECT_GT(codeLength, 0);
+}
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include <Renderer/RandomNumberGenerator.hpp>
+
+#include <array>
+#include <random>
+
+using libprojectM::Renderer::RandomNumberGenerator;
+
+TEST(RandomNumberGenerator, SameSeedRepeatsSequence)
+{
+    RandomNumberGenerator first(12345);
+    RandomNumberGenerator second(12345);
+
+    for (int index = 0; index < 1000; index++)
+    {
+        ASSERT_EQ(first(), second());
+    }
+
+    // Reseeding restarts the sequence.
+    first.Seed(12345);
+    RandomNumberGenerator third(12345);
+    EXPECT_EQ(first(), third());
+}
+
+TEST(RandomNumberGenerator, DifferentSeedsDiffer)
+{
+    RandomNumberGenerator first(1);
+    RandomNumberGenerator second(2);
+
+    int equalValues = 0;
+    for (int index = 0; index < 100; index++)
+    {
+        if (first() == second())
+        {
+            equalValues++;
+        }
+    }
+
+    EXPECT_LT(equalValues, 2);
+}
+
+TEST(RandomNumberGenerator, ZeroSeedProducesValues)
+{
+    RandomNumberGenerator generator(0);
+
+    uint32_t combined{};
+    for (int index = 0; index < 16; index++)
+    {
+        combined |= generator();
+    }
+
+    EXPECT_NE(combined, 0U);
+}
+
+TEST(RandomNumberGenerator, FloatsAreInUnitRange)
+{
+    RandomNumberGenerator generator(42);
+
+    float sum{};
+    for (int index = 0; index < 10000; index++)
+    {
+        auto value = generator.NextFloat();
+        ASSERT_GE(value, 0.0f);
+        ASSERT_LT(value, 1.0f);
+        sum += value;
+    }
+
+    EXPECT_NEAR(sum / 10000.0f, 0.5f, 0.02f);
+}
+
+TEST(RandomNumberGenerator, IndexesCoverRange)
+{
+    RandomNumberGenerator generator(42);
+
+    std::array<int, 6> counts{};
+    for (int index = 0; index < 6000; index++)
+    {
+        auto value = generator.NextIndex(6);
+        ASSERT_LT(value, 6U);
+        counts.at(value)++;
+    }
+
+    for (auto count : counts)
+    {
+        EXPECT_GT(count, 800);
+        EXPECT_LT(count, 1200);
+    }
+
+    EXPECT_EQ(generator.NextIndex(1), 0U);
+}
+
+TEST(RandomNumberGenerator, WorksWithStandardDistributions)
+{
+    RandomNumberGenerator generator(7);
+    std::uniform_int_distribution<int> distribution(10, 20);
+
+    for (int index = 0; index < 1000; index++)
+    {
+        auto value = distribution(generator);
+        ASSERT_GE(value, 10);
+        ASSERT_LE(value, 20);
+    }
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <Renderer/OpenGL.h>
+
+#include <projectM-4/audio.h>
+#include <projectM-4/core.h>
+#include <projectM-4/instrumentation.h>
+#include <projectM-4/parameters.h>
+#include <projectM-4/render_opengl.h>
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static constexpr auto renderTargetQualityTestDataPath{PROJECTM_TEST_DATA_DIR "/RenderTargetQuality/"};
+
+namespace {
+
+constexpr int frameCount{30};
+constexpr int viewportSize{128};
+
+/**
+ * Result of rendering the test preset with a given render target quality.
+ */
+struct QualityRenderResult {
+    std::vector<unsigned char> pixels;         //!< Contents of the output framebuffer after the last frame.
+    projectm_frame_bandwidth_stats bandwidth{}; //!< Bandwidth estimate of the last frame.
+};
+
+/**
+ * Renders the same preset and audio with different render target qualities into an offscreen framebuffer.
+ */
+class RenderTargetQuality : public EGLTestFixture
+{
+protected:
+    /**
+     * Renders the motion vector test preset and returns the final image and bandwidth estimate.
+     */
+    static auto Render(projectm_render_target_quality quality) -> QualityRenderResult
+    {
+        QualityRenderResult result;
+
+        auto* projectM = projectm_create_with_opengl_load_proc(LoadGLProc, nullptr);
+        if (projectM == nullptr)
+        {
+            return result;
+        }
+
+        GLuint texture{};
+        GLuint framebuffer{};
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, viewportSize, viewportSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glGenFramebuffers(1, &framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+
+        // Fixed seed and frame times, so only the render target quality differs between renders.
+        projectm_set_random_seed(projectM, 1);
+        projectm_set_render_target_quality(projectM, quality);
+        projectm_set_window_size(projectM, viewportSize, viewportSize);
+        projectm_load_preset_file(projectM, (std::string(renderTargetQualityTestDataPath) + "motion-vectors.milk").c_str(), false);
+
+        std::array<float, 512> samples{};
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            for (size_t sample = 0; sample < samples.size(); sample++)
+            {
+                samples[sample] = 0.8f * std::sin(static_cast<float>(sample) * 0.05f + static_cast<float>(frame) * 0.3f);
+            }
+            projectm_pcm_add_float(projectM, samples.data(), static_cast<unsigned int>(samples.size()), PROJECTM_MONO);
+            projectm_set_frame_time(projectM, static_cast<double>(frame) / 60.0);
+            projectm_opengl_render_frame_fbo(projectM, framebuffer);
+        }
+
+        result.pixels.resize(viewportSize * viewportSize * 4);
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        glReadPixels(0, 0, viewportSize, viewportSize, GL_RGBA, GL_UNSIGNED_BYTE, result.pixels.data());
+        EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+        projectm_get_frame_bandwidth_stats(projectM, &result.bandwidth);
+
+        projectm_destroy(projectM);
+
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteTextures(1, &texture);
+
+        return result;
+    }
+
+    /**
+     * Returns the mean absolute difference per color channel of two images.
+     */
+    static auto MeanDifference(const std::vector<unsigned char>& first, const std::vector<unsigned char>& second) -> long
+    {
+        long totalDifference{};
+        for (size_t index = 0; index < first.size(); index++)
+        {
+            totalDifference += std::abs(first[index] - second[index]);
+        }
+        return totalDifference / static_cast<long>(first.size());
+    }
+
+};
+
+} // namespace
+
+TEST_F(RenderTargetQuality, RendersReproducibly)
+{
+    auto first = Render(PROJECTM_RENDER_TARGET_QUALITY_DEFAULT);
+    auto second = Render(PROJECTM_RENDER_TARGET_QUALITY_DEFAULT);
+
+    ASSERT_EQ(first.pixels.size(), viewportSize * viewportSize * 4);
+    EXPECT_TRUE(first.pixels == second.pixels);
+}
+
+TEST_F(RenderTargetQuality, LowQualityResemblesDefault)
+{
+    auto defaultQuality = Render(PROJECTM_RENDER_TARGET_QUALITY_DEFAULT);
+    auto lowQuality = Render(PROJECTM_RENDER_TARGET_QUALITY_LOW);
+
+    ASSERT_EQ(defaultQuality.pixels.size(), viewportSize * viewportSize * 4);
+    ASSERT_EQ(lowQuality.pixels.size(), defaultQuality.pixels.size());
+
+    // Only the motion vector end points are less accurate, the rest of the image is identical.
+    EXPECT_LE(MeanDifference(defaultQuality.pixels, lowQuality.pixels), 1);
+
+    EXPECT_GT(defaultQuality.bandwidth.bytes_written, 0);
+    EXPECT_LT(lowQuality.bandwidth.bytes_written, defaultQuality.bandwidth.bytes_written);
+    EXPECT_LT(lowQuality.bandwidth.render_target_bytes, defaultQuality.bandwidth.render_target_bytes);
+}
+
+TEST_F(RenderTargetQuality, HighQualityResemblesDefault)
+{
+    auto defaultQuality = Render(PROJECTM_RENDER_TARGET_QUALITY_DEFAULT);
+    auto highQuality = Render(PROJECTM_RENDER_TARGET_QUALITY_HIGH);
+
+    ASSERT_EQ(defaultQuality.pixels.size(), viewportSize * viewportSize * 4);
+    ASSERT_EQ(highQuality.pixels.size(), defaultQuality.pixels.size());
+
+    // The additional precision mostly affects the decay of dark areas.
+    EXPECT_LE(MeanDifference(defaultQuality.pixels, highQuality.pixels), 2);
+
+    EXPECT_EQ(highQuality.bandwidth.bytes_written, defaultQuality.bandwidth.bytes_written);
+    EXPECT_EQ(highQuality.bandwidth.render_target_bytes, defaultQuality.bandwidth.render_target_bytes);
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <UserSprites/SpriteManager.hpp>
+
+#include <Renderer/OpenGL.h>
+#include <Renderer/RandomNumberGenerator.hpp>
+#include <Renderer/ShaderCache.hpp>
+#include <Renderer/TextureManager.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+using libprojectM::UserSprites::Sprite;
+using libprojectM::UserSprites::SpriteManager;
+
+namespace {
+
+constexpr int viewportSize{256};
+
+/**
+ * Milkdrop sprite code moving the sprite around depending on its index.
+ */
+auto SpriteCode(int index, int blendMode) -> std::string
+{
+    return "img=idlem\n"
+           "init_1=index=" + std::to_string(index) + ";\n"
+           "code_1=x=0.5+0.4*sin(time+index*0.1);y=0.5+0.4*cos(time*0.7+index*0.13);\n"
+           "code_2=sx=0.05;sy=0.05;rot=index*0.01;burn=0;blendmode=" + std::to_string(blendMode) + ";\n";
+}
+
+/**
+ * Spawns and draws user sprites into an offscreen framebuffer with a surfaceless EGL context.
+ */
+class SpriteManagerRendering : public EGLTestFixture
+{
+protected:
+    void SetUp() override
+    {
+        EGLTestFixture::SetUp();
+        if (IsSkipped())
+        {
+            return;
+        }
+
+        if (!LoadGLFunctions())
+        {
+            GTEST_SKIP() << "Unable to load the OpenGL functions.";
+        }
+
+        glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, viewportSize, viewportSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glGenFramebuffers(1, &m_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+        glViewport(0, 0, viewportSize, viewportSize);
+
+        m_textureManager = std::make_unique<libprojectM::Renderer::TextureManager>(std::vector<std::string>{});
+        m_spriteManager = std::make_unique<SpriteManager>();
+
+        m_renderContext.viewportSizeX = viewportSize;
+        m_renderContext.viewportSizeY = viewportSize;
+        m_renderContext.fps = 60.0f;
+        m_renderContext.shaderCache = &m_shaderCache;
+        m_renderContext.textureManager = m_textureManager.get();
+        m_renderContext.randomGenerator = &m_randomGenerator;
+    }
+
+    void TearDown() override
+    {
+        m_spriteManager.reset();
+        m_textureManager.reset();
+
+        if (m_context != EGL_NO_CONTEXT)
+        {
+            glDeleteFramebuffers(1, &m_framebuffer);
+            glDeleteTextures(1, &m_texture);
+        }
+
+        EGLTestFixture::TearDown();
+    }
+
+    /**
+     * Draws all sprites once.
+     */
+    void DrawFrame(int frame)
+    {
+        m_renderContext.time = static_cast<float>(frame) / 60.0f;
+        m_renderContext.frame = frame;
+
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        m_spriteManager->Draw(m_audioData, m_renderContext, m_framebuffer, Sprite::PresetList{});
+    }
+
+    GLuint m_texture{};
+    GLuint m_framebuffer{};
+    libprojectM::Renderer::ShaderCache m_shaderCache;
+    libprojectM::Renderer::RandomNumberGenerator m_randomGenerator{1};
+    std::unique_ptr<libprojectM::Renderer::TextureManager> m_textureManager;
+    std::unique_ptr<SpriteManager> m_spriteManager;
+    libprojectM::Renderer::RenderContext m_renderContext;
+    libprojectM::Audio::FrameAudioData m_audioData;
+};
+
+} // namespace
+
+TEST_F(SpriteManagerRendering, ReusesSlotsWithNewIdentifiers)
+{
+    m_spriteManager->SpriteSlots(4);
+
+    auto first = m_spriteManager->Spawn("milkdrop", SpriteCode(0, 0), m_renderContext);
+    auto second = m_spriteManager->Spawn("milkdrop", SpriteCode(1, 0), m_renderContext);
+    ASSERT_NE(first, 0);
+    ASSERT_NE(second, 0);
+    ASSERT_NE(first, second);
+
+    // A destroyed sprite's identifier must not address the sprite reusing its slot.
+    m_spriteManager->Destroy(first);
+    auto third = m_spriteManager->Spawn("milkdrop", SpriteCode(2, 0), m_renderContext);
+    ASSERT_NE(third, 0);
+    EXPECT_NE(third, first);
+
+    m_spriteManager->Destroy(first);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 2);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteIdentifiers(), (std::vector<SpriteManager::SpriteIdentifier>{second, third}));
+}
+
+TEST_F(SpriteManagerRendering, EvictsOldestSprite)
+{
+    m_spriteManager->SpriteSlots(3);
+
+    std::vector<SpriteManager::SpriteIdentifier> identifiers;
+    for (int index = 0; index < 5; index++)
+    {
+        identifiers.push_back(m_spriteManager->Spawn("milkdrop", SpriteCode(index, 0), m_renderContext));
+    }
+
+    EXPECT_EQ(m_spriteManager->ActiveSpriteIdentifiers(),
+              (std::vector<SpriteManager::SpriteIdentifier>{identifiers[2], identifiers[3], identifiers[4]}));
+
+    m_spriteManager->SpriteSlots(1);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteIdentifiers(), (std::vector<SpriteManager::SpriteIdentifier>{identifiers[4]}));
+}
+
+TEST_F(SpriteManagerRendering, BatchesSpritesWithSameState)
+{
+    m_spriteManager->SpriteSlots(8);
+
+    // Two runs with different blend modes, interrupted once.
+    for (int index = 0; index < 8; index++)
+    {
+        m_spriteManager->Spawn("milkdrop", SpriteCode(index, index < 5 ? 0 : 2), m_renderContext);
+    }
+
+    DrawFrame(1);
+
+    EXPECT_EQ(m_spriteManager->LastDrawCallCount(), 2);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+}
+
+/**
+ * Spawn and draw time of a thousand sprites. Takes long with software rendering, so it isn't run
+ * by default. Run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(SpriteManagerRendering, DISABLED_ThousandSpritesBenchmark)
+{
+    constexpr int spriteCount{1000};
+    constexpr int frameCount{60};
+
+    m_spriteManager->SpriteSlots(spriteCount);
+
+    auto spawnStart = std::chrono::steady_clock::now();
+    for (int index = 0; index < spriteCount; index++)
+    {
+        ASSERT_NE(m_spriteManager->Spawn("milkdrop", SpriteCode(index, 0), m_renderContext), 0);
+    }
+    auto spawnTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - spawnStart).count();
+
+    auto drawStart = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frameCount; frame++)
+    {
+        DrawFrame(frame);
+    }
+    glFinish();
+    auto drawTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drawStart).count() / frameCount;
+
+    std::cout << "[ BENCHMARK ] " << spriteCount << " sprites: spawn " << spawnTime << " ms total, draw "
+              << drawTime << " ms/frame, " << m_spriteManager->LastDrawCallCount() << " draw call(s)/frame" << std::endl;
+
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), spriteCount);
+    EXPECT_EQ(m_spriteManager->LastDrawCallCount(), 1);
+    EXPECT_EQ(glGetError(), GL_NO_ERROR);
+
+    m_spriteManager->DestroyAll();
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 0);
+}
+
+TEST_F(SpriteManagerRendering, ReusesParsedDefinitions)
+{
+    m_spriteManager->SpriteSlots(8);
+
+    for (int spawn = 0; spawn < 5; spawn++)
+    {
+        ASSERT_NE(m_spriteManager->Spawn("milkdrop", SpriteCode(1, 0), m_renderContext), 0);
+    }
+    ASSERT_NE(m_spriteManager->Spawn("MilkDrop", SpriteCode(1, 0), m_renderContext), 0);
+
+    const auto& cache = m_spriteManager->DefinitionCache();
+    EXPECT_EQ(cache.Size(), 1);
+    EXPECT_EQ(cache.Misses(), 1);
+    EXPECT_EQ(cache.Hits(), 5);
+
+    // Each sprite still has its own code context.
+    DrawFrame(1);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 6);
+}
+
+TEST_F(SpriteManagerRendering, DoesNotCacheInvalidDefinition)
+{
+    std::string const invalidCode = "img=idlem\ncode_1=x=(0.5;\n";
+
+    EXPECT_EQ(m_spriteManager->Spawn("milkdrop", invalidCode, m_renderContext), 0);
+    EXPECT_EQ(m_spriteManager->Spawn("milkdrop", invalidCode, m_renderContext), 0);
+
+    const auto& cache = m_spriteManager->DefinitionCache();
+    EXPECT_EQ(cache.Size(), 0);
+    EXPECT_EQ(cache.Misses(), 2);
+    EXPECT_EQ(cache.Hits(), 0);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 0);
+}
+
+TEST_F(SpriteManagerRendering, ReusedCodeStartsWithFreshState)
+{
+    // Counts its frames and finishes on the second one.
+    std::string const spriteCode = "img=idlem\n"
+                                   "code_1=n=n+1;megabuf(0)=megabuf(0)+1;done=above(n+megabuf(0),2);\n";
+
+    ASSERT_NE(m_spriteManager->Spawn("milkdrop", spriteCode, m_renderContext), 0);
+    DrawFrame(1);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 1);
+    DrawFrame(2);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 0);
+
+    // The next sprite gets the compiled code of the first one, but none of its variables or memory.
+    ASSERT_NE(m_spriteManager->Spawn("milkdrop", spriteCode, m_renderContext), 0);
+    DrawFrame(3);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 1);
+    DrawFrame(4);
+    EXPECT_EQ(m_spriteManager->ActiveSpriteCount(), 0);
+
+    EXPECT_EQ(m_spriteManager->DefinitionCache().Hits(), 1);
+}
+
+TEST_F(SpriteManagerRendering, DestroyAllClearsDefinitionCache)
+{
+    m_spriteManager->SpriteSlots(4);
+
+    ASSERT_NE(m_spriteManager->Spawn("milkdrop", SpriteCode(0, 0), m_renderContext), 0);
+    ASSERT_NE(m_spriteManager->Spawn("milkdrop", SpriteCode(1, 0), m_renderContext), 0);
+    EXPECT_EQ(m_spriteManager->DefinitionCache().Size(), 2);
+
+    m_spriteManager->DestroyAll();
+    EXPECT_EQ(m_spriteManager->DefinitionCache().Size(), 0);
+
+    ASSERT_NE(m_spriteManager->Spawn("milkdrop", SpriteCode(0, 0), m_renderContext), 0);
+    EXPECT_EQ(m_spriteManager->DefinitionCache().Size(), 1);
+
+    m_spriteManager->SpriteSlots(0);
+    EXPECT_EQ(m_spriteManager->DefinitionCache().Size(), 0);
+}
@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#include "EGLTestContext.hpp"
+
+#include <MilkdropPreset/PerFrameContext.hpp>
+#include <MilkdropPreset/PresetState.hpp>
+#include <MilkdropPreset/Waveforms/Factory.hpp>
+
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using libprojectM::MilkdropPreset::PerFrameContext;
+using libprojectM::MilkdropPreset::PresetState;
+using libprojectM::MilkdropPreset::WaveformMode;
+using libprojectM::MilkdropPreset::Waveforms::Factory;
+using libprojectM::MilkdropPreset::Waveforms::WaveformMath;
+using libprojectM::Renderer::Point;
+
+namespace {
+
+/**
+ * Expected output of one waveform, recorded from the original per-sample implementation.
+ */
+struct GoldenWave {
+    size_t vertexCount{};         //!< Number of smoothed vertices.
+    float sumX{};                 //!< Sum of all X coordinates.
+    float sumY{};                 //!< Sum of all Y coordinates.
+    std::vector<Point> vertices;  //!< Vertices at 0, 1/5, 2/5, 3/5 and 4/5 of the list, plus the last one.
+};
+
+/**
+ * Expected output of both waveforms of a waveform mode.
+ */
+struct GoldenMode {
+    WaveformMode mode;
+    GoldenWave wave1;
+    GoldenWave wave2;
+};
+
+// clang-format off
+const std::vector<GoldenMode> goldenModes{
+    {WaveformMode::Circle,
+     {479, -2.020475f, -46.602703f, {{0.495476f, 0.503218f}, {-0.254806f, 0.677158f}, {-0.570725f, -0.174307f}, {-0.148305f, -0.994804f}, {0.415199f, -0.426053f}, {0.513485f, 0.489246f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::XYOscillationSpiral,
+     {479, -161.168976f, 246.019989f, {{-0.346500f, 0.746508f}, {-0.487770f, 0.256923f}, {-0.657458f, 0.206867f}, {-0.376104f, 0.337625f}, {-0.193808f, 0.825331f}, {-0.021891f, 0.684245f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::CenteredSpiro,
+     {959, 5.846161f, -96.935623f, {{0.234375f, -0.199635f}, {0.172240f, 0.268183f}, {0.227846f, -0.344423f}, {0.072462f, -0.268316f}, {0.043833f, 0.308368f}, {-0.107026f, -0.099966f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::CenteredSpiroVolume,
+     {959, 5.846161f, -96.935623f, {{0.234375f, -0.199635f}, {0.172240f, 0.268183f}, {0.227846f, -0.344423f}, {0.072462f, -0.268316f}, {0.043833f, 0.308368f}, {-0.107026f, -0.099966f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::DerivativeLine,
+     {319, -6.616792f, -28.796583f, {{-0.819492f, -0.230594f}, {-0.646829f, 0.103571f}, {-0.217939f, -0.231470f}, {0.250265f, -0.060982f}, {0.409951f, -0.179911f}, {1.026875f, -0.179318f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::ExplosiveHash,
+     {959, 5.148221f, -98.815605f, {{-0.069318f, -0.088879f}, {0.098168f, -0.022584f}, {-0.094186f, -0.279697f}, {0.015293f, -0.101400f}, {0.149382f, -0.066307f}, {-0.013683f, -0.090954f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::Line,
+     {159, -1.114356f, -3.222399f, {{-1.104482f, -0.551328f}, {-0.630713f, -0.427771f}, {-0.233661f, -0.119206f}, {0.165110f, 0.185977f}, {0.656481f, 0.308955f}, {1.098639f, 0.494713f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::DoubleLine,
+     {159, -15.702010f, 25.480896f, {{-1.196229f, -0.370804f}, {-0.722459f, -0.247248f}, {-0.325408f, 0.061318f}, {0.073364f, 0.366501f}, {0.564735f, 0.489479f}, {1.006892f, 0.675236f}}},
+     {159, 12.796235f, -30.593473f, {{-1.006050f, -0.745007f}, {-0.571972f, -0.543353f}, {-0.099834f, -0.382530f}, {0.300847f, -0.081105f}, {0.705042f, 0.213405f}, {1.143332f, 0.406771f}}}},
+    {WaveformMode::SpectrumLine,
+     {511, 70.622948f, -144.399200f, {{-1.065401f, -0.628225f}, {-0.546442f, -0.563787f}, {-0.080172f, -0.395675f}, {0.375277f, -0.206271f}, {0.825977f, -0.007524f}, {1.273995f, 0.196501f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::Milkdrop2077Wave9,
+     {159, -0.685598f, -4.066041f, {{-1.106275f, -0.547800f}, {-0.613498f, -0.461644f}, {-0.233626f, -0.119276f}, {0.148654f, 0.218357f}, {0.660574f, 0.300903f}, {1.109094f, 0.474140f}}},
+     {159, 0.000000f, 0.000000f, {{0.000000f, 0.000000f}, {0.000000f, 0.000000f}, {0.000000f, 0.000000f}, {0.000000f, 0.000000f}, {0.000000f, 0.000000f}, {0.000000f, 0.000000f}}}},
+    {WaveformMode::Milkdrop2077WaveX,
+     {159, -1.547040f, -3.681745f, {{-1.102673f, -0.203671f}, {-0.648086f, -0.263558f}, {-0.233697f, -0.046437f}, {0.181717f, 0.165472f}, {0.652351f, 0.096620f}, {1.088087f, 0.132579f}}},
+     {159, 1.483715f, -2.036070f, {{0.144088f, -1.099162f}, {0.114878f, -0.669934f}, {0.158498f, -0.217710f}, {-0.017008f, 0.207334f}, {-0.181737f, 0.633715f}, {-0.198032f, 1.064545f}}}},
+    {WaveformMode::Milkdrop2077Wave11,
+     {159, -68.239540f, -2.191522f, {{-0.464726f, -1.099978f}, {-0.317551f, -0.673962f}, {-0.449912f, -0.233750f}, {-0.576961f, 0.206452f}, {-0.417871f, 0.646200f}, {-0.368377f, 1.072371f}}},
+     {159, 72.768303f, -2.188190f, {{0.455933f, -1.100011f}, {0.480461f, -0.673799f}, {0.580120f, -0.233957f}, {0.458973f, 0.206236f}, {0.348685f, 0.646412f}, {0.386229f, 1.072603f}}}},
+    {WaveformMode::Milkdrop2077WaveSkewed,
+     {479, 261.659180f, -203.316544f, {{0.639033f, -0.532208f}, {0.421734f, -0.205436f}, {0.413652f, -0.124574f}, {0.459186f, -0.302847f}, {0.683630f, -0.644906f}, {0.651210f, -0.691202f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::Milkdrop2077WaveStar,
+     {479, -0.338649f, -46.379356f, {{0.394981f, 0.380870f}, {-0.257887f, 0.675538f}, {-0.570240f, -0.182279f}, {-0.137769f, -0.997969f}, {0.420348f, -0.414459f}, {0.612839f, 0.641344f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::Milkdrop2077WaveFlower,
+     {479, -7.121728f, 45.198460f, {{-0.290256f, -0.167727f}, {0.541359f, 0.594809f}, {-0.332015f, 0.663863f}, {-0.020037f, -0.008437f}, {0.272880f, -0.375187f}, {-0.589221f, -0.274989f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+    {WaveformMode::Milkdrop2077WaveLasso,
+     {479, -528.289673f, 15.276471f, {{-1.213790f, 0.158984f}, {-1.333232f, 0.114000f}, {-1.156963f, -0.069115f}, {-1.424379f, 0.262752f}, {-0.883969f, -0.084884f}, {-0.456347f, -0.343296f}}},
+     {0, 0.000000f, 0.000000f, {}}},
+};
+// clang-format on
+
+/**
+ * Generates waveform vertices from deterministic audio data. The preset state contains
+ * OpenGL objects, so it needs a context even though the waveform math doesn't draw anything.
+ */
+class WaveformMathTest : public EGLTestFixture
+{
+protected:
+    void SetUp() override
+    {
+        EGLTestFixture::SetUp();
+        if (IsSkipped())
+        {
+            return;
+        }
+
+        if (!LoadGLFunctions())
+        {
+            GTEST_SKIP() << "Unable to load the OpenGL functions.";
+        }
+
+        m_state = std::make_unique<PresetState>();
+        m_state->renderContext.viewportSizeX = 512;
+        m_state->renderContext.viewportSizeY = 384;
+        m_state->renderContext.time = 3.7f;
+        m_state->waveScale = 1.0f;
+        m_state->waveSmoothing = 0.75f;
+        m_state->modWaveAlphaByvolume = false;
+        m_state->audioData.vol = 1.0f;
+
+        for (size_t sample = 0; sample < m_state->audioData.waveformLeft.size(); sample++)
+        {
+            float const position = static_cast<float>(sample);
+            m_state->audioData.waveformLeft[sample] = 48.0f * std::sin(position * 0.11f) + 16.0f * std::sin(position * 0.37f);
+            m_state->audioData.waveformRight[sample] = 40.0f * std::cos(position * 0.07f) - 20.0f * std::sin(position * 0.23f);
+        }
+        for (size_t sample = 0; sample < m_state->audioData.spectrumLeft.size(); sample++)
+        {
+            float const position = static_cast<float>(sample);
+            m_state->audioData.spectrumLeft[sample] = 30.0f / (1.0f + position * 0.05f);
+            m_state->audioData.spectrumRight[sample] = 25.0f / (1.0f + position * 0.03f) + 5.0f * std::sin(position * 0.2f);
+        }
+
+        m_perFrameContext = std::make_unique<PerFrameContext>(m_state->globalMemory, &m_state->globalRegisters);
+        m_perFrameContext->RegisterBuiltinVariables();
+        *m_perFrameContext->wave_x = 0.5;
+        *m_perFrameContext->wave_y = 0.45;
+        *m_perFrameContext->wave_mystery = 0.3;
+        *m_perFrameContext->wave_a = 0.8;
+    }
+
+    void TearDown() override
+    {
+        m_perFrameContext.reset();
+        m_state.reset();
+
+        EGLTestFixture::TearDown();
+    }
+
+    static void ExpectGoldenWave(const WaveformMath::VertexList& vertices, const GoldenWave& golden)
+    {
+        ASSERT_EQ(vertices.size(), golden.vertexCount);
+        if (vertices.empty())
+        {
+            return;
+        }
+
+        double sumX{};
+        double sumY{};
+        for (const auto& vertex : vertices)
+        {
+            sumX += vertex.X();
+            sumY += vertex.Y();
+        }
+        EXPECT_NEAR(sumX, golden.sumX, 1e-3);
+        EXPECT_NEAR(sumY, golden.sumY, 1e-3);
+
+        ASSERT_EQ(golden.vertices.size(), 6);
+        for (size_t sampledVertex = 0; sampledVertex < golden.vertices.size(); sampledVertex++)
+        {
+            size_t const index = sampledVertex == 5 ? vertices.size() - 1 : vertices.size() * sampledVertex / 5;
+            SCOPED_TRACE("vertex " + std::to_string(index));
+            EXPECT_NEAR(vertices[index].X(), golden.vertices[sampledVertex].X(), 1e-4);
+            EXPECT_NEAR(vertices[index].Y(), golden.vertices[sampledVertex].Y(), 1e-4);
+        }
+    }
+
+    std::unique_ptr<PresetState> m_state;
+    std::unique_ptr<PerFrameContext> m_perFrameContext;
+};
+
+} // namespace
+
+TEST_F(WaveformMathTest, MatchesGoldenVertices)
+{
+    ASSERT_EQ(goldenModes.size(), static_cast<size_t>(WaveformMode::Count));
+
+    for (const auto& golden : goldenModes)
+    {
+        SCOPED_TRACE("waveform mode " + std::to_string(static_cast<int>(golden.mode)));
+
+        auto waveformMath = Factory::Create(golden.mode);
+        ASSERT_TRUE(waveformMath);
+
+        std::array<WaveformMath::VertexList, 2> vertices;
+        waveformMath->GetVertices(*m_state, *m_perFrameContext, vertices);
+
+        {
+            SCOPED_TRACE("wave 1");
+            ExpectGoldenWave(vertices[0], golden.wave1);
+        }
+        {
+            SCOPED_TRACE("wave 2");
+            ExpectGoldenWave(vertices[1], golden.wave2);
+        }
+    }
+}
+
+TEST_F(WaveformMathTest, ReusesVertexStorage)
+{
+    for (int mode = 0; mode < static_cast<int>(WaveformMode::Count); mode++)
+    {
+        SCOPED_TRACE("waveform mode " + std::to_string(mode));
+
+        auto waveformMath = Factory::Create(static_cast<WaveformMode>(mode));
+        std::array<WaveformMath::VertexList, 2> vertices;
+        waveformMath->GetVertices(*m_state, *m_perFrameContext, vertices);
+        const auto* firstWaveData = vertices[0].data();
+
+        m_state->renderContext.time += 0.1f;
+        waveformMath->GetVertices(*m_state, *m_perFrameContext, vertices);
+        EXPECT_EQ(vertices[0].data(), firstWaveData);
+    }
+}
+
+/**
+ * Vertex generation time per frame for each waveform mode. Only prints timings, so it isn't run
+ * by default. Run with --gtest_also_run_disabled_tests.
+ */
+TEST_F(WaveformMathTest, DISABLED_Benchmark)
+{
+    constexpr int frameCount{5000};
+
+    for (int mode = 0; mode < static_cast<int>(WaveformMode::Count); mode++)
+    {
+        auto waveformMath = Factory::Create(static_cast<WaveformMode>(mode));
+        std::array<WaveformMath::VertexList, 2> vertices;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frameCount; frame++)
+        {
+            m_state->renderContext.time = static_cast<float>(frame) * 0.01f;
+            waveformMath->GetVertices(*m_state, *m_perFrameContext, vertices);
+        }
+        auto frameTime = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frameCount;
+
+        std::cout << "[ BENCHMARK ] Waveform mode " << mode << ": " << frameTime << " us/frame, "
+                  << vertices[0].size() + vertices[1].size() << " vertices" << std::endl;
+    }
+}
@@ -4,8 +4,11 @@
 
 #include <gtest/gtest.h>
 
+using ::testing::_;
+using ::testing::DoAll;
 using ::testing::Return;
 using ::testing::ReturnRef;
+using ::testing::SetArgReferee;
 using ::testing::Throw;
 
 /**
@@ -120,6 +123,66 @@ TEST(projectMPlaylistAPI, ItemsPartial)
 }
 
 
+TEST(projectMPlaylistAPI, ItemsGeneration)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, ItemsGeneration())
+        .Times(1)
+        .WillOnce(Return(1234));
+
+    EXPECT_EQ(projectm_playlist_items_generation(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), 1234);
+}
+
+
+TEST(projectMPlaylistAPI, ItemsView)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    std::vector<libprojectM::Playlist::Item> items{
+        libprojectM::Playlist::Item("/some/file"),
+        libprojectM::Playlist::Item("/another/file1"),
+        libprojectM::Playlist::Item("/another/file2")};
+
+    EXPECT_CALL(mockPlaylist, Items())
+        .Times(2)
+        .WillRepeatedly(ReturnRef(items));
+    EXPECT_CALL(mockPlaylist, ItemsGeneration())
+        .Times(1)
+        .WillOnce(Return(42));
+
+    const char* filenames[5]{};
+    uint64_t generation{};
+
+    EXPECT_EQ(projectm_playlist_items_view(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 1, 5, filenames, &generation), 2);
+    EXPECT_EQ(generation, 42);
+
+    // Pointers must reference the playlist-owned strings.
+    EXPECT_EQ(filenames[0], items.at(1).Filename().c_str());
+    EXPECT_EQ(filenames[1], items.at(2).Filename().c_str());
+    EXPECT_EQ(filenames[2], nullptr);
+
+    EXPECT_EQ(projectm_playlist_items_view(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 3, 5, filenames, nullptr), 0);
+}
+
+
+TEST(projectMPlaylistAPI, Find)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, Find(std::string("*.milk"), 10, 3))
+        .Times(1)
+        .WillOnce(Return(std::vector<uint32_t>{12, 15}));
+
+    uint32_t indices[3]{};
+    EXPECT_EQ(projectm_playlist_find(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), "*.milk", 10, 3, indices), 2);
+    EXPECT_EQ(indices[0], 12);
+    EXPECT_EQ(indices[1], 15);
+
+    EXPECT_EQ(projectm_playlist_find(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), nullptr, 10, 3, indices), 0);
+}
+
+
 TEST(projectMPlaylistAPI, ItemsOutOfRange)
 {
     PlaylistCWrapperMock mockPlaylist;
@@ -351,6 +414,55 @@ TEST(projectMPlaylistAPI, SetShuffle)
 }
 
 
+TEST(projectMPlaylistAPI, SetShuffleMode)
+{
+    using libprojectM::Playlist::Playlist;
+
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, SetShuffleMode(Playlist::ShuffleMode::Random))
+        .Times(1);
+    EXPECT_CALL(mockPlaylist, SetShuffleMode(Playlist::ShuffleMode::Bag))
+        .Times(1);
+
+    projectm_playlist_set_shuffle_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), SHUFFLE_MODE_RANDOM);
+    projectm_playlist_set_shuffle_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), SHUFFLE_MODE_BAG);
+}
+
+
+TEST(projectMPlaylistAPI, GetShuffleMode)
+{
+    using libprojectM::Playlist::Playlist;
+
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, GetShuffleMode())
+        .Times(2)
+        .WillOnce(Return(Playlist::ShuffleMode::Random))
+        .WillOnce(Return(Playlist::ShuffleMode::Bag));
+
+    EXPECT_EQ(projectm_playlist_get_shuffle_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), SHUFFLE_MODE_RANDOM);
+    EXPECT_EQ(projectm_playlist_get_shuffle_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), SHUFFLE_MODE_BAG);
+}
+
+
+TEST(projectMPlaylistAPI, PeekNextPosition)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, PeekNextPresetIndex(_))
+        .Times(2)
+        .WillOnce(Return(false))
+        .WillOnce(DoAll(SetArgReferee<0>(5), Return(true)));
+
+    uint32_t position{0};
+    EXPECT_FALSE(projectm_playlist_peek_next_position(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), &position));
+    EXPECT_EQ(position, 0);
+    EXPECT_TRUE(projectm_playlist_peek_next_position(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), &position));
+    EXPECT_EQ(position, 5);
+}
+
+
 TEST(projectMPlaylistAPI, Sort)
 {
     using libprojectM::Playlist::Playlist;
@@ -651,4 +763,122 @@ TEST(projectMPlaylistAPI, ApplyFilter)
         .WillOnce(Return(5));
 
     EXPECT_EQ(projectm_playlist_apply_filter(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), 5);
-}
\ No newline at end of file
+}
+
+TEST(projectMPlaylistAPI, Save)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, SaveSnapshot(std::string("/some/playlist.bin")))
+        .Times(1)
+        .WillOnce(Return(true));
+
+    EXPECT_TRUE(projectm_playlist_save(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), "/some/playlist.bin"));
+    EXPECT_FALSE(projectm_playlist_save(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), nullptr));
+}
+
+
+TEST(projectMPlaylistAPI, Load)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, LoadSnapshot(std::string("/some/playlist.bin")))
+        .Times(1)
+        .WillOnce(Return(false));
+
+    EXPECT_FALSE(projectm_playlist_load(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), "/some/playlist.bin"));
+    EXPECT_FALSE(projectm_playlist_load(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), nullptr));
+}
+
+
+TEST(projectMPlaylistAPI, SetFrameBudget)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, SetFrameBudget(0.04))
+        .Times(1);
+
+    projectm_playlist_set_frame_budget(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 0.04);
+}
+
+
+TEST(projectMPlaylistAPI, GetFrameBudget)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, FrameBudget())
+        .Times(1)
+        .WillOnce(Return(0.02));
+
+    EXPECT_DOUBLE_EQ(projectm_playlist_get_frame_budget(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), 0.02);
+}
+
+
+TEST(projectMPlaylistAPI, SetCostMode)
+{
+    using libprojectM::Playlist::Playlist;
+
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, SetCostMode(Playlist::CostMode::Ignore))
+        .Times(1);
+    EXPECT_CALL(mockPlaylist, SetCostMode(Playlist::CostMode::Skip))
+        .Times(1);
+    EXPECT_CALL(mockPlaylist, SetCostMode(Playlist::CostMode::DownWeight))
+        .Times(1);
+
+    projectm_playlist_set_cost_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), COST_MODE_IGNORE);
+    projectm_playlist_set_cost_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), COST_MODE_SKIP);
+    projectm_playlist_set_cost_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), COST_MODE_DOWN_WEIGHT);
+}
+
+
+TEST(projectMPlaylistAPI, GetCostMode)
+{
+    using libprojectM::Playlist::Playlist;
+
+    PlaylistCWrapperMock mockPlaylist;
+
+    EXPECT_CALL(mockPlaylist, GetCostMode())
+        .Times(3)
+        .WillOnce(Return(Playlist::CostMode::Ignore))
+        .WillOnce(Return(Playlist::CostMode::Skip))
+        .WillOnce(Return(Playlist::CostMode::DownWeight));
+
+    EXPECT_EQ(projectm_playlist_get_cost_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), COST_MODE_IGNORE);
+    EXPECT_EQ(projectm_playlist_get_cost_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), COST_MODE_SKIP);
+    EXPECT_EQ(projectm_playlist_get_cost_mode(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist)), COST_MODE_DOWN_WEIGHT);
+}
+
+
+TEST(projectMPlaylistAPI, GetPresetStats)
+{
+    PlaylistCWrapperMock mockPlaylist;
+
+    std::vector<libprojectM::Playlist::Item> items{
+        libprojectM::Playlist::Item("/some/PresetA.milk"),
+        libprojectM::Playlist::Item("/some/PresetB.milk")};
+
+    EXPECT_CALL(mockPlaylist, Items())
+        .WillRepeatedly(ReturnRef(items));
+
+    mockPlaylist.Stats().Record("/some/PresetB.milk", 100, 0.05);
+
+    uint32_t playCount{};
+    uint64_t frameCount{};
+    double averageFrameTime{};
+
+    EXPECT_FALSE(projectm_playlist_get_preset_stats(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 0, &playCount, &frameCount, &averageFrameTime));
+    EXPECT_FALSE(projectm_playlist_get_preset_stats(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 2, &playCount, &frameCount, &averageFrameTime));
+
+    ASSERT_TRUE(projectm_playlist_get_preset_stats(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 1, &playCount, &frameCount, &averageFrameTime));
+    EXPECT_EQ(playCount, 1);
+    EXPECT_EQ(frameCount, 100);
+    EXPECT_DOUBLE_EQ(averageFrameTime, 0.05);
+
+    EXPECT_TRUE(projectm_playlist_get_preset_stats(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 1, nullptr, nullptr, nullptr));
+
+    projectm_playlist_clear_stats(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist));
+
+    EXPECT_FALSE(projectm_playlist_get_preset_stats(reinterpret_cast<projectm_playlist_handle>(&mockPlaylist), 1, nullptr, nullptr, nullptr));
+}
@@ -192,4 +192,76 @@ TEST(projectMPlaylistFilter, MatchEverything)
     EXPECT_FALSE(filter.Passes("\\path\\to\\yet\\another\\TestCase.milk"));
     EXPECT_FALSE(filter.Passes("/path/of/my/TestPreset.milk"));
     EXPECT_FALSE(filter.Passes("/another/something/completely/different"));
-}
\ No newline at end of file
+}
+
+TEST(projectMPlaylistFilter, PrefixMatch)
+{
+    Filter filter;
+
+    filter.SetList({"-Test*"});
+
+    EXPECT_FALSE(filter.Passes("/path/to/TestSome.milk"));
+    EXPECT_FALSE(filter.Passes("Test"));
+    EXPECT_TRUE(filter.Passes("/path/to/Tes.milk"));
+
+    filter.SetList({"-/path/Test*"});
+
+    EXPECT_FALSE(filter.Passes("/path/TestSome.milk"));
+    EXPECT_FALSE(filter.Passes("\\path\\TestSome.milk"));
+    EXPECT_TRUE(filter.Passes("/path/TestSome/Preset.milk"));
+}
+
+
+TEST(projectMPlaylistFilter, SuffixMatch)
+{
+    Filter filter;
+
+    filter.SetList({"-*.milk"});
+
+    EXPECT_FALSE(filter.Passes("/path/to/TestSome.milk"));
+    EXPECT_FALSE(filter.Passes(".milk"));
+    EXPECT_TRUE(filter.Passes("/path/to/TestSome.milk2"));
+    EXPECT_TRUE(filter.Passes("milk"));
+
+    filter.SetList({"-*/TestSome.milk"});
+
+    EXPECT_FALSE(filter.Passes("path/TestSome.milk"));
+    EXPECT_FALSE(filter.Passes("path\\TestSome.milk"));
+    EXPECT_TRUE(filter.Passes("path/to/TestSome.milk"));
+}
+
+
+TEST(projectMPlaylistFilter, FirstMatchingRuleWins)
+{
+    Filter filter;
+
+    // Literal rules are looked up separately, but must still respect the rule order.
+    filter.SetList({"+/path/to/Test*.milk",
+                    "-TestSome.milk",
+                    "-/path/to/TestSome.milk",
+                    "+**/Other.milk",
+                    "-Other.milk"});
+
+    EXPECT_TRUE(filter.Passes("/path/to/TestSome.milk"));
+    EXPECT_FALSE(filter.Passes("/another/path/TestSome.milk"));
+    EXPECT_TRUE(filter.Passes("/another/path/Other.milk"));
+
+    filter.SetList({"-TestSome.milk",
+                    "+/path/to/Test*.milk"});
+
+    EXPECT_FALSE(filter.Passes("/path/to/TestSome.milk"));
+    EXPECT_TRUE(filter.Passes("/path/to/TestOther.milk"));
+}
+
+
+TEST(projectMPlaylistFilter, Matches)
+{
+    Filter filter;
+
+    filter.SetList({"+/path/to/Test*.milk",
+                    "-Other.milk"});
+
+    EXPECT_TRUE(filter.Matches("/path/to/TestSome.milk"));
+    EXPECT_TRUE(filter.Matches("/path/to/Other.milk"));
+    EXPECT_FALSE(filter.Matches("/path/to/Preset.milk"));
+}
@@ -23,3 +23,11 @@ TEST(projectMPlaylistItem, FilenameEquality)
     EXPECT_TRUE(item == "/some/file");
     EXPECT_FALSE(item == "/some/other/file");
 }
+
+
+TEST(projectMPlaylistItem, Id)
+{
+    libprojectM::Playlist::Item item("/some/file", 42);
+
+    EXPECT_EQ(item.Id(), 42);
+}
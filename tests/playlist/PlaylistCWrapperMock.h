@@ -18,11 +18,16 @@ public:
     MOCK_METHOD(bool, Empty, (), (const));
     MOCK_METHOD(void, Clear, ());
     MOCK_METHOD(const std::vector<libprojectM::Playlist::Item>&, Items, (), (const));
+    MOCK_METHOD(uint64_t, ItemsGeneration, (), (const));
+    MOCK_METHOD(std::vector<uint32_t>, Find, (const std::string&, uint32_t, uint32_t), (const));
     MOCK_METHOD(bool, AddItem, (const std::string&, uint32_t, bool) );
     MOCK_METHOD(uint32_t, AddPath, (const std::string&, uint32_t, bool, bool) );
     MOCK_METHOD(bool, RemoveItem, (uint32_t));
     MOCK_METHOD(bool, Shuffle, (), (const));
     MOCK_METHOD(void, SetShuffle, (bool) );
+    MOCK_METHOD(void, SetShuffleMode, (ShuffleMode));
+    MOCK_METHOD(ShuffleMode, GetShuffleMode, (), (const));
+    MOCK_METHOD(bool, PeekNextPresetIndex, (uint32_t&));
     MOCK_METHOD(void, Sort, (uint32_t, uint32_t, SortPredicate, SortOrder));
     MOCK_METHOD(uint32_t, RetryCount, ());
     MOCK_METHOD(void, SetRetryCount, (uint32_t));
@@ -37,4 +42,10 @@ public:
     MOCK_METHOD(void, SetPresetSwitchFailedCallback, (projectm_playlist_preset_switch_failed_event, void*) );
     MOCK_METHOD(class libprojectM::Playlist::Filter&, Filter, ());
     MOCK_METHOD(uint32_t, ApplyFilter, ());
+    MOCK_METHOD(bool, SaveSnapshot, (const std::string&), (const));
+    MOCK_METHOD(bool, LoadSnapshot, (const std::string&));
+    MOCK_METHOD(void, SetFrameBudget, (double));
+    MOCK_METHOD(double, FrameBudget, (), (const));
+    MOCK_METHOD(void, SetCostMode, (CostMode));
+    MOCK_METHOD(CostMode, GetCostMode, (), (const));
 };
@@ -0,0 +1,145 @@
+#include <Playlist.hpp>
+#include <PlaylistSnapshot.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+
+using libprojectM::Playlist::Playlist;
+using libprojectM::Playlist::PlaylistSnapshot;
+
+namespace {
+
+auto ReadFile(const std::string& filename) -> std::vector<char>
+{
+    std::ifstream file(filename, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void WriteFile(const std::string& filename, const std::vector<char>& data)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+auto CreateSnapshot() -> PlaylistSnapshot
+{
+    PlaylistSnapshot snapshot;
+    snapshot.items = {"/some/PresetZ.milk", "/some/PresetA.milk", "/some/other/PresetC.milk"};
+    snapshot.filters = {"-**/Bad*.milk", "+/some/**"};
+    snapshot.history = {0, 2, 1};
+    snapshot.shuffle = true;
+    snapshot.currentPosition = 2;
+    return snapshot;
+}
+
+} // namespace
+
+TEST(projectMPlaylistSnapshot, RoundTrip)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/RoundTrip.pmpl";
+
+    ASSERT_TRUE(CreateSnapshot().Save(filename));
+
+    PlaylistSnapshot loaded;
+    ASSERT_TRUE(loaded.Load(filename));
+
+    auto expected = CreateSnapshot();
+    EXPECT_EQ(loaded.items, expected.items);
+    EXPECT_EQ(loaded.filters, expected.filters);
+    EXPECT_EQ(loaded.history, expected.history);
+    EXPECT_EQ(loaded.shuffle, expected.shuffle);
+    EXPECT_EQ(loaded.currentPosition, expected.currentPosition);
+}
+
+
+TEST(projectMPlaylistSnapshot, MissingFile)
+{
+    PlaylistSnapshot snapshot;
+    EXPECT_FALSE(snapshot.Load(PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/DoesNotExist.pmpl"));
+}
+
+
+TEST(projectMPlaylistSnapshot, Truncated)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/Truncated.pmpl";
+
+    ASSERT_TRUE(CreateSnapshot().Save(filename));
+    auto data = ReadFile(filename);
+
+    for (size_t length = 0; length < data.size(); length++)
+    {
+        WriteFile(filename, {data.begin(), data.begin() + static_cast<std::ptrdiff_t>(length)});
+
+        PlaylistSnapshot snapshot;
+        EXPECT_FALSE(snapshot.Load(filename)) << "Length: " << length;
+    }
+}
+
+
+TEST(projectMPlaylistSnapshot, Corrupted)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/Corrupted.pmpl";
+
+    ASSERT_TRUE(CreateSnapshot().Save(filename));
+    auto data = ReadFile(filename);
+
+    for (size_t offset = 0; offset < data.size(); offset++)
+    {
+        auto corruptedData = data;
+        corruptedData[offset] = static_cast<char>(corruptedData[offset] ^ 0x5A);
+        WriteFile(filename, corruptedData);
+
+        PlaylistSnapshot snapshot = CreateSnapshot();
+        snapshot.items.clear();
+        EXPECT_FALSE(snapshot.Load(filename)) << "Offset: " << offset;
+        EXPECT_TRUE(snapshot.items.empty());
+    }
+}
+
+
+TEST(projectMPlaylistSnapshot, PlaylistRoundTrip)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PlaylistRoundTrip.pmpl";
+
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/other/PresetC.milk", Playlist::InsertAtEnd, false));
+    playlist.SetShuffle(true);
+    playlist.SetPresetIndex(2);
+    playlist.SetPresetIndex(1);
+    playlist.Filter().SetList({"-**/Bad*.milk"});
+
+    ASSERT_TRUE(playlist.SaveSnapshot(filename));
+
+    Playlist restoredPlaylist;
+    EXPECT_TRUE(restoredPlaylist.AddItem("/to/be/replaced.milk", Playlist::InsertAtEnd, false));
+    ASSERT_TRUE(restoredPlaylist.LoadSnapshot(filename));
+
+    ASSERT_EQ(restoredPlaylist.Size(), 3);
+    EXPECT_EQ(restoredPlaylist.Items().at(0).Filename(), "/some/PresetZ.milk");
+    EXPECT_EQ(restoredPlaylist.Items().at(1).Filename(), "/some/PresetA.milk");
+    EXPECT_EQ(restoredPlaylist.Items().at(2).Filename(), "/some/other/PresetC.milk");
+    EXPECT_TRUE(restoredPlaylist.Shuffle());
+    EXPECT_EQ(restoredPlaylist.PresetIndex(), 1);
+    EXPECT_EQ(restoredPlaylist.HistoryItems(), playlist.HistoryItems());
+    EXPECT_EQ(restoredPlaylist.Filter().List(), playlist.Filter().List());
+    EXPECT_FALSE(restoredPlaylist.Filter().Passes("/some/BadPreset.milk"));
+
+    EXPECT_EQ(restoredPlaylist.LastPresetIndex(), 2);
+    EXPECT_EQ(restoredPlaylist.LastPresetIndex(), 0);
+}
+
+
+TEST(projectMPlaylistSnapshot, PlaylistUnchangedOnFailure)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+
+    EXPECT_FALSE(playlist.LoadSnapshot(PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/DoesNotExist.pmpl"));
+
+    ASSERT_EQ(playlist.Size(), 1);
+    EXPECT_EQ(playlist.Items().at(0).Filename(), "/some/PresetZ.milk");
+}
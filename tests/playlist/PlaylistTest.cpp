@@ -351,6 +351,118 @@ TEST(projectMPlaylistPlaylist, RemoveItemWithHistory)
 }
 
 
+TEST(projectMPlaylistPlaylist, ItemIdsAreUnique)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/file", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/other/file", 0, false));
+    EXPECT_TRUE(playlist.RemoveItem(0));
+    EXPECT_TRUE(playlist.AddItem("/some/other/file", Playlist::InsertAtEnd, false));
+
+    const auto& items = playlist.Items();
+    ASSERT_EQ(items.size(), 2);
+    EXPECT_NE(items.at(0).Id(), items.at(1).Id());
+}
+
+
+TEST(projectMPlaylistPlaylist, SortWithHistory)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetC.milk", Playlist::InsertAtEnd, false));
+
+    playlist.SetPresetIndex(1);
+    playlist.SetPresetIndex(2);
+    playlist.SetPresetIndex(0);
+
+    playlist.Sort(0, 3, Playlist::SortPredicate::FullPath, Playlist::SortOrder::Ascending);
+
+    // History still refers to PresetZ, PresetA and PresetC, now at indices 2, 0 and 1.
+    auto historyItems = playlist.HistoryItems();
+    ASSERT_EQ(historyItems.size(), 3);
+    EXPECT_EQ(historyItems.at(0), 2);
+    EXPECT_EQ(historyItems.at(1), 0);
+    EXPECT_EQ(historyItems.at(2), 1);
+
+    EXPECT_EQ(playlist.LastPresetIndex(), 1);
+    EXPECT_EQ(playlist.LastPresetIndex(), 0);
+    EXPECT_EQ(playlist.LastPresetIndex(), 2);
+}
+
+
+TEST(projectMPlaylistPlaylist, ApplyFilterWithHistory)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetC.milk", Playlist::InsertAtEnd, false));
+
+    playlist.SetPresetIndex(1);
+    playlist.SetPresetIndex(2);
+    playlist.SetPresetIndex(0);
+
+    playlist.Filter().SetList({"-PresetA.milk"});
+    EXPECT_EQ(playlist.ApplyFilter(), 1);
+
+    auto historyItems = playlist.HistoryItems();
+    ASSERT_EQ(historyItems.size(), 2);
+    EXPECT_EQ(historyItems.at(0), 0);
+    EXPECT_EQ(historyItems.at(1), 1);
+
+    // Removed item is skipped when going back in history.
+    EXPECT_EQ(playlist.LastPresetIndex(), 1);
+    EXPECT_EQ(playlist.LastPresetIndex(), 0);
+}
+
+
+TEST(projectMPlaylistPlaylist, RemoveItems)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetC.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, true));
+
+    playlist.SetPresetIndex(1);
+    playlist.SetPresetIndex(2);
+    playlist.SetPresetIndex(0);
+
+    EXPECT_EQ(playlist.RemoveItems({}), 0);
+    EXPECT_EQ(playlist.RemoveItems({"/some/PresetA.milk", "/some/PresetX.milk"}), 2);
+
+    ASSERT_EQ(playlist.Size(), 2);
+    EXPECT_EQ(playlist.Items().at(0).Filename(), "/some/PresetZ.milk");
+    EXPECT_EQ(playlist.Items().at(1).Filename(), "/some/PresetC.milk");
+
+    auto historyItems = playlist.HistoryItems();
+    ASSERT_EQ(historyItems.size(), 2);
+    EXPECT_EQ(historyItems.at(0), 0);
+    EXPECT_EQ(historyItems.at(1), 1);
+}
+
+
+TEST(projectMPlaylistPlaylist, HistorySizeLimit)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+
+    for (size_t iteration = 0; iteration < Playlist::MaxHistoryItems + 10; iteration++)
+    {
+        playlist.NextPresetIndex();
+    }
+
+    auto historyItems = playlist.HistoryItems();
+    ASSERT_EQ(historyItems.size(), Playlist::MaxHistoryItems);
+
+    // Oldest entries were dropped. Current item is index 0, so the newest history entry is 1.
+    EXPECT_EQ(playlist.PresetIndex(), 0);
+    EXPECT_EQ(historyItems.back(), 1);
+    EXPECT_EQ(historyItems.front(), 0);
+}
+
+
 TEST(projectMPlaylistPlaylist, RemoveItemIndexOutOfBounds)
 {
     Playlist playlist;
@@ -549,6 +661,140 @@ TEST(projectMPlaylistPlaylist, NextPresetIndexShuffle)
 }
 
 
+TEST(projectMPlaylistPlaylist, NextPresetIndexShuffleBag)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetShuffleMode(Playlist::ShuffleMode::Bag);
+    EXPECT_EQ(playlist.GetShuffleMode(), Playlist::ShuffleMode::Bag);
+
+    for (int index = 0; index < 10; index++)
+    {
+        EXPECT_TRUE(playlist.AddItem("/some/Preset" + std::to_string(index) + ".milk", Playlist::InsertAtEnd, false));
+    }
+
+    // Each cycle plays every item exactly once, and no item is repeated across cycle boundaries.
+    uint32_t lastIndex = playlist.PresetIndex();
+    for (int cycle = 0; cycle < 5; cycle++)
+    {
+        std::set<uint32_t> playlistIndices;
+        for (int i = 0; i < 10; i++)
+        {
+            uint32_t predictedIndex{};
+            ASSERT_TRUE(playlist.PeekNextPresetIndex(predictedIndex));
+
+            auto index = playlist.NextPresetIndex();
+            EXPECT_EQ(index, predictedIndex);
+            EXPECT_NE(index, lastIndex);
+
+            playlistIndices.insert(index);
+            lastIndex = index;
+        }
+
+        EXPECT_EQ(playlistIndices.size(), 10);
+    }
+}
+
+
+TEST(projectMPlaylistPlaylist, ShuffleBagAddAndRemoveItems)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetShuffleMode(Playlist::ShuffleMode::Bag);
+
+    for (int index = 0; index < 4; index++)
+    {
+        EXPECT_TRUE(playlist.AddItem("/some/Preset" + std::to_string(index) + ".milk", Playlist::InsertAtEnd, false));
+    }
+
+    // Start a cycle, then change the playlist.
+    std::set<std::string> played;
+    played.insert(playlist.Items().at(playlist.NextPresetIndex()).Filename());
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetNew.milk", 0, false));
+
+    std::string removed;
+    for (const auto& item : playlist.Items())
+    {
+        if (played.find(item.Filename()) == played.end() && item.Filename() != "/some/PresetNew.milk")
+        {
+            removed = item.Filename();
+            break;
+        }
+    }
+    EXPECT_EQ(playlist.RemoveItems({removed}), 1);
+
+    // The rest of the cycle contains the new item, but not the removed one.
+    for (int i = 0; i < 3; i++)
+    {
+        played.insert(playlist.Items().at(playlist.NextPresetIndex()).Filename());
+    }
+
+    EXPECT_EQ(played.size(), 4);
+    EXPECT_TRUE(played.find("/some/PresetNew.milk") != played.end());
+    EXPECT_TRUE(played.find(removed) == played.end());
+}
+
+
+TEST(projectMPlaylistPlaylist, PreviousPresetIndexShuffleBag)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetShuffleMode(Playlist::ShuffleMode::Bag);
+
+    for (int index = 0; index < 10; index++)
+    {
+        EXPECT_TRUE(playlist.AddItem("/some/Preset" + std::to_string(index) + ".milk", Playlist::InsertAtEnd, false));
+    }
+
+    std::vector<uint32_t> played;
+    for (int i = 0; i < 4; i++)
+    {
+        played.push_back(playlist.NextPresetIndex());
+    }
+
+    // Stepping back returns the items played before, in reverse order.
+    EXPECT_EQ(playlist.PreviousPresetIndex(), played.at(2));
+    EXPECT_EQ(playlist.PreviousPresetIndex(), played.at(1));
+
+    // Going forward again replays the items stepped over.
+    EXPECT_EQ(playlist.NextPresetIndex(), played.at(2));
+    EXPECT_EQ(playlist.NextPresetIndex(), played.at(3));
+
+    // The rest of the cycle still contains every item exactly once.
+    std::set<uint32_t> playlistIndices(played.begin(), played.end());
+    for (int i = 0; i < 6; i++)
+    {
+        playlistIndices.insert(playlist.NextPresetIndex());
+    }
+    EXPECT_EQ(playlistIndices.size(), 10);
+}
+
+
+TEST(projectMPlaylistPlaylist, PeekNextPresetIndex)
+{
+    Playlist playlist;
+
+    uint32_t index{};
+    EXPECT_FALSE(playlist.PeekNextPresetIndex(index));
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+
+    ASSERT_TRUE(playlist.PeekNextPresetIndex(index));
+    EXPECT_EQ(index, 1);
+    EXPECT_EQ(playlist.NextPresetIndex(), 1);
+    ASSERT_TRUE(playlist.PeekNextPresetIndex(index));
+    EXPECT_EQ(index, 0);
+
+    playlist.SetShuffle(true);
+    EXPECT_FALSE(playlist.PeekNextPresetIndex(index));
+}
+
+
 TEST(projectMPlaylistPlaylist, NextPresetIndexSequential)
 {
     Playlist playlist;
@@ -568,6 +814,148 @@ TEST(projectMPlaylistPlaylist, NextPresetIndexSequential)
 }
 
 
+TEST(projectMPlaylistPlaylist, NextPresetIndexCostSkipSequential)
+{
+    Playlist playlist;
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetB.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetC.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetD.milk", Playlist::InsertAtEnd, false));
+
+    playlist.Stats().Record("/some/PresetB.milk", 100, 0.1);
+    // Not enough frames recorded to be rated.
+    playlist.Stats().Record("/some/PresetC.milk", Playlist::MinCostEstimateFrames - 1, 0.1);
+
+    // Budget not enabled yet.
+    playlist.SetCostMode(Playlist::CostMode::Skip);
+    EXPECT_EQ(playlist.NextPresetIndex(), 1);
+
+    playlist.SetFrameBudget(0.05);
+    EXPECT_EQ(playlist.NextPresetIndex(), 2);
+    EXPECT_EQ(playlist.NextPresetIndex(), 3);
+    EXPECT_EQ(playlist.NextPresetIndex(), 0);
+    EXPECT_EQ(playlist.NextPresetIndex(), 2);
+    EXPECT_EQ(playlist.PreviousPresetIndex(), 0);
+}
+
+
+TEST(projectMPlaylistPlaylist, NextPresetIndexCostSkipAllOverBudget)
+{
+    Playlist playlist;
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetB.milk", Playlist::InsertAtEnd, false));
+
+    playlist.Stats().Record("/some/PresetA.milk", 100, 0.1);
+    playlist.Stats().Record("/some/PresetB.milk", 100, 0.1);
+
+    playlist.SetFrameBudget(0.05);
+    playlist.SetCostMode(Playlist::CostMode::Skip);
+
+    // Falls back to the adjacent item.
+    EXPECT_EQ(playlist.NextPresetIndex(), 1);
+    EXPECT_EQ(playlist.NextPresetIndex(), 0);
+}
+
+
+TEST(projectMPlaylistPlaylist, NextPresetIndexCostSkipShuffle)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetFrameBudget(0.05);
+    playlist.SetCostMode(Playlist::CostMode::Skip);
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetB.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetC.milk", Playlist::InsertAtEnd, false));
+
+    playlist.Stats().Record("/some/PresetB.milk", 100, 0.1);
+
+    // With 16 attempts per selection, the chance of not finding an item within budget is (1/3)^16.
+    for (int i = 0; i < 100; i++)
+    {
+        EXPECT_NE(playlist.NextPresetIndex(), 1);
+    }
+}
+
+
+TEST(projectMPlaylistPlaylist, NextPresetIndexCostSkipShuffleSingleItemWithinBudget)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetFrameBudget(0.05);
+    playlist.SetCostMode(Playlist::CostMode::Skip);
+
+    // With only one of 64 items within budget, most random draws miss it.
+    for (int i = 0; i < 64; i++)
+    {
+        auto filename = "/some/Preset" + std::to_string(i) + ".milk";
+        EXPECT_TRUE(playlist.AddItem(filename, Playlist::InsertAtEnd, false));
+        if (i != 42)
+        {
+            playlist.Stats().Record(filename, 100, 0.1);
+        }
+    }
+
+    for (int i = 0; i < 20; i++)
+    {
+        EXPECT_EQ(playlist.NextPresetIndex(), 42);
+    }
+}
+
+
+TEST(projectMPlaylistPlaylist, NextPresetIndexCostSkipShuffleBagSingleItemWithinBudget)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetShuffleMode(Playlist::ShuffleMode::Bag);
+    playlist.SetFrameBudget(0.05);
+    playlist.SetCostMode(Playlist::CostMode::Skip);
+
+    // The only item within budget is usually further back in the bag than the items checked first.
+    for (int i = 0; i < 64; i++)
+    {
+        auto filename = "/some/Preset" + std::to_string(i) + ".milk";
+        EXPECT_TRUE(playlist.AddItem(filename, Playlist::InsertAtEnd, false));
+        if (i != 42)
+        {
+            playlist.Stats().Record(filename, 100, 0.1);
+        }
+    }
+
+    EXPECT_EQ(playlist.NextPresetIndex(), 42);
+}
+
+
+TEST(projectMPlaylistPlaylist, NextPresetIndexCostDownWeight)
+{
+    Playlist playlist;
+
+    playlist.SetShuffle(true);
+    playlist.SetFrameBudget(0.01);
+    playlist.SetCostMode(Playlist::CostMode::DownWeight);
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetB.milk", Playlist::InsertAtEnd, false));
+
+    // PresetB is ten times over budget and accepted with a probability of 0.1.
+    playlist.Stats().Record("/some/PresetB.milk", 100, 0.1);
+
+    std::vector<int> playCount(2);
+    for (int i = 0; i < 1000; i++)
+    {
+        playCount.at(playlist.NextPresetIndex())++;
+    }
+
+    EXPECT_GT(playCount.at(0), 800);
+    EXPECT_GT(playCount.at(1), 0);
+}
+
+
 TEST(projectMPlaylistPlaylist, PreviousPresetIndexEmptyPlaylist)
 {
     Playlist playlist;
@@ -783,3 +1171,82 @@ TEST(projectMPlaylistPlaylist, ApplyFilter)
     // Test_A will not reappear.
     ASSERT_EQ(playlist.Size(), 2);
 }
+
+
+TEST(projectMPlaylistPlaylist, ApplyFilterKeepsOrder)
+{
+    Playlist playlist;
+
+    // Large enough to be filtered on multiple threads.
+    const uint32_t itemCount = 4 * Playlist::MinItemsPerFilterThread + 123;
+    for (uint32_t index = 0; index < itemCount; index++)
+    {
+        std::string filename = "/presets/" + std::to_string(index) + (index % 3 == 0 ? "_remove.milk" : ".milk");
+        ASSERT_TRUE(playlist.AddItem(filename, Playlist::InsertAtEnd, true));
+    }
+
+    playlist.Filter().SetList({"-*_remove.milk"});
+
+    EXPECT_EQ(playlist.ApplyFilter(), (itemCount + 2) / 3);
+
+    const auto& items = playlist.Items();
+    ASSERT_EQ(items.size(), itemCount - (itemCount + 2) / 3);
+
+    uint32_t expectedIndex{1};
+    for (const auto& item : items)
+    {
+        EXPECT_EQ(item.Filename(), "/presets/" + std::to_string(expectedIndex) + ".milk");
+        expectedIndex += expectedIndex % 3 == 1 ? 1 : 2;
+    }
+}
+
+
+TEST(projectMPlaylistPlaylist, ItemsGeneration)
+{
+    Playlist playlist;
+
+    auto generation = playlist.ItemsGeneration();
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_GT(playlist.ItemsGeneration(), generation);
+    generation = playlist.ItemsGeneration();
+
+    // Failed or non-mutating calls don't change the generation.
+    EXPECT_FALSE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_FALSE(playlist.RemoveItem(5));
+    EXPECT_EQ(playlist.ApplyFilter(), 0);
+    playlist.NextPresetIndex();
+    EXPECT_EQ(playlist.ItemsGeneration(), generation);
+
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", 0, false));
+    EXPECT_GT(playlist.ItemsGeneration(), generation);
+    generation = playlist.ItemsGeneration();
+
+    playlist.Sort(0, 2, Playlist::SortPredicate::FullPath, Playlist::SortOrder::Descending);
+    EXPECT_GT(playlist.ItemsGeneration(), generation);
+    generation = playlist.ItemsGeneration();
+
+    EXPECT_TRUE(playlist.RemoveItem(0));
+    EXPECT_GT(playlist.ItemsGeneration(), generation);
+    generation = playlist.ItemsGeneration();
+
+    playlist.Clear();
+    EXPECT_GT(playlist.ItemsGeneration(), generation);
+}
+
+
+TEST(projectMPlaylistPlaylist, Find)
+{
+    Playlist playlist;
+    EXPECT_TRUE(playlist.AddItem("/some/PresetZ.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/Other.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/other/PresetC.milk", Playlist::InsertAtEnd, false));
+    EXPECT_TRUE(playlist.AddItem("/some/PresetA.milk", Playlist::InsertAtEnd, false));
+
+    EXPECT_EQ(playlist.Find("Preset*", 0, 10), std::vector<uint32_t>({0, 2, 3}));
+    EXPECT_EQ(playlist.Find("-Preset*", 1, 10), std::vector<uint32_t>({2, 3}));
+    EXPECT_EQ(playlist.Find("Preset*", 0, 2), std::vector<uint32_t>({0, 2}));
+    EXPECT_EQ(playlist.Find("/some/Preset*", 0, 10), std::vector<uint32_t>({0, 3}));
+    EXPECT_TRUE(playlist.Find("Preset*", 4, 10).empty());
+    EXPECT_TRUE(playlist.Find("NoMatch", 0, 10).empty());
+}
@@ -0,0 +1,267 @@
+#include <PresetMetadataIndex.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+
+#include PROJECTM_FILESYSTEM_INCLUDE
+
+using libprojectM::Playlist::PresetMetadataIndex;
+
+namespace {
+
+/**
+ * Creates an empty test directory in the test output directory and returns its path.
+ */
+auto CreateTestDirectory(const std::string& name) -> std::string
+{
+    std::string path = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/" + name;
+    PROJECTM_FILESYSTEM_NAMESPACE::filesystem::remove_all(path);
+    PROJECTM_FILESYSTEM_NAMESPACE::filesystem::create_directories(path);
+    return path;
+}
+
+/**
+ * Writes a small test file and returns its path.
+ */
+auto WriteTestFile(const std::string& directory, const std::string& name, const std::string& contents) -> std::string
+{
+    std::string filename = directory + "/" + name;
+    std::ofstream file(filename, std::ios::trunc);
+    file << contents;
+    return filename;
+}
+
+/**
+ * Metadata function deriving the properties from the file contents: "warp" and "comp" enable the
+ * shaders, each "wave" adds a custom wave and "noise" references a texture. Files containing
+ * "broken" have no metadata.
+ */
+auto MakeMetadataFunction(std::atomic<int>& callCount) -> PresetMetadataIndex::MetadataFunction
+{
+    return [&callCount](const std::string& filename, PresetMetadataIndex::Entry& entry) {
+        callCount++;
+
+        std::ifstream file(filename);
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (contents.find("broken") != std::string::npos)
+        {
+            entry.customWaveCount = 99;
+            return false;
+        }
+
+        entry.hasWarpShader = contents.find("warp") != std::string::npos;
+        entry.hasCompositeShader = contents.find("comp") != std::string::npos;
+        for (auto pos = contents.find("wave"); pos != std::string::npos; pos = contents.find("wave", pos + 1))
+        {
+            entry.customWaveCount++;
+        }
+        if (contents.find("noise") != std::string::npos)
+        {
+            entry.textures.push_back("noise_lq");
+        }
+        entry.blurLevel = entry.hasCompositeShader ? 2 : 0;
+        entry.parseTime = 0.001;
+        entry.shaderTranslationTime = entry.hasCompositeShader ? 0.25 : 0.0;
+        return true;
+    };
+}
+
+} // namespace
+
+
+TEST(projectMPlaylistPresetMetadataIndex, BuildIndexesAllFiles)
+{
+    auto directory = CreateTestDirectory("PresetIndexBuild");
+    for (int file = 0; file < 20; file++)
+    {
+        WriteTestFile(directory, "preset" + std::to_string(file) + ".milk", "wave " + std::to_string(file));
+    }
+    WriteTestFile(directory, "readme.txt", "not a preset");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+
+    EXPECT_EQ(index.Build(directory, false, 4), 20);
+    EXPECT_EQ(callCount, 20);
+    ASSERT_EQ(index.Entries().size(), 20);
+
+    const auto& entry = index.Entries().begin()->second;
+    EXPECT_TRUE(entry.hasMetadata);
+    EXPECT_EQ(entry.customWaveCount, 1);
+    EXPECT_GT(entry.fileSize, 0);
+    EXPECT_NE(entry.contentHash, 0);
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, UnchangedFilesAreNotReadAgain)
+{
+    auto directory = CreateTestDirectory("PresetIndexUnchanged");
+    WriteTestFile(directory, "a.milk", "warp");
+    WriteTestFile(directory, "b.milk", "comp");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+
+    EXPECT_EQ(index.Build(directory, false, 0), 2);
+    EXPECT_EQ(index.Build(directory, false, 0), 2);
+    EXPECT_EQ(callCount, 2);
+
+    WriteTestFile(directory, "b.milk", "comp wave");
+    EXPECT_EQ(index.Build(directory, false, 0), 2);
+    EXPECT_EQ(callCount, 3);
+    EXPECT_EQ(index.Entries().at(directory + "/b.milk").customWaveCount, 1);
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, RemovedFilesAreDropped)
+{
+    auto directory = CreateTestDirectory("PresetIndexRemoved");
+    WriteTestFile(directory, "a.milk", "warp");
+    auto removedFile = WriteTestFile(directory, "b.milk", "comp");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+
+    EXPECT_EQ(index.Build(directory, false, 2), 2);
+
+    ASSERT_EQ(std::remove(removedFile.c_str()), 0);
+    EXPECT_EQ(index.Build(directory, false, 2), 1);
+    EXPECT_EQ(index.Entries().size(), 1);
+    EXPECT_EQ(index.Entries().count(removedFile), 0);
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, FailedMetadataKeepsFileInfoOnly)
+{
+    auto directory = CreateTestDirectory("PresetIndexFailed");
+    auto brokenFile = WriteTestFile(directory, "broken.milk", "broken");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+
+    EXPECT_EQ(index.Build(directory, false, 1), 1);
+
+    const auto& entry = index.Entries().at(brokenFile);
+    EXPECT_FALSE(entry.hasMetadata);
+    EXPECT_EQ(entry.customWaveCount, 0);
+    EXPECT_GT(entry.fileSize, 0);
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, FindMatchesAllConditions)
+{
+    auto directory = CreateTestDirectory("PresetIndexFind");
+    auto plainFile = WriteTestFile(directory, "a-plain.milk", "plain");
+    auto warpFile = WriteTestFile(directory, "b-warp.milk", "warp wave wave noise");
+    auto compFile = WriteTestFile(directory, "c-comp.milk", "comp wave");
+    auto brokenFile = WriteTestFile(directory, "d-broken.milk", "broken");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+    ASSERT_EQ(index.Build(directory, false, 2), 4);
+
+    std::vector<std::string> filenames;
+    ASSERT_TRUE(index.Find({}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({plainFile, warpFile, compFile, brokenFile}));
+
+    filenames.clear();
+    ASSERT_TRUE(index.Find({"composite_shader = 0", "custom_waves>=1"}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({warpFile}));
+
+    filenames.clear();
+    ASSERT_TRUE(index.Find({"blur_level<=1"}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({plainFile, warpFile}));
+
+    filenames.clear();
+    ASSERT_TRUE(index.Find({"load_time < 0.1"}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({plainFile, warpFile}));
+
+    filenames.clear();
+    ASSERT_TRUE(index.Find({"texture=NOISE_LQ"}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({warpFile}));
+
+    filenames.clear();
+    ASSERT_TRUE(index.Find({"texture!=noise_lq"}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({plainFile, compFile}));
+
+    filenames.clear();
+    ASSERT_TRUE(index.Find({"metadata=0", "size>0"}, filenames));
+    EXPECT_EQ(filenames, std::vector<std::string>({brokenFile}));
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, FindRejectsInvalidConditions)
+{
+    auto directory = CreateTestDirectory("PresetIndexInvalid");
+    WriteTestFile(directory, "a.milk", "warp");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+    ASSERT_EQ(index.Build(directory, false, 1), 1);
+
+    for (const auto* condition : {"warp_shader", "unknown=1", "warp_shader=yes", "blur_level=", "texture<noise", "size=>1"})
+    {
+        std::vector<std::string> filenames;
+        EXPECT_FALSE(index.Find({"warp_shader=1", condition}, filenames)) << condition;
+        EXPECT_TRUE(filenames.empty());
+    }
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, SaveAndLoad)
+{
+    auto directory = CreateTestDirectory("PresetIndexSave");
+    WriteTestFile(directory, "a.milk", "warp wave noise");
+    WriteTestFile(directory, "b.milk", "comp");
+    WriteTestFile(directory, "c.milk", "broken");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+    ASSERT_EQ(index.Build(directory, false, 2), 3);
+
+    const std::string indexFile = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetIndexSave.txt";
+    ASSERT_TRUE(index.Save(indexFile));
+
+    PresetMetadataIndex loadedIndex(MakeMetadataFunction(callCount));
+    ASSERT_TRUE(loadedIndex.Load(indexFile));
+    ASSERT_EQ(loadedIndex.Entries().size(), index.Entries().size());
+
+    for (const auto& entry : index.Entries())
+    {
+        const auto& loadedEntry = loadedIndex.Entries().at(entry.first);
+        EXPECT_EQ(loadedEntry.modificationTime, entry.second.modificationTime);
+        EXPECT_EQ(loadedEntry.fileSize, entry.second.fileSize);
+        EXPECT_EQ(loadedEntry.contentHash, entry.second.contentHash);
+        EXPECT_EQ(loadedEntry.hasMetadata, entry.second.hasMetadata);
+        EXPECT_EQ(loadedEntry.hasWarpShader, entry.second.hasWarpShader);
+        EXPECT_EQ(loadedEntry.hasCompositeShader, entry.second.hasCompositeShader);
+        EXPECT_EQ(loadedEntry.customWaveCount, entry.second.customWaveCount);
+        EXPECT_EQ(loadedEntry.blurLevel, entry.second.blurLevel);
+        EXPECT_DOUBLE_EQ(loadedEntry.shaderTranslationTime, entry.second.shaderTranslationTime);
+        EXPECT_EQ(loadedEntry.textures, entry.second.textures);
+    }
+
+    // A loaded index is used for unchanged files.
+    int callsBefore = callCount;
+    EXPECT_EQ(loadedIndex.Build(directory, false, 2), 3);
+    EXPECT_EQ(callCount, callsBefore);
+}
+
+
+TEST(projectMPlaylistPresetMetadataIndex, LoadRejectsOtherFiles)
+{
+    auto directory = CreateTestDirectory("PresetIndexLoadOther");
+    WriteTestFile(directory, "a.milk", "warp");
+    auto otherFile = WriteTestFile(directory, "other.txt", "projectM-preset-stats 1\n");
+
+    std::atomic<int> callCount{0};
+    PresetMetadataIndex index(MakeMetadataFunction(callCount));
+    ASSERT_EQ(index.Build(directory, false, 1), 1);
+
+    EXPECT_FALSE(index.Load(otherFile));
+    EXPECT_FALSE(index.Load(directory + "/does-not-exist.txt"));
+    EXPECT_EQ(index.Entries().size(), 1);
+}
@@ -0,0 +1,119 @@
+#include <PresetStats.hpp>
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+using libprojectM::Playlist::PresetStats;
+
+TEST(projectMPlaylistPresetStats, Record)
+{
+    PresetStats stats;
+
+    EXPECT_EQ(stats.Get("/some/PresetA.milk"), nullptr);
+
+    stats.Record("/some/PresetA.milk", 100, 0.01);
+    stats.Record("/some/PresetA.milk", 300, 0.03);
+
+    const auto* entry = stats.Get("/some/PresetA.milk");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->playCount, 2);
+    EXPECT_EQ(entry->frameCount, 400);
+    EXPECT_DOUBLE_EQ(entry->averageFrameTime, 0.025);
+
+    EXPECT_EQ(stats.Size(), 1);
+}
+
+
+TEST(projectMPlaylistPresetStats, RecordWithoutFrames)
+{
+    PresetStats stats;
+
+    stats.Record("/some/PresetA.milk", 0, 0.0);
+
+    EXPECT_EQ(stats.Get("/some/PresetA.milk"), nullptr);
+    EXPECT_EQ(stats.Size(), 0);
+}
+
+
+TEST(projectMPlaylistPresetStats, Clear)
+{
+    PresetStats stats;
+
+    stats.Record("/some/PresetA.milk", 100, 0.01);
+    stats.Clear();
+
+    EXPECT_EQ(stats.Get("/some/PresetA.milk"), nullptr);
+    EXPECT_EQ(stats.Size(), 0);
+}
+
+
+TEST(projectMPlaylistPresetStats, SaveAndLoad)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetStatsSaveAndLoad.txt";
+
+    PresetStats stats;
+    stats.Record("/some/PresetA.milk", 100, 0.01);
+    stats.Record("/some/path with spaces/Preset\tB.milk", 50, 1.0 / 3.0);
+
+    ASSERT_TRUE(stats.Save(filename));
+
+    PresetStats loadedStats;
+    loadedStats.Record("/some/PresetC.milk", 10, 0.1);
+    ASSERT_TRUE(loadedStats.Load(filename));
+
+    EXPECT_EQ(loadedStats.Size(), 2);
+    EXPECT_EQ(loadedStats.Get("/some/PresetC.milk"), nullptr);
+
+    const auto* entryA = loadedStats.Get("/some/PresetA.milk");
+    ASSERT_NE(entryA, nullptr);
+    EXPECT_EQ(entryA->playCount, 1);
+    EXPECT_EQ(entryA->frameCount, 100);
+    EXPECT_DOUBLE_EQ(entryA->averageFrameTime, 0.01);
+
+    const auto* entryB = loadedStats.Get("/some/path with spaces/Preset\tB.milk");
+    ASSERT_NE(entryB, nullptr);
+    EXPECT_EQ(entryB->frameCount, 50);
+    EXPECT_DOUBLE_EQ(entryB->averageFrameTime, 1.0 / 3.0);
+}
+
+
+TEST(projectMPlaylistPresetStats, LoadInvalidFile)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetStatsLoadInvalidFile.txt";
+
+    {
+        std::ofstream file(filename, std::ios::trunc);
+        file << "not-a-stats-file 1\n1\t100\t0.01\t/some/PresetA.milk\n";
+    }
+
+    PresetStats stats;
+    stats.Record("/some/PresetB.milk", 10, 0.1);
+
+    EXPECT_FALSE(stats.Load(filename));
+    EXPECT_FALSE(stats.Load(PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetStatsDoesNotExist.txt"));
+
+    EXPECT_EQ(stats.Size(), 1);
+    EXPECT_NE(stats.Get("/some/PresetB.milk"), nullptr);
+}
+
+
+TEST(projectMPlaylistPresetStats, LoadSkipsMalformedLines)
+{
+    const std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetStatsLoadSkipsMalformedLines.txt";
+
+    {
+        std::ofstream file(filename, std::ios::trunc);
+        file << "projectM-preset-stats 1\n"
+             << "1\t100\t0.01\t/some/PresetA.milk\n"
+             << "garbage\n"
+             << "1\t0\t0.01\t/some/PresetB.milk\n"
+             << "2\t200\t0.02\n";
+    }
+
+    PresetStats stats;
+    ASSERT_TRUE(stats.Load(filename));
+
+    EXPECT_EQ(stats.Size(), 1);
+    EXPECT_NE(stats.Get("/some/PresetA.milk"), nullptr);
+}
@@ -0,0 +1,195 @@
+#include <PresetValidator.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using libprojectM::Playlist::PresetValidator;
+
+namespace {
+
+/**
+ * Writes a small test file into the test output directory and returns its path.
+ */
+auto WriteTestFile(const std::string& name, const std::string& contents) -> std::string
+{
+    std::string filename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/" + name;
+    std::ofstream file(filename, std::ios::trunc);
+    file << contents;
+    return filename;
+}
+
+/**
+ * Waits until the validator's worker thread has checked all files.
+ */
+void WaitForValidator(const PresetValidator& validator)
+{
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (validator.Running() && std::chrono::steady_clock::now() < timeout)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * Validation function treating all files containing "broken" as invalid.
+ */
+auto MakeValidateFunction(std::atomic<int>& callCount) -> PresetValidator::ValidateFunction
+{
+    return [&callCount](const std::string& filename, std::string& errorMessage) {
+        callCount++;
+
+        std::ifstream file(filename);
+        std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (contents.find("broken") != std::string::npos)
+        {
+            errorMessage = "Broken\tpreset";
+            return false;
+        }
+        return true;
+    };
+}
+
+} // namespace
+
+
+TEST(projectMPlaylistPresetValidator, FindsInvalidFiles)
+{
+    auto validFile = WriteTestFile("ValidatorValid.milk", "valid");
+    auto brokenFile = WriteTestFile("ValidatorBroken.milk", "broken");
+
+    std::atomic<int> callCount{0};
+    PresetValidator validator(MakeValidateFunction(callCount));
+
+    ASSERT_TRUE(validator.Start({validFile, brokenFile}));
+    WaitForValidator(validator);
+
+    EXPECT_FALSE(validator.Running());
+    EXPECT_EQ(validator.Progress(), 2);
+    EXPECT_EQ(validator.Total(), 2);
+    EXPECT_EQ(callCount, 2);
+
+    auto invalidFilenames = validator.TakeInvalidFilenames();
+    ASSERT_EQ(invalidFilenames.size(), 1);
+    EXPECT_EQ(invalidFilenames.at(0), brokenFile);
+    EXPECT_TRUE(validator.TakeInvalidFilenames().empty());
+
+    PresetValidator::CacheEntry entry;
+    ASSERT_TRUE(validator.GetCacheEntry(brokenFile, entry));
+    EXPECT_FALSE(entry.valid);
+    EXPECT_EQ(entry.errorMessage, "Broken\tpreset");
+    EXPECT_EQ(entry.fileSize, 6);
+}
+
+
+TEST(projectMPlaylistPresetValidator, CachedResultsAreReused)
+{
+    auto validFile = WriteTestFile("ValidatorCachedValid.milk", "valid");
+    auto brokenFile = WriteTestFile("ValidatorCachedBroken.milk", "broken");
+
+    std::atomic<int> callCount{0};
+    PresetValidator validator(MakeValidateFunction(callCount));
+
+    ASSERT_TRUE(validator.Start({validFile, brokenFile}));
+    WaitForValidator(validator);
+    EXPECT_EQ(callCount, 2);
+    validator.TakeInvalidFilenames();
+
+    // Unchanged files are only looked up in the cache, but invalid files are still reported.
+    ASSERT_TRUE(validator.Start({validFile, brokenFile}));
+    WaitForValidator(validator);
+    EXPECT_EQ(callCount, 2);
+    EXPECT_EQ(validator.TakeInvalidFilenames().size(), 1);
+
+    // Changed files are checked again.
+    WriteTestFile("ValidatorCachedValid.milk", "now broken");
+    ASSERT_TRUE(validator.Start({validFile, brokenFile}));
+    WaitForValidator(validator);
+    EXPECT_EQ(callCount, 3);
+    EXPECT_EQ(validator.TakeInvalidFilenames().size(), 2);
+}
+
+
+TEST(projectMPlaylistPresetValidator, NonFilesAreNotCached)
+{
+    std::atomic<int> callCount{0};
+    PresetValidator validator(MakeValidateFunction(callCount));
+
+    ASSERT_TRUE(validator.Start({"idle://Preset.milk"}));
+    WaitForValidator(validator);
+    ASSERT_TRUE(validator.Start({"idle://Preset.milk"}));
+    WaitForValidator(validator);
+
+    EXPECT_EQ(callCount, 2);
+
+    PresetValidator::CacheEntry entry;
+    EXPECT_FALSE(validator.GetCacheEntry("idle://Preset.milk", entry));
+}
+
+
+TEST(projectMPlaylistPresetValidator, Stop)
+{
+    std::vector<std::string> filenames(10000, "idle://Preset.milk");
+
+    std::atomic<int> callCount{0};
+    PresetValidator validator([&callCount](const std::string&, std::string&) {
+        callCount++;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        return true;
+    });
+
+    ASSERT_TRUE(validator.Start(filenames));
+    validator.Stop();
+
+    EXPECT_FALSE(validator.Running());
+    EXPECT_LT(validator.Progress(), 10000);
+    EXPECT_EQ(validator.Progress(), static_cast<uint32_t>(callCount));
+}
+
+
+TEST(projectMPlaylistPresetValidator, SaveAndLoadCache)
+{
+    const std::string cacheFilename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetValidatorCache.txt";
+
+    auto validFile = WriteTestFile("ValidatorSavedValid.milk", "valid");
+    auto brokenFile = WriteTestFile("ValidatorSavedBroken.milk", "broken");
+
+    std::atomic<int> callCount{0};
+    PresetValidator validator(MakeValidateFunction(callCount));
+
+    ASSERT_TRUE(validator.Start({validFile, brokenFile}));
+    WaitForValidator(validator);
+    ASSERT_TRUE(validator.SaveCache(cacheFilename));
+
+    std::atomic<int> loadedCallCount{0};
+    PresetValidator loadedValidator(MakeValidateFunction(loadedCallCount));
+    ASSERT_TRUE(loadedValidator.LoadCache(cacheFilename));
+
+    PresetValidator::CacheEntry entry;
+    ASSERT_TRUE(loadedValidator.GetCacheEntry(brokenFile, entry));
+    EXPECT_FALSE(entry.valid);
+    EXPECT_EQ(entry.errorMessage, "Broken preset");
+    ASSERT_TRUE(loadedValidator.GetCacheEntry(validFile, entry));
+    EXPECT_TRUE(entry.valid);
+    EXPECT_TRUE(entry.errorMessage.empty());
+
+    ASSERT_TRUE(loadedValidator.Start({validFile, brokenFile}));
+    WaitForValidator(loadedValidator);
+    EXPECT_EQ(loadedCallCount, 0);
+    EXPECT_EQ(loadedValidator.TakeInvalidFilenames().size(), 1);
+}
+
+
+TEST(projectMPlaylistPresetValidator, LoadCacheInvalidFile)
+{
+    const std::string cacheFilename = PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/PresetValidatorCacheInvalid.txt";
+    WriteTestFile("PresetValidatorCacheInvalid.txt", "projectM-preset-stats 1\n");
+
+    PresetValidator validator([](const std::string&, std::string&) { return true; });
+
+    EXPECT_FALSE(validator.LoadCache(cacheFilename));
+    EXPECT_FALSE(validator.LoadCache(PROJECTM_PLAYLIST_TEST_OUTPUT_DIR "/DoesNotExist.txt"));
+}
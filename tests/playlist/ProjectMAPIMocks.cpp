@@ -22,3 +22,35 @@ PROJECTM_EXPORT void projectm_load_preset_file(projectm_handle, const char*,
                                bool)
 {
 }
+
+PROJECTM_EXPORT uint32_t projectm_get_preset_frame_count(projectm_handle)
+{
+    return 0;
+}
+
+PROJECTM_EXPORT double projectm_get_preset_average_frame_time(projectm_handle)
+{
+    return 0.0;
+}
+
+PROJECTM_EXPORT bool projectm_validate_preset_file(projectm_handle, const char*, char** error_message)
+{
+    if (error_message != nullptr)
+    {
+        *error_message = nullptr;
+    }
+    return true;
+}
+
+PROJECTM_EXPORT bool projectm_get_preset_metadata(projectm_handle, const char*, projectm_preset_metadata*, char** error_message)
+{
+    if (error_message != nullptr)
+    {
+        *error_message = nullptr;
+    }
+    return false;
+}
+
+PROJECTM_EXPORT void projectm_free_string(const char*)
+{
+}